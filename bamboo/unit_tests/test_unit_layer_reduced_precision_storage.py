@@ -0,0 +1,53 @@
+import sys
+sys.path.insert(0, '../common_python')
+import tools
+import pytest
+import os
+
+
+def skeleton_layer_reduced_precision_storage(cluster, executables, dir_name, compiler_name):
+    if compiler_name not in executables:
+      e = 'skeleton_layer_reduced_precision_storage: default_exes[%s] does not exist' % compiler_name
+      print('Skip - ' + e)
+      pytest.skip(e)
+    output_file_name = '%s/bamboo/unit_tests/output/layer_reduced_precision_storage_%s_output.txt' % (dir_name, compiler_name)
+    error_file_name  = '%s/bamboo/unit_tests/error/layer_reduced_precision_storage_%s_error.txt' % (dir_name, compiler_name)
+    command = tools.get_command(
+        cluster=cluster, executable=executables[compiler_name], num_nodes=1,
+        time_limit=10,
+        num_processes=2, dir_name=dir_name,
+        data_reader_name='synthetic',
+        model_folder='tests/layer_tests', model_name='reduced_precision_storage',
+        optimizer_name='sgd',
+        output_file_name=output_file_name, error_file_name=error_file_name)
+    return_code = os.system(command)
+    assert return_code == 0
+
+    # Layers after the split layer should keep their inputs in
+    # bfloat16 between forward and backward prop
+    with open(output_file_name) as f:
+        output = f.read()
+    assert 'Reduced-precision storage: bfloat16' in output
+    assert 'Reduced-precision storage: bfloat16, 0 inputs' not in output
+
+
+def test_unit_layer_reduced_precision_storage_clang6(cluster, exes, dirname):
+    skeleton_layer_reduced_precision_storage(cluster, exes, dirname, 'clang6')
+
+
+def test_unit_layer_reduced_precision_storage_gcc7(cluster, exes, dirname):
+    skeleton_layer_reduced_precision_storage(cluster, exes, dirname, 'gcc7')
+
+
+def test_unit_layer_reduced_precision_storage_intel19(cluster, exes, dirname):
+    skeleton_layer_reduced_precision_storage(cluster, exes, dirname, 'intel19')
+
+
+# Run with python3 -m pytest -s test_unit_layer_reduced_precision_storage.py -k 'test_unit_layer_reduced_precision_storage_exe' --exe=<executable>
+def test_unit_layer_reduced_precision_storage_exe(cluster, dirname, exe):
+    if exe is None:
+        e = 'test_unit_layer_reduced_precision_storage_exe: Non-local testing'
+        print('Skip - ' + e)
+        pytest.skip(e)
+    exes = {'exe': exe}
+    skeleton_layer_reduced_precision_storage(cluster, exes, dirname, 'exe')
@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+"""Compare two layer benchmark JSON files.
+
+Usage: compare_benchmarks.py baseline.json contender.json [--threshold=0.1]
+
+Prints the median time of each benchmark in both files and the
+relative change. Exits with a nonzero status if any benchmark is
+slower than the baseline by more than the threshold (default 10%).
+
+"""
+import argparse
+import json
+import sys
+
+def load_medians(filename):
+    """Map from benchmark name to median time."""
+    with open(filename) as f:
+        data = json.load(f)
+    medians = {}
+    for entry in data['benchmarks']:
+        if entry.get('aggregate_name', 'median') == 'median':
+            medians[entry['run_name']] = entry['real_time']
+    return medians
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Compare two layer benchmark JSON files.')
+    parser.add_argument('baseline', type=str)
+    parser.add_argument('contender', type=str)
+    parser.add_argument('--threshold', type=float, default=0.1,
+                        help='relative slowdown reported as a regression')
+    args = parser.parse_args()
+
+    baseline = load_medians(args.baseline)
+    contender = load_medians(args.contender)
+    regressions = []
+    print('{:<44}{:>16}{:>16}{:>10}'.format(
+        'benchmark', 'baseline (us)', 'contender (us)', 'change'))
+    for name in sorted(set(baseline) & set(contender)):
+        old, new = baseline[name], contender[name]
+        change = (new - old) / old if old > 0 else 0.0
+        flag = ''
+        if change > args.threshold:
+            regressions.append(name)
+            flag = '  REGRESSION'
+        print('{:<44}{:>16.1f}{:>16.1f}{:>+10.1%}{}'.format(
+            name, old, new, change, flag))
+    for name in sorted(set(baseline) ^ set(contender)):
+        print('{:<44}{:>14}'.format(name, 'missing in one file'))
+
+    if regressions:
+        print('{} regression(s) above {:.0%}'.format(len(regressions),
+                                                     args.threshold))
+        sys.exit(1)
+
+if __name__ == '__main__':
+    main()
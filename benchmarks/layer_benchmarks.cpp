@@ -0,0 +1,456 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+// layer_benchmarks.cpp - Micro-benchmarks for CPU layer kernels
+////////////////////////////////////////////////////////////////////////////////
+
+// Times the forward and backward compute functions of CPU layers at
+// representative shapes. Each benchmark builds a small model with
+// Gaussian (or uniform) input layers, the layer under test, and an L2
+// norm sink per output, then runs forward and backward propagation
+// through every layer. Only the fp_compute and bp_compute time of the
+// layer under test is recorded, so tensor setup, the inputs, and the
+// sinks do not contribute.
+//
+// Results are printed as a table and, with --benchmark_out, written
+// as JSON in the format of Google Benchmark so that runs can be
+// compared with compare_benchmarks.py (or Google Benchmark's own
+// tools/compare.py).
+//
+// Usage: layer_benchmarks [--iterations=N] [--warmup=N]
+//                         [--mini_batch_size=N]
+//                         [--benchmark_filter=substring]
+//                         [--benchmark_out=file.json]
+//
+// Must be run on a single MPI rank. The number of OpenMP threads is
+// controlled as usual with OMP_NUM_THREADS.
+
+#include "lbann/lbann.hpp"
+#include "lbann/proto/factories.hpp"
+
+#include <lbann.pb.h>
+#include <google/protobuf/text_format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace lbann;
+
+namespace {
+
+/** Benchmark configuration. */
+struct benchmark_config {
+  /** Benchmark name. */
+  std::string name;
+  /** Layer prototext, without name, parents, or children. */
+  std::string layer;
+  /** Dimensions of each input tensor. */
+  std::vector<std::string> input_dims;
+  /** Number of output tensors. */
+  int num_outputs;
+  /** Inputs are uniform random indices in [0,max_index) if
+   *  nonzero, otherwise standard Gaussian. */
+  int max_index;
+};
+
+/** Timing statistics in microseconds. */
+struct timing_stats {
+  double median, mean, stddev, min, max;
+};
+
+/** Benchmark cases. */
+std::vector<benchmark_config> get_benchmarks() {
+  return {
+
+    // Convolution
+    {"convolution/3x3/64x56x56",
+     "convolution { num_dims: 2 num_output_channels: 64"
+     " conv_dims_i: 3 conv_pads_i: 1 conv_strides_i: 1 has_bias: false }",
+     {"64 56 56"}, 1, 0},
+    {"convolution/1x1/256x56x56",
+     "convolution { num_dims: 2 num_output_channels: 64"
+     " conv_dims_i: 1 conv_pads_i: 0 conv_strides_i: 1 has_bias: false }",
+     {"256 56 56"}, 1, 0},
+    {"convolution/3x3_stride2/128x56x56",
+     "convolution { num_dims: 2 num_output_channels: 128"
+     " conv_dims_i: 3 conv_pads_i: 1 conv_strides_i: 2 has_bias: false }",
+     {"128 56 56"}, 1, 0},
+    {"convolution/depthwise_3x3/32x112x112",
+     "convolution { num_dims: 2 num_output_channels: 32 num_groups: 32"
+     " conv_dims_i: 3 conv_pads_i: 1 conv_strides_i: 1 has_bias: false }",
+     {"32 112 112"}, 1, 0},
+
+    // Fully-connected
+    {"fully_connected/4096x1000",
+     "fully_connected { num_neurons: 1000 has_bias: true }",
+     {"4096"}, 1, 0},
+
+    // Pooling
+    {"pooling/max_3x3_stride2/64x112x112",
+     "pooling { num_dims: 2 pool_mode: \"max\""
+     " pool_dims_i: 3 pool_pads_i: 1 pool_strides_i: 2 }",
+     {"64 112 112"}, 1, 0},
+    {"pooling/average_7x7/2048x7x7",
+     "pooling { num_dims: 2 pool_mode: \"average\""
+     " pool_dims_i: 7 pool_pads_i: 0 pool_strides_i: 1 }",
+     {"2048 7 7"}, 1, 0},
+    {"pooling/max_2x2_stride2/256x56x56",
+     "pooling { num_dims: 2 pool_mode: \"max\""
+     " pool_dims_i: 2 pool_pads_i: 0 pool_strides_i: 2 }",
+     {"256 56 56"}, 1, 0},
+    {"pooling/max_2x2x2_stride2/32x32x32x32",
+     "pooling { num_dims: 3 pool_mode: \"max\""
+     " pool_dims_i: 2 pool_pads_i: 0 pool_strides_i: 2 }",
+     {"32 32 32 32"}, 1, 0},
+    {"pooling/max_3x3x3_stride2/32x32x32x32",
+     "pooling { num_dims: 3 pool_mode: \"max\""
+     " pool_dims_i: 3 pool_pads_i: 1 pool_strides_i: 2 }",
+     {"32 32 32 32"}, 1, 0},
+    {"pooling/average_2x2x2_stride2/32x32x32x32",
+     "pooling { num_dims: 3 pool_mode: \"average\""
+     " pool_dims_i: 2 pool_pads_i: 0 pool_strides_i: 2 }",
+     {"32 32 32 32"}, 1, 0},
+
+    // Batch normalization
+    {"batch_normalization/64x112x112",
+     "batch_normalization { decay: 0.9 epsilon: 1e-5"
+     " statistics_group_size: 1 }",
+     {"64 112 112"}, 1, 0},
+    {"batch_normalization/512x7x7",
+     "batch_normalization { decay: 0.9 epsilon: 1e-5"
+     " statistics_group_size: 1 }",
+     {"512 7 7"}, 1, 0},
+
+    // Softmax
+    {"softmax/1000", "softmax {}", {"1000"}, 1, 0},
+    {"softmax/32000", "softmax {}", {"32000"}, 1, 0},
+    {"log_softmax/1000", "log_softmax {}", {"1000"}, 1, 0},
+    {"softmax_cross_entropy/1000", "softmax_cross_entropy {}",
+     {"1000", "1000"}, 1, 0},
+
+    // Entry-wise
+    {"relu/64x56x56", "relu {}", {"64 56 56"}, 1, 0},
+    {"sigmoid/64x56x56", "sigmoid {}", {"64 56 56"}, 1, 0},
+
+    // Concatenation and slice
+    {"concatenation/2x64x28x28",
+     "concatenation { axis: 0 }",
+     {"64 28 28", "64 28 28"}, 1, 0},
+    {"slice/128x28x28",
+     "slice { axis: 0 slice_points: \"0 64 128\" }",
+     {"128 28 28"}, 2, 0},
+
+    // Embedding
+    {"embedding/100000x64/8_indices",
+     "embedding { dictionary_size: 100000 embedding_size: 64 }",
+     {"8"}, 1, 100000},
+
+  };
+}
+
+/** Prototext for a model containing the benchmarked layer. */
+std::string get_prototext(const benchmark_config& config,
+                          int mini_batch_size) {
+  const int num_inputs = config.input_dims.size();
+  std::ostringstream ss;
+  ss << "optimizer { sgd { learn_rate: 0.01 } }\n"
+     << "model {\n"
+     << "  mini_batch_size: " << mini_batch_size << "\n"
+     << "  objective_function {\n";
+  for (int i = 0; i < config.num_outputs; ++i) {
+    ss << "    layer_term { scale_factor: 1 layer: \"loss" << i << "\" }\n";
+  }
+  ss << "  }\n";
+
+  // Input layers
+  for (int i = 0; i < num_inputs; ++i) {
+    ss << "  layer {\n"
+       << "    name: \"x" << i << "\"\n"
+       << "    data_layout: \"data_parallel\" device_allocation: \"cpu\"\n";
+    if (config.max_index > 0) {
+      ss << "    uniform { min: 0 max: " << config.max_index - 1;
+    } else {
+      ss << "    gaussian { mean: 0 stdev: 1";
+    }
+    ss << " neuron_dims: \"" << config.input_dims[i] << "\" }\n"
+       << "  }\n";
+  }
+
+  // Benchmarked layer
+  ss << "  layer {\n"
+     << "    name: \"layer\"\n"
+     << "    parents: \"";
+  for (int i = 0; i < num_inputs; ++i) {
+    ss << (i > 0 ? " " : "") << "x" << i;
+  }
+  ss << "\"\n"
+     << "    data_layout: \"data_parallel\" device_allocation: \"cpu\"\n"
+     << "    " << config.layer << "\n"
+     << "  }\n";
+
+  // Loss layers
+  for (int i = 0; i < config.num_outputs; ++i) {
+    ss << "  layer {\n"
+       << "    name: \"loss" << i << "\"\n"
+       << "    parents: \"layer\"\n"
+       << "    data_layout: \"data_parallel\" device_allocation: \"cpu\"\n"
+       << "    l2_norm2 {}\n"
+       << "  }\n";
+  }
+
+  ss << "}\n";
+  return ss.str();
+}
+
+/** Compute statistics of per-iteration times (in seconds). */
+timing_stats get_stats(std::vector<double> times) {
+  timing_stats stats;
+  for (auto& t : times) { t *= 1e6; }
+  std::sort(times.begin(), times.end());
+  const size_t n = times.size();
+  stats.median = (n % 2 == 1 ?
+                  times[n/2] :
+                  (times[n/2-1] + times[n/2]) / 2);
+  stats.mean = std::accumulate(times.begin(), times.end(), 0.0) / n;
+  double sqsum = 0;
+  for (const auto& t : times) { sqsum += (t - stats.mean) * (t - stats.mean); }
+  stats.stddev = n > 1 ? std::sqrt(sqsum / (n - 1)) : 0.0;
+  stats.min = times.front();
+  stats.max = times.back();
+  return stats;
+}
+
+/** Run a benchmark and record fp/bp compute times.
+ *  Times are per iteration in seconds.
+ */
+void run_benchmark(lbann_comm* comm,
+                   const benchmark_config& config,
+                   int mini_batch_size,
+                   int warmup,
+                   int iterations,
+                   std::vector<double>& fp_times,
+                   std::vector<double>& bp_times) {
+
+  // Construct model
+  lbann_data::LbannPB pb;
+  const auto prototext = get_prototext(config, mini_batch_size);
+  if (!google::protobuf::TextFormat::ParseFromString(prototext, &pb)) {
+    LBANN_ERROR("failed to parse prototext for benchmark ",
+                "\"", config.name, "\":\n", prototext);
+  }
+  auto m = proto::construct_model(comm, {}, pb.optimizer(), pb.model());
+  m->setup(std::shared_ptr<thread_pool>());
+  m->set_execution_mode(execution_mode::training);
+  m->set_current_mini_batch_size(mini_batch_size);
+  m->set_effective_mini_batch_size(mini_batch_size);
+
+  // Find benchmarked layer
+  const auto layers = m->get_layers();
+  Layer* target = nullptr;
+  for (auto* l : layers) {
+    if (l->get_name() == "layer") { target = l; }
+  }
+  if (target == nullptr) {
+    LBANN_ERROR("could not find layer in benchmark \"", config.name, "\"");
+  }
+
+  // Run forward and backward prop through all layers
+  fp_times.clear();
+  bp_times.clear();
+  for (int iter = 0; iter < warmup + iterations; ++iter) {
+    const auto fp_start = target->get_fp_compute_time();
+    const auto bp_start = target->get_bp_compute_time();
+    for (auto* l : layers) {
+      l->forward_prop();
+    }
+    for (auto* l : layers) {
+      auto* eval = dynamic_cast<abstract_evaluation_layer*>(l);
+      if (eval != nullptr) { eval->get_value(); }
+    }
+    for (auto it = layers.rbegin(); it != layers.rend(); ++it) {
+      (*it)->back_prop();
+    }
+    for (auto* w : m->get_weights()) {
+      auto* opt = w->get_optimizer();
+      if (opt != nullptr) {
+        opt->get_gradient();
+        opt->clear_gradient();
+      }
+    }
+    if (iter >= warmup) {
+      fp_times.push_back(target->get_fp_compute_time() - fp_start);
+      bp_times.push_back(target->get_bp_compute_time() - bp_start);
+    }
+  }
+
+}
+
+void print_result(const std::string& name, const timing_stats& stats) {
+  std::cout << std::left << std::setw(44) << name
+            << std::right << std::fixed << std::setprecision(1)
+            << std::setw(14) << stats.median
+            << std::setw(14) << stats.mean
+            << std::setw(14) << stats.min
+            << std::setw(14) << stats.max
+            << std::defaultfloat << std::endl;
+}
+
+/** Write a Google Benchmark style entry for each statistic. */
+void write_json_entries(std::ostream& os,
+                        const std::string& name,
+                        int iterations,
+                        const timing_stats& stats,
+                        bool& first) {
+  const std::vector<std::pair<std::string, double>> aggregates = {
+    {"median", stats.median},
+    {"mean", stats.mean},
+    {"stddev", stats.stddev},
+    {"min", stats.min},
+    {"max", stats.max}
+  };
+  for (const auto& agg : aggregates) {
+    os << (first ? "" : ",\n")
+       << "    {\n"
+       << "      \"name\": \"" << name << "_" << agg.first << "\",\n"
+       << "      \"run_name\": \"" << name << "\",\n"
+       << "      \"run_type\": \"aggregate\",\n"
+       << "      \"aggregate_name\": \"" << agg.first << "\",\n"
+       << "      \"iterations\": " << iterations << ",\n"
+       // Only wall-clock time is measured, so it is also reported as
+       // CPU time for compatibility with comparison tools
+       << "      \"real_time\": " << agg.second << ",\n"
+       << "      \"cpu_time\": " << agg.second << ",\n"
+       << "      \"time_unit\": \"us\"\n"
+       << "    }";
+    first = false;
+  }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  world_comm_ptr comm = initialize(argc, argv, lbann_default_random_seed);
+
+  try {
+    options *opts = options::get();
+    opts->init(argc, argv);
+    const int iterations = opts->get_int("iterations", 20);
+    const int warmup = opts->get_int("warmup", 3);
+    const int mini_batch_size = opts->get_int("mini_batch_size", 32);
+    const auto filter = opts->get_string("benchmark_filter", "");
+    const auto out_file = opts->get_string("benchmark_out", "");
+    if (iterations < 1 || warmup < 0 || mini_batch_size < 1) {
+      LBANN_ERROR("invalid benchmark options (iterations=", iterations, ", ",
+                  "warmup=", warmup, ", ",
+                  "mini_batch_size=", mini_batch_size, ")");
+    }
+    if (comm->get_procs_in_world() != 1) {
+      LBANN_ERROR("layer benchmarks must be run on a single process, ",
+                  "but there are ", comm->get_procs_in_world());
+    }
+
+    // Header
+    const auto num_threads = omp_get_max_threads();
+    std::cout << "threads=" << num_threads << " "
+              << "mini_batch_size=" << mini_batch_size << " "
+              << "iterations=" << iterations << " "
+              << "warmup=" << warmup << std::endl
+              << std::left << std::setw(44) << "benchmark"
+              << std::right << std::setw(14) << "median (us)"
+              << std::setw(14) << "mean (us)"
+              << std::setw(14) << "min (us)"
+              << std::setw(14) << "max (us)" << std::endl;
+
+    // JSON output
+    std::ofstream json;
+    bool first_entry = true;
+    if (!out_file.empty()) {
+      json.open(out_file);
+      if (!json) {
+        LBANN_ERROR("could not open ", out_file, " for writing");
+      }
+      char date[64];
+      const auto now = std::time(nullptr);
+      std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S",
+                    std::localtime(&now));
+      json << "{\n"
+           << "  \"context\": {\n"
+           << "    \"date\": \"" << date << "\",\n"
+           << "    \"executable\": \"" << argv[0] << "\",\n"
+           << "    \"lbann_version\": \"" << LBANN_MAKE_STR(LBANN_VERSION) << "\",\n"
+           << "    \"num_threads\": " << num_threads << ",\n"
+           << "    \"mini_batch_size\": " << mini_batch_size << ",\n"
+           << "    \"library_build_type\": \""
+#ifdef LBANN_DEBUG
+           << "debug"
+#else
+           << "release"
+#endif // LBANN_DEBUG
+           << "\"\n"
+           << "  },\n"
+           << "  \"benchmarks\": [\n";
+    }
+
+    // Run benchmarks
+    std::vector<double> fp_times, bp_times;
+    for (const auto& config : get_benchmarks()) {
+      if (config.name.find(filter) == std::string::npos) { continue; }
+      run_benchmark(comm.get(), config, mini_batch_size, warmup, iterations,
+                    fp_times, bp_times);
+      const auto fp_stats = get_stats(fp_times);
+      const auto bp_stats = get_stats(bp_times);
+      print_result(config.name + "/fp", fp_stats);
+      print_result(config.name + "/bp", bp_stats);
+      if (json.is_open()) {
+        write_json_entries(json, config.name + "/fp", iterations,
+                           fp_stats, first_entry);
+        write_json_entries(json, config.name + "/bp", iterations,
+                           bp_stats, first_entry);
+      }
+    }
+
+    if (json.is_open()) {
+      json << "\n  ]\n}\n";
+    }
+
+  } catch (exception& e) {
+    El::ReportException(e);
+    return EXIT_FAILURE;
+  } catch (std::exception& e) {
+    El::ReportException(e);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
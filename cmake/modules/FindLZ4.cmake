@@ -0,0 +1,52 @@
+# Defines the following variables:
+#   - LZ4_FOUND
+#   - LZ4_LIBRARIES
+#   - LZ4_INCLUDE_DIRS
+#
+# Also creates an imported target LZ4
+
+# Find the header
+find_path(LZ4_INCLUDE_DIRS lz4.h
+  HINTS ${LZ4_DIR} $ENV{LZ4_DIR}
+  PATH_SUFFIXES include
+  NO_DEFAULT_PATH
+  DOC "Directory with LZ4 header.")
+find_path(LZ4_INCLUDE_DIRS lz4.h)
+
+# Find the library
+find_library(LZ4_LIBRARY lz4
+  HINTS ${LZ4_DIR} $ENV{LZ4_DIR}
+  PATH_SUFFIXES lib64 lib
+  NO_DEFAULT_PATH
+  DOC "The LZ4 library.")
+find_library(LZ4_LIBRARY lz4)
+
+# Standard handling of the package arguments
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(LZ4
+  DEFAULT_MSG
+  LZ4_LIBRARY LZ4_INCLUDE_DIRS)
+
+# Setup the imported target
+if (NOT TARGET LZ4::LZ4)
+  add_library(LZ4::LZ4 INTERFACE IMPORTED)
+endif (NOT TARGET LZ4::LZ4)
+
+# Set the include directories for the target
+set_property(TARGET LZ4::LZ4 APPEND
+  PROPERTY INTERFACE_INCLUDE_DIRECTORIES ${LZ4_INCLUDE_DIRS})
+
+# Set the link libraries for the target
+set_property(TARGET LZ4::LZ4 APPEND
+  PROPERTY INTERFACE_LINK_LIBRARIES ${LZ4_LIBRARY})
+
+#
+# Cleanup
+#
+
+# Set the include directories
+mark_as_advanced(FORCE LZ4_INCLUDE_DIRS)
+
+# Set the libraries
+set(LZ4_LIBRARIES LZ4::LZ4)
+mark_as_advanced(FORCE LZ4_LIBRARY)
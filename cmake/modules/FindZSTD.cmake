@@ -0,0 +1,52 @@
+# Defines the following variables:
+#   - ZSTD_FOUND
+#   - ZSTD_LIBRARIES
+#   - ZSTD_INCLUDE_DIRS
+#
+# Also creates an imported target ZSTD
+
+# Find the header
+find_path(ZSTD_INCLUDE_DIRS zstd.h
+  HINTS ${ZSTD_DIR} $ENV{ZSTD_DIR}
+  PATH_SUFFIXES include
+  NO_DEFAULT_PATH
+  DOC "Directory with ZSTD header.")
+find_path(ZSTD_INCLUDE_DIRS zstd.h)
+
+# Find the library
+find_library(ZSTD_LIBRARY zstd
+  HINTS ${ZSTD_DIR} $ENV{ZSTD_DIR}
+  PATH_SUFFIXES lib64 lib
+  NO_DEFAULT_PATH
+  DOC "The ZSTD library.")
+find_library(ZSTD_LIBRARY zstd)
+
+# Standard handling of the package arguments
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(ZSTD
+  DEFAULT_MSG
+  ZSTD_LIBRARY ZSTD_INCLUDE_DIRS)
+
+# Setup the imported target
+if (NOT TARGET ZSTD::ZSTD)
+  add_library(ZSTD::ZSTD INTERFACE IMPORTED)
+endif (NOT TARGET ZSTD::ZSTD)
+
+# Set the include directories for the target
+set_property(TARGET ZSTD::ZSTD APPEND
+  PROPERTY INTERFACE_INCLUDE_DIRECTORIES ${ZSTD_INCLUDE_DIRS})
+
+# Set the link libraries for the target
+set_property(TARGET ZSTD::ZSTD APPEND
+  PROPERTY INTERFACE_LINK_LIBRARIES ${ZSTD_LIBRARY})
+
+#
+# Cleanup
+#
+
+# Set the include directories
+mark_as_advanced(FORCE ZSTD_INCLUDE_DIRS)
+
+# Set the libraries
+set(ZSTD_LIBRARIES ZSTD::ZSTD)
+mark_as_advanced(FORCE ZSTD_LIBRARY)
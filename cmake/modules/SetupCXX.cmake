@@ -152,6 +152,9 @@ endif ()
 # Check if we can use Linux's sys/sendfile.h
 check_include_file_cxx(sys/sendfile.h LBANN_SYS_SENDFILE_OK)
 
+# Check if we can use Linux's io_uring interface
+check_include_file_cxx(linux/io_uring.h LBANN_HAS_IO_URING)
+
 # Testing for std::any
 include(CheckCXXSourceCompiles)
 set(_ANY_TEST_CODE
@@ -38,6 +38,7 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 /** @brief A utility macro for easily adding default-constructed sub-class
  *  builders.*/
@@ -173,6 +174,12 @@ public:
   /** @brief Return this callback's name. */
   virtual std::string name() const = 0;
 
+  /** @brief Names of layers that the callback refers to.
+   *  @details Model setup passes that remove or rename layers leave
+   *  these layers in place.
+   */
+  virtual std::vector<std::string> get_layer_names() const { return {}; }
+
   ///@}
 
 protected:
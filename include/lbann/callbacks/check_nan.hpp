@@ -30,6 +30,7 @@
 #define LBANN_CALLBACKS_CALLBACK_CHECK_NAN_HPP_INCLUDED
 
 #include "lbann/callbacks/callback.hpp"
+#include <random>
 
 namespace lbann {
 namespace callback {
@@ -37,13 +38,27 @@ namespace callback {
 /**
  * Check matrices for whether they include any NaNs or infs to help debugging.
  * This will kill the rank if such values are discovered.
+ *
+ * By default every entry of every matrix is scanned after every
+ * step. In fast mode, each local matrix is first summed with a
+ * vectorized reduction and only scanned entry by entry if the sum is
+ * not finite, which makes the check cheap enough to leave on. The
+ * check can also be restricted to every batch_interval steps and to
+ * a random subset of layers in each step.
  */
 class check_nan : public callback_base {
  public:
   using callback_base::on_forward_prop_end;
   using callback_base::on_backward_prop_end;
 
-  check_nan() : callback_base() {}
+  /** @param batch_interval  Check every this many steps.
+   *  @param fast            Only scan matrices whose sum is not finite.
+   *  @param layer_fraction  Probability that a layer's activations
+   *                         and error signals are checked in a step.
+   */
+  check_nan(int batch_interval = 1,
+            bool fast = false,
+            double layer_fraction = 1.0);
   check_nan(const check_nan&) = default;
   check_nan& operator=(
     const check_nan&) = default;
@@ -60,11 +75,26 @@ class check_nan : public callback_base {
   void on_batch_end(model *m) override;
   std::string name() const override { return "check_nan"; }
 
+ private:
+  /** Randomly decide whether to check a layer. */
+  bool sample_layer();
+
+  /** Only scan matrices whose sum is not finite. */
+  bool m_fast;
+  /** Probability that a layer is checked in a step. */
+  double m_layer_fraction;
+  /** Random number generator for layer sampling.
+   *  Kept separate from the global generators so that sampling does
+   *  not change the random sequences seen by the model.
+   */
+  std::minstd_rand m_rng;
+
 };
 
 // Builder function
-LBANN_ADD_DEFAULT_CALLBACK_BUILDER(
-  check_nan, build_check_nan_callback_from_pbuf)
+std::unique_ptr<callback_base>
+build_check_nan_callback_from_pbuf(
+  const google::protobuf::Message&, std::shared_ptr<lbann_summary> const&);
 
 } // namespace callback
 } // namespace lbann
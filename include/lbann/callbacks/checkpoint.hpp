@@ -31,6 +31,10 @@
 #include "lbann/callbacks/callback.hpp"
 #include "lbann/io/persist.hpp"
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace lbann {
 namespace callback {
 
@@ -51,6 +55,16 @@ class checkpoint : public callback_base {
    *  @param per_rank_dir The directory into which to dump distributed checkpoints
    *  @param ckpt_dist_epochs The frequency of distributed checkpoints in epochs
    *  @param ckpt_dist_steps The frequence of distributed checkpoints in steps
+   *  @param full_checkpoint_interval If greater than one, only every
+   *         Nth checkpoint of each kind is full. The checkpoints in
+   *         between are incremental: they only contain matrices
+   *         (weights and optimizer state) whose content changed since
+   *         the last full checkpoint, and restart reads the others
+   *         from that full checkpoint.
+   *  @param compression Compression of checkpoint data: "none",
+   *         "lz4", or "zstd", optionally followed by ":level" (see
+   *         parse_compression). Restart detects compressed data
+   *         regardless of this setting.
    */
   checkpoint(std::string checkpoint_dir,
              int checkpoint_epochs,
@@ -58,7 +72,9 @@ class checkpoint : public callback_base {
              int checkpoint_secs,
              std::string per_rank_dir,
              int ckpt_dist_epochs,
-             int ckpt_dist_steps) :
+             int ckpt_dist_steps,
+             int full_checkpoint_interval = 0,
+             std::string compression = "") :
     callback_base(),
     m_checkpoint_dir(checkpoint_dir),
     m_checkpoint_epochs(checkpoint_epochs),
@@ -66,7 +82,9 @@ class checkpoint : public callback_base {
     m_checkpoint_secs(checkpoint_secs),
     m_per_rank_dir(per_rank_dir),
     m_ckpt_dist_epochs(ckpt_dist_epochs),
-    m_ckpt_dist_steps(ckpt_dist_steps) {}
+    m_ckpt_dist_steps(ckpt_dist_steps),
+    m_full_checkpoint_interval(full_checkpoint_interval),
+    m_compression(compression) {}
   checkpoint(const checkpoint&) = default;
   checkpoint& operator=(const checkpoint&) = default;
   checkpoint* copy() const override { return new checkpoint(*this); }
@@ -103,12 +121,41 @@ class checkpoint : public callback_base {
     m_ckpt_dist_steps = ckpt_dist_steps;
   }
 
+  inline void set_full_checkpoint_interval(int interval){
+    m_full_checkpoint_interval = interval;
+  }
+
+  inline void set_compression(std::string compression){
+    m_compression = compression;
+  }
+
   bool need_checkpoint(model *m);
   bool restart(model *m);
   std::string name() const override { return "checkpoint"; }
  protected:
   bool do_checkpoint(model *m);
  private:
+  /** Incremental checkpoint state for shared or distributed checkpoints. */
+  struct incremental_state {
+    /** Last full checkpoint (empty if there is none). */
+    std::string base_dir;
+    /** Content hashes of matrices in the last full checkpoint. */
+    std::unordered_map<std::string, uint64_t> hashes;
+    /** Incremental checkpoints since the last full checkpoint. */
+    int count = 0;
+  };
+  /** Set up persist for a full or incremental checkpoint.
+   *  Returns true if the checkpoint is full.
+   */
+  bool begin_incremental(incremental_state& state);
+  /** Gather the tensor index of a distributed checkpoint and write
+   *  it on the trainer master. */
+  void write_index(model *m, const std::string& filename);
+  /** Read the tensor index of a distributed checkpoint on the
+   *  trainer master. Returns the number of ranks that wrote the
+   *  checkpoint, or 0 if there is no index. */
+  int read_index(const std::string& filename, std::vector<char>& index);
+
   std::string m_checkpoint_dir;
   int m_checkpoint_epochs;
   int m_checkpoint_steps;
@@ -116,6 +163,10 @@ class checkpoint : public callback_base {
   std::string m_per_rank_dir;
   int m_ckpt_dist_epochs;
   int m_ckpt_dist_steps;
+  int m_full_checkpoint_interval;
+  std::string m_compression;
+  incremental_state m_shared_incremental;
+  incremental_state m_dist_incremental;
   EvalType m_checkpoint_last;
   persist p;
   bool m_checkpoint_dist;
@@ -158,17 +209,33 @@ static inline std::string get_last_distributed_checkpoint_filename(model *m, std
   return ss.str();
 }
 
-static inline std::string get_distributed_checkpoint_dirname(model *m, std::string dir, int epoch, int step) {
+static inline std::string get_distributed_checkpoint_dirname(model *m, std::string dir, int epoch, int step, int rank) {
   lbann_comm *comm = m->get_comm();
   std::stringstream ss;
   ss << dir << "/" << m->get_name().c_str();
   ss << "." << comm->get_trainer_rank();
-  ss << ".rank." << comm->get_rank_in_trainer();
+  ss << ".rank." << rank;
   ss << ".epoch." << epoch;
   ss << ".step."<< step << "/";
   return ss.str();
 }
 
+static inline std::string get_distributed_checkpoint_dirname(model *m, std::string dir, int epoch, int step) {
+  return get_distributed_checkpoint_dirname(m, dir, epoch, step,
+                                            m->get_comm()->get_rank_in_trainer());
+}
+
+// Global tensor index of a distributed checkpoint, used to restart on a different number of ranks
+static inline std::string get_distributed_checkpoint_index_filename(model *m, std::string dir, int epoch, int step) {
+  lbann_comm *comm = m->get_comm();
+  std::stringstream ss;
+  ss << dir << "/" << m->get_name().c_str();
+  ss << "." << comm->get_trainer_rank();
+  ss << ".epoch." << epoch;
+  ss << ".step."<< step << ".index";
+  return ss.str();
+}
+
 // Print last checkpoint to file, used to determine which checkpoint to load from.
 static inline bool write_latest(std::string filename, int epoch, int train) {
   // open the file for writing
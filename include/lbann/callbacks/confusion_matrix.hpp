@@ -50,6 +50,9 @@ public:
     return new confusion_matrix(*this);
   }
   std::string name() const override { return "confusion matrix"; }
+  std::vector<std::string> get_layer_names() const override {
+    return {m_prediction_layer, m_label_layer};
+  }
 
   void setup(model *m) override;
 
@@ -32,6 +32,7 @@
 #include <utility>
 
 #include "lbann/callbacks/callback.hpp"
+#include "lbann/utils/tensor_dump.hpp"
 
 namespace lbann {
 namespace callback {
@@ -44,6 +45,9 @@ namespace callback {
  * checkpointing, but for exporting gradient matrices for analysis
  * that isn't easily done in LBANN.  Note this dumps matrices during
  * each mini-batch. This will be slow and produce a lot of output.
+ * The npy_blocks and raw_blocks formats are much cheaper: each
+ * process writes its local block in binary, optionally in a
+ * background thread (see tensor_dump_writer).
  */
 class dump_gradients : public callback_base {
  public:
@@ -52,9 +56,13 @@ class dump_gradients : public callback_base {
   /**
    * @param basename The basename for writing files.
    * @param batch_interval The frequency at which to dump the gradients
+   * @param format File format: ascii, npy_blocks, or raw_blocks.
+   * @param background Write binary files in a background thread.
    */
-  dump_gradients(std::string basename, int batch_interval = 1) :
-    callback_base(batch_interval), m_basename(std::move(basename)) {}
+  dump_gradients(std::string basename,
+                 int batch_interval = 1,
+                 std::string format = "ascii",
+                 bool background = false);
   dump_gradients(
     const dump_gradients&) = default;
   dump_gradients& operator=(
@@ -67,6 +75,10 @@ class dump_gradients : public callback_base {
  private:
   /** @brief Basename for writing files. */
   std::string m_basename;
+  /** @brief File format. */
+  std::string m_format;
+  /** @brief Writer for binary formats. */
+  tensor_dump_writer m_writer;
 };
 
 // Builder function
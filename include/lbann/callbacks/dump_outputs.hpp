@@ -28,6 +28,7 @@
 #define LBANN_CALLBACKS_CALLBACK_DUMP_OUTPUTS_HPP_INCLUDED
 
 #include "lbann/callbacks/callback.hpp"
+#include "lbann/utils/tensor_dump.hpp"
 
 #include <set>
 #include <string>
@@ -50,6 +51,13 @@ namespace callback {
  *  we use internally).
  *
  *  CNPY is required to export to NumPy file formats (npy and npz).
+ *
+ *  The formats above gather each output tensor to one process. With
+ *  the npy_blocks and raw_blocks formats, each process instead writes
+ *  its local block in binary, optionally in a background thread, and
+ *  the output file name above, without extension, is the prefix for the block
+ *  files and JSON sidecar (see tensor_dump_writer). These formats do
+ *  not require CNPY.
  */
 class dump_outputs : public callback_base {
 public:
@@ -65,19 +73,25 @@ public:
    *  @param directory      Directory for output files (default: current
    *                        working directory).
    *  @param file_format    Output file format. Options are csv, tsv,
-   *                        npy, npz (default: csv).
+   *                        npy, npz, npy_blocks, raw_blocks (default:
+   *                        csv).
+   *  @param background     Write block files in a background thread.
    */
   dump_outputs(
     std::set<std::string> layer_names,// = std::set<std::string>(),
     std::set<execution_mode> modes, // = std::set<std::string>(),
     El::Int batch_interval = 0,
     std::string directory = "",
-    std::string file_format = "");
+    std::string file_format = "",
+    bool background = false);
 
   dump_outputs* copy() const override {
     return new dump_outputs(*this);
   }
   std::string name() const override { return "dump outputs"; }
+  std::vector<std::string> get_layer_names() const override {
+    return {m_layer_names.begin(), m_layer_names.end()};
+  }
 
   void on_forward_prop_end(model* m, Layer* l) override {
     do_dump_outputs(*m, *l);
@@ -108,6 +122,9 @@ private:
   /** @brief Output file format. */
   std::string m_file_format;
 
+  /** @brief Writer for npy_blocks and raw_blocks formats. */
+  tensor_dump_writer m_writer;
+
   /** @brief   Dump outputs to file.
    *  @details Returns immediately if an output dump is not needed.
    */
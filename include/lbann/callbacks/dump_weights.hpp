@@ -32,6 +32,7 @@
 #include <utility>
 
 #include "lbann/callbacks/callback.hpp"
+#include "lbann/utils/tensor_dump.hpp"
 
 namespace lbann {
 namespace callback {
@@ -42,14 +43,21 @@ namespace callback {
  * The matrices are written to files using Elemental's simple ASCII format. This
  * is not meant for checkpointing, but for exporting weight matrices for
  * analysis that isn't easily done in LBANN.
+ *
+ * With the npy_blocks and raw_blocks formats, each process instead
+ * writes its local block in binary, optionally in a background
+ * thread (see tensor_dump_writer).
  */
 class dump_weights : public callback_base {
  public:
   /**
    * @param basename The basename for writing files.
+   * @param format File format: ascii, npy_blocks, or raw_blocks.
+   * @param background Write binary files in a background thread.
    */
-  dump_weights(std::string basename) :
-    callback_base(), m_basename(std::move(basename)) {}
+  dump_weights(std::string basename,
+               std::string format = "ascii",
+               bool background = false);
   dump_weights(const dump_weights&) = default;
   dump_weights& operator=(
     const dump_weights&) = default;
@@ -62,6 +70,10 @@ class dump_weights : public callback_base {
  private:
   /** Basename for writing files. */
   std::string m_basename;
+  /** File format. */
+  std::string m_format;
+  /** Writer for binary formats. */
+  tensor_dump_writer m_writer;
   /// Dump weights from learning layers.
   void do_dump_weights(model *m, std::string s = "");
 };
@@ -67,6 +67,9 @@ public:
 
   mixup* copy() const override { return new mixup(*this); }
   std::string name() const override { return "mixup"; }
+  std::vector<std::string> get_layer_names() const override {
+    return {m_layers.begin(), m_layers.end()};
+  }
 
   void on_forward_prop_end(model *m, Layer *l) override;
 
@@ -58,7 +58,12 @@ class monitor_io : public callback_base {
   void on_epoch_end(model *m) override;
   void on_test_end(model *m) override;
   std::string name() const override { return "monitor_io"; }
+  std::vector<std::string> get_layer_names() const override {
+    return {m_layers.begin(), m_layers.end()};
+  }
  private:
+  /** Report and reset achieved IOPS and queue depth of async I/O. */
+  void report_async_io(model *m, execution_mode mode);
   /** Indicies of layers to monitor. */
   std::unordered_set<std::string> m_layers;
 };
@@ -52,6 +52,9 @@ public:
                               = std::set<std::string>());
   perturb_dropout* copy() const override { return new perturb_dropout(*this); }
   std::string name() const override { return "perturb dropout"; }
+  std::vector<std::string> get_layer_names() const override {
+    return {m_layer_names.begin(), m_layer_names.end()};
+  }
 
   void setup(model* m) override;
 
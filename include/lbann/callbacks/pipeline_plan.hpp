@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_CALLBACKS_CALLBACK_PIPELINE_PLAN_HPP_INCLUDED
+#define LBANN_CALLBACKS_CALLBACK_PIPELINE_PLAN_HPP_INCLUDED
+
+#include "lbann/callbacks/callback.hpp"
+#include <unordered_map>
+
+namespace lbann {
+namespace callback {
+
+/** Plan a pipeline-parallel decomposition of a model.
+ *  Measures per-layer forward and backward prop times during the
+ *  first training epoch. At the end of the epoch, the layer
+ *  execution order is split into contiguous stages with balanced
+ *  compute and a one-forward-one-backward (1F1B) schedule over
+ *  micro-batches is simulated. The trainer master reports the stage
+ *  boundaries, the per-stage times, and the fraction of time stages
+ *  spend idle in the pipeline bubble. If the model runs with
+ *  pipeline parallelism, the bubble measured as time spent waiting
+ *  for other stages is also reported at the end of each epoch.
+ */
+class pipeline_plan : public callback_base {
+public:
+
+  /** @param num_stages         Number of pipeline stages.
+   *  @param num_micro_batches  Number of micro-batches each
+   *                            mini-batch is split into.
+   */
+  pipeline_plan(El::Int num_stages, El::Int num_micro_batches);
+  pipeline_plan(const pipeline_plan&) = default;
+  pipeline_plan& operator=(const pipeline_plan&) = default;
+  pipeline_plan* copy() const override {
+    return new pipeline_plan(*this);
+  }
+  std::string name() const override { return "pipeline plan"; }
+
+  using callback_base::on_forward_prop_begin;
+  using callback_base::on_forward_prop_end;
+  using callback_base::on_backward_prop_begin;
+  using callback_base::on_backward_prop_end;
+
+  void on_epoch_begin(model *m) override;
+  void on_epoch_end(model *m) override;
+  void on_batch_end(model *m) override;
+  void on_forward_prop_begin(model *m, Layer *l) override;
+  void on_forward_prop_end(model *m, Layer *l) override;
+  void on_backward_prop_begin(model *m, Layer *l) override;
+  void on_backward_prop_end(model *m, Layer *l) override;
+
+private:
+
+  /** Number of pipeline stages. */
+  El::Int m_num_stages;
+  /** Number of micro-batches per mini-batch. */
+  El::Int m_num_micro_batches;
+  /** Whether the pipeline plan has been reported. */
+  bool m_done = false;
+
+  /** Number of training mini-batches that have been timed. */
+  El::Int m_num_batches = 0;
+  /** Start time of the current layer's forward or backward prop. */
+  EvalType m_start_time = EvalType(0);
+  /** Accumulated forward prop time for each layer. */
+  std::unordered_map<const Layer*,EvalType> m_fp_times;
+  /** Accumulated backward prop time for each layer. */
+  std::unordered_map<const Layer*,EvalType> m_bp_times;
+
+  /** Partition layers, simulate pipeline, and report results. */
+  void report_plan(model& m) const;
+  /** Report time spent waiting in the model's pipeline. */
+  void report_bubble(model& m) const;
+
+};
+
+// Builder function
+std::unique_ptr<callback_base>
+build_pipeline_plan_callback_from_pbuf(
+  const google::protobuf::Message&, std::shared_ptr<lbann_summary> const&);
+
+} // namespace callback
+} // namespace lbann
+
+#endif  // LBANN_CALLBACKS_CALLBACK_PIPELINE_PLAN_HPP_INCLUDED
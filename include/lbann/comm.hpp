@@ -31,6 +31,7 @@
 #include <map>
 #include <typeindex>
 #include "base.hpp"
+#include "lbann/utils/step_timing.hpp"
 #ifdef LBANN_HAS_CUDA
 #include <cuda_runtime.h>
 #endif // LBANN_HAS_CUDA
@@ -667,6 +668,7 @@ class lbann_comm {
   template <typename T>
   void allreduce(T *snd, int count, T *rcv, const El::mpi::Comm& c, El::mpi::Op op = El::mpi::SUM) {
     auto const size_c = El::mpi::Size(c);
+    step_timing::scope timing_scope(step_timing::category::comm_wait);
     bytes_sent += count * sizeof(T);
 #ifdef LBANN_HAS_ALUMINUM
 #ifdef LBANN_ALUMINUM_MPI_PASSTHROUGH
@@ -686,6 +688,7 @@ class lbann_comm {
   template <typename T>
   void allreduce(T *data, int count, const El::mpi::Comm& c, El::mpi::Op op = El::mpi::SUM) {
     auto const size_c = El::mpi::Size(c);
+    step_timing::scope timing_scope(step_timing::category::comm_wait);
     bytes_sent += count * sizeof(T);
 #ifdef LBANN_HAS_ALUMINUM
 #ifdef LBANN_ALUMINUM_MPI_PASSTHROUGH
@@ -747,12 +750,14 @@ class lbann_comm {
   /** Wait for a all non-blocking requests to complete. */
   template <typename T>
   void wait_all(std::vector<El::mpi::Request<T>>& req) {
+    step_timing::scope timing_scope(step_timing::category::comm_wait);
     El::mpi::WaitAll(req.size(), req.data());
   }
 
   /** Wait for a non-blocking request to complete. */
   template <typename T>
   void wait(El::mpi::Request<T>& req) {
+    step_timing::scope timing_scope(step_timing::category::comm_wait);
     El::mpi::Wait(req);
   }
 
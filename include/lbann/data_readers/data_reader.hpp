@@ -33,6 +33,7 @@
 #include "lbann/utils/random.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/comm.hpp"
+#include "lbann/io/async_file_reader.hpp"
 #include "lbann/io/file_io.hpp"
 #include "lbann/io/persist.hpp"
 #include "lbann/utils/options.hpp"
@@ -44,6 +45,7 @@
 #include <vector>
 #include <unistd.h>
 #include <unordered_set>
+#include <unordered_map>
 
 
 #define NOT_IMPLEMENTED(n) { \
@@ -127,6 +129,15 @@ class generic_data_reader {
    */
   void set_file_dir(std::string s);
 
+  /**
+   * Read the files of each mini-batch with one batch of asynchronous
+   * reads (see async_file_reader) before fetching samples. Only
+   * affects readers that override get_sample_files.
+   */
+  void set_async_io(bool b) { m_async_io = b; }
+  /// Whether files are read with batched asynchronous reads.
+  bool using_async_io() const { return m_async_io; }
+
   /**
    * Set base directory for your locally cached (e.g, on ssd) data.
    */
@@ -803,6 +814,25 @@ class generic_data_reader {
   /// get_absolute_sample_count() and get_use_percent().
   double get_percent_to_use();
 
+  /**
+   * Files read by fetch_datum/label/response for a sample.
+   * Readers that read whole files (or fixed-size file prefixes) for
+   * each sample can override this to support async I/O. Each file is
+   * appended as a path and the number of bytes to read (zero for the
+   * whole file).
+   */
+  virtual void get_sample_files(
+    int data_id, std::vector<std::pair<std::string, size_t>>& files) const {}
+
+  /**
+   * Contents of a sample's file that was read with async I/O.
+   * Returns a null pointer if the file was not read in advance, in
+   * which case the reader should read it itself.
+   * @param data_id The index of the datum.
+   * @param file The file's position in the list from get_sample_files.
+   */
+  std::vector<char>* get_async_file(int data_id, size_t file);
+
   /**
    * Called before fetch_datum/label/response to allow initialization.
    */
@@ -907,6 +937,15 @@ class generic_data_reader {
 
   std::shared_ptr<thread_pool> m_io_thread_pool;
 
+  /// Read each mini-batch's files with batched asynchronous reads.
+  bool m_async_io = false;
+  /// Read requests for the current mini-batch (reused to keep buffers).
+  std::vector<async_file_reader::request> m_async_requests;
+  /// First request and number of requests for each sample.
+  std::unordered_map<int, std::pair<size_t, size_t>> m_async_sample_files;
+  /// Read the files of the current mini-batch with async I/O.
+  void read_async_files(int mb_size);
+
   /// special handling for 1B jag; each reader
   /// owns a unique subset of the data
   bool m_jag_partitioned;
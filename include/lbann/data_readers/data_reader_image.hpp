@@ -30,7 +30,9 @@
 #define IMAGE_DATA_READER_HPP
 
 #include "data_reader.hpp"
+#include "lbann/data_readers/image_shards.hpp"
 #include "lbann/data_store/data_store_conduit.hpp"
+#include <memory>
 
 namespace lbann {
 class image_data_reader : public generic_data_reader {
@@ -52,6 +54,19 @@ class image_data_reader : public generic_data_reader {
    */
   virtual void set_input_params(const int width=0, const int height=0, const int num_ch=0, const int num_labels=0);
 
+  /** Read samples from packed image shards.
+   *  If enabled, the data file is a list of shard files (see
+   *  @c image_shards) instead of a list of image files and labels.
+   *  @param use_mmap Read from memory-mapped shards instead of with
+   *                  @c pread.
+   */
+  void set_use_image_shards(bool use_shards, bool use_mmap = false) {
+    m_use_image_shards = use_shards;
+    m_image_shards_mmap = use_mmap;
+  }
+  /** Whether samples are read from packed image shards. */
+  bool using_image_shards() const { return m_use_image_shards; }
+
   // dataset specific functions
   void load() override;
 
@@ -114,6 +129,21 @@ class image_data_reader : public generic_data_reader {
   int m_image_linearized_size; ///< linearized image size
   int m_num_labels; ///< number of labels
 
+  bool m_use_image_shards = false; ///< read samples from packed shards
+  bool m_image_shards_mmap = false; ///< memory-map packed shards
+  /** Packed image shards (shared by copies of the reader). */
+  std::shared_ptr<const image_shards> m_image_shards;
+
+  void get_sample_files(
+    int data_id,
+    std::vector<std::pair<std::string, size_t>>& files) const override;
+
+  /** Read and decode a sample's image. */
+  void load_image_sample(int data_id, El::Matrix<uint8_t>& image,
+                         std::vector<size_t>& dims);
+  /** Read a sample's encoded image. */
+  void read_encoded_image(int data_id, std::vector<char>& data) const;
+
   void load_conduit_node_from_file(int data_id, conduit::Node &node);
 
 };
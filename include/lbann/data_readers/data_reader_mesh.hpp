@@ -30,6 +30,7 @@
 #define LBANN_DATA_READER_MESH_HPP
 
 #include "data_reader.hpp"
+#include <memory>
 
 namespace lbann {
 
@@ -38,6 +39,26 @@ namespace lbann {
  * Provide the directory containing all the channel subdirectories.
  * This assumes the data is stored as floats in row-major order.
  * The channels to load are currently hardcoded. This only supports regression.
+ *
+ * Alternatively, all samples can be read from a single packed file
+ * (see tools/mesh/pack_mesh.py) given as the data filename. Each
+ * sample is a fixed-size record with all channels followed by the
+ * target, already in the column-major layout used by the model, so a
+ * sample is read with one pread straight into the data matrix instead
+ * of opening one file per channel. The file has the layout
+ * (little-endian):
+ *
+ * @code
+ * char     magic[8];      // "LBANNMSH"
+ * uint32_t version;       // 1
+ * uint32_t byte_order;    // 0x01020304
+ * uint64_t num_samples;
+ * uint32_t num_channels;
+ * uint32_t height;
+ * uint32_t width;
+ * uint32_t reserved;
+ * float    records[num_samples][num_channels+1][width][height];
+ * @endcode
  */
 class mesh_reader : public generic_data_reader {
  public:
@@ -60,6 +81,8 @@ class mesh_reader : public generic_data_reader {
   }
   /// Set whether to do random horizontal and vertical flips.
   void set_random_flips(bool b) { m_random_flips = b; }
+  /// Set whether to read samples from a packed file.
+  void set_use_packed_file(bool b) { m_use_packed_file = b; }
 
   void load() override;
   int get_linearized_data_size() const override {
@@ -77,14 +100,28 @@ class mesh_reader : public generic_data_reader {
   bool fetch_datum(CPUMat& X, int data_id, int mb_idx) override;
   bool fetch_response(CPUMat& Y, int data_id, int mb_idx) override;
 
+  void get_sample_files(
+    int data_id,
+    std::vector<std::pair<std::string, size_t>>& files) const override;
+
   /**
-   * Load filename into mat.
+   * Load a channel (or, if channel is the number of channels, the
+   * target) of datum data_id into mat.
    * This may do datatype conversion if DataType is not float.
    * mat should be of size (m_data_height, m_data_width).
    */
-  void load_file(int data_id, const std::string channel, Mat& mat);
+  void load_file(int data_id, size_t channel, Mat& mat);
   /// Return the full path to the data file for datum data_id's channel.
-  std::string construct_filename(std::string channel, int data_id);
+  std::string construct_filename(std::string channel, int data_id) const;
+  /// Open the packed file and check its header.
+  void load_packed_file();
+  /**
+   * Read count values of datum data_id from the packed file into buf,
+   * starting at offset values into the datum's record.
+   */
+  void read_packed(int data_id, size_t offset, size_t count, DataType* buf);
+  /// Apply the recorded flips of datum data_id to an image.
+  void apply_flips(int data_id, DataType* buf);
 
   /// Flip mat horizontally (i.e. about its vertical axis).
   void horizontal_flip(CPUMat& mat);
@@ -141,6 +178,10 @@ class mesh_reader : public generic_data_reader {
    * transformation applied.
    */
   std::vector<std::pair<bool, bool>> m_flip_choices;
+  /// Whether to read samples from a packed file.
+  bool m_use_packed_file = false;
+  /// File descriptor of the packed file (shared by copies of the reader).
+  std::shared_ptr<const int> m_packed_fd;
 };
 
 }  // namespace lbann
@@ -83,6 +83,9 @@ class data_reader_multihead_siamese : public data_reader_multi_images {
   void set_defaults() override;
   bool fetch_datum(CPUMat& X, int data_id, int mb_idx) override;
   bool fetch_label(CPUMat& Y, int data_id, int mb_idx) override;
+  void get_sample_files(
+    int data_id,
+    std::vector<std::pair<std::string, size_t>>& files) const override;
 
  protected:
   offline_patches_npz m_samples;
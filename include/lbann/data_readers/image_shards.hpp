@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_DATA_READERS_IMAGE_SHARDS_HPP
+#define LBANN_DATA_READERS_IMAGE_SHARDS_HPP
+
+#include "lbann/base.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Packed image shards.
+ *
+ *  Encoded images (e.g. JPEG or PNG files) are concatenated into a
+ *  small number of large shard files so that a data reader does not
+ *  open one file per sample. Each shard file @c name has an index
+ *  file @c name.idx with the following layout (little-endian):
+ *
+ *  @code
+ *  char     magic[8];      // "LBANNSHD"
+ *  uint32_t version;       // 1
+ *  uint32_t byte_order;    // 0x01020304
+ *  uint64_t num_records;
+ *  uint64_t data_size;     // Size of shard file in bytes
+ *  struct {
+ *    uint64_t offset;      // Position of encoded image in shard
+ *    uint64_t length;      // Size of encoded image in bytes
+ *    int64_t  label;
+ *  } records[num_records];
+ *  @endcode
+ *
+ *  A set of shards is described by a text file listing one shard
+ *  file per line. Relative paths are relative to a base directory.
+ *  Samples are numbered consecutively across shards in list order.
+ *  Index files are memory-mapped. Shard files are opened once and
+ *  samples are read with @c pread, or, in mmap mode, copied from a
+ *  read-only mapping of the whole shard.
+ *
+ *  Shards can be created with tools/image_shards/pack_image_shards.py.
+ */
+class image_shards {
+public:
+
+  /** On-disk index header. */
+  struct index_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t num_records;
+    std::uint64_t data_size;
+  };
+  /** On-disk index record. */
+  struct index_record {
+    std::uint64_t offset;
+    std::uint64_t length;
+    std::int64_t label;
+  };
+
+  /** Open shards listed in a shard list file.
+   *  @param list_file  Text file with one shard file per line.
+   *  @param base_dir   Directory for relative shard paths.
+   *  @param use_mmap   Read samples from memory-mapped shards
+   *                    instead of with @c pread.
+   */
+  image_shards(const std::string& list_file,
+               const std::string& base_dir,
+               bool use_mmap = false);
+  ~image_shards();
+  image_shards(const image_shards&) = delete;
+  image_shards& operator=(const image_shards&) = delete;
+
+  /** Number of samples in all shards. */
+  El::Int get_num_samples() const { return m_num_samples; }
+  /** Number of shard files. */
+  El::Int get_num_shards() const { return m_shards.size(); }
+  /** Label of a sample. */
+  int get_label(El::Int sample) const;
+  /** Size in bytes of a sample's encoded image. */
+  El::Int get_size(El::Int sample) const;
+  /** Read a sample's encoded image.
+   *  @c buf must hold @c get_size(sample) bytes. All read functions
+   *  may be called concurrently from I/O threads.
+   */
+  void read(El::Int sample, std::uint8_t* buf) const;
+  /** Read a sample's encoded image into an n x 1 matrix. */
+  void read(El::Int sample, El::Matrix<std::uint8_t>& buf) const;
+  /** Read a sample's encoded image into a vector. */
+  void read(El::Int sample, std::vector<char>& buf) const;
+
+private:
+
+  /** Open shard file and its index. */
+  struct shard {
+    std::string path;
+    int fd = -1;
+    const index_record* records = nullptr;
+    std::uint64_t num_records = 0;
+    std::uint64_t data_size = 0;
+    /** Mapping of index file. */
+    void* index_map = nullptr;
+    size_t index_map_size = 0;
+    /** Mapping of shard file (mmap mode only). */
+    const std::uint8_t* data_map = nullptr;
+  };
+
+  /** Open a shard file and map its index. */
+  void open_shard(shard& s);
+  /** Shard and record of a sample. */
+  const index_record& find(El::Int sample, const shard*& s) const;
+
+  std::vector<shard> m_shards;
+  /** First sample in each shard, plus total number of samples. */
+  std::vector<El::Int> m_offsets;
+  El::Int m_num_samples = 0;
+  bool m_use_mmap;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_DATA_READERS_IMAGE_SHARDS_HPP
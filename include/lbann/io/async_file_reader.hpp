@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_IO_ASYNC_FILE_READER_HPP_INCLUDED
+#define LBANN_IO_ASYNC_FILE_READER_HPP_INCLUDED
+
+#include "lbann_config.hpp"
+#include "lbann/utils/threads/thread_pool.hpp"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Batched asynchronous file reads.
+ *
+ *  Data readers that read one or more files per sample can submit
+ *  the reads for a whole mini-batch at once instead of issuing a
+ *  blocking read from each I/O thread, so the number of reads in
+ *  flight is not limited by the number of I/O threads. Reads are
+ *  issued through io_uring when the kernel supports it. Otherwise a
+ *  dedicated pool of threads issues @c pread calls, with one thread
+ *  per read in flight.
+ *
+ *  Files are opened on the calling thread when their first read is
+ *  submitted, so at most @c queue_depth files are open at once.
+ */
+class async_file_reader {
+public:
+
+  /** A file to read. */
+  struct request {
+    /** Path of the file. */
+    std::string path;
+    /** Number of bytes to read from the start of the file. If zero,
+     *  the whole file is read.
+     */
+    size_t length = 0;
+    /** Contents of the file. Resized to the number of bytes read, so
+     *  reusing a request keeps its allocation.
+     */
+    std::vector<char> data;
+  };
+
+  /** I/O statistics since the last reset. */
+  struct statistics {
+    /** Number of files read. */
+    uint64_t num_files = 0;
+    /** Number of bytes read. */
+    uint64_t num_bytes = 0;
+    /** Wall time (in seconds) spent in read_batch. */
+    double time = 0;
+    /** Sum over files of the time (in seconds) from submitting the
+     *  first read to completing the last read.
+     */
+    double file_time = 0;
+    /** Files read per second. */
+    double iops() const { return time > 0 ? num_files / time : 0; }
+    /** Mean number of reads in flight (by Little's law). */
+    double queue_depth() const { return time > 0 ? file_time / time : 0; }
+  };
+
+  /** @param queue_depth Maximum number of reads in flight. */
+  explicit async_file_reader(int queue_depth = default_queue_depth);
+  ~async_file_reader();
+  async_file_reader(const async_file_reader&) = delete;
+  async_file_reader& operator=(const async_file_reader&) = delete;
+
+  /** Read a batch of files and wait for all reads to finish.
+   *  May be called concurrently, but batches are processed one at a
+   *  time.
+   */
+  void read_batch(std::vector<request>& requests);
+
+  /** Name of the I/O backend ("io_uring" or "threads"). */
+  std::string get_backend() const;
+  /** Maximum number of reads in flight. */
+  int get_queue_depth() const { return m_queue_depth; }
+  /** I/O statistics since the last reset. */
+  statistics get_statistics() const;
+  /** Reset I/O statistics. */
+  void reset_statistics();
+
+  /** Reader shared by all data readers in the process. */
+  static async_file_reader& get_shared();
+
+  static constexpr int default_queue_depth = 64;
+
+private:
+
+  /** io_uring submission and completion rings. */
+  struct uring;
+
+  /** Read files with io_uring. */
+  void read_batch_uring(std::vector<request>& requests,
+                        std::vector<double>& file_times);
+  /** Read files with a pool of threads. */
+  void read_batch_threads(std::vector<request>& requests,
+                          std::vector<double>& file_times);
+
+  int m_queue_depth;
+  /** io_uring rings (null if io_uring is not available). */
+  std::unique_ptr<uring> m_uring;
+  /** Threads for blocking reads (if io_uring is not available). */
+  std::unique_ptr<thread_pool> m_threads;
+  /** Serializes batches. */
+  std::mutex m_batch_mutex;
+  /** Protects statistics. */
+  mutable std::mutex m_stats_mutex;
+  statistics m_stats;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_IO_ASYNC_FILE_READER_HPP_INCLUDED
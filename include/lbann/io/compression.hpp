@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_IO_COMPRESSION_HPP_INCLUDED
+#define LBANN_IO_COMPRESSION_HPP_INCLUDED
+
+#include "lbann_config.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/** Compression codecs for checkpoint data. */
+enum class compression_codec { none, lz4, zstd };
+
+/** Human-readable name of a compression codec. */
+std::string to_string(compression_codec codec);
+
+/** Whether LBANN was built with a compression codec. */
+bool compression_available(compression_codec codec);
+
+/** @brief Settings for compressing a buffer. */
+struct compression_settings {
+  compression_codec codec = compression_codec::none;
+  /** Codec level. For Zstandard, the compression level (0 selects
+   *  the library default). For LZ4, the acceleration factor.
+   */
+  int level = 0;
+  /** Size of the values in the buffer. Bytes are shuffled so that
+   *  the i-th bytes of all values are adjacent, which makes
+   *  floating-point data much more compressible. 1 disables the
+   *  shuffle.
+   */
+  size_t element_size = 1;
+  /** Size of independently compressed chunks. */
+  size_t chunk_size = 1 << 20;
+};
+
+/** Parse a compression setting of the form "codec" or
+ *  "codec:level", where codec is none, lz4, or zstd.
+ */
+compression_settings parse_compression(const std::string& str);
+
+/** @brief Header of a compressed frame.
+ *
+ *  A frame consists of this header, the stored size of each chunk
+ *  (uint64_t[num_chunks]), and the stored chunks. Each chunk is byte
+ *  shuffled and compressed. If compression does not make a chunk
+ *  smaller, it is stored shuffled but uncompressed. The settings are
+ *  recorded so that a frame can be decompressed without knowing how
+ *  it was written.
+ */
+struct compression_frame_header {
+  char magic[8];               // "LBANNCMP"
+  std::uint32_t version;
+  std::uint32_t codec;
+  std::int32_t level;
+  std::uint32_t element_size;
+  std::uint64_t chunk_size;
+  std::uint64_t size;          // Uncompressed size in bytes
+  std::uint64_t num_chunks;
+
+  /** Whether the header has the frame magic and a known version. */
+  bool valid() const;
+  /** Size of the chunk table and chunks. */
+  std::uint64_t payload_size(const std::uint64_t* chunk_sizes) const;
+};
+
+/** @brief Compress a buffer into a frame.
+ *
+ *  Chunks are compressed in parallel with OpenMP.
+ *
+ *  @param data      Buffer to compress.
+ *  @param size      Size of the buffer in bytes.
+ *  @param settings  Compression settings.
+ *  @param frame     Output frame. Resized to the frame size.
+ */
+void compress(const void* data,
+              size_t size,
+              const compression_settings& settings,
+              std::vector<char>& frame);
+
+/** @brief Decompress a frame.
+ *
+ *  Chunks are decompressed in parallel with OpenMP.
+ *
+ *  @param header    Frame header.
+ *  @param payload   Chunk table and chunks that follow the header.
+ *  @param data      Output buffer with room for @c header.size bytes.
+ */
+void decompress(const compression_frame_header& header,
+                const char* payload,
+                void* data);
+
+} // namespace lbann
+
+#endif // LBANN_IO_COMPRESSION_HPP_INCLUDED
@@ -30,7 +30,11 @@
 #define LBANN_PERSIST_H
 
 #include "lbann/base.hpp"
+#include "lbann/io/compression.hpp"
 #include "El.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace lbann {
 
@@ -58,8 +62,42 @@ class persist {
   char m_train_filename[1024];
   char m_validate_filename[1024];
   callback_type ckpt_type;
+  /** Content hashes of matrices in the base checkpoint (incremental
+   *  checkpoints only). */
+  std::unordered_map<std::string, uint64_t>* m_base_hashes;
+  /** Bytes of unchanged matrices that were not written. */
+  uint64_t m_skipped_bytes;
+  /** Compression of matrices and large buffers. */
+  compression_settings m_compression;
+  /** Bytes passed to the compressor. */
+  uint64_t m_compression_raw_bytes;
+  /** Bytes produced by the compressor. */
+  uint64_t m_compressed_bytes;
+  /** Time spent compressing (in seconds). */
+  double m_compression_time;
+
+  /** Block of a distributed matrix in a per-rank file. */
+  struct tensor_block {
+    El::Int height, width;
+    El::Int col_shift, col_stride, row_shift, row_stride;
+    El::Int local_height, local_width;
+    /** Position of the block's data in its file. */
+    uint64_t offset;
+    std::string file;
+  };
+  /** Index entries for matrices written since open_checkpoint. */
+  std::string m_index;
+  /** Blocks of each matrix (elastic restart only). */
+  std::unordered_map<std::string, std::vector<tensor_block>> m_index_blocks;
+  bool m_elastic_restart;
+  /** Checkpoint directory of this rank's random number generators
+   *  (elastic restart only). Empty if the checkpoint was written by
+   *  fewer ranks. */
+  std::string m_rank_checkpoint_dir;
  public:
   char m_checkpoint_dir[1024];
+  /** Base checkpoint of an incremental checkpoint (empty if none). */
+  char m_base_checkpoint_dir[1024];
 
  public:
   persist();
@@ -85,6 +123,92 @@ class persist {
 
   void reset_bytes() {
     m_bytes = 0;
+    m_skipped_bytes = 0;
+    m_compression_raw_bytes = 0;
+    m_compressed_bytes = 0;
+    m_compression_time = 0;
+  }
+
+  uint64_t get_skipped_bytes() const {
+    return m_skipped_bytes;
+  }
+
+  /** @brief Write an incremental checkpoint.
+   *
+   *  Matrices are hashed as they are written. If @c base_dir is
+   *  empty, every matrix is written and its hash is recorded in
+   *  @c hashes, so the checkpoint can serve as a base. Otherwise,
+   *  matrices whose hash matches the one recorded for the base are
+   *  not written, and the next call to @c open_checkpoint records
+   *  @c base_dir in the new checkpoint. On restart, matrices that are
+   *  missing from a checkpoint are read from its base.
+   */
+  void set_incremental(const std::string& base_dir,
+                       std::unordered_map<std::string, uint64_t>& hashes);
+  /** Write every matrix without hashing. */
+  void clear_incremental();
+
+  /** @brief Compress checkpoint data.
+   *
+   *  Matrices, and buffers of at least @c min_compressed_size bytes,
+   *  are written as compressed frames (see compression.hpp). Each
+   *  process compresses its own data, on multiple threads. Frames
+   *  record their codec and level, so restart detects and
+   *  decompresses them regardless of this setting.
+   */
+  void set_compression(const compression_settings& settings);
+  const compression_settings& get_compression() const {
+    return m_compression;
+  }
+  uint64_t get_compression_raw_bytes() const {
+    return m_compression_raw_bytes;
+  }
+  uint64_t get_compressed_bytes() const {
+    return m_compressed_bytes;
+  }
+  double get_compression_time() const {
+    return m_compression_time;
+  }
+  /** Smallest buffer that is compressed by write_bytes. */
+  static constexpr size_t min_compressed_size = 1 << 16;
+
+  /** @brief Tensor index entries of a distributed checkpoint.
+   *
+   *  write_rank_distmat records one line per matrix block written by
+   *  this process (or left in the base of an incremental checkpoint):
+   *
+   *  @code
+   *  block <key> <height> <width> <col_shift> <col_stride> <row_shift>
+   *        <row_stride> <local_height> <local_width> <offset> <file>
+   *  @endcode
+   *
+   *  The entries of all processes, concatenated, form a global index
+   *  that does not depend on the process layout.
+   */
+  const std::string& get_index() const { return m_index; }
+
+  /** @brief Restart a distributed checkpoint on a different layout.
+   *
+   *  read_rank_distmat finds the blocks that overlap the local part
+   *  of a matrix in @c index (see get_index) and reads the columns it
+   *  needs from each block file directly.
+   */
+  void set_elastic_restart(const std::string& index);
+  void clear_elastic_restart();
+  bool is_elastic_restart() const { return m_elastic_restart; }
+
+  /** @brief Directory with rank-specific state.
+   *
+   *  On an elastic restart, matrices and scalars are read through
+   *  the index and from rank 0's directory, but each rank that
+   *  wrote the checkpoint still has its own random number generator
+   *  state. Otherwise, this is the checkpoint directory.
+   */
+  void set_rank_checkpoint_dir(const std::string& dir) {
+    m_rank_checkpoint_dir = dir;
+  }
+  std::string get_rank_checkpoint_dir() const {
+    return m_elastic_restart ? m_rank_checkpoint_dir : m_checkpoint_dir;
   }
 
   bool write_rank_distmat(persist_type type, const char *name, const AbsDistMat& M);
@@ -119,6 +243,29 @@ class persist {
 
  private:
   int get_fd(persist_type type) const;
+  /** Path of a matrix file in the checkpoint directory. */
+  std::string get_filename(persist_type type, const char *name) const;
+  /** Path of a matrix file to restart from: the checkpoint directory,
+   *  or the base checkpoint if the matrix was not written. */
+  std::string get_restart_filename(persist_type type, const char *name) const;
+  /** Whether a matrix must be written to an incremental checkpoint.
+   *  Records the hash if the checkpoint is a base. With @c shared,
+   *  the decision is agreed upon by all processes in the matrix's
+   *  grid. */
+  bool need_write(persist_type type, const char *name,
+                  const AbsDistMat& M, bool shared);
+  /** Compress a buffer and write it at the current position. */
+  void write_frame(int fd, const std::string& filename,
+                   const void *buf, size_t size);
+  /** Read and decompress a buffer if a compressed frame is at the
+   *  current position. Otherwise, return false without reading. */
+  bool read_frame(int fd, const std::string& filename,
+                  void *buf, size_t size);
+  /** Record a matrix block in the tensor index. */
+  void add_index_block(persist_type type, const char *name,
+                       const AbsDistMat& M, const std::string& filename);
+  /** Read the local part of a matrix from indexed blocks. */
+  bool read_elastic_distmat(persist_type type, const char *name, AbsDistMat& M);
 };
 
 bool write_distmat(int fd, const char *name, DistMat *M, uint64_t *bytes);
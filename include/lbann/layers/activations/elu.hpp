@@ -55,6 +55,9 @@ public:
   std::string get_type() const override { return "ELU"; }
   data_layout get_data_layout() const override { return Layout; }
   El::Device get_device_allocation() const override { return Device; }
+  bool supports_in_place_backprop() const override { return true; }
+  bool supports_in_place_forward_prop() const override { return true; }
+  bool supports_reduced_precision_storage() const override { return true; }
 
   description get_description() const override {
     auto desc = Layer::get_description();
@@ -44,6 +44,8 @@ public:
   std::string get_type() const override { return "identity"; }
   data_layout get_data_layout() const override { return Layout; }
   El::Device get_device_allocation() const override { return Device; }
+  bool supports_output_views() const override { return false; }
+  bool supports_error_signal_views() const override { return false; }
 protected:
   void setup_dims() override {
     Layer::setup_dims();
@@ -29,6 +29,7 @@
 
 #include "lbann/layers/layer.hpp"
 #include "lbann/utils/cudnn.hpp"
+#include <vector>
 
 namespace lbann {
 
@@ -110,6 +111,8 @@ private:
 
   /** Workspace for column-wise reductions. */
   std::unique_ptr<AbsDistMat> m_workspace;
+  /** Column-wise shifts for CPU forward prop. */
+  std::vector<DataType> m_shifts;
 
 #ifdef LBANN_HAS_CUDNN
   /** Tensor cuDNN descriptors. */
@@ -29,6 +29,7 @@
 
 #include "lbann/layers/layer.hpp"
 #include "lbann/utils/cudnn.hpp"
+#include <vector>
 
 // Threshold outputs to a minimum value.
 // If enabled, the minimum output value is sqrt(min), where min is the
@@ -117,6 +118,8 @@ private:
 
   /** Workspace for column-wise reductions. */
   std::unique_ptr<AbsDistMat> m_workspace;
+  /** Column-wise shifts for CPU forward prop. */
+  std::vector<DataType> m_shifts;
 
 #ifdef LBANN_HAS_CUDNN
   /** Tensor cuDNN descriptors. */
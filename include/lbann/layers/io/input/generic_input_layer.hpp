@@ -34,6 +34,7 @@
 #include "lbann/models/model.hpp"
 #include "lbann/callbacks/imcomm.hpp"
 #include "lbann/utils/omp_diagnostics.hpp"
+#include "lbann/utils/step_timing.hpp"
 
 #include <future>
 
@@ -201,6 +202,15 @@ class generic_input_layer : public io_layer {
    */
   void fp_setup_outputs(El::Int mini_batch_size) override {
 
+    // Samples provided externally determine the mini-batch size
+    if (m_external_samples != nullptr) {
+      mini_batch_size = m_external_samples->Width();
+      this->m_model->set_current_mini_batch_size(mini_batch_size);
+      this->m_model->set_effective_mini_batch_size(mini_batch_size);
+      io_layer::fp_setup_outputs(mini_batch_size);
+      return;
+    }
+
     // Determine model mini-batch size and effective mini-batch size
     // Note: If inter-model communication is activated, the effective
     // mini-batch is equal to the global mini-batch size.
@@ -248,6 +258,10 @@ class generic_input_layer : public io_layer {
   }
 
   void fp_compute() override {
+    if (m_external_samples != nullptr) {
+      fp_compute_external_samples();
+      return;
+    }
     execution_mode mode = this->m_model->get_execution_mode();
 
     increment_active_buffer_idx(mode);
@@ -265,6 +279,7 @@ class generic_input_layer : public io_layer {
 
     // Wait for the background thread to complete fetching the data
     if(io_buffer->is_data_fetched_in_background(mode)) {
+      step_timing::scope timing_scope(step_timing::category::data_wait);
       io_buffer->get_data_fetch_future(mode).get();
       io_buffer->set_fetch_data_in_background(false, mode);
     }
@@ -307,6 +322,45 @@ class generic_input_layer : public io_layer {
     }
   }
 
+  /** Provide samples directly instead of fetching from data readers.
+   *  Each column of @c samples is a flattened sample and the matrix
+   *  must be identical on every process in the trainer. Any target
+   *  output is filled with zeros. The matrix is not copied, so it
+   *  must persist until forward prop is finished. Pass a null pointer
+   *  to resume fetching from data readers.
+   */
+  void set_external_samples(const CPUMat* samples) {
+    m_external_samples = samples;
+  }
+
+  /** Copy external samples into the output tensors. */
+  void fp_compute_external_samples() {
+    const auto& samples = *m_external_samples;
+    auto& output = get_activations(0);
+    if (samples.Height() != output.Height()) {
+      std::stringstream err;
+      err << "input layer \"" << get_name() << "\" "
+          << "expects samples of size " << output.Height() << ", "
+          << "but got samples of size " << samples.Height();
+      LBANN_ERROR(err.str());
+    }
+    const El::Int local_height = output.LocalHeight();
+    const El::Int local_width = output.LocalWidth();
+    CPUMat local_samples(local_height, local_width);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < local_width; ++col) {
+      const auto& global_col = output.GlobalCol(col);
+      for (El::Int row = 0; row < local_height; ++row) {
+        const auto& global_row = output.GlobalRow(row);
+        local_samples(row, col) = samples(global_row, global_col);
+      }
+    }
+    El::Copy(local_samples, output.Matrix());
+    for (int i = 1; i < get_num_children(); ++i) {
+      El::Zero(get_activations(i));
+    }
+  }
+
   void setup_next_io_buffer(generic_io_buffer* io_buffer) {
     int mini_batch_size = get_current_mini_batch_size();
     for (int i = 0; i < get_num_children(); ++i) {
@@ -906,6 +960,8 @@ class generic_input_layer : public io_layer {
  //  std::map<execution_mode, dataset_stats> m_dataset_stats;
   bool m_data_set_processed;
   std::mutex dr_mutex;
+  /** Samples provided instead of data reader samples (not owned). */
+  const CPUMat* m_external_samples = nullptr;
 };
 
 template<typename T> inline void generic_input_layer::initialize_io_buffer(lbann_comm *comm, int num_parallel_readers, std::map<execution_mode, generic_data_reader *> data_readers) {
@@ -57,6 +57,11 @@ class io_layer : public Layer {
       m_data_reader_mode(data_reader_mode) {
   }
 
+  /** Forward prop fetches data from the data reader. */
+  bool supports_recomputation() const override { return false; }
+  /** Data readers fill output tensors as contiguous buffers. */
+  bool supports_output_views() const override { return false; }
+
   /**
    * Return the dataset for the given execution mode.
    */
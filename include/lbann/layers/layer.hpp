@@ -35,7 +35,9 @@
 #include "lbann/utils/timer.hpp"
 #include "lbann/utils/description.hpp"
 #include "lbann/io/persist.hpp"
+#include "lbann/utils/reduced_precision.hpp"
 #include <string>
+#include <utility>
 #include <vector>
 
 // Forward-declare protobuf classes
@@ -159,6 +161,12 @@ public:
 
   /** Reset layer stat counters. */
   virtual void reset_counters();
+  /** Time spent in the forward propagation computation since the
+   *  counters were last reset. */
+  EvalType get_fp_compute_time() const { return m_fp_compute_time; }
+  /** Time spent in the backward propagation computation since the
+   *  counters were last reset. */
+  EvalType get_bp_compute_time() const { return m_bp_compute_time; }
 
   /** Whether the layer is using a GPU implementation. */
   inline bool using_gpus() const {
@@ -325,6 +333,204 @@ public:
   void unfreeze();
   bool is_frozen() const;
 
+  // ===========================================================
+  // Activation recomputation functions
+  // ===========================================================
+
+  /** Whether forward prop can be repeated to regenerate outputs.
+   *  Layers whose forward prop is stochastic (e.g. dropout), updates
+   *  persistent state (e.g. batch normalization statistics), or
+   *  interacts with data readers or the objective function must
+   *  override this to return false.
+   */
+  virtual bool supports_recomputation() const { return true; }
+  /** Whether error signals can overwrite previous error signals.
+   *  Used for memory planning. True for entry-wise layers, where each
+   *  entry of the previous error signal is only read to compute the
+   *  corresponding entry of the error signal.
+   */
+  virtual bool supports_in_place_backprop() const { return false; }
+  /** Whether outputs can overwrite inputs.
+   *  Used in frozen models. True for entry-wise layers, where each
+   *  input entry is only read to compute the corresponding output
+   *  entry.
+   */
+  virtual bool supports_in_place_forward_prop() const { return false; }
+  /** Mark layer as an activation checkpoint.
+   *  When the model recomputes activations during backprop, the
+   *  outputs of checkpoint layers are kept alive after forward prop.
+   */
+  void set_activation_checkpoint(bool checkpoint) {
+    m_activation_checkpoint = checkpoint;
+  }
+  /** Whether layer is an activation checkpoint. */
+  bool is_activation_checkpoint() const { return m_activation_checkpoint; }
+  /** Release memory for input and output tensors.
+   *  Views into other layers' tensors are detached. The tensors are
+   *  reconstructed during the next forward prop.
+   */
+  void free_activations();
+
+  // ===========================================================
+  // Inference functions
+  // ===========================================================
+
+  /** Whether outputs are independent of inputs and of the data.
+   *  Used to reuse outputs between forward prop steps in frozen
+   *  models.
+   */
+  virtual bool has_constant_outputs() const { return false; }
+  /** Fold a per-channel affine transform into the layer's weights.
+   *  Afterwards, each output entry in channel c (the first output
+   *  dimension) is scale(c)*y+shift(c), where y is the original
+   *  output. Returns false if the layer does not support this.
+   */
+  virtual bool fold_channelwise_affine(const CPUMat& scale,
+                                       const CPUMat& shift) {
+    return false;
+  }
+  /** Fold layer into its parent layer's weights.
+   *  Only valid for inference once the weights are final. If
+   *  successful, the layer's outputs become views into its inputs.
+   *  Returns false if the layer or its parent does not support this.
+   */
+  virtual bool fold_into_parent(Layer& parent) { return false; }
+
+  // ===========================================================
+  // Tensor view functions
+  // ===========================================================
+
+  /** Whether output tensors can be placed in a child's memory.
+   *  True if output tensors are allocated by
+   *  Layer::fp_setup_outputs and kernels respect the leading
+   *  dimension of the local output matrix. Layers whose outputs are
+   *  views (e.g. into their inputs) must override this to return
+   *  false.
+   */
+  virtual bool supports_output_views() const { return true; }
+  /** Whether error signals can be placed in a parent's memory.
+   *  True if error signals are allocated by
+   *  Layer::bp_setup_gradient_wrt_inputs and kernels respect the
+   *  leading dimension of the local error signal matrix.
+   */
+  virtual bool supports_error_signal_views() const { return true; }
+  /** Whether the layer can provide memory for a parent's output.
+   *  E.g. a concatenation layer can let a parent write directly into
+   *  its output tensor if the parent's piece is contiguous.
+   */
+  virtual bool provides_parent_output_view(int parent_index) const {
+    return false;
+  }
+  /** Whether the layer can provide memory for a child's error signal.
+   *  E.g. a slice layer can let a child write directly into its error
+   *  signal if the child's piece is contiguous.
+   */
+  virtual bool provides_child_error_signal_view(int child_index) const {
+    return false;
+  }
+  /** Place an output tensor in memory provided by the child layer.
+   *  Set up by the model when the child layer supports it.
+   */
+  void set_output_view(int child_index, bool view);
+  /** Whether an output tensor is placed in the child layer's memory. */
+  bool is_output_view(int child_index) const;
+  /** Place an error signal in memory provided by the parent layer.
+   *  Set up by the model when the parent layer supports it.
+   */
+  void set_error_signal_view(int parent_index, bool view);
+  /** Whether an error signal is placed in the parent layer's memory. */
+  bool is_error_signal_view(int parent_index) const;
+  /** Compute the output tensor over the parent's output tensor.
+   *  Set up by the model when the layer supports in-place forward
+   *  prop. A separate output tensor is used if the parent's output
+   *  is not writable.
+   */
+  void set_in_place_output(bool in_place) { m_in_place_output = in_place; }
+  /** Whether the output tensor is computed over the parent's output. */
+  bool is_in_place_output() const { return m_in_place_output; }
+  /** Compute the error signal over the child's error signal.
+   *  Set up by the model when the layer supports in-place backprop.
+   *  A separate error signal is used if the child's error signal is
+   *  not writable.
+   */
+  void set_in_place_error_signal(bool in_place) {
+    m_in_place_error_signal = in_place;
+  }
+  /** Whether the error signal is computed over the child's error
+   *  signal. */
+  bool is_in_place_error_signal() const { return m_in_place_error_signal; }
+
+  // ===========================================================
+  // Pipeline functions
+  // ===========================================================
+
+  /** Take an input tensor from a buffer instead of the parent's
+   *  output.
+   *  Set up by the model when the parent runs in a different
+   *  pipeline stage. The buffer must be distributed like the input
+   *  tensor and stay alive until the layer's next forward prop. A
+   *  null pointer restores the parent's output.
+   */
+  void set_remote_input(int parent_index, const AbsDistMat* input);
+  /** Take a gradient w.r.t. an output tensor from a buffer instead
+   *  of the child's error signal.
+   *  Set up by the model when the child runs in a different pipeline
+   *  stage. A null pointer restores the child's error signal.
+   */
+  void set_remote_prev_error_signal(int child_index,
+                                    const AbsDistMat* gradient);
+
+  // ===========================================================
+  // Reduced-precision storage functions
+  // ===========================================================
+
+  /** Whether the input tensor can be kept in reduced precision
+   *  between forward and backward prop.
+   *  True if backprop only reads the input through the local input
+   *  matrix and it is fine for backprop to see rounded input values.
+   */
+  virtual bool supports_reduced_precision_storage() const { return false; }
+  /** Keep the input tensor in reduced precision between forward and
+   *  backward prop during training.
+   *  Set up by the model. The parent's output tensor is released
+   *  after forward prop (see @c release_stored_input) and
+   *  reconstructed at the start of backprop.
+   */
+  void set_input_storage_format(storage_format format) {
+    m_input_storage_format = format;
+  }
+  storage_format get_input_storage_format() const {
+    return m_input_storage_format;
+  }
+  /** Keep the error signal in reduced precision until the parent's
+   *  backprop.
+   *  Set up by the model. The error signal is released after backprop
+   *  (see @c release_stored_error_signal) and reconstructed at the
+   *  start of the parent's backprop.
+   */
+  void set_error_signal_storage_format(storage_format format) {
+    m_error_signal_storage_format = format;
+  }
+  storage_format get_error_signal_storage_format() const {
+    return m_error_signal_storage_format;
+  }
+  /** Release the parent's output tensor if the input is stored in
+   *  reduced precision.
+   *  Called by the model once forward prop callbacks are done with
+   *  the layer.
+   */
+  void release_stored_input();
+  /** Release the error signal if it is stored in reduced precision.
+   *  Called by the model once backprop callbacks are done with the
+   *  layer.
+   */
+  void release_stored_error_signal();
+  /** Reconstruct released tensors from reduced-precision storage.
+   *  Called by the model after backprop in case it stopped before
+   *  reaching the layers that consume them.
+   */
+  void restore_stored_tensors();
+
 protected:
 
   // ===========================================================
@@ -404,6 +610,21 @@ protected:
    *  tensor is resized to match the mini-batch size.
    */
   virtual void bp_setup_gradient_wrt_inputs(El::Int mini_batch_size);
+  /** Setup a parent's output tensor as a view into this layer's memory.
+   *  Called by the parent's 'fp_setup_outputs' function, before this
+   *  layer's forward prop, if 'provides_parent_output_view' is true.
+   */
+  virtual void setup_parent_output_view(const Layer& parent,
+                                        El::Int mini_batch_size,
+                                        AbsDistMat& output);
+  /** Setup a child's error signal as a view into this layer's memory.
+   *  Called by the child's 'bp_setup_gradient_wrt_inputs' function,
+   *  before this layer's backprop, if
+   *  'provides_child_error_signal_view' is true.
+   */
+  virtual void setup_child_error_signal_view(const Layer& child,
+                                             El::Int mini_batch_size,
+                                             AbsDistMat& error_signal);
   /** Compute objective funciton gradients.
    *  Called by the 'back_prop' function. Given the input, output, and
    *  gradient w.r.t. output tensors, the gradient w.r.t. input
@@ -411,6 +632,30 @@ protected:
    *  w.r.t. the weights are sent to the appropriate optimizers.
    */
   virtual void bp_compute();
+  /** Apply layer operation and store the input tensor.
+   *  Called by the 'forward_prop' function instead of 'fp_compute'
+   *  when the input is kept in reduced precision. The default
+   *  converts the local input matrix after 'fp_compute'. Layers that
+   *  sweep through their input entry by entry can fuse the
+   *  conversion into their compute loop.
+   */
+  virtual void fp_compute_and_store_input(
+    storage_format format, reduced_precision_matrix& stored_input);
+  /** Compute objective function gradients with tensors kept in
+   *  reduced precision.
+   *  Called by the 'back_prop' function instead of 'bp_compute' if
+   *  the parent's output tensor was released after forward prop or
+   *  if the error signal is stored. If @c stored_input is not null,
+   *  @c local_input is the local input matrix, which is allocated but
+   *  not initialized. If @c stored_error_signal is not null, the
+   *  local error signal is stored in it. The default converts
+   *  tensors before and after 'bp_compute'.
+   */
+  virtual void bp_compute_with_stored_tensors(
+    const reduced_precision_matrix* stored_input,
+    AbsMat* local_input,
+    storage_format error_signal_format,
+    reduced_precision_matrix* stored_error_signal);
 
   // ===========================================================
   // Update step helper functions
@@ -451,6 +696,23 @@ protected:
   /** Avoid back prop if frozen */
   bool m_frozen;
 
+  /** Keep outputs alive when recomputing activations. */
+  bool m_activation_checkpoint = false;
+
+  /** Whether each output tensor is placed in the child's memory. */
+  std::vector<bool> m_output_views;
+  /** Whether each error signal is placed in the parent's memory. */
+  std::vector<bool> m_error_signal_views;
+  /** Whether the output is computed over the parent's output. */
+  bool m_in_place_output = false;
+  /** Whether the error signal is computed over the child's error
+   *  signal. */
+  bool m_in_place_error_signal = false;
+  /** Format of the input tensor between forward and backward prop. */
+  storage_format m_input_storage_format = storage_format::full;
+  /** Format of the error signal until the parent's backprop. */
+  storage_format m_error_signal_storage_format = storage_format::full;
+
   /** Time spent in forward propagation. */
   EvalType m_fp_time;
   /** Time spent in the forward propagation computation. */
@@ -479,6 +741,19 @@ private:
   /** Get error signal tensor corresponding to parent layer. */
   const AbsDistMat& get_error_signals(const Layer& parent) const;
 
+  /** Reconstruct the parent's output tensor after it was released.
+   *  If @c convert is false, the tensor is only allocated.
+   */
+  void restore_stored_input(bool convert);
+  /** Reconstruct the error signal after it was released. */
+  void restore_stored_error_signal();
+  /** Parent output or remote buffer that provides an input tensor. */
+  const AbsDistMat& get_input_source(int parent_index) const;
+  /** Child error signal or remote buffer that provides a gradient
+   *  w.r.t. an output tensor.
+   */
+  const AbsDistMat& get_prev_error_signal_source(int child_index) const;
+
   // ===========================================================
   // Private class members
   // ===========================================================
@@ -510,6 +785,36 @@ private:
    */
   const Layer* m_hint_layer = nullptr;
 
+  /** Reduced-precision copy of the local input matrix. */
+  reduced_precision_matrix m_stored_input;
+  /** Reduced-precision copy of the local error signal matrix. */
+  reduced_precision_matrix m_stored_error_signal;
+  /** Whether the input was stored during the current forward prop. */
+  bool m_input_stored = false;
+  /** Whether the error signal was stored during the current backprop. */
+  bool m_error_signal_stored = false;
+  /** Whether the parent's output tensor is released. */
+  bool m_stored_input_released = false;
+  /** Whether the error signal is released. */
+  bool m_stored_error_signal_released = false;
+  /** Alignments of released tensors.
+   *  Each entry is a column and row alignment.
+   */
+  std::pair<int,int> m_stored_input_alignment, m_stored_error_signal_alignment;
+  /** Global dimensions of released tensors. */
+  std::pair<El::Int,El::Int> m_stored_input_dims, m_stored_error_signal_dims;
+
+  /** Buffers that replace parents' outputs (see
+   *  @c set_remote_input).
+   *  Null entries use the parent's output. Not copied since the
+   *  buffers belong to the model.
+   */
+  std::vector<const AbsDistMat*> m_remote_inputs;
+  /** Buffers that replace children's error signals (see
+   *  @c set_remote_prev_error_signal).
+   */
+  std::vector<const AbsDistMat*> m_remote_prev_error_signals;
+
 };
 
 } // namespace lbann
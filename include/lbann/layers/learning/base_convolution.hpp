@@ -37,6 +37,7 @@
 #include "lbann/utils/random.hpp"
 #include "lbann/utils/timer.hpp"
 #include "lbann/utils/im2col.hpp"
+#include "lbann/utils/grouped_convolution.hpp"
 
 namespace lbann {
 
@@ -312,10 +313,13 @@ public:
           << "has non-unit dilation, which is not yet supported on CPU";
       LBANN_ERROR(err.str());
     }
-    if (Device == El::Device::CPU && m_groups != 1) {
+    if (Device == El::Device::CPU && m_groups != 1
+        && !direct_grouped_convolution_supported(num_spatial_dims)) {
       err << get_type() << " layer \"" << get_name() << "\" "
-          << "has " << m_groups << " groups, "
-          << "but only one group is currently supported on CPU";
+          << "has " << m_groups << " groups and "
+          << num_spatial_dims << " spatial dimensions, "
+          << "but grouped convolution on CPU only supports "
+          << "1D, 2D, and 3D data";
       LBANN_ERROR(err.str());
     }
 
@@ -872,6 +876,69 @@ protected:
 
   }
 
+  /** Grouped convolution with direct CPU kernels.
+   *  Used instead of im2col when there is more than one channel
+   *  group, e.g. for depthwise convolution.
+   */
+  void apply_convolution_grouped(bool during_forward_prop) {
+
+    // Local matrices
+    const auto& local_kernel = static_cast<const DMat<Device>&>(
+      this->m_weights[0]->get_values().LockedMatrix());
+    const auto& local_input = (during_forward_prop ?
+                               get_local_prev_activations() :
+                               get_local_prev_error_signals());
+    auto& local_output = (during_forward_prop ?
+                          get_local_activations() :
+                          get_local_error_signals());
+
+    // Tensor dimensions
+    const auto& input_dims = (during_forward_prop ?
+                              get_input_dims() : get_output_dims());
+    const auto& output_dims = (during_forward_prop ?
+                               get_output_dims() : get_input_dims());
+    const auto& kernel_dims = get_kernel_dims();
+
+    grouped_convolution_forward(local_input, local_kernel, local_output,
+                                input_dims[0], output_dims[0], m_groups,
+                                input_dims.size() - 1, &input_dims[1],
+                                m_pads.data(),
+                                &kernel_dims[2],
+                                m_strides.data());
+
+  }
+
+  /** Grouped transposed convolution with direct CPU kernels. */
+  void apply_transposed_convolution_grouped(bool during_forward_prop) {
+
+    // Local matrices
+    const auto& local_kernel = static_cast<const DMat<Device>&>(
+      this->m_weights[0]->get_values().LockedMatrix());
+    const auto& local_input = (during_forward_prop ?
+                               get_local_prev_activations() :
+                               get_local_prev_error_signals());
+    auto& local_output = (during_forward_prop ?
+                          get_local_activations() :
+                          get_local_error_signals());
+
+    // Tensor dimensions
+    // Note: The transposed convolution's output is the input of the
+    // corresponding convolution.
+    const auto& input_dims = (during_forward_prop ?
+                              get_input_dims() : get_output_dims());
+    const auto& output_dims = (during_forward_prop ?
+                               get_output_dims() : get_input_dims());
+    const auto& kernel_dims = get_kernel_dims();
+
+    grouped_convolution_backward_data(local_input, local_kernel, local_output,
+                                      output_dims[0], input_dims[0], m_groups,
+                                      output_dims.size() - 1, &output_dims[1],
+                                      m_pads.data(),
+                                      &kernel_dims[2],
+                                      m_strides.data());
+
+  }
+
   void apply_bias_cpu() {
 
     // Return immediately if there is no bias
@@ -961,6 +1028,33 @@ protected:
     optimizer* kernel_optimizer = this->m_weights[0]->get_optimizer();
     if (kernel_optimizer == nullptr) { return; }
 
+    // Grouped convolution computes the kernel gradient directly
+    if (m_groups != 1) {
+      DataType dst_scale = 0, gradient_scale = 0;
+      auto& kernel_gradient = kernel_optimizer->get_gradient_buffer(
+        dst_scale, gradient_scale, true);
+      El::Scale(dst_scale, kernel_gradient);
+      gradient_scale /= effective_mini_batch_size;
+      const auto& x = (using_transposed_convolution ?
+                       local_gradient_wrt_output : local_input);
+      const auto& dy = (using_transposed_convolution ?
+                        local_input : local_gradient_wrt_output);
+      const auto& x_dims = (using_transposed_convolution ?
+                            output_dims : input_dims);
+      const auto& y_dims = (using_transposed_convolution ?
+                            input_dims : output_dims);
+      auto& local_kernel_gradient
+        = static_cast<DMat<Device>&>(kernel_gradient.Matrix());
+      grouped_convolution_backward_filter(x, dy, local_kernel_gradient,
+                                          gradient_scale,
+                                          x_dims[0], y_dims[0], m_groups,
+                                          x_dims.size() - 1, &x_dims[1],
+                                          m_pads.data(),
+                                          &kernel_dims[2],
+                                          m_strides.data());
+      return;
+    }
+
     // Initialize matrices
     const int m = (using_transposed_convolution ?
                    kernel_size / num_input_channels :
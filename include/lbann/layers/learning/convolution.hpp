@@ -102,6 +102,43 @@ public:
 
   El::Device get_device_allocation() const override { return Device; }
 
+  bool fold_channelwise_affine(const CPUMat& scale,
+                               const CPUMat& shift) override {
+    const El::Int num_channels = this->m_output_channels;
+    if (this->m_bias_scaling_factor == DataType(0)
+        || scale.Height() != num_channels) {
+      return false;
+    }
+
+    // Gather weights on every process
+    auto& kernel_weights = *this->m_weights[0];
+    auto& bias_weights = *this->m_weights[1];
+    StarMat<El::Device::CPU> kernel(kernel_weights.get_values().Grid());
+    StarMat<El::Device::CPU> bias(bias_weights.get_values().Grid());
+    El::Copy(kernel_weights.get_values(), kernel);
+    El::Copy(bias_weights.get_values(), bias);
+    auto& local_kernel = kernel.Matrix();
+    auto& local_bias = bias.Matrix();
+
+    // Scale kernel and shift bias for each output channel
+    // Note: The kernel tensor is stored as a column vector and the
+    // output channel is its slowest-varying dimension.
+    const El::Int channel_kernel_size = local_kernel.Height() / num_channels;
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int c = 0; c < num_channels; ++c) {
+      const auto& s = scale(c, 0);
+      for (El::Int i = 0; i < channel_kernel_size; ++i) {
+        local_kernel(c * channel_kernel_size + i, 0) *= s;
+      }
+      local_bias(c, 0) = (s * local_bias(c, 0)
+                          + shift(c, 0) / this->m_bias_scaling_factor);
+    }
+    kernel_weights.set_values(kernel);
+    bias_weights.set_values(bias);
+    return true;
+
+  }
+
 protected:
 
   void setup_dims() override {
@@ -143,7 +180,11 @@ protected:
       base_convolution_layer<Device>::apply_convolution_cudnn(true);
       base_convolution_layer<Device>::apply_bias_cudnn();
     } else {
-      base_convolution_layer<Device>::apply_convolution_im2col(true);
+      if (this->m_groups == 1) {
+        base_convolution_layer<Device>::apply_convolution_im2col(true);
+      } else {
+        base_convolution_layer<Device>::apply_convolution_grouped(true);
+      }
       base_convolution_layer<Device>::apply_bias_cpu();
     }
   }
@@ -154,7 +195,11 @@ protected:
       base_convolution_layer<Device>::apply_transposed_convolution_cudnn(false);
     } else {
       base_convolution_layer<Device>::compute_gradients_im2col(false);
-      base_convolution_layer<Device>::apply_transposed_convolution_im2col(false);
+      if (this->m_groups == 1) {
+        base_convolution_layer<Device>::apply_transposed_convolution_im2col(false);
+      } else {
+        base_convolution_layer<Device>::apply_transposed_convolution_grouped(false);
+      }
     }
   }
 
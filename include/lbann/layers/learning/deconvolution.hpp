@@ -106,7 +106,7 @@ public:
     auto output_dims = input_dims;
 
     // Check for unsupported features
-    /// @todo Implement dilated and grouped deconvolution
+    /// @todo Implement dilated deconvolution
     if (std::any_of(this->m_dilations.begin(),
                     this->m_dilations.end(),
                     [] (int d) { return d != 1; })) {
@@ -119,13 +119,6 @@ public:
       err << ")";
       LBANN_ERROR(err.str());
     }
-    if (this->m_groups != 1) {
-      err << this->get_type() << " layer "
-          << "\"" << this->get_name() << "\" "
-          << "has non-unit groups "
-          << "(" << this->m_groups << ")";
-      LBANN_ERROR(err.str());
-    }
 
     // Initialize output tensor dimensions
     /// @todo Dilated deconvolution
@@ -147,7 +140,7 @@ protected:
   std::vector<int> get_kernel_dims() const override {
     std::vector<int> dims;
     dims.push_back(this->get_input_dims()[0]);
-    dims.push_back(this->m_output_channels);
+    dims.push_back(this->m_output_channels / this->m_groups);
     dims.insert(dims.end(),
                 this->m_conv_dims.begin(),
                 this->m_conv_dims.end());
@@ -159,7 +152,11 @@ protected:
       base_convolution_layer<Device>::apply_transposed_convolution_cudnn(true);
       base_convolution_layer<Device>::apply_bias_cudnn();
     } else {
-      base_convolution_layer<Device>::apply_transposed_convolution_im2col(true);
+      if (this->m_groups == 1) {
+        base_convolution_layer<Device>::apply_transposed_convolution_im2col(true);
+      } else {
+        base_convolution_layer<Device>::apply_transposed_convolution_grouped(true);
+      }
       base_convolution_layer<Device>::apply_bias_cpu();
     }
   }
@@ -170,7 +167,11 @@ protected:
       base_convolution_layer<Device>::apply_convolution_cudnn(false);
     } else {
       base_convolution_layer<Device>::compute_gradients_im2col(true);
-      base_convolution_layer<Device>::apply_convolution_im2col(false);
+      if (this->m_groups == 1) {
+        base_convolution_layer<Device>::apply_convolution_im2col(false);
+      } else {
+        base_convolution_layer<Device>::apply_convolution_grouped(false);
+      }
     }
   }
 
@@ -31,16 +31,37 @@
 
 namespace lbann {
 
+/** @brief Reduction over the embedding vectors of a sample. */
+enum class embedding_pooling { sum, mean };
+
+/** @brief Lookup table of embedding vectors.
+ *
+ *  Each input entry is an index into a dictionary of embedding
+ *  vectors, which are stored as the columns of the weights
+ *  matrix. If a sample has multiple indices (a "bag"), the
+ *  corresponding embedding vectors are summed or averaged. Negative
+ *  indices are treated as padding and ignored. Indices that are not
+ *  less than the dictionary size, or are NaN, are an error.
+ *
+ *  With sparse gradients, only the dictionary entries used in a
+ *  mini-batch are communicated and updated by the optimizer. For
+ *  optimizers with state (e.g. momentum or Adam), this is a "lazy"
+ *  update: the state of unused entries is not decayed.
+ */
 template <data_layout Layout, El::Device Device>
 class embedding_layer : public Layer {
 public:
 
   embedding_layer(lbann_comm* comm,
                   El::Int dictionary_size,
-                  El::Int embedding_size)
+                  El::Int embedding_size,
+                  embedding_pooling pooling = embedding_pooling::sum,
+                  bool sparse_gradient = false)
     : Layer(comm),
       m_dictionary_size{dictionary_size},
-      m_embedding_size{embedding_size} {
+      m_embedding_size{embedding_size},
+      m_pooling{pooling},
+      m_sparse_gradient{sparse_gradient} {
     static_assert(Layout == data_layout::DATA_PARALLEL,
                   "embedding layer only supports data parallel layout");
     static_assert(Device == El::Device::CPU,
@@ -63,6 +84,11 @@ public:
     auto desc = Layer::get_description();
     desc.add("Dictionary size", m_dictionary_size);
     desc.add("Embedding size", m_embedding_size);
+    if (get_input_size() > 1) {
+      desc.add("Pooling",
+               m_pooling == embedding_pooling::mean ? "mean" : "sum");
+    }
+    desc.add("Sparse gradient", m_sparse_gradient);
     return desc;
   }
 
@@ -79,6 +105,13 @@ private:
 
   El::Int m_dictionary_size;
   El::Int m_embedding_size;
+  /** Reduction over multiple indices per sample. */
+  embedding_pooling m_pooling;
+  /** Whether to send column-sparse gradients to the optimizer. */
+  bool m_sparse_gradient;
+  /** Dense gradient w.r.t. dictionary.
+   *  Not allocated with sparse gradients.
+   */
   StarMat<El::Device::CPU> m_dictionary_gradient;
 
 };
@@ -98,6 +98,7 @@ public:
   std::string get_type() const override { return "fully connected"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_reduced_precision_storage() const override { return true; }
 
   description get_description() const override {
     auto desc = learning_layer::get_description();
@@ -107,6 +108,50 @@ public:
     return desc;
   }
 
+  bool fold_channelwise_affine(const CPUMat& scale,
+                               const CPUMat& shift) override {
+    const El::Int output_size = get_output_size();
+    const El::Int num_channels = scale.Height();
+    if (m_bias_scaling_factor == DataType(0)
+        || num_channels < 1
+        || output_size % num_channels != 0) {
+      return false;
+    }
+    const El::Int channel_size = output_size / num_channels;
+
+    // Gather weights on every process
+    auto& linearity_weights = *this->m_weights[0];
+    auto& bias_weights = *this->m_weights[1];
+    StarMat<El::Device::CPU> linearity(linearity_weights.get_values().Grid());
+    StarMat<El::Device::CPU> bias(bias_weights.get_values().Grid());
+    El::Copy(linearity_weights.get_values(), linearity);
+    El::Copy(bias_weights.get_values(), bias);
+    auto& local_linearity = linearity.Matrix();
+    auto& local_bias = bias.Matrix();
+
+    // Scale rows of linearity matrix and shift bias
+    // Note: Output entry i is the inner product of row i of the
+    // linearity matrix (column i if transposed) with the input.
+    const El::Int input_size = get_input_size();
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int i = 0; i < output_size; ++i) {
+      const auto& c = i / channel_size;
+      const auto& s = scale(c, 0);
+      for (El::Int j = 0; j < input_size; ++j) {
+        auto& x = (m_transpose ?
+                   local_linearity(j, i) :
+                   local_linearity(i, j));
+        x *= s;
+      }
+      local_bias(i, 0) = (s * local_bias(i, 0)
+                          + shift(c, 0) / m_bias_scaling_factor);
+    }
+    linearity_weights.set_values(linearity);
+    bias_weights.set_values(bias);
+    return true;
+
+  }
+
 protected:
 
   void setup_matrices(const El::Grid& grid) override;
@@ -125,7 +125,9 @@ public:
     local_fp_compute(get_local_prev_activations(0),
                      get_local_prev_activations(1),
                      m_workspace->Matrix());
-    m_comm->allreduce(*m_workspace, m_workspace->RedundantComm());
+    if (m_workspace->RedundantSize() > 1) {
+      m_comm->allreduce(*m_workspace, m_workspace->RedundantComm());
+    }
     El::Copy(*m_workspace, get_activations());
 
   }
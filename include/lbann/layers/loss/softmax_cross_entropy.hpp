@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYERS_LOSS_SOFTMAX_CROSS_ENTROPY_HPP_INCLUDED
+#define LBANN_LAYERS_LOSS_SOFTMAX_CROSS_ENTROPY_HPP_INCLUDED
+
+#include "lbann/layers/layer.hpp"
+
+namespace lbann {
+
+/** @brief Softmax followed by cross entropy loss.
+ *
+ *  Given logits @f$x@f$ and ground truth distribution
+ *  @f$\hat{y}@f$,
+ *  @f[
+ *    CE(\text{softmax}(x),\hat{y})
+ *    = \log \left( \sum\limits_j e^{x_j} \right) \sum\limits_i \hat{y}_i
+ *      - \sum\limits_i \hat{y}_i x_i
+ *  @f]
+ *  This is equivalent to a softmax layer followed by a cross entropy
+ *  layer, but the logits are read once in the forward pass, the
+ *  softmax output is never stored, and the gradient w.r.t. the
+ *  logits does not divide by the prediction. It is intended for
+ *  classifier heads.
+ *
+ *  Only the CPU implementation is available.
+ */
+template <data_layout T_layout, El::Device Dev>
+class softmax_cross_entropy_layer : public Layer {
+public:
+
+  softmax_cross_entropy_layer(lbann_comm *comm) : Layer(comm) {
+    this->m_expected_num_parent_layers = 2;
+  }
+
+  softmax_cross_entropy_layer(const softmax_cross_entropy_layer& other)
+    : Layer(other) {
+    m_workspace.reset(other.m_workspace ?
+                      other.m_workspace->Copy() :
+                      nullptr);
+    m_column_stats.reset(other.m_column_stats ?
+                         other.m_column_stats->Copy() :
+                         nullptr);
+  }
+
+  softmax_cross_entropy_layer& operator=(const softmax_cross_entropy_layer& other) {
+    Layer::operator=(other);
+    m_workspace.reset(other.m_workspace ?
+                      other.m_workspace->Copy() :
+                      nullptr);
+    m_column_stats.reset(other.m_column_stats ?
+                         other.m_column_stats->Copy() :
+                         nullptr);
+    return *this;
+  }
+
+  softmax_cross_entropy_layer* copy() const override {
+    return new softmax_cross_entropy_layer(*this);
+  }
+  std::string get_type() const override { return "softmax cross entropy"; }
+  data_layout get_data_layout() const override { return T_layout; }
+  El::Device get_device_allocation() const override { return Dev; }
+
+  void setup_dims() override {
+    Layer::setup_dims();
+    set_output_dims({1});
+
+    // Check that input dimensions match
+    if (get_input_dims(0) != get_input_dims(1)) {
+      const auto& parents = get_parent_layers();
+      std::stringstream err;
+      err << get_type() << " layer \"" << get_name() << "\" "
+          << "has input tensors with different dimensions (";
+      for (int i = 0; i < get_num_parents(); ++i) {
+        const auto& dims = get_input_dims(i);
+        err << (i > 0 ? ", " : "")
+            << "layer \"" << parents[i]->get_name() << "\" outputs ";
+        for (size_t j = 0; j < dims.size(); ++j) {
+          err << (j > 0 ? " x " : "") << dims[j];
+        }
+      }
+      err << ")";
+      LBANN_ERROR(err.str());
+    }
+
+  }
+
+  void setup_data() override {
+    Layer::setup_data();
+
+    // Initialize workspaces
+    const auto& logits = get_prev_activations(0);
+    switch (get_data_layout()) {
+    case data_layout::DATA_PARALLEL:
+      m_workspace.reset(new StarVCMat<Dev>(logits.Grid(), logits.Root()));
+      m_column_stats.reset(new StarVCMat<Dev>(logits.Grid(), logits.Root()));
+      break;
+    case data_layout::MODEL_PARALLEL:
+      m_workspace.reset(new StarMRMat<Dev>(logits.Grid(), logits.Root()));
+      m_column_stats.reset(new StarMRMat<Dev>(logits.Grid(), logits.Root()));
+      break;
+    default: LBANN_ERROR("invalid data layout");
+    }
+
+  }
+
+  void fp_compute() override;
+  void bp_compute() override;
+
+private:
+
+  /** Workspace for column-wise reductions.
+   *  Rows are sum(exp(x-max)), dot(y_hat,x), and sum(y_hat).
+   */
+  std::unique_ptr<AbsDistMat> m_workspace;
+  /** Column statistics needed for back prop.
+   *  Rows are LogSumExp(x) and sum(y_hat).
+   */
+  std::unique_ptr<AbsDistMat> m_column_stats;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_LAYERS_LOSS_SOFTMAX_CROSS_ENTROPY_HPP_INCLUDED
@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYERS_MATH_FUSED_ENTRYWISE_HPP_INCLUDED
+#define LBANN_LAYERS_MATH_FUSED_ENTRYWISE_HPP_INCLUDED
+
+#include "lbann/layers/layer.hpp"
+#include "lbann/utils/fused_entrywise.hpp"
+#include <memory>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Define entry-wise fusion functions that report an error.
+ *  @details For layer types where fusion is not supported, e.g. GPU
+ *  layers.
+ */
+#define LBANN_DEFINE_UNSUPPORTED_ENTRYWISE_FUSION(layer, layout, device) \
+  template <>                                                           \
+  void layer<layout, device>::fp_compute_entrywise(                     \
+    const DataType*, DataType*, El::Int) const {                        \
+    LBANN_ERROR("entry-wise fusion is not supported for this layer");   \
+  }                                                                     \
+  template <>                                                           \
+  void layer<layout, device>::bp_compute_entrywise(                     \
+    const DataType*, const DataType*, DataType*, El::Int) const {       \
+    LBANN_ERROR("entry-wise fusion is not supported for this layer");   \
+  }
+
+/** @brief Chain of entry-wise layers applied in a single pass.
+ *
+ *  Constructed by the model when fusing runs of entry-wise layers
+ *  (see @c model::fuse_entrywise_layers). Data is processed in
+ *  cache-sized tiles, so the input and output tensors are each read
+ *  or written once per step instead of once per fused layer. Backprop
+ *  recomputes the intermediate values within each tile.
+ *
+ *  Only CPU layers are supported.
+ */
+template <data_layout Layout, El::Device Device>
+class fused_entrywise_layer : public Layer {
+public:
+
+  /** @param layers Entry-wise layers in execution order. Each layer
+   *                must implement @c entrywise_fusion_interface.
+   */
+  fused_entrywise_layer(lbann_comm* comm,
+                        std::vector<std::unique_ptr<Layer>> layers);
+  fused_entrywise_layer(const fused_entrywise_layer& other);
+  fused_entrywise_layer& operator=(const fused_entrywise_layer& other);
+
+  fused_entrywise_layer* copy() const override {
+    return new fused_entrywise_layer(*this);
+  }
+  std::string get_type() const override { return "fused entry-wise"; }
+  data_layout get_data_layout() const override { return Layout; }
+  El::Device get_device_allocation() const override { return Device; }
+  bool supports_in_place_backprop() const override { return true; }
+  bool supports_in_place_forward_prop() const override { return true; }
+  bool supports_reduced_precision_storage() const override { return true; }
+
+  description get_description() const override;
+
+  /** @brief Number of fused layers. */
+  El::Int get_num_fused_layers() const noexcept { return m_layers.size(); }
+
+protected:
+
+  void setup_dims() override {
+    Layer::setup_dims();
+    set_output_dims(get_input_dims());
+  }
+  void fp_compute() override;
+  void bp_compute() override;
+  void fp_compute_and_store_input(
+    storage_format format, reduced_precision_matrix& stored_input) override;
+  void bp_compute_with_stored_tensors(
+    const reduced_precision_matrix* stored_input,
+    AbsMat* local_input,
+    storage_format error_signal_format,
+    reduced_precision_matrix* stored_error_signal) override;
+
+private:
+
+  /** @brief Fused layers in execution order. */
+  std::vector<std::unique_ptr<Layer>> m_layers;
+  /** @brief Entry-wise operators of fused layers. */
+  std::vector<const entrywise_fusion_interface*> m_operators;
+  /** @brief Per-thread storage for intermediate values in backprop. */
+  std::vector<DataType> m_workspace;
+
+  /** @brief Initialize operator pointers from fused layers. */
+  void setup_operators();
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_LAYERS_MATH_FUSED_ENTRYWISE_HPP_INCLUDED
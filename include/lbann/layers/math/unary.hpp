@@ -27,7 +27,7 @@
 #ifndef LBANN_LAYERS_MATH_UNARY_HPP_INCLUDED
 #define LBANN_LAYERS_MATH_UNARY_HPP_INCLUDED
 
-#include "lbann/layers/layer.hpp"
+#include "lbann/layers/math/fused_entrywise.hpp"
 
 namespace lbann {
 
@@ -37,7 +37,8 @@ namespace lbann {
  *  @param Name     Type that can be converted into a string.
  */
 template <data_layout Layout, El::Device Device, typename Name>
-class entrywise_unary_layer : public Layer {
+class entrywise_unary_layer : public Layer,
+                              public entrywise_fusion_interface {
 public:
   entrywise_unary_layer(lbann_comm *comm) : Layer(comm) {}
   entrywise_unary_layer* copy() const override {
@@ -46,6 +47,16 @@ public:
   std::string get_type() const override { return Name(); }
   data_layout get_data_layout() const override { return Layout; }
   El::Device get_device_allocation() const override { return Device; }
+  bool supports_in_place_backprop() const override { return true; }
+  bool supports_in_place_forward_prop() const override { return true; }
+  bool supports_reduced_precision_storage() const override { return true; }
+  void fp_compute_entrywise(const DataType* x,
+                            DataType* y,
+                            El::Int size) const override;
+  void bp_compute_entrywise(const DataType* x,
+                            const DataType* dy,
+                            DataType* dx,
+                            El::Int size) const override;
 protected:
   void setup_dims() override {
     Layer::setup_dims();
@@ -53,8 +64,79 @@ protected:
   }
   void fp_compute() override;
   void bp_compute() override;
+  void fp_compute_and_store_input(
+    storage_format format, reduced_precision_matrix& stored_input) override;
+  void bp_compute_with_stored_tensors(
+    const reduced_precision_matrix* stored_input,
+    AbsMat* local_input,
+    storage_format error_signal_format,
+    reduced_precision_matrix* stored_error_signal) override;
 };
 
+// Conversions of stored inputs are fused into the compute loop on
+// CPUs
+template <data_layout Layout, El::Device Device, typename Name>
+void entrywise_unary_layer<Layout,Device,Name>::fp_compute_and_store_input(
+  storage_format format, reduced_precision_matrix& stored_input) {
+  if (Device != El::Device::CPU) {
+    Layer::fp_compute_and_store_input(format, stored_input);
+    return;
+  }
+  const auto& local_input = get_local_prev_activations();
+  auto& local_output = get_local_activations();
+  stored_input.resize(format, local_input.Height(), local_input.Width());
+  fused_entrywise_fp({this},
+                     local_input.Height(), local_input.Width(),
+                     local_input.LockedBuffer(), local_input.LDim(),
+                     local_output.Buffer(), local_output.LDim(),
+                     format, stored_input.get_buffer());
+}
+
+template <data_layout Layout, El::Device Device, typename Name>
+void entrywise_unary_layer<Layout,Device,Name>::bp_compute_with_stored_tensors(
+  const reduced_precision_matrix* stored_input,
+  AbsMat* local_input,
+  storage_format error_signal_format,
+  reduced_precision_matrix* stored_error_signal) {
+  if (Device != El::Device::CPU) {
+    Layer::bp_compute_with_stored_tensors(stored_input, local_input,
+                                          error_signal_format,
+                                          stored_error_signal);
+    return;
+  }
+  const auto& local_prev_activations = get_local_prev_activations();
+  const auto& local_gradient_wrt_output = get_local_prev_error_signals();
+  auto& local_gradient_wrt_input = get_local_error_signals();
+  auto* input = (local_input != nullptr ?
+                 local_input->Buffer() :
+                 const_cast<DataType*>(local_prev_activations.LockedBuffer()));
+  const auto& input_ldim = (local_input != nullptr ?
+                            local_input->LDim() :
+                            local_prev_activations.LDim());
+  if (stored_error_signal != nullptr) {
+    stored_error_signal->resize(error_signal_format,
+                                local_gradient_wrt_input.Height(),
+                                local_gradient_wrt_input.Width());
+  }
+  std::vector<DataType> workspace;
+  fused_entrywise_bp({this},
+                     local_gradient_wrt_input.Height(),
+                     local_gradient_wrt_input.Width(),
+                     (stored_input != nullptr ?
+                      stored_input->get_format() : storage_format::full),
+                     (stored_input != nullptr ?
+                      stored_input->get_buffer() : nullptr),
+                     input, input_ldim,
+                     local_gradient_wrt_output.LockedBuffer(),
+                     local_gradient_wrt_output.LDim(),
+                     local_gradient_wrt_input.Buffer(),
+                     local_gradient_wrt_input.LDim(),
+                     error_signal_format,
+                     (stored_error_signal != nullptr ?
+                      stored_error_signal->get_buffer() : nullptr),
+                     workspace);
+}
+
 // Convenience macro to define an entry-wise unary layer class
 #define DEFINE_ENTRYWISE_UNARY_LAYER(layer_name, layer_string)          \
   struct layer_name##_name_struct {                                     \
@@ -97,6 +97,13 @@ private:
   std::unique_ptr<AbsDistMat> m_scale_gradient;
   /** Gradient w.r.t. bias terms. */
   std::unique_ptr<AbsDistMat> m_bias_gradient;
+  /** Whether the layer has been folded into its parent's weights. */
+  bool m_folded = false;
+  /** Whether a ReLU is applied to the output.
+   *  Set when the model fuses a following ReLU layer into this
+   *  layer.
+   */
+  bool m_fused_relu = false;
 
 public:
   /** @brief Set up batch normalization.
@@ -143,7 +150,9 @@ public:
       m_scale_gradient(other.m_scale_gradient ?
                        other.m_scale_gradient->Copy() : nullptr),
       m_bias_gradient(other.m_bias_gradient ?
-                      other.m_bias_gradient->Copy() : nullptr) {}
+                      other.m_bias_gradient->Copy() : nullptr),
+      m_folded(other.m_folded),
+      m_fused_relu(other.m_fused_relu) {}
 
   batch_normalization_layer& operator=(const batch_normalization_layer& other) {
     regularizer_layer::operator=(other);
@@ -169,6 +178,8 @@ public:
                            other.m_scale_gradient->Copy() : nullptr);
     m_bias_gradient.reset(other.m_bias_gradient ?
                           other.m_bias_gradient->Copy() : nullptr);
+    m_folded = other.m_folded;
+    m_fused_relu = other.m_fused_relu;
 
     return *this;
   }
@@ -177,12 +188,72 @@ public:
   std::string get_type() const override { return "batch normalization"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_recomputation() const override { return false; }
+  bool supports_reduced_precision_storage() const override { return true; }
+  /** A folded layer without a fused ReLU outputs a view of its
+   *  input, so it cannot write into a child's memory.
+   */
+  bool supports_output_views() const override {
+    return !(m_folded && !m_fused_relu);
+  }
+
+  bool fold_into_parent(Layer& parent) override {
+    if (m_folded) { return true; }
+
+    // Get running statistics and affine parameters
+    // Note: Weights are small, so they are gathered on every process.
+    const auto& num_channels = get_output_dims()[0];
+    std::vector<StarMat<El::Device::CPU>> params;
+    for (size_t i = 0; i < 4; ++i) {
+      const auto& values = this->m_weights[i]->get_values();
+      params.emplace_back(values.Grid());
+      El::Copy(values, params.back());
+    }
+    const auto& local_scale = params[0].LockedMatrix();
+    const auto& local_bias = params[1].LockedMatrix();
+    const auto& local_running_mean = params[2].LockedMatrix();
+    const auto& local_running_var = params[3].LockedMatrix();
+
+    // Inference-mode batch normalization is a per-channel affine
+    // transform
+    CPUMat scale(num_channels, 1), shift(num_channels, 1);
+    for (El::Int c = 0; c < num_channels; ++c) {
+      const auto& inv_stdev
+        = 1 / std::sqrt(local_running_var(c, 0) + m_epsilon);
+      scale(c, 0) = local_scale(c, 0) * inv_stdev;
+      shift(c, 0) = (local_bias(c, 0)
+                     - scale(c, 0) * local_running_mean(c, 0));
+    }
+    if (!parent.fold_channelwise_affine(scale, shift)) { return false; }
+    m_folded = true;
+    return true;
+
+  }
+
+  /** @brief Apply a ReLU to the output.
+   *
+   *  The ReLU is applied in the same sweep as normalization in
+   *  forward prop, and the error signal is masked in the same sweeps
+   *  as batch normalization backprop. Only supported on CPU.
+   */
+  void fuse_relu() {
+    if (Dev != El::Device::CPU) {
+      LBANN_ERROR("ReLU fusion is only supported for "
+                  "CPU batch normalization");
+    }
+    m_fused_relu = true;
+  }
+  /** Whether a ReLU is applied to the output. */
+  bool has_fused_relu() const { return m_fused_relu; }
 
   description get_description() const override {
     auto desc = regularizer_layer::get_description();
     desc.add("Decay", m_decay);
     desc.add("Epsilon", m_epsilon);
     desc.add("Statistics group size", m_statistics_group_size);
+    if (m_fused_relu) {
+      desc.add("Fused ReLU", "enabled");
+    }
     return desc;
   }
 
@@ -193,11 +264,29 @@ protected:
     m_mean_and_var.reset(new StarMat<Dev>(grid));
     m_mean_v.reset(new StarMat<Dev>(grid));
     m_var_v.reset(new StarMat<Dev>(grid));
-    m_mean_and_var_gradient.reset(new StarMat<Dev>(grid));
-    m_mean_gradient_v.reset(new StarMat<Dev>(grid));
-    m_var_gradient_v.reset(new StarMat<Dev>(grid));
-    m_scale_gradient.reset(new StarMat<Dev>(grid));
-    m_bias_gradient.reset(new StarMat<Dev>(grid));
+
+    // Gradient buffers are only needed for back prop
+    if (!m_model->is_frozen_model()) {
+      m_mean_and_var_gradient.reset(new StarMat<Dev>(grid));
+      m_mean_gradient_v.reset(new StarMat<Dev>(grid));
+      m_var_gradient_v.reset(new StarMat<Dev>(grid));
+      m_scale_gradient.reset(new StarMat<Dev>(grid));
+      m_bias_gradient.reset(new StarMat<Dev>(grid));
+    } else {
+      m_mean_and_var_gradient.reset();
+      m_mean_gradient_v.reset();
+      m_var_gradient_v.reset();
+      m_scale_gradient.reset();
+      m_bias_gradient.reset();
+    }
+  }
+
+  void fp_setup_outputs(El::Int mini_batch_size) override {
+    if (m_folded && !m_fused_relu) {
+      El::LockedView(get_activations(), get_prev_activations());
+    } else {
+      regularizer_layer::fp_setup_outputs(mini_batch_size);
+    }
   }
 
   void setup_dims() override {
@@ -293,17 +382,21 @@ protected:
 
     // Initialize matrices
     El::Zeros(*m_mean_and_var,   num_channels, 2);
-    El::Zeros(*m_mean_and_var_gradient, num_channels, 2);
-    El::Zeros(*m_scale_gradient, num_channels, 1);
-    El::Zeros(*m_bias_gradient,  num_channels, 1);
+    if (m_mean_and_var_gradient != nullptr) {
+      El::Zeros(*m_mean_and_var_gradient, num_channels, 2);
+      El::Zeros(*m_scale_gradient, num_channels, 1);
+      El::Zeros(*m_bias_gradient,  num_channels, 1);
+    }
 
     // Initialize views.
     El::View(*m_mean_v, *m_mean_and_var, El::ALL, El::IR(0, 1));
     El::View(*m_var_v, *m_mean_and_var, El::ALL, El::IR(1, 2));
-    El::View(*m_mean_gradient_v, *m_mean_and_var_gradient,
-             El::ALL, El::IR(0, 1));
-    El::View(*m_var_gradient_v, *m_mean_and_var_gradient,
-             El::ALL, El::IR(1, 2));
+    if (m_mean_and_var_gradient != nullptr) {
+      El::View(*m_mean_gradient_v, *m_mean_and_var_gradient,
+               El::ALL, El::IR(0, 1));
+      El::View(*m_var_gradient_v, *m_mean_and_var_gradient,
+               El::ALL, El::IR(1, 2));
+    }
 
     // Initialize freeze state
     for (auto&& w : this->m_weights) {
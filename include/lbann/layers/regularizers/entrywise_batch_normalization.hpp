@@ -82,6 +82,7 @@ public:
   std::string get_type() const override { return "entry-wise batch normalization"; }
   data_layout get_data_layout() const override { return Layout; }
   El::Device get_device_allocation() const override { return Device; }
+  bool supports_recomputation() const override { return false; }
 
   description get_description() const override {
     auto desc = Layer::get_description();
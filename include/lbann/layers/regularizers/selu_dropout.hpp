@@ -94,6 +94,7 @@ class selu_dropout : public regularizer_layer {
   data_layout get_data_layout() const override { return T_layout; }
 
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_recomputation() const override { return false; }
 
   void setup_dims() override {
     regularizer_layer::setup_dims();
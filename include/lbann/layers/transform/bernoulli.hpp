@@ -54,6 +54,7 @@ public:
   std::string get_type() const override { return "Bernoulli"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_recomputation() const override { return false; }
 
   description get_description() const override {
     auto desc = transform_layer::get_description();
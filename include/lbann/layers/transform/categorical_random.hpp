@@ -55,6 +55,7 @@ class categorical_random_layer : public transform_layer {
   std::string get_type() const override { return "categorical random"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_recomputation() const override { return false; }
 
  protected:
 
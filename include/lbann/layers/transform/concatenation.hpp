@@ -62,6 +62,8 @@ public:
   std::string get_type() const override { return "concatenation"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_output_views() const override { return false; }
+  bool supports_error_signal_views() const override { return false; }
 
   description get_description() const override {
     auto desc = transform_layer::get_description();
@@ -69,6 +71,16 @@ public:
     return desc;
   }
 
+  /** Each input is a contiguous range of rows in the output tensor
+   *  if there is only one block per slice, i.e. all dimensions before
+   *  the concatenation dimension are one.
+   */
+  bool provides_parent_output_view(int parent_index) const override {
+    return (T_layout == data_layout::DATA_PARALLEL
+            && get_num_parents() > 1
+            && get_blocks_per_slice() == 1);
+  }
+
 protected:
 
   void setup_pointers() override {
@@ -144,17 +156,33 @@ protected:
 
   }
 
+  void setup_parent_output_view(const Layer& parent,
+                                El::Int mini_batch_size,
+                                AbsDistMat& output) override {
+    const auto& parents = get_parent_layers();
+    const auto& parent_index = (std::find(parents.begin(), parents.end(),
+                                          &parent)
+                                - parents.begin());
+    const auto& unit_block_size = get_unit_block_size();
+    setup_output_buffer(mini_batch_size);
+    El::View(output, get_activations(),
+             El::IR(m_concat_points[parent_index] * unit_block_size,
+                    m_concat_points[parent_index+1] * unit_block_size),
+             El::ALL);
+  }
+
   void fp_setup_outputs(El::Int mini_batch_size) override {
     const auto& num_inputs = get_num_parents();
     const auto& output_dims = get_output_dims();
 
     // Initialize output tensor
+    // Note: Parents may have already written into the output tensor
+    // if it provides their output tensors.
     auto& output = get_activations();
-    output.Empty(false);
     if (num_inputs > 1) {
-      output.AlignWith(get_prev_activations());
-      output.Resize(get_output_size(), mini_batch_size);
+      setup_output_buffer(mini_batch_size);
     } else {
+      output.Empty(false);
       El::LockedView(output, get_prev_activations());
       return;
     }
@@ -186,6 +214,13 @@ protected:
       const auto& block_size = input_num_unit_slices * unit_block_size;
       const auto& output_block_offset = m_concat_points[i] * unit_block_size;
 
+      // Nothing to be done if input is already in output tensor
+      if (T_layout == data_layout::DATA_PARALLEL
+          && blocks_per_slice == 1
+          && is_local_view(input, output, output_block_offset)) {
+        continue;
+      }
+
       // Populate output tensor one block at a time
       for (int block = 0; block < blocks_per_slice; ++block) {
         const auto& input_offset = block * block_size;
@@ -271,6 +306,52 @@ protected:
 
 private:
 
+  /** Number of contiguous blocks in each unit slice of the output. */
+  El::Int get_blocks_per_slice() const {
+    const auto& output_dims = get_output_dims();
+    return std::accumulate(output_dims.begin(),
+                           output_dims.begin() + m_concat_dim,
+                           1, std::multiplies<int>());
+  }
+
+  /** Size of contiguous block in each unit slice of the output. */
+  El::Int get_unit_block_size() const {
+    const auto& output_dims = get_output_dims();
+    return std::accumulate(output_dims.begin() + m_concat_dim + 1,
+                           output_dims.end(),
+                           1, std::multiplies<int>());
+  }
+
+  /** Allocate output tensor if needed.
+   *  The output tensor is only reallocated if its size changes, so
+   *  views from parent layers remain valid within a mini-batch step.
+   */
+  void setup_output_buffer(El::Int mini_batch_size) {
+    auto& output = get_activations();
+    if (output.Viewing()
+        || output.Height() != get_output_size()
+        || output.Width() != mini_batch_size) {
+      output.Empty(false);
+      output.AlignWith(get_prev_activations());
+      output.Resize(get_output_size(), mini_batch_size);
+    }
+  }
+
+  /** Whether a matrix is a view into rows of another matrix.
+   *  Only checks local data.
+   */
+  static bool is_local_view(const AbsDistMat& view,
+                            const AbsDistMat& mat,
+                            El::Int row_offset) {
+    const auto& local_view = view.LockedMatrix();
+    const auto& local_mat = mat.LockedMatrix();
+    return (local_view.Width() > 0
+            && local_view.Width() == local_mat.Width()
+            && local_view.LDim() == local_mat.LDim()
+            && (local_view.LockedBuffer()
+                == local_mat.LockedBuffer(row_offset, 0)));
+  }
+
   /** Tensor dimension to concatenation. */
   El::Int m_concat_dim;
   /** Concatenation points for each child layer. */
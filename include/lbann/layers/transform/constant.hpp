@@ -48,6 +48,7 @@ public:
   std::string get_type() const override { return "constant"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool has_constant_outputs() const override { return true; }
 
   description get_description() const override {
     auto desc = transform_layer::get_description();
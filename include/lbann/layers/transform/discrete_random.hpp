@@ -62,6 +62,7 @@ class discrete_random_layer : public transform_layer {
   std::string get_type() const override { return "discrete random"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_recomputation() const override { return false; }
 
  protected:
 
@@ -28,6 +28,7 @@
 #define LBANN_LAYER_EVALUATION_HPP_INCLUDED
 
 #include "lbann/layers/transform/transform.hpp"
+#include <vector>
 
 namespace lbann {
 
@@ -39,8 +40,44 @@ public:
   EvalType get_scale() const { return m_scale; }
   /** Set scaling factor. */
   void set_scale(EvalType scale) { m_scale = scale; }
-  /** Get evaluated value. */
+  /** Get evaluated value.
+   *  With deferred evaluation, the value of the current mini-batch
+   *  step is reduced with a blocking allreduce, so this must be
+   *  called by all processes.
+   */
   EvalType get_value(bool scaled = true);
+  /** Replace the evaluated value of the current mini-batch step.
+   *  Used when the value is assembled from several forward props,
+   *  e.g. micro-batches in a pipeline. Waits for the reduction of the
+   *  last forward prop. Not supported with deferred evaluation.
+   */
+  void set_value(EvalType value);
+
+  /** @brief Deferred evaluation.
+   *
+   *  Instead of starting an allreduce in every forward prop, local
+   *  sums are accumulated (on the device that computes them) over
+   *  @c window mini-batch steps and reduced with one non-blocking
+   *  allreduce per window. Values of completed windows are obtained
+   *  with @c collect_deferred_value. A window of one or less
+   *  disables deferred evaluation.
+   */
+  void set_deferred_evaluation(El::Int window);
+  El::Int get_deferred_evaluation() const { return m_deferred_window; }
+  /** Register a consumer of deferred values.
+   *  Each consumer receives the value of every window.
+   */
+  int add_deferred_consumer();
+  /** Get the sum of unscaled values times mini-batch sizes over
+   *  windows whose reduction completed since the consumer's last
+   *  call. Does not block unless @c flush, in which case the current
+   *  partial window is reduced and all reductions are waited on.
+   *  Flushing must be done by all processes.
+   */
+  EvalType collect_deferred_value(int consumer, bool flush);
+
+  /** Forward prop starts a reduction for the objective function. */
+  bool supports_recomputation() const override { return false; }
 
   /** Construct an evaluation layer.
    *  The caller is responsible for deallocating the layer.
@@ -58,6 +95,16 @@ protected:
 
 private:
 
+  /** Deferred evaluation forward prop. */
+  void fp_compute_deferred();
+  /** Start reducing the current window. */
+  void start_deferred_reduction();
+  /** Complete the pending reduction.
+   *  Returns false if @c wait is false and the reduction has not
+   *  completed.
+   */
+  bool finish_deferred_reduction(bool wait);
+
   /** Scaling factor to apply to evaluated value. */
   EvalType m_scale = 0;
   /** Evaluated value.
@@ -71,6 +118,34 @@ private:
   cuda::event_wrapper m_copy_event;
 #endif // LBANN_HAS_GPU
 
+  /** Mini-batch steps per deferred reduction. */
+  El::Int m_deferred_window = 0;
+  /** Mini-batch steps in the current window. */
+  El::Int m_deferred_steps = 0;
+  /** Local sum of values times mini-batch sizes in the current
+   *  window (CPU). */
+  DataType m_deferred_local_sum = 0;
+  /** Whether a window is being reduced. */
+  bool m_deferred_pending = false;
+  /** Reduced sum of a window.
+   *  The value may be stored in pinned memory.
+   */
+  CPUMat m_deferred_value;
+  /** Values of completed windows not yet collected by each
+   *  consumer. */
+  std::vector<EvalType> m_deferred_collected;
+  /** Whether m_value holds the reduced value of the current step. */
+  bool m_value_reduced = false;
+  /** Mini-batch size of the current step. */
+  El::Int m_mini_batch_size = 0;
+#ifdef LBANN_HAS_GPU
+  /** Local sum of the current step (GPU). */
+  GPUMat m_step_sum_d;
+  /** Local sum of values times mini-batch sizes in the current
+   *  window (GPU). */
+  GPUMat m_deferred_sum_d;
+#endif // LBANN_HAS_GPU
+
 };
 
 /** Evaluation layer.
@@ -31,6 +31,7 @@
 #include <vector>
 #include "lbann/layers/transform/transform.hpp"
 #include "lbann/utils/cudnn.hpp"
+#include "lbann/utils/direct_pooling.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/im2col.hpp"
 
@@ -61,7 +62,7 @@ private:
    *  matrix. The entry gives the index of the maximum entry within
    *  the pooling window.
    */
-  std::vector<int> m_max_pool_indices;
+  max_pool_indices m_max_pool_indices;
 
 #ifdef LBANN_HAS_CUDNN
   /** Pooling descriptor. */
@@ -263,6 +264,8 @@ protected:
   void fp_compute() override {
     if(this->using_gpus()) {
       fp_compute_cudnn();
+    } else if(direct_pooling_supported(get_input_dims().size() - 1)) {
+      fp_compute_direct();
     } else {
       fp_compute_im2col();
     }
@@ -271,6 +274,8 @@ protected:
   void bp_compute() override {
     if(this->using_gpus()) {
       bp_compute_cudnn();
+    } else if(direct_pooling_supported(get_input_dims().size() - 1)) {
+      bp_compute_direct();
     } else {
       bp_compute_im2col();
     }
@@ -333,6 +338,70 @@ private:
 #endif // #ifndef LBANN_HAS_CUDNN
   }
 
+  /// Pooling forward propagation with direct CPU kernels
+  void fp_compute_direct() {
+    const auto& input_dims = get_input_dims();
+    const auto& local_input = get_local_prev_activations();
+    auto& local_output = get_local_activations();
+    switch (m_pool_mode) {
+    case pool_mode::max:
+      max_pool_forward(local_input,
+                       local_output,
+                       m_max_pool_indices,
+                       input_dims[0],
+                       input_dims.size() - 1,
+                       &input_dims[1],
+                       m_pads.data(),
+                       m_pool_dims.data(),
+                       m_strides.data());
+      break;
+    case pool_mode::average:
+      average_pool_forward(local_input,
+                           local_output,
+                           input_dims[0],
+                           input_dims.size() - 1,
+                           &input_dims[1],
+                           m_pads.data(),
+                           m_pool_dims.data(),
+                           m_strides.data());
+      break;
+    default:
+      LBANN_ERROR("CPU pooling layer only supports max and average pooling");
+    }
+  }
+
+  /// Pooling backward propagation with direct CPU kernels
+  void bp_compute_direct() {
+    const auto& input_dims = get_input_dims();
+    const auto& local_gradient_wrt_output = get_local_prev_error_signals();
+    auto& local_gradient_wrt_input = get_local_error_signals();
+    switch (m_pool_mode) {
+    case pool_mode::max:
+      max_pool_backward(local_gradient_wrt_output,
+                        m_max_pool_indices,
+                        local_gradient_wrt_input,
+                        input_dims[0],
+                        input_dims.size() - 1,
+                        &input_dims[1],
+                        m_pads.data(),
+                        m_pool_dims.data(),
+                        m_strides.data());
+      break;
+    case pool_mode::average:
+      average_pool_backward(local_gradient_wrt_output,
+                            local_gradient_wrt_input,
+                            input_dims[0],
+                            input_dims.size() - 1,
+                            &input_dims[1],
+                            m_pads.data(),
+                            m_pool_dims.data(),
+                            m_strides.data());
+      break;
+    default:
+      LBANN_ERROR("CPU pooling layer only supports max and average pooling");
+    }
+  }
+
   /// Pooling forward propagation with im2col
   void fp_compute_im2col() {
     if(m_pool_mode != pool_mode::max && m_pool_mode != pool_mode::average) {
@@ -351,7 +420,8 @@ private:
 
     // Initialize max pool indices if needed
     if(m_pool_mode == pool_mode::max) {
-      m_max_pool_indices.assign(get_output_size() * local_width, 0);
+      m_max_pool_indices.resize(get_output_size() * local_width,
+                                m_pool_size);
     }
 
     // Initialize matrices
@@ -376,7 +446,7 @@ private:
       if(m_pool_mode == pool_mode::max) {
         // Apply max pooling
         DataType *output_buffer = local_output.Buffer(0, sample);
-        int *indices_buffer = &m_max_pool_indices[sample * get_output_size()];
+        const El::Int indices_offset = sample * get_output_size();
         LBANN_OMP_PARALLEL_FOR
         for(int channel = 0; channel < num_channels; ++channel) {
           for(int j = 0; j < num_per_output_channel; ++j) {
@@ -392,7 +462,7 @@ private:
             }
             const int output_index = j + channel * num_per_output_channel;
             output_buffer[output_index] = max_entry;
-            indices_buffer[output_index] = max_index;
+            m_max_pool_indices.set(indices_offset + output_index, max_index);
           }
         }
       }
@@ -420,7 +490,7 @@ private:
 
   }
 
-  /// Pooling forward propagation with im2col
+  /// Pooling backward propagation with im2col
   void bp_compute_im2col() {
     if(m_pool_mode != pool_mode::max && m_pool_mode != pool_mode::average) {
       LBANN_ERROR("CPU pooling layer only supports max and average pooling");
@@ -453,13 +523,13 @@ private:
         // corresponding to max
         const DataType *gradient_wrt_output_buffer
           = local_gradient_wrt_output.LockedBuffer(0, sample);
-        const int *indices_buffer
-          = &m_max_pool_indices[sample * get_output_size()];
+        const El::Int indices_offset = sample * get_output_size();
         LBANN_OMP_PARALLEL_FOR
         for(int channel = 0; channel < num_channels; ++channel) {
           for(int j = 0; j < num_per_input_channel; ++j) {
             const int input_index = j + channel * num_per_input_channel;
-            const int max_index = indices_buffer[input_index];
+            const int max_index
+              = m_max_pool_indices.get(indices_offset + input_index);
             DataType *im2col_buffer = im2col_mat.Buffer(channel*m_pool_size, j);
             im2col_buffer[max_index]
               = gradient_wrt_output_buffer[input_index];
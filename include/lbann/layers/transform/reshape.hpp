@@ -48,6 +48,8 @@ public:
   std::string get_type() const override { return "reshape"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_output_views() const override { return false; }
+  bool supports_error_signal_views() const override { return false; }
 
 protected:
 
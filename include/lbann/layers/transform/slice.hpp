@@ -77,6 +77,8 @@ public:
   std::string get_type() const override { return "slice"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_output_views() const override { return false; }
+  bool supports_error_signal_views() const override { return false; }
 
   /** Get slice points. */
   std::vector<El::Int>& get_slice_points() { return m_slice_points; }
@@ -94,6 +96,20 @@ public:
     return desc;
   }
 
+  /** Each output's error signal is a contiguous range of rows in the
+   *  error signal if there is only one block per slice, i.e. all
+   *  dimensions before the slice dimension are one. The slices must
+   *  cover the input tensor so no rows need to be zeroed.
+   */
+  bool provides_child_error_signal_view(int child_index) const override {
+    const auto& input_dims = get_input_dims();
+    return (T_layout == data_layout::DATA_PARALLEL
+            && get_blocks_per_slice() == 1
+            && m_slice_points[0] == 0
+            && (m_slice_points[get_num_children()]
+                == input_dims[m_slice_dim]));
+  }
+
 protected:
 
   void setup_matrices(const El::Grid& grid) override {
@@ -212,15 +228,30 @@ protected:
 
   }
 
+  void setup_child_error_signal_view(const Layer& child,
+                                     El::Int mini_batch_size,
+                                     AbsDistMat& error_signal) override {
+    const auto& children = get_child_layers();
+    const auto& child_index = (std::find(children.begin(), children.end(),
+                                         &child)
+                               - children.begin());
+    const auto& unit_block_size = get_unit_block_size();
+    setup_error_signal_buffer(mini_batch_size);
+    El::View(error_signal, get_error_signals(),
+             El::IR(m_slice_points[child_index] * unit_block_size,
+                    m_slice_points[child_index+1] * unit_block_size),
+             El::ALL);
+  }
+
   void bp_setup_gradient_wrt_inputs(El::Int mini_batch_size) override {
     const auto& num_outputs = get_num_children();
     const auto& input_dims = get_input_dims();
 
     // Initialize gradient w.r.t. input tensor
+    // Note: Children may have already written into the gradient
+    // w.r.t. input tensor if it provides their error signals.
     auto& gradient_wrt_input = get_error_signals();
-    gradient_wrt_input.Empty(false);
-    gradient_wrt_input.AlignWith(get_prev_activations());
-    gradient_wrt_input.Resize(get_input_size(), mini_batch_size);
+    setup_error_signal_buffer(mini_batch_size);
     if (m_slice_points[0] != 0
         || m_slice_points[num_outputs] != input_dims[m_slice_dim]) {
       El::Zero(gradient_wrt_input);
@@ -251,6 +282,14 @@ protected:
       const auto& block_size = output_num_unit_slices * unit_block_size;
       const auto& input_block_offset = m_slice_points[i] * unit_block_size;
 
+      // Nothing to be done if gradient is already in error signal
+      if (T_layout == data_layout::DATA_PARALLEL
+          && blocks_per_slice == 1
+          && is_local_view(gradient_wrt_output, gradient_wrt_input,
+                           input_block_offset)) {
+        continue;
+      }
+
       // Populate gradient w.r.t. input tensor one block at a time
       for (int block = 0; block < blocks_per_slice; ++block) {
         const auto& input_offset = (input_block_offset
@@ -274,6 +313,52 @@ protected:
 
 private:
 
+  /** Number of contiguous blocks in each unit slice of the input. */
+  El::Int get_blocks_per_slice() const {
+    const auto& input_dims = get_input_dims();
+    return std::accumulate(input_dims.begin(),
+                           input_dims.begin() + m_slice_dim,
+                           1, std::multiplies<int>());
+  }
+
+  /** Size of contiguous block in each unit slice of the input. */
+  El::Int get_unit_block_size() const {
+    const auto& input_dims = get_input_dims();
+    return std::accumulate(input_dims.begin() + m_slice_dim + 1,
+                           input_dims.end(),
+                           1, std::multiplies<int>());
+  }
+
+  /** Allocate gradient w.r.t. input tensor if needed.
+   *  The tensor is only reallocated if its size changes, so views
+   *  from child layers remain valid within a mini-batch step.
+   */
+  void setup_error_signal_buffer(El::Int mini_batch_size) {
+    auto& gradient_wrt_input = get_error_signals();
+    if (gradient_wrt_input.Viewing()
+        || gradient_wrt_input.Height() != get_input_size()
+        || gradient_wrt_input.Width() != mini_batch_size) {
+      gradient_wrt_input.Empty(false);
+      gradient_wrt_input.AlignWith(get_prev_activations());
+      gradient_wrt_input.Resize(get_input_size(), mini_batch_size);
+    }
+  }
+
+  /** Whether a matrix is a view into rows of another matrix.
+   *  Only checks local data.
+   */
+  static bool is_local_view(const AbsDistMat& view,
+                            const AbsDistMat& mat,
+                            El::Int row_offset) {
+    const auto& local_view = view.LockedMatrix();
+    const auto& local_mat = mat.LockedMatrix();
+    return (local_view.Width() > 0
+            && local_view.Width() == local_mat.Width()
+            && local_view.LDim() == local_mat.LDim()
+            && (local_view.LockedBuffer()
+                == local_mat.LockedBuffer(row_offset, 0)));
+  }
+
   /** Tensor dimension to slice. */
   El::Int m_slice_dim;
   /** Slice points for each child layer. */
@@ -47,6 +47,7 @@ public:
   std::string get_type() const override { return "stop_gradient"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_output_views() const override { return false; }
 
 protected:
   void setup_dims() override {
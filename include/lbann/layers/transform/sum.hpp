@@ -45,6 +45,7 @@ public:
   std::string get_type() const override { return "sum"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_error_signal_views() const override { return false; }
 
 protected:
 
@@ -81,6 +81,10 @@ class weights_layer : public transform_layer {
   std::string get_type() const override { return "weights"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool has_constant_outputs() const override {
+    return (!this->m_weights.empty()
+            && this->m_weights[0]->get_optimizer() == nullptr);
+  }
 
  protected:
 
@@ -57,6 +57,7 @@
 #include "lbann/layers/loss/l2_norm2.hpp"
 #include "lbann/layers/loss/mean_absolute_error.hpp"
 #include "lbann/layers/loss/mean_squared_error.hpp"
+#include "lbann/layers/loss/softmax_cross_entropy.hpp"
 #include "lbann/layers/loss/top_k_categorical_accuracy.hpp"
 
 /// Math layers
@@ -158,6 +159,7 @@
 #include "lbann/callbacks/monitor_io.hpp"
 #include "lbann/callbacks/perturb_adam.hpp"
 #include "lbann/callbacks/perturb_dropout.hpp"
+#include "lbann/callbacks/pipeline_plan.hpp"
 #include "lbann/callbacks/print_statistics.hpp"
 #include "lbann/callbacks/profiler.hpp"
 #include "lbann/callbacks/replace_weights.hpp"
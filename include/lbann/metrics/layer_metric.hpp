@@ -63,6 +63,8 @@ class layer_metric : public metric {
 
   void setup(model& m) override;
   EvalType evaluate(execution_mode mode, int mini_batch_size) override;
+  void evaluate_deferred(execution_mode mode, int mini_batch_size) override;
+  void flush_deferred(execution_mode mode) override;
 
   /** Computation to evaluate the metric function (deprecated).
    *  This function is not called since the 'evaluate' function is
@@ -84,6 +86,8 @@ class layer_metric : public metric {
   std::string m_unit;
   /** Corresponding layer. */
   Layer* m_layer;
+  /** Deferred value consumer ID in the evaluation layer. */
+  int m_deferred_consumer = -1;
 
   /** Get corresponding evaluation layer. */
   abstract_evaluation_layer& get_evaluation_layer();
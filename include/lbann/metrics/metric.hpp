@@ -121,6 +121,19 @@ class metric {
    */
   virtual EvalType evaluate(execution_mode mode, int mini_batch_size) = 0;
 
+  /** Record a mini-batch step with deferred evaluation.
+   *  Metrics that support deferred evaluation count the mini-batch
+   *  samples immediately and add values once their reductions
+   *  complete. Other metrics are evaluated as usual.
+   */
+  virtual void evaluate_deferred(execution_mode mode, int mini_batch_size) {
+    evaluate(mode, mini_batch_size);
+  }
+  /** Wait for deferred reductions so that statistics are exact.
+   *  Must be called by all processes.
+   */
+  virtual void flush_deferred(execution_mode mode) {}
+
   /** Clear all statistics. */
   void reset_statistics() { m_statistics.clear(); }
   /** Clear statistics for an execution mode. */
@@ -32,6 +32,7 @@
 #include "lbann/layers/layer.hpp"
 #include "lbann/utils/summary.hpp"
 #include "lbann/utils/graph.hpp"
+#include "lbann/utils/step_timing.hpp"
 #include "lbann/io/file_io.hpp"
 #include "lbann/io/persist.hpp"
 #include "lbann/objective_functions/objective_function.hpp"
@@ -40,6 +41,7 @@
 #include "lbann/optimizers/optimizer.hpp"
 #include "lbann/utils/threads/thread_pool.hpp"
 
+#include <memory>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -105,6 +107,14 @@ public:
     return m_metrics;
   }
 
+  /** @brief Breakdown of mini-batch step times.
+   *  @details Steps are recorded for the current training epoch and
+   *  the most recent evaluation in each mode.
+   */
+  const step_timing& get_step_timing() const noexcept {
+    return m_step_timing;
+  }
+
   /** @brief Size of model's list of layers. */
   El::Int get_num_layers() const noexcept;
   /** @param pos Position in model's list of layers. */
@@ -224,6 +234,161 @@ public:
   /** @brief Are background I/O activities enabled by the input layers */
   bool background_io_activity_allowed() { return m_background_io_allowed; }
 
+  /** @brief Recompute activations during backprop.
+   *
+   *  Layer outputs between activation checkpoints are freed after
+   *  training forward prop and recomputed when backprop reaches
+   *  them. If no layer is marked as a checkpoint, checkpoints are
+   *  chosen at cut points of the layer graph that are at least @c
+   *  checkpoint_interval layers apart. A non-positive interval
+   *  defaults to the square root of the number of layers.
+   *
+   *  Activations that do not contribute to any weight gradient may
+   *  not be restored if backprop terminates early. Must be called
+   *  before setup.
+   */
+  void set_activation_recomputation(bool enable,
+                                    El::Int checkpoint_interval = 0);
+
+  /** @brief Fuse chains of entry-wise layers.
+   *
+   *  During setup, each chain of CPU entry-wise layers with matching
+   *  data layouts is replaced by a @c fused_entrywise_layer that
+   *  takes the name of the last layer in the chain. Intermediate
+   *  layers in a chain are no longer accessible from the model.
+   *  Similarly, a ReLU layer that follows a CPU batch normalization
+   *  layer is applied by the batch normalization layer and removed
+   *  from the model.
+   *
+   *  Must be called before setup.
+   */
+  void set_entrywise_layer_fusion(bool enable) {
+    m_fuse_entrywise_layers = enable;
+  }
+
+  /** @brief Build model for forward-only inference.
+   *
+   *  Weights do not have optimizers and layers do not allocate
+   *  backprop tensors, so the model cannot be trained. Before the
+   *  first forward prop step, batch normalization layers are folded
+   *  into the weights of preceding convolution and fully-connected
+   *  layers, unless other layers share those weights. Outputs of layers that only depend on constant and
+   *  weights layers are computed once and then reused.
+   *
+   *  Must be called before setup.
+   */
+  void set_frozen_model(bool frozen) { m_frozen_model = frozen; }
+  /** @brief Whether the model is built for forward-only inference. */
+  bool is_frozen_model() const noexcept { return m_frozen_model; }
+
+  /** @brief Defer objective function and metric reductions.
+   *
+   *  Evaluation layers accumulate local values over @c window
+   *  mini-batch steps and reduce them with one non-blocking
+   *  allreduce per window instead of one per step. Statistics are
+   *  exact after @c flush_deferred_evaluation, which is called at
+   *  the end of every epoch and evaluation and when the execution
+   *  mode changes. A window of one or less disables deferral.
+   *
+   *  Must be called before setup.
+   */
+  void set_deferred_evaluation(El::Int window) {
+    m_deferred_evaluation_window = window;
+  }
+  /** @brief Mini-batch steps per deferred evaluation reduction. */
+  El::Int get_deferred_evaluation() const noexcept {
+    return m_deferred_evaluation_window;
+  }
+
+  /** @brief Keep activations and error signals in reduced precision
+   *  between uses.
+   *
+   *  During training, fully-connected, batch normalization, and
+   *  entry-wise CPU layers keep their input in @c format after
+   *  forward prop and the parent's output is released until the
+   *  layer's backprop. Their error signals are kept the same way
+   *  until the parent's backprop if other layers run in between.
+   *  Computation, weights, and optimizer state stay in full
+   *  precision, so the weights are the master copy. Released tensors
+   *  are empty when model-level forward prop callbacks run. With
+   *  float16, loss scaling (see @c objective_function) keeps small
+   *  error signals representable.
+   *
+   *  Must be called before setup.
+   */
+  void set_reduced_precision_storage(storage_format format) {
+    m_reduced_precision_storage = format;
+  }
+  /** @brief Format of activations and error signals between uses. */
+  storage_format get_reduced_precision_storage() const noexcept {
+    return m_reduced_precision_storage;
+  }
+
+  /** @brief Run layers as a pipeline of stages on subsets of the
+   *  trainer's processes.
+   *
+   *  Layers other than input layers are split in execution order
+   *  into @c num_stages contiguous stages with equal numbers of
+   *  layers, or at @c stage_boundaries if given (the names of the
+   *  first layer of every stage after the first, e.g. from the
+   *  pipeline plan callback). Stage @f$s@f$ runs on trainer ranks
+   *  @f$[sG,(s+1)G)@f$ with @f$G@f$ the number of processes per
+   *  trainer divided by @c num_stages. Input layers run on every
+   *  process. Each mini-batch is split into @c num_micro_batches
+   *  micro-batches that flow through the stages with a
+   *  one-forward-one-backward schedule. Activations and error
+   *  signals that cross stages are sent point-to-point between
+   *  processes with the same rank in their stage.
+   *
+   *  Stages other than the last recompute a micro-batch's forward
+   *  prop before its backprop, so they keep the activations of one
+   *  micro-batch. Weights are replicated over the trainer and their
+   *  gradients are summed over all processes. Only CPU data-parallel
+   *  layers are supported, layers that cannot be recomputed (see
+   *  @c Layer::supports_recomputation) must be in the last stage
+   *  unless they are evaluation layers, and weights may not be
+   *  shared between stages.
+   *
+   *  Must be called before setup.
+   */
+  void set_pipeline_parallelism(El::Int num_stages,
+                                El::Int num_micro_batches,
+                                std::vector<std::string> stage_boundaries = {});
+  /** @brief Number of pipeline stages. */
+  El::Int get_num_pipeline_stages() const noexcept {
+    return m_num_pipeline_stages;
+  }
+  /** @brief Number of micro-batches per pipelined mini-batch. */
+  El::Int get_num_micro_batches() const noexcept {
+    return m_num_micro_batches;
+  }
+  /** @brief Pipeline stage that runs a layer.
+   *  @details Input layers run on every process and return -1.
+   */
+  El::Int get_pipeline_stage(const Layer& l) const;
+  /** @brief Pipeline stage of this process. */
+  El::Int get_pipeline_stage() const noexcept { return m_pipeline_stage; }
+  /** @brief Process grid that a layer's tensors are distributed
+   *  over.
+   *  @details The grid of this process's pipeline stage for layers
+   *  in that stage and the trainer grid otherwise.
+   */
+  const El::Grid& get_layer_grid(const Layer& l) const;
+  /** @brief Fraction of pipelined step time that this process spent
+   *  waiting for tensors from other stages.
+   *  @details Measured over all pipelined steps since setup. This is
+   *  the process's share of the pipeline bubble.
+   */
+  EvalType get_pipeline_bubble_fraction() const;
+
+  /** @brief Complete deferred reductions so that objective function
+   *  and metric statistics are exact.
+   *  @details Callbacks that need fresh statistics in the middle of
+   *  an epoch should call this. Must be called by all processes in
+   *  the trainer.
+   */
+  void flush_deferred_evaluation();
+
   // ===========================================
   // Setup
   // ===========================================
@@ -242,6 +407,15 @@ public:
   /** @brief Train model. */
   virtual void train(int num_epochs, int num_batches=0);
 
+  /** @brief Forward prop on a mini-batch for inference.
+   *
+   *  Callbacks, the objective function, and metrics are not invoked
+   *  and evaluation layers are skipped. Input layers should be
+   *  provided samples with
+   *  @c generic_input_layer::set_external_samples.
+   */
+  virtual void infer_mini_batch();
+
   /** @brief Complete any background I/O data fetch for the execution
       mode requested */
   virtual void collect_background_data_fetch(execution_mode mode);
@@ -340,6 +514,19 @@ protected:
    *  Called in setup function.
    */
   virtual void setup_layer_execution_order();
+  /** @brief Replace chains of entry-wise layers with fused layers.
+   *
+   *  Called in setup function after the layer execution order is
+   *  set up and only if layer fusion is enabled.
+   */
+  virtual void fuse_entrywise_layers();
+  /** @brief Assign layers to pipeline stages.
+   *
+   *  Called in setup function before layers are set up and only if
+   *  pipeline parallelism is enabled. Creates the process grid of
+   *  this process's stage.
+   */
+  virtual void setup_pipeline_stages();
   /** @brief Set up layers.
    *
    *  Called in setup function.
@@ -352,6 +539,56 @@ protected:
    *  weights are deleted.
    */
   virtual void setup_weights();
+  /** @brief Set up activation recomputation.
+   *
+   *  Called in setup function after layers are set up. Partitions
+   *  the layer list into segments that are recomputed during
+   *  backprop.
+   */
+  virtual void setup_activation_recomputation();
+  /** @brief Place layer tensors in memory provided by neighbors.
+   *
+   *  Called in setup function after activation recomputation is set
+   *  up. If a layer can provide memory for a parent's output (e.g.
+   *  concatenation) or a child's error signal (e.g. slice), and the
+   *  neighbor's data layout, device, and tensor setup allow it, the
+   *  neighbor writes directly into a view of the layer's tensor
+   *  instead of the layer copying it. Layers whose activations are
+   *  freed for recomputation are excluded.
+   */
+  virtual void setup_tensor_views();
+  /** @brief Compute entry-wise layers in place.
+   *
+   *  Called in setup function after tensor views are set up. An
+   *  entry-wise layer with one parent and one child computes its
+   *  error signal over its child's error signal. In frozen models,
+   *  it computes its output over its parent's output if no other
+   *  layer consumes it. Layers bind to their neighbors' tensors
+   *  during forward and backward prop, so chains of entry-wise
+   *  layers share a single buffer.
+   */
+  virtual void setup_in_place_tensors();
+  /** @brief Choose tensors to keep in reduced precision.
+   *
+   *  Called in setup function after in-place tensors are set up. A
+   *  layer that supports reduced-precision storage keeps its input
+   *  if its parent's output is only consumed by the layer and is not
+   *  recomputed. It keeps its error signal if the parent's backprop
+   *  does not immediately follow its own and the error signal does
+   *  not share memory with a neighbor.
+   */
+  virtual void setup_reduced_precision_storage();
+  /** @brief Report memory that layer tensors could share.
+   *
+   *  Called in setup function after layers are set up. Tensor
+   *  lifetimes are computed over the forward and backward prop
+   *  execution order and a plan packs the buffers into an arena for
+   *  each device. In-place tensors and views alias the buffer they
+   *  share. The model description reports the memory allocated with
+   *  in-place layers and the footprint if all buffers were reused
+   *  according to the plan, which is not applied.
+   */
+  virtual void plan_activation_memory();
 
   /** @brief Reset model pointer and execution mode. */
   virtual void reset_mode_and_model(execution_mode mode);
@@ -359,13 +596,35 @@ protected:
   virtual void reset_epoch_statistics(execution_mode mode);
   /** @brief Evaluate model on a mini-batch */
   virtual bool evaluate_mini_batch(execution_mode mode);
+  /** @brief Update objective function and metric statistics for a
+   *  mini-batch step. */
+  void evaluate_statistics(execution_mode mode);
   /** @brief Train model on a mini-batch. */
   virtual bool train_mini_batch();
 
   /** @brief Forward propagation step. */
   virtual void forward_prop(execution_mode mode);
+  /** @brief Fold layers and find constant layers in frozen model.
+   *  @details Deferred until the first forward prop step so that
+   *  weights loaded after setup are folded.
+   */
+  virtual void fold_layers_for_inference();
+  /** @brief Whether to reuse a layer's outputs from a previous
+   *  forward prop step.
+   */
+  bool reuse_constant_outputs(El::Int pos);
   /** @brief Backward propagation step. */
   virtual void backward_prop();
+  /** @brief Forward and backward prop through pipeline stages.
+   *
+   *  Input layers run on every process. Each process then runs its
+   *  stage's part of the one-forward-one-backward schedule
+   *  over micro-batches, or only forward prop if @c backprop is
+   *  false. Evaluation layers end up with their mini-batch values
+   *  on every process.
+   */
+  virtual void pipeline_forward_backward_prop(execution_mode mode,
+                                              bool backprop);
   /** @brief Clear each optimizer's gradient.
    *
    *  This must be called before training forward prop since layers
@@ -502,6 +761,159 @@ private:
   /** @brief Flag that allows input layers to fetch data in the background */
   bool m_background_io_allowed = true;
 
+  /** @brief Whether to recompute activations during backprop. */
+  bool m_recompute_activations = false;
+  /** @brief Minimum distance between automatically chosen
+   *  activation checkpoints.
+   */
+  El::Int m_activation_checkpoint_interval = 0;
+  /** @brief Layers that are recomputed during backprop.
+   *  @details Each entry is the first and last position of a segment
+   *  in the layer list. Segments are in execution order.
+   */
+  std::vector<std::pair<El::Int,El::Int>> m_recompute_segments;
+  /** @brief Whether a layer's activations are freed after forward
+   *  prop.
+   *  @details A layer is only freed if all of its children are in
+   *  the same segment.
+   */
+  std::vector<bool> m_free_activations;
+  /** @brief Whether a layer is rerun during backprop.
+   *  @details Includes freed layers and layers with freed parents.
+   */
+  std::vector<bool> m_rerun_forward_prop;
+
+  /** @brief Local memory (in bytes) for layer tensors if each tensor
+   *  is allocated separately.
+   */
+  El::Int m_naive_activation_memory = 0;
+  /** @brief Local memory (in bytes) for layer tensors that in-place
+   *  layers do not allocate.
+   */
+  El::Int m_in_place_activation_memory = 0;
+  /** @brief Local memory (in bytes) for layer tensors if buffers
+   *  were reused according to the static memory plan.
+   */
+  El::Int m_planned_activation_memory = 0;
+
+  /** @brief Whether to fuse chains of entry-wise layers. */
+  bool m_fuse_entrywise_layers = false;
+  /** @brief Number of layers replaced by fused entry-wise layers. */
+  El::Int m_num_fused_layers = 0;
+  /** @brief Memory passes over layer tensors saved per training step
+   *  by fusing entry-wise layers.
+   */
+  El::Int m_num_saved_memory_passes = 0;
+
+  /** @brief Number of output tensors placed in a child's memory. */
+  El::Int m_num_output_views = 0;
+  /** @brief Number of error signals placed in a parent's memory. */
+  El::Int m_num_error_signal_views = 0;
+  /** @brief Number of outputs computed over a parent's output. */
+  El::Int m_num_in_place_outputs = 0;
+  /** @brief Number of error signals computed over a child's error
+   *  signal.
+   */
+  El::Int m_num_in_place_error_signals = 0;
+
+  /** @brief Format of activations and error signals between uses. */
+  storage_format m_reduced_precision_storage = storage_format::full;
+  /** @brief Number of layer inputs kept in reduced precision. */
+  El::Int m_num_stored_inputs = 0;
+  /** @brief Number of error signals kept in reduced precision. */
+  El::Int m_num_stored_error_signals = 0;
+  /** @brief Local memory (in bytes) saved by keeping tensors in
+   *  reduced precision.
+   */
+  El::Int m_reduced_precision_saved_memory = 0;
+
+  /** @brief Whether the model is built for forward-only inference. */
+  bool m_frozen_model = false;
+  /** @brief Whether layers have been folded for inference. */
+  bool m_folded_for_inference = false;
+  /** @brief Local memory (in bytes) for backprop tensors and weight
+   *  gradients that a training build would allocate.
+   */
+  El::Int m_frozen_saved_memory = 0;
+  /** @brief Whether each layer's outputs are constant. */
+  std::vector<bool> m_constant_layers;
+  /** @brief Mini-batch size of each constant layer's outputs.
+   *  @details Negative if outputs have not been computed.
+   */
+  std::vector<El::Int> m_constant_mini_batch_sizes;
+
+  /** @brief Breakdown of mini-batch step times. */
+  step_timing m_step_timing;
+
+  /** @brief Mini-batch steps per deferred evaluation reduction. */
+  El::Int m_deferred_evaluation_window = 0;
+  /** @brief Execution mode of steps with deferred reductions. */
+  execution_mode m_deferred_evaluation_mode = execution_mode::invalid;
+
+  /** @brief Number of pipeline stages. */
+  El::Int m_num_pipeline_stages = 1;
+  /** @brief Number of micro-batches per pipelined mini-batch. */
+  El::Int m_num_micro_batches = 1;
+  /** @brief Names of the first layer of each pipeline stage after
+   *  the first.
+   *  @details Empty if stages are chosen automatically.
+   */
+  std::vector<std::string> m_pipeline_stage_boundaries;
+  /** @brief Pipeline stage of each layer in the layer list.
+   *  @details -1 for input layers.
+   */
+  std::vector<El::Int> m_pipeline_stages;
+  /** @brief Pipeline stage of this process. */
+  El::Int m_pipeline_stage = 0;
+  /** @brief Process grid of this process's pipeline stage. */
+  std::shared_ptr<El::Grid> m_pipeline_grid;
+  /** @brief Time (in seconds) spent in pipelined steps. */
+  EvalType m_pipeline_time = 0;
+  /** @brief Time (in seconds) spent in pipelined steps waiting for
+   *  other stages.
+   */
+  EvalType m_pipeline_wait_time = 0;
+
+  /** @brief Tensors exchanged between layers in different pipeline
+   *  stages.
+   *  @details Buffers are allocated for every micro-batch since a
+   *  stage may run several forward props before a backprop.
+   */
+  struct pipeline_transfer {
+    /** Position of the parent layer in the layer list. */
+    El::Int parent_pos;
+    /** Position of the child layer in the layer list. */
+    El::Int child_pos;
+    /** Index of the child among the parent's children. */
+    int output_index;
+    /** Index of the parent among the child's parents. */
+    int input_index;
+    /** Output of an input layer replicated over the trainer. */
+    std::unique_ptr<AbsDistMat> replicated_output;
+    /** Child's input tensor for each micro-batch. */
+    std::vector<std::unique_ptr<AbsDistMat>> inputs;
+    /** Parent's gradient w.r.t. output tensor for each
+     *  micro-batch. */
+    std::vector<std::unique_ptr<AbsDistMat>> gradients;
+    /** Local matrices being sent for each micro-batch. */
+    std::vector<CPUMat> send_buffers;
+    /** Receive requests for each micro-batch. */
+    std::vector<El::mpi::Request<DataType>> recv_requests;
+    /** Send requests for each micro-batch. */
+    std::vector<El::mpi::Request<DataType>> send_requests;
+  };
+  /** @brief Tensors exchanged between pipeline stages.
+   *  @details Set up at the first pipelined step. Sorted by parent
+   *  position and then by output index, which is the order in which
+   *  forward prop produces them.
+   */
+  std::vector<pipeline_transfer> m_pipeline_transfers;
+
+  /** @brief Set up buffers for tensors exchanged between pipeline
+   *  stages.
+   */
+  void setup_pipeline_transfers();
+
   // ===========================================
   // Functions to add utility layers
   // ===========================================
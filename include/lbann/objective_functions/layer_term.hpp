@@ -51,6 +51,9 @@ public:
 
   EvalType finish_evaluation() override;
 
+  bool supports_deferred_evaluation() const override { return true; }
+  EvalType collect_deferred_evaluation(bool flush) override;
+
   void differentiate() override;
 
   void compute_weight_regularization() override {};
@@ -60,6 +63,9 @@ private:
   /** Get corresponding evaluation layer. */
   abstract_evaluation_layer& get_evaluation_layer();
 
+  /** Deferred value consumer ID in the evaluation layer. */
+  int m_deferred_consumer = -1;
+
 };
 
 } // namespace lbann
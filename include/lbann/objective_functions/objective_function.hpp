@@ -73,6 +73,22 @@ class objective_function {
    */
   EvalType finish_evaluation(execution_mode mode, int mini_batch_size);
 
+  /** Record a mini-batch step with deferred evaluation.
+   *  Used instead of finish_evaluation when evaluation layers defer
+   *  their reductions (see
+   *  @c abstract_evaluation_layer::set_deferred_evaluation). The
+   *  mini-batch samples are counted immediately. Terms that support
+   *  deferred evaluation add their values once their reductions
+   *  complete, so statistics may lag behind until
+   *  flush_deferred_evaluation is called. Other terms are evaluated
+   *  as usual.
+   */
+  void finish_deferred_evaluation(execution_mode mode, int mini_batch_size);
+  /** Wait for deferred reductions so that statistics are exact.
+   *  Must be called by all processes.
+   */
+  void flush_deferred_evaluation(execution_mode mode);
+
   /** Compute the objective function gradient.
    *  The gradient is with respect to the objective function inputs
    */
@@ -115,6 +131,56 @@ class objective_function {
     m_differentiation_time = 0.0;
   }
 
+  /** Get loss scaling factor. */
+  EvalType get_loss_scale() const { return m_loss_scale; }
+  /** Set loss scaling factor.
+   *  Gradient contributions from each term are multiplied by the loss
+   *  scale so that small error signals do not underflow in
+   *  reduced-precision arithmetic. The model is responsible for
+   *  removing the loss scale from the weight gradients before the
+   *  optimization step. The objective function value is not scaled.
+   */
+  void set_loss_scale(EvalType loss_scale);
+  /** Whether the loss scale is adjusted during training. */
+  bool get_dynamic_loss_scaling() const { return m_dynamic_loss_scaling; }
+  /** Enable or disable dynamic loss scaling.
+   *  With dynamic loss scaling, the loss scale is halved whenever
+   *  the weight gradients overflow and doubled after
+   *  @c growth_interval consecutive steps without overflow.
+   */
+  void set_dynamic_loss_scaling(bool enable, El::Int growth_interval = 2000);
+  /** Update loss scale after computing weight gradients.
+   *  @param gradients_finite  Whether all weight gradients are
+   *                           finite.
+   *  @returns                 Whether the optimization step should
+   *                           be applied.
+   */
+  bool update_loss_scale(bool gradients_finite);
+
+  /** Save dynamic loss scaling state to checkpoint.
+   *  The state is written to a separate "loss_scale" file in the
+   *  checkpoint directory. Nothing is written if dynamic loss scaling
+   *  is disabled.
+   */
+  bool save_to_checkpoint_shared(persist& p, lbann_comm& comm);
+  /** Load dynamic loss scaling state from checkpoint.
+   *  Checkpoints without loss scaling state, e.g. from runs without
+   *  dynamic loss scaling, keep the configured loss scale.
+   */
+  bool load_from_checkpoint_shared(persist& p, lbann_comm& comm);
+  /** Save dynamic loss scaling state to checkpoint.
+   *  The state is written to a separate "loss_scale" file in the
+   *  checkpoint directory. Nothing is written if dynamic loss scaling
+   *  is disabled.
+   */
+  bool save_to_checkpoint_distributed(persist& p);
+  /** Load dynamic loss scaling state from checkpoint.
+   *  The trainer master's state is used on every process.
+   *  Checkpoints without loss scaling state keep the configured loss
+   *  scale.
+   */
+  bool load_from_checkpoint_distributed(persist& p, lbann_comm& comm);
+
  private:
 
   /** List of objective function terms. */
@@ -128,6 +194,23 @@ class objective_function {
   /** Time spent computing the objective function gradient. */
   EvalType m_differentiation_time = EvalType(0);
 
+  /** Loss scaling factor for gradient contributions. */
+  EvalType m_loss_scale = EvalType(1);
+  /** Whether the loss scale is adjusted during training. */
+  bool m_dynamic_loss_scaling = false;
+  /** Number of steps without overflow before increasing loss scale. */
+  El::Int m_loss_scale_growth_interval = 2000;
+  /** Number of consecutive steps without overflow. */
+  El::Int m_num_finite_steps = 0;
+
+  /** Write loss scaling state to a checkpoint directory. */
+  void write_loss_scale(const std::string& dir) const;
+  /** Read loss scaling state from a checkpoint directory on the
+   *  trainer master and broadcast it.
+   *  The state is unchanged if the checkpoint does not have it.
+   */
+  void read_loss_scale(const std::string& dir, lbann_comm& comm);
+
 };
 
 } // namespace lbann
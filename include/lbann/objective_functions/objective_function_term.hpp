@@ -64,6 +64,16 @@ class objective_function_term {
   /** Complete evaluation of the objective function term. */
   virtual EvalType finish_evaluation() = 0;
 
+  /** Whether the term supports deferred evaluation.
+   *  See @c objective_function::finish_deferred_evaluation.
+   */
+  virtual bool supports_deferred_evaluation() const { return false; }
+  /** Get the sum of values times mini-batch sizes over mini-batch
+   *  steps whose deferred evaluation has completed since the last
+   *  call. This should include the scaling factor.
+   */
+  virtual EvalType collect_deferred_evaluation(bool flush) { return EvalType(0); }
+
   /** Compute the gradient of the objective function term.
    *  The gradient is computed w.r.t. the objective function term
    *  inputs. This should include the scaling factor.
@@ -84,10 +94,19 @@ class objective_function_term {
   /** Set list of pointers to weights. */
   void set_weights_pointers(std::vector<weights*> w) { m_weights = w; }
 
+  /** Set loss scaling factor.
+   *  The loss scale is applied to gradient contributions but not to
+   *  the objective function value. See
+   *  @c objective_function::set_loss_scale.
+   */
+  void set_loss_scale(EvalType loss_scale) { m_loss_scale = loss_scale; }
+
  protected:
 
   /** Scaling factor for objective function term. */
   EvalType m_scale_factor;
+  /** Loss scaling factor for gradient contributions. */
+  EvalType m_loss_scale = EvalType(1);
 
   /** Layers used to compute objective function term. */
   std::vector<Layer*> m_layers;
@@ -59,6 +59,14 @@ protected:
 
   /** Computation for an optimization step. */
   void step_compute(AbsDistMat& values, const AbsDistMat& gradient) override;
+  bool supports_sparse_step() const override { return true; }
+  /** Update of the columns with nonzero gradient.
+   *  @details Equivalent to a dense step since the cache does not
+   *  decay.
+   */
+  void sparse_step_compute(AbsDistMat& values,
+                           const std::vector<El::Int>& columns,
+                           const CPUMat& gradient) override;
 
 private:
 
@@ -125,6 +125,14 @@ protected:
   /** Computation for an optimization step. */
   void step_compute(AbsDistMat& values,
                     const AbsDistMat& gradient) override;
+  bool supports_sparse_step() const override { return true; }
+  /** Lazy update of the columns with nonzero gradient.
+   *  @details Moments are only decayed for the updated columns. The
+   *  bias correction uses the global step count.
+   */
+  void sparse_step_compute(AbsDistMat& values,
+                           const std::vector<El::Int>& columns,
+                           const CPUMat& gradient) override;
 
 private:
 
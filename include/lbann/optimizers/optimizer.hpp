@@ -30,6 +30,7 @@
 #include <string>
 #include <memory>
 #include <unordered_set>
+#include <vector>
 #include "lbann/utils/compiler_control.hpp"
 #include "lbann/base.hpp"
 #include "lbann/comm.hpp"
@@ -117,12 +118,47 @@ public:
    *                            assumed to be identical. If true, an
    *                            allreduce is performed lazily when the
    *                            gradient is accessed.
+   *
+   *  Replicated CPU contributions may live on a different process
+   *  grid than the weights, e.g. on a pipeline stage. Only the
+   *  processes in that grid contribute and the sum is formed by the
+   *  gradient allreduce, so every process in the weights' grid must
+   *  have the gradient in the allreduce_needed state (see
+   *  @c get_gradient_buffer).
    */
   void add_to_gradient(const AbsDistMat& gradient,
                        DataType scale = DataType(1),
                        bool allreduce_needed = false);
+  /** @brief Add a column-sparse contribution to the objective
+   *  function gradient w.r.t. the weights.
+   *
+   *  Only the listed columns of the contribution are nonzero,
+   *  e.g. the dictionary entries used by an embedding layer. The
+   *  contributions are exchanged with an allgather over the
+   *  redundant communicator, so communication scales with the number
+   *  of columns rather than the width of the weights matrix. If the
+   *  weights values are not replicated CPU matrices, the
+   *  contribution is densified and added with @c add_to_gradient.
+   *
+   *  @param columns    Column index for each column of
+   *                    @c gradient. Indices may repeat.
+   *  @param gradient   Local contributions to gradient columns.
+   *  @param scale      Scaling factor for gradient contribution.
+   */
+  void add_to_sparse_gradient(const std::vector<El::Int>& columns,
+                              const CPUMat& gradient,
+                              DataType scale = DataType(1));
   /** @brief Zero out the objective function gradient w.r.t. the weights. */
   void clear_gradient();
+  /** @brief Scaling factor applied to every gradient contribution.
+   *
+   *  Used to remove the objective function's loss scale as
+   *  contributions are accumulated, so the gradient is not rescaled
+   *  in a separate pass before the optimization step.
+   */
+  void set_gradient_scale(DataType scale) { m_gradient_scale = scale; }
+  /** @brief Scaling factor applied to every gradient contribution. */
+  DataType get_gradient_scale() const noexcept { return m_gradient_scale; }
   /** @brief Get the gradient buffer.
    *
    *  This provides access to the underlying gradient buffer, which may be
@@ -133,6 +169,7 @@ public:
    *  provides a scaling factor that must be applied to the user's data.
    *  Essentially, this enables computations of the form
    *  gradient = buf_scale*gradient + in_scale*new_gradient
+   *  in_scale includes the gradient scale (see set_gradient_scale).
    *  This is an expert-mode function and is intended to help eliminate copies
    *  and facilitate kernel fusion.
    *
@@ -201,6 +238,23 @@ protected:
   virtual void step_compute(AbsDistMat& values,
                             const AbsDistMat& gradient) = 0;
 
+  /** @brief Whether the optimizer implements @c sparse_step_compute. */
+  virtual bool supports_sparse_step() const { return false; }
+  /** @brief Computation for an optimization step with a
+   *  column-sparse gradient.
+   *
+   *  Called instead of @c step_compute when all gradient
+   *  contributions were added with @c add_to_sparse_gradient. Only
+   *  the listed columns of the weights and of the optimizer state are
+   *  updated ("lazy" updates). @c columns is sorted with no
+   *  duplicates and column @c i of @c gradient corresponds to column
+   *  @c columns[i] of @c values. @c values is a replicated CPU
+   *  matrix.
+   */
+  virtual void sparse_step_compute(AbsDistMat& values,
+                                   const std::vector<El::Int>& columns,
+                                   const CPUMat& gradient);
+
 private:
 
   /** @brief LBANN communicator. */
@@ -220,6 +274,20 @@ private:
    */
   std::unique_ptr<AbsDistMat> m_gradient_v;
 
+  /** @brief Column indices of sparse gradient contributions.
+   *
+   *  Sorted with no duplicates. These contributions have already
+   *  been exchanged over the redundant communicator and are added to
+   *  the dense gradient when it is accessed.
+   */
+  std::vector<El::Int> m_sparse_gradient_columns;
+  /** @brief Sparse gradient contributions.
+   *
+   *  Column-major, with one column for each entry in
+   *  @c m_sparse_gradient_columns.
+   */
+  std::vector<DataType> m_sparse_gradient_values;
+
   /** @brief Sources of gradient contributions.
    *
    *  This set contains pointers to objects (e.g. layers and objective
@@ -235,6 +303,9 @@ private:
   /** @brief Status of values in objective function gradient. */
   optimizer_gradient_status m_gradient_status = optimizer_gradient_status::cleared;
 
+  /** @brief Scaling factor applied to every gradient contribution. */
+  DataType m_gradient_scale = DataType(1);
+
   /** @brief Communication request object for gradient allreduce.
    *
    *  Used to synchronize non-blocking allreduce.
@@ -268,6 +339,9 @@ private:
    */
   void finish_gradient_allreduce();
 
+  /** @brief Add pending sparse contributions to the dense gradient. */
+  void densify_sparse_gradient();
+
 public:
 
   // ===========================================
@@ -98,6 +98,13 @@ protected:
 
   /** Computation for an optimization step. */
   void step_compute(AbsDistMat& values, const AbsDistMat& gradient) override;
+  bool supports_sparse_step() const override { return true; }
+  /** Lazy update of the columns with nonzero gradient.
+   *  @details Velocity is only decayed for the updated columns.
+   */
+  void sparse_step_compute(AbsDistMat& values,
+                           const std::vector<El::Int>& columns,
+                           const CPUMat& gradient) override;
 
 private:
 
@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_DIRECT_POOLING_HPP
+#define LBANN_UTILS_DIRECT_POOLING_HPP
+
+#include "lbann/base.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace lbann {
+
+/// Positions of maximum entries for max pooling
+/** Each entry corresponds to an entry in the pooling output and
+ *  gives the position of the maximum entry within the pooling window
+ *  (row-major over the window dimensions, matching the row ordering
+ *  of im2col). Positions are stored as 16-bit integers when the
+ *  pooling window has at most 2^16 entries and as 32-bit integers
+ *  otherwise, so the index buffer is half the size of the output in
+ *  the common case.
+ */
+class max_pool_indices {
+public:
+
+  /** Resize for a given number of output entries and window size. */
+  void resize(El::Int size, El::Int window_size) {
+    m_wide = window_size > El::Int(1) << 16;
+    if (m_wide) {
+      m_narrow_indices.clear();
+      m_wide_indices.resize(size);
+    } else {
+      m_wide_indices.clear();
+      m_narrow_indices.resize(size);
+    }
+  }
+
+  /** Number of entries. */
+  El::Int size() const {
+    return (m_wide ? m_wide_indices.size() : m_narrow_indices.size());
+  }
+  /** Whether positions are stored as 32-bit integers. */
+  bool is_wide() const { return m_wide; }
+
+  /** Get window position. */
+  int get(El::Int i) const {
+    return (m_wide ? int(m_wide_indices[i]) : int(m_narrow_indices[i]));
+  }
+  /** Set window position. */
+  void set(El::Int i, int index) {
+    if (m_wide) { m_wide_indices[i] = index; }
+    else        { m_narrow_indices[i] = index; }
+  }
+
+  std::uint16_t* narrow_data() { return m_narrow_indices.data(); }
+  const std::uint16_t* narrow_data() const { return m_narrow_indices.data(); }
+  std::uint32_t* wide_data() { return m_wide_indices.data(); }
+  const std::uint32_t* wide_data() const { return m_wide_indices.data(); }
+
+private:
+  bool m_wide = false;
+  std::vector<std::uint16_t> m_narrow_indices;
+  std::vector<std::uint32_t> m_wide_indices;
+};
+
+/// Whether the direct pooling kernels support a tensor
+/** The direct kernels handle 1D, 2D, and 3D spatial data. Other
+ *  cases should fall back to im2col.
+ */
+inline bool direct_pooling_supported(int num_dims) {
+  return 1 <= num_dims && num_dims <= 3;
+}
+
+/// Max pooling forward propagation without im2col
+/** Each column of input and output is a sample. The kernel is
+ *  parallelized over (sample, channel) pairs and vectorized over the
+ *  innermost output dimension. Padding is treated as zeros, matching
+ *  the im2col implementation.
+ *  @param input            Input tensors (one per column).
+ *  @param output           Output tensors (one per column).
+ *  @param indices          Window positions of maximum entries. Is
+ *                          resized to match output.
+ *  @param num_channels     Number of channels.
+ *  @param num_dims         Number of spatial dimensions.
+ *  @param input_dims       Spatial dimensions of input.
+ *  @param pads             Zero pads.
+ *  @param window_dims      Dimensions of pooling window.
+ *  @param strides          Pooling window strides.
+ */
+void max_pool_forward(const CPUMat& input,
+                      CPUMat& output,
+                      max_pool_indices& indices,
+                      int num_channels,
+                      int num_dims,
+                      const int * input_dims,
+                      const int * pads,
+                      const int * window_dims,
+                      const int * strides);
+
+/// Max pooling backward propagation without im2col
+/** The gradient w.r.t. each output entry is added to the input entry
+ *  recorded in indices. Parameters match max_pool_forward.
+ */
+void max_pool_backward(const CPUMat& gradient_wrt_output,
+                       const max_pool_indices& indices,
+                       CPUMat& gradient_wrt_input,
+                       int num_channels,
+                       int num_dims,
+                       const int * input_dims,
+                       const int * pads,
+                       const int * window_dims,
+                       const int * strides);
+
+/// Average pooling forward propagation without im2col
+/** Padding entries are included in the average. Parameters match
+ *  max_pool_forward.
+ */
+void average_pool_forward(const CPUMat& input,
+                          CPUMat& output,
+                          int num_channels,
+                          int num_dims,
+                          const int * input_dims,
+                          const int * pads,
+                          const int * window_dims,
+                          const int * strides);
+
+/// Average pooling backward propagation without im2col
+/** Parameters match max_pool_forward. */
+void average_pool_backward(const CPUMat& gradient_wrt_output,
+                           CPUMat& gradient_wrt_input,
+                           int num_channels,
+                           int num_dims,
+                           const int * input_dims,
+                           const int * pads,
+                           const int * window_dims,
+                           const int * strides);
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_DIRECT_POOLING_HPP
@@ -133,6 +133,35 @@ void apply_entrywise_binary_operator(const AbsMat& input1,
 
 }
 
+/** Apply an entry-wise unary operator to a contiguous CPU buffer.
+ *  The loop is not parallelized, so this may be called within an
+ *  OpenMP parallel region. The input and output may alias.
+ */
+template <typename UnaryOperator>
+inline void apply_entrywise_unary_operator(const DataType* input,
+                                           DataType* output,
+                                           El::Int size) {
+  UnaryOperator op;
+  for (El::Int i = 0; i < size; ++i) {
+    output[i] = op(input[i]);
+  }
+}
+
+/** Apply an entry-wise binary operator to contiguous CPU buffers.
+ *  The loop is not parallelized, so this may be called within an
+ *  OpenMP parallel region. The inputs and output may alias.
+ */
+template <typename BinaryOperator>
+inline void apply_entrywise_binary_operator(const DataType* input1,
+                                            const DataType* input2,
+                                            DataType* output,
+                                            El::Int size) {
+  BinaryOperator op;
+  for (El::Int i = 0; i < size; ++i) {
+    output[i] = op(input1[i], input2[i]);
+  }
+}
+
 /** Apply an entry-wise unary operator to CPU data.
  *  The input and output data must be on CPU, have the same
  *  dimensions, and be aligned.
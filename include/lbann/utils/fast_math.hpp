@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_FAST_MATH_HPP_INCLUDED
+#define LBANN_UTILS_FAST_MATH_HPP_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace lbann {
+namespace fast_math {
+
+/** @brief Exponential function.
+ *
+ *  The single-precision specialization uses a branch-free
+ *  range-reduced polynomial (relative error within a few ulp) so
+ *  that loops calling it can be auto-vectorized. Finite arguments
+ *  outside the normalized range are clamped, so the result never
+ *  underflows to zero. As with @c std::exp, NaN is propagated,
+ *  @f$ e^{\infty} = \infty @f$ and @f$ e^{-\infty} = 0 @f$. Other
+ *  types fall back to @c std::exp.
+ */
+template <typename T>
+inline T exp(T x) { return std::exp(x); }
+
+template <>
+inline float exp<float>(float x) {
+
+  // Clamp to the range where the result is a normalized float
+  // Note: Comparing bit patterns as integers avoids floating-point
+  // compares, which prevent GCC from vectorizing unless trapping
+  // math is disabled. Positive floats order as signed integers and
+  // negative floats order in reverse as unsigned integers.
+  // The bounds are 88.3762626 and -87.3365448.
+  std::int32_t x_bits;
+  std::memcpy(&x_bits, &x, sizeof(x));
+  const std::uint32_t x_in_bits = static_cast<std::uint32_t>(x_bits);
+  x_bits = x_bits < 0x42B0C0A5 ? x_bits : 0x42B0C0A5;
+  std::uint32_t x_ubits = static_cast<std::uint32_t>(x_bits);
+  x_ubits = x_ubits < 0xC2AEAC50u ? x_ubits : 0xC2AEAC50u;
+  std::memcpy(&x, &x_ubits, sizeof(x));
+
+  // Range reduction: x = n log(2) + r, with |r| <= log(2)/2
+  // Note: Adding 1.5*2^23 rounds to the nearest integer and leaves
+  // n in the low mantissa bits.
+  constexpr float shifter = 12582912.f;
+  const float t = x * 1.44269504088896341f + shifter;
+  const float n = t - shifter;
+  float r = x - n * 0.693359375f;
+  r -= n * -2.12194440e-4f;
+
+  // Polynomial approximation of exp(r)
+  float p = 1.9875691500e-4f;
+  p = p * r + 1.3981999507e-3f;
+  p = p * r + 8.3334519073e-3f;
+  p = p * r + 4.1665795894e-2f;
+  p = p * r + 1.6666665459e-1f;
+  p = p * r + 5.0000001201e-1f;
+  p = p * r * r + r + 1.f;
+
+  // Scale by 2^n by constructing the exponent bits directly
+  std::int32_t scale_bits;
+  std::memcpy(&scale_bits, &t, sizeof(t));
+  scale_bits = (scale_bits - 0x4B400000 + 127) << 23;
+  float scale;
+  std::memcpy(&scale, &scale_bits, sizeof(scale));
+  float y = p * scale;
+
+  // Non-finite arguments
+  // Note: NaN and +inf are passed through and -inf maps to zero. The
+  // checks are equivalent to x != x and x == +/-inf, but use bit
+  // masks so the function stays free of floating-point compares and
+  // branches.
+  constexpr std::uint32_t inf_bits = 0x7F800000u;
+  constexpr std::uint32_t neg_inf_bits = 0xFF800000u;
+  std::uint32_t y_bits;
+  std::memcpy(&y_bits, &y, sizeof(y));
+  const std::uint32_t nan_mask
+    = 0u - static_cast<std::uint32_t>((x_in_bits & 0x7FFFFFFFu) > inf_bits);
+  const std::uint32_t inf_mask
+    = 0u - static_cast<std::uint32_t>(x_in_bits == inf_bits);
+  const std::uint32_t neg_inf_mask
+    = 0u - static_cast<std::uint32_t>(x_in_bits == neg_inf_bits);
+  y_bits = (y_bits & ~(nan_mask | inf_mask | neg_inf_mask))
+    | (x_in_bits & (nan_mask | inf_mask));
+  std::memcpy(&y, &y_bits, sizeof(y));
+  return y;
+
+}
+
+/** @brief Maximum and shifted sum of exponentials in a single sweep.
+ *
+ *  On exit, @c max is the maximum of its input value and the entries
+ *  of @c x, and @c sum is @f$ \sum_i e^{x_i - max} @f$ plus the
+ *  input value of @c sum rescaled to the new maximum. Pass
+ *  @c lowest and zero to start a fresh reduction. If any entry is
+ *  NaN, both @c max and @c sum are NaN.
+ *
+ *  Entries are processed in blocks small enough to stay in L1
+ *  cache. The running sum is rescaled whenever a block raises the
+ *  maximum, so the input is streamed from memory once rather than
+ *  once for the maximum and again for the sum.
+ */
+template <typename T, typename Index>
+inline void max_and_sum_exp(const T* x,
+                            Index size,
+                            T& max,
+                            T& sum) {
+  constexpr Index block_size = 256;
+  for (Index start = 0; start < size; start += block_size) {
+    const Index end = std::min(start + block_size, size);
+
+    // Block max
+    // Note: Independent per-lane maxima let the compiler vectorize
+    // the reduction without reassociating floating-point operations.
+    constexpr int num_lanes = 8;
+    T lane_max[num_lanes];
+    std::fill(lane_max, lane_max + num_lanes, max);
+    Index i = start;
+    for (; i + num_lanes <= end; i += num_lanes) {
+      for (int j = 0; j < num_lanes; ++j) {
+        lane_max[j] = lane_max[j] > x[i+j] ? lane_max[j] : x[i+j];
+      }
+    }
+    for (; i < end; ++i) {
+      lane_max[0] = lane_max[0] > x[i] ? lane_max[0] : x[i];
+    }
+    const T block_max = *std::max_element(lane_max, lane_max + num_lanes);
+
+    // Rescale running sum if max has increased
+    if (block_max > max) {
+      sum *= fast_math::exp(max - block_max);
+      max = block_max;
+    }
+
+    // Block sum
+    // Note: The lane maxima skip NaN entries, but exp propagates
+    // them into the block sum.
+    T block_sum = T(0);
+    for (i = start; i < end; ++i) {
+      block_sum += fast_math::exp(x[i] - max);
+    }
+    sum += block_sum;
+    if (block_sum != block_sum) { max = block_sum; }
+  }
+}
+
+} // namespace fast_math
+} // namespace lbann
+
+#endif // LBANN_UTILS_FAST_MATH_HPP_INCLUDED
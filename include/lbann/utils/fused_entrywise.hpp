@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_FUSED_ENTRYWISE_HPP_INCLUDED
+#define LBANN_UTILS_FUSED_ENTRYWISE_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/utils/reduced_precision.hpp"
+#include <vector>
+
+namespace lbann {
+
+/** @brief Interface for layers that can be fused into a
+ *  @c fused_entrywise_layer.
+ *
+ *  The layer must have one input tensor and one output tensor with
+ *  the same dimensions, and each output entry must only depend on
+ *  the corresponding input entry.
+ */
+class entrywise_fusion_interface {
+public:
+  virtual ~entrywise_fusion_interface() = default;
+
+  /** @brief Apply forward prop function to local CPU data.
+   *  @details Computes @f$ y = f(x) @f$. @c x and @c y may alias.
+   */
+  virtual void fp_compute_entrywise(const DataType* x,
+                                    DataType* y,
+                                    El::Int size) const = 0;
+  /** @brief Apply backward prop function to local CPU data.
+   *  @details Computes @f$ dx = f'(x) \, dy @f$. @c dy and @c dx may
+   *  alias.
+   */
+  virtual void bp_compute_entrywise(const DataType* x,
+                                    const DataType* dy,
+                                    DataType* dx,
+                                    El::Int size) const = 0;
+
+};
+
+/** @brief Apply a chain of entry-wise operators in a single pass.
+ *
+ *  Matrices are column-major. Columns are processed in cache-sized
+ *  tiles and all operators are applied to a tile before moving to
+ *  the next one. @c output may alias @c input.
+ */
+void fused_entrywise_fp(
+  const std::vector<const entrywise_fusion_interface*>& ops,
+  El::Int height, El::Int width,
+  const DataType* input, El::Int input_ldim,
+  DataType* output, El::Int output_ldim);
+
+/** @brief Apply a chain of entry-wise operators and keep a
+ *  reduced-precision copy of the input, in a single pass.
+ *
+ *  Each input tile is converted while it is in cache, so storing the
+ *  input does not take an extra sweep over memory. @c stored_input
+ *  is column-major with leading dimension @c height.
+ */
+void fused_entrywise_fp(
+  const std::vector<const entrywise_fusion_interface*>& ops,
+  El::Int height, El::Int width,
+  const DataType* input, El::Int input_ldim,
+  DataType* output, El::Int output_ldim,
+  storage_format stored_input_format, uint16_t* stored_input);
+
+/** @brief Backprop through a chain of entry-wise operators in a
+ *  single pass.
+ *
+ *  Intermediate values are recomputed from @c input within each
+ *  tile. @c gradient_wrt_input may alias @c gradient_wrt_output.
+ *
+ *  @param workspace Per-thread storage for intermediate values.
+ *                   Resized as needed.
+ */
+void fused_entrywise_bp(
+  const std::vector<const entrywise_fusion_interface*>& ops,
+  El::Int height, El::Int width,
+  const DataType* input, El::Int input_ldim,
+  const DataType* gradient_wrt_output, El::Int gradient_wrt_output_ldim,
+  DataType* gradient_wrt_input, El::Int gradient_wrt_input_ldim,
+  std::vector<DataType>& workspace);
+
+/** @brief Backprop through a chain of entry-wise operators with
+ *  tensors kept in reduced precision.
+ *
+ *  If @c stored_input is not null, each input tile is converted back
+ *  into @c input before it is used, so @c input is restored as a
+ *  side effect. Otherwise @c input is only read. If
+ *  @c stored_gradient_wrt_input is not null, each tile of
+ *  @c gradient_wrt_input is also converted into it while it is in
+ *  cache. Stored matrices are column-major with leading dimension
+ *  @c height.
+ */
+void fused_entrywise_bp(
+  const std::vector<const entrywise_fusion_interface*>& ops,
+  El::Int height, El::Int width,
+  storage_format stored_input_format, const uint16_t* stored_input,
+  DataType* input, El::Int input_ldim,
+  const DataType* gradient_wrt_output, El::Int gradient_wrt_output_ldim,
+  DataType* gradient_wrt_input, El::Int gradient_wrt_input_ldim,
+  storage_format stored_gradient_wrt_input_format,
+  uint16_t* stored_gradient_wrt_input,
+  std::vector<DataType>& workspace);
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_FUSED_ENTRYWISE_HPP_INCLUDED
@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_GROUPED_CONVOLUTION_HPP
+#define LBANN_UTILS_GROUPED_CONVOLUTION_HPP
+
+#include "lbann/base.hpp"
+
+namespace lbann {
+
+/// Whether the direct grouped convolution kernels support a tensor
+/** The direct kernels handle 1D, 2D, and 3D spatial data. */
+inline bool direct_grouped_convolution_supported(int num_dims) {
+  return 1 <= num_dims && num_dims <= 3;
+}
+
+/// Grouped convolution forward propagation without im2col
+/** Intended for depthwise and small-group convolution, where each
+ *  group is too small to make good use of GEMM. Each column of input
+ *  and output is a sample. The kernel is a contiguous tensor with
+ *  dimensions (output channels) x (input channels / groups) x
+ *  (spatial dims). The computation is parallelized over (sample,
+ *  output channel) pairs and vectorized over the innermost output
+ *  dimension. Padding is treated as zeros.
+ *  @param input                Input tensors (one per column).
+ *  @param kernel               Convolution kernel.
+ *  @param output               Output tensors (one per column).
+ *  @param num_input_channels   Number of input channels.
+ *  @param num_output_channels  Number of output channels.
+ *  @param num_groups           Number of channel groups.
+ *  @param num_dims             Number of spatial dimensions.
+ *  @param input_dims           Spatial dimensions of input.
+ *  @param pads                 Zero pads.
+ *  @param kernel_dims          Spatial dimensions of kernel.
+ *  @param strides              Convolution strides.
+ */
+void grouped_convolution_forward(const CPUMat& input,
+                                 const CPUMat& kernel,
+                                 CPUMat& output,
+                                 int num_input_channels,
+                                 int num_output_channels,
+                                 int num_groups,
+                                 int num_dims,
+                                 const int * input_dims,
+                                 const int * pads,
+                                 const int * kernel_dims,
+                                 const int * strides);
+
+/// Grouped convolution backward propagation w.r.t. input
+/** Equivalently, grouped transposed convolution. Parallelized over
+ *  (sample, input channel) pairs. Parameters match
+ *  grouped_convolution_forward.
+ */
+void grouped_convolution_backward_data(const CPUMat& gradient_wrt_output,
+                                       const CPUMat& kernel,
+                                       CPUMat& gradient_wrt_input,
+                                       int num_input_channels,
+                                       int num_output_channels,
+                                       int num_groups,
+                                       int num_dims,
+                                       const int * input_dims,
+                                       const int * pads,
+                                       const int * kernel_dims,
+                                       const int * strides);
+
+/// Grouped convolution backward propagation w.r.t. kernel
+/** The kernel gradient, scaled by scale, is added to
+ *  gradient_wrt_kernel. Parallelized over kernel channels, with
+ *  contributions from all local samples reduced by the owning thread.
+ *  Other parameters match grouped_convolution_forward.
+ */
+void grouped_convolution_backward_filter(const CPUMat& input,
+                                         const CPUMat& gradient_wrt_output,
+                                         CPUMat& gradient_wrt_kernel,
+                                         DataType scale,
+                                         int num_input_channels,
+                                         int num_output_channels,
+                                         int num_groups,
+                                         int num_dims,
+                                         const int * input_dims,
+                                         const int * pads,
+                                         const int * kernel_dims,
+                                         const int * strides);
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_GROUPED_CONVOLUTION_HPP
@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_MEMORY_PLANNER_HPP_INCLUDED
+#define LBANN_UTILS_MEMORY_PLANNER_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include <vector>
+
+namespace lbann {
+
+/** @brief Static planner for buffers with known lifetimes.
+ *
+ *  Each buffer is live over an interval of discrete time steps
+ *  (inclusive on both ends). The planner assigns each buffer an
+ *  offset into a single arena so that buffers with overlapping
+ *  lifetimes do not overlap in memory. Offsets are chosen greedily,
+ *  largest buffers first, using the smallest gap that fits.
+ *
+ *  A buffer may alias an earlier buffer, e.g. when an entry-wise
+ *  operation is performed in-place. An alias shares the storage of
+ *  the buffer it aliases and extends its lifetime.
+ */
+class memory_planner {
+public:
+
+  /** @brief Register a buffer.
+   *  @returns Buffer index.
+   */
+  El::Int add_buffer(El::Int size, El::Int first_use, El::Int last_use);
+  /** @brief Register a buffer that reuses another buffer's storage.
+   *  @returns Buffer index.
+   */
+  El::Int add_alias(El::Int buffer, El::Int first_use, El::Int last_use);
+
+  /** @brief Number of registered buffers, including aliases. */
+  El::Int get_num_buffers() const noexcept { return m_buffers.size(); }
+
+  /** @brief Assign offsets to buffers.
+   *  @details Must be called after all buffers are registered.
+   */
+  void plan();
+
+  /** @brief Offset of a buffer within the arena. */
+  El::Int get_offset(El::Int buffer) const;
+  /** @brief Arena size required by the plan. */
+  El::Int get_planned_size() const;
+  /** @brief Memory required if every buffer is allocated separately.
+   *  @details Aliases are not counted.
+   */
+  El::Int get_naive_size() const;
+  /** @brief Memory saved by aliases.
+   *  @details Memory that would be required if each alias were
+   *  allocated separately.
+   */
+  El::Int get_aliased_size() const;
+  /** @brief Maximum memory that is simultaneously live.
+   *  @details This is a lower bound on the planned size.
+   */
+  El::Int get_peak_live_size() const;
+
+private:
+
+  /** @brief Buffer metadata. */
+  struct buffer_info {
+    El::Int size;
+    El::Int first_use;
+    El::Int last_use;
+    /** Index of aliased buffer. Negative if not an alias. */
+    El::Int alias;
+    El::Int offset;
+  };
+
+  /** @brief Registered buffers. */
+  std::vector<buffer_info> m_buffers;
+  /** @brief Arena size. Negative if plan has not been computed. */
+  El::Int m_planned_size = -1;
+
+  /** @brief Get buffer that owns storage for a buffer. */
+  El::Int get_root(El::Int buffer) const;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_MEMORY_PLANNER_HPP_INCLUDED
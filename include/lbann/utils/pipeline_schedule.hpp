@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_PIPELINE_SCHEDULE_HPP_INCLUDED
+#define LBANN_UTILS_PIPELINE_SCHEDULE_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include <vector>
+
+namespace lbann {
+namespace pipeline {
+
+/** @brief Step performed by a pipeline stage. */
+struct operation {
+  /** Whether the step is forward or backward prop. */
+  bool forward;
+  /** Micro-batch index. */
+  El::Int micro_batch;
+};
+
+/** @brief Sequence of operations for each pipeline stage. */
+using schedule = std::vector<std::vector<operation>>;
+
+/** @brief Statistics from a simulated pipeline execution. */
+struct simulation_result {
+  /** Time from first operation start to last operation end. */
+  double total_time = 0;
+  /** Time each stage spends waiting for data. */
+  std::vector<double> idle_times;
+  /** Fraction of stage time spent idle.
+   *  @details Averaged over stages.
+   */
+  double bubble_fraction = 0;
+};
+
+/** @brief Partition a sequence into contiguous pipeline stages.
+ *
+ *  Stages are chosen to minimize the maximum stage cost. Each stage
+ *  is non-empty, so the number of stages is reduced if there are
+ *  fewer costs than requested stages.
+ *
+ *  @param costs      Cost of each item, e.g. layer compute time.
+ *  @param num_stages Requested number of stages.
+ *  @returns Index of first item in each stage.
+ */
+std::vector<El::Int> partition(const std::vector<double>& costs,
+                               El::Int num_stages);
+
+/** @brief Construct a one-forward-one-backward (1F1B) schedule.
+ *
+ *  Stage @f$s@f$ performs @f$p-s-1@f$ warm-up forward steps, where
+ *  @f$p@f$ is the number of stages, and then alternates between
+ *  forward and backward steps. Compared to performing all forward
+ *  steps first (GPipe-style), at most @f$p-s@f$ micro-batches of
+ *  activations are live on each stage.
+ */
+schedule one_forward_one_backward(El::Int num_stages,
+                                  El::Int num_micro_batches);
+
+/** @brief Simulate a pipeline schedule.
+ *
+ *  A forward step depends on the previous stage's forward step for
+ *  the same micro-batch. A backward step depends on the next stage's
+ *  backward step for the same micro-batch and on the stage's own
+ *  forward step. Each stage performs its steps in schedule order.
+ *
+ *  @param steps            Schedule for each stage.
+ *  @param forward_costs    Forward step time for each stage.
+ *  @param backward_costs   Backward step time for each stage.
+ *  @param transfer_time    Time to send a tensor between stages.
+ */
+simulation_result simulate(const schedule& steps,
+                           const std::vector<double>& forward_costs,
+                           const std::vector<double>& backward_costs,
+                           double transfer_time = 0);
+
+} // namespace pipeline
+} // namespace lbann
+
+#endif // LBANN_UTILS_PIPELINE_SCHEDULE_HPP_INCLUDED
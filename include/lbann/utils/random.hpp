@@ -249,6 +249,12 @@ void uniform_fill_procdet(AbsDistMat& mat, El::Int m, El::Int n,
 
 bool save_rng_to_checkpoint_shared(persist& p, const lbann_comm* comm);
 bool load_rng_from_checkpoint_shared(persist& p, const lbann_comm* comm);
+/** Deterministically reseed the rank-specific generators.
+ *  Used when a checkpoint has no state for a rank, e.g. after an
+ *  elastic restart on more ranks than wrote the checkpoint. Requires
+ *  the data sequence generator to be restored first.
+ */
+void reseed_rank_rng_from_checkpoint(int rank);
 
 template<typename DistType,typename DType=DataType>
 class rng {
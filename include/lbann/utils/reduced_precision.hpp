@@ -0,0 +1,186 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_REDUCED_PRECISION_HPP_INCLUDED
+#define LBANN_UTILS_REDUCED_PRECISION_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Floating-point format for tensors kept in memory between
+ *  forward and backward prop.
+ */
+enum class storage_format {
+  /** Same type as computation (@c DataType). */
+  full,
+  /** 8-bit exponent, 7-bit mantissa. Same range as fp32. */
+  bfloat16,
+  /** IEEE half precision. 5-bit exponent, 10-bit mantissa. */
+  float16
+};
+
+std::string to_string(storage_format format);
+/** @brief Parse a storage format name.
+ *  @details Accepts "full", "bfloat16" ("bf16"), and "float16"
+ *  ("fp16"). An empty string is full precision.
+ */
+storage_format storage_format_from_string(const std::string& name);
+
+/** @brief Round to nearest bfloat16 (ties to even). */
+inline uint16_t float_to_bfloat16(float x) {
+  uint32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  if ((bits & 0x7fffffffu) > 0x7f800000u) {
+    return (bits >> 16) | 0x0040u;
+  }
+  bits += 0x7fffu + ((bits >> 16) & 1u);
+  return bits >> 16;
+}
+
+/** @brief Convert bfloat16 to float. This is exact. */
+inline float bfloat16_to_float(uint16_t x) {
+  const uint32_t bits = static_cast<uint32_t>(x) << 16;
+  float y;
+  std::memcpy(&y, &bits, sizeof(y));
+  return y;
+}
+
+/** @brief Round to nearest IEEE half (ties to even).
+ *  @details Values too large for half precision become infinite,
+ *  so overflow is visible to loss scaling.
+ */
+inline uint16_t float_to_float16(float x) {
+  uint32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  const uint32_t sign = (bits >> 16) & 0x8000u;
+  const uint32_t abs = bits & 0x7fffffffu;
+  if (abs > 0x7f800000u) { return sign | 0x7e00u; }
+  if (abs >= 0x477ff000u) { return sign | 0x7c00u; }
+  if (abs < 0x38800000u) {
+    // Subnormal half
+    if (abs < 0x33000000u) { return sign; }
+    const uint32_t exponent = abs >> 23;
+    const uint32_t mantissa = (abs & 0x7fffffu) | 0x800000u;
+    const uint32_t shift = 126 - exponent;
+    uint32_t result = mantissa >> shift;
+    const uint32_t remainder = mantissa & ((1u << shift) - 1);
+    const uint32_t halfway = 1u << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (result & 1u))) {
+      ++result;
+    }
+    return sign | result;
+  }
+  uint32_t result = abs - 0x38000000u;
+  result += 0xfffu + ((result >> 13) & 1u);
+  return sign | (result >> 13);
+}
+
+/** @brief Convert IEEE half to float. This is exact. */
+inline float float16_to_float(uint16_t x) {
+  const uint32_t sign = static_cast<uint32_t>(x & 0x8000u) << 16;
+  const uint32_t exponent = (x >> 10) & 0x1fu;
+  uint32_t mantissa = x & 0x3ffu;
+  uint32_t bits;
+  if (exponent == 0x1fu) {
+    bits = sign | 0x7f800000u | (mantissa << 13);
+  } else if (exponent != 0) {
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  } else if (mantissa == 0) {
+    bits = sign;
+  } else {
+    // Normalize subnormal half
+    uint32_t float_exponent = 113;
+    while ((mantissa & 0x400u) == 0) {
+      mantissa <<= 1;
+      --float_exponent;
+    }
+    bits = sign | (float_exponent << 23) | ((mantissa & 0x3ffu) << 13);
+  }
+  float y;
+  std::memcpy(&y, &bits, sizeof(y));
+  return y;
+}
+
+/** @brief Convert contiguous entries to a reduced-precision format. */
+void encode_reduced_precision(storage_format format,
+                              const DataType* x,
+                              uint16_t* y,
+                              El::Int size);
+/** @brief Convert contiguous reduced-precision entries back to
+ *  @c DataType.
+ */
+void decode_reduced_precision(storage_format format,
+                              const uint16_t* x,
+                              DataType* y,
+                              El::Int size);
+
+/** @brief Local matrix stored in a reduced-precision format.
+ *
+ *  Entries are stored column-major with no padding. Storage is kept
+ *  between uses, so a tensor that is stored every step is not
+ *  reallocated.
+ */
+class reduced_precision_matrix {
+public:
+
+  /** @brief Allocate storage for a matrix.
+   *  @details Entries are left uninitialized.
+   */
+  void resize(storage_format format, El::Int height, El::Int width);
+  /** @brief Convert a matrix and store it. */
+  void store(storage_format format, const AbsMat& x);
+  /** @brief Convert stored entries into a matrix.
+   *  @details The matrix must have the stored dimensions.
+   */
+  void load(AbsMat& x) const;
+
+  storage_format get_format() const noexcept { return m_format; }
+  El::Int get_height() const noexcept { return m_height; }
+  El::Int get_width() const noexcept { return m_width; }
+  uint16_t* get_buffer() noexcept { return m_data.data(); }
+  const uint16_t* get_buffer() const noexcept { return m_data.data(); }
+
+private:
+
+  /** @brief Format of stored entries. */
+  storage_format m_format = storage_format::full;
+  /** @brief Matrix height. */
+  El::Int m_height = 0;
+  /** @brief Matrix width. */
+  El::Int m_width = 0;
+  /** @brief Stored entries. */
+  std::vector<uint16_t> m_data;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_REDUCED_PRECISION_HPP_INCLUDED
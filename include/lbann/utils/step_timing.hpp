@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_STEP_TIMING_HPP_INCLUDED
+#define LBANN_UTILS_STEP_TIMING_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/utils/timer.hpp"
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+// Forward declarations
+class lbann_comm;
+class lbann_summary;
+
+/** @brief Breakdown of mini-batch step time.
+ *
+ *  Attributes the wall time of each mini-batch step to exclusive
+ *  categories: waiting for input data, layer forward and backward
+ *  compute, blocking communication, the optimizer, and callbacks.
+ *  Time that is not claimed by any category (e.g. tensor setup and
+ *  objective function bookkeeping) is reported as "other", so the
+ *  categories always add up to the step time.
+ *
+ *  Code regions are attributed with a @c scope object. Scopes nest:
+ *  a blocking allreduce inside a layer's forward prop compute is
+ *  charged to communication, not to forward prop. Scopes only record
+ *  on the thread that is running a step. An active scope costs two
+ *  clock reads; on other threads a scope only checks a thread-local
+ *  pointer and reads no clock.
+ */
+class step_timing {
+public:
+
+  /** Step time categories. */
+  enum class category {
+    data_wait,
+    fp_compute,
+    bp_compute,
+    comm_wait,
+    optimizer,
+    callbacks,
+    other
+  };
+  static constexpr int num_categories = 7;
+  /** Time (in seconds) spent in each category during a step. */
+  using step_record = std::array<EvalType, num_categories>;
+
+  /** Human-readable name of a category. */
+  static std::string category_name(category c);
+
+  step_timing() = default;
+  step_timing(const step_timing& other);
+  step_timing& operator=(const step_timing& other);
+  ~step_timing();
+
+  /** Start timing a step on the calling thread. */
+  void begin_step();
+  /** Finish timing the current step and record it. */
+  void end_step(execution_mode mode);
+
+  /** Recorded steps for an execution mode. */
+  const std::vector<step_record>& get_steps(execution_mode mode) const;
+  /** Total time in each category over the recorded steps. */
+  step_record get_totals(execution_mode mode) const;
+  /** Discard recorded steps for an execution mode. */
+  void reset(execution_mode mode);
+
+  /** Report recorded steps to the summarizer.
+   *  For each category, writes a histogram of per-step times over
+   *  all steps and processes in the trainer, the mean time per step,
+   *  and the rank imbalance (the largest per-process total divided
+   *  by the mean per-process total). Must be called by every process
+   *  in the trainer.
+   */
+  void summarize(lbann_summary& summarizer,
+                 lbann_comm& comm,
+                 execution_mode mode,
+                 int step) const;
+
+  /** Attribute time to a category while in scope. */
+  class scope {
+  public:
+    explicit scope(category c) : m_timing(active()) {
+      if (m_timing != nullptr) {
+        m_previous = m_timing->m_category;
+        m_timing->switch_category(c);
+      }
+    }
+    ~scope() {
+      if (m_timing != nullptr) { m_timing->switch_category(m_previous); }
+    }
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+  private:
+    step_timing* m_timing;
+    category m_previous = category::other;
+  };
+
+  /** Record scopes on the calling thread while in scope.
+   *  Used when a step is executed by a different thread than the
+   *  one that started it, e.g. within an OpenMP single region.
+   */
+  class thread_binding {
+  public:
+    explicit thread_binding(step_timing& timing) : m_previous(active()) {
+      active() = timing.m_in_step ? &timing : nullptr;
+    }
+    ~thread_binding() { active() = m_previous; }
+    thread_binding(const thread_binding&) = delete;
+    thread_binding& operator=(const thread_binding&) = delete;
+  private:
+    step_timing* m_previous;
+  };
+
+private:
+
+  /** Step timing object that records scopes on this thread. */
+  static step_timing*& active();
+
+  /** Charge elapsed time to the current category and switch. */
+  void switch_category(category c) {
+    const auto now = get_time();
+    m_current[static_cast<int>(m_category)] += now - m_last_time;
+    m_last_time = now;
+    m_category = c;
+  }
+
+  /** Whether a step is being timed. */
+  bool m_in_step = false;
+  /** Category that time is currently charged to. */
+  category m_category = category::other;
+  /** Time of the last category switch. */
+  EvalType m_last_time = 0;
+  /** Times for the current step. */
+  step_record m_current = {};
+  /** Recorded steps for each execution mode. */
+  std::map<execution_mode, std::vector<step_record>> m_steps;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_STEP_TIMING_HPP_INCLUDED
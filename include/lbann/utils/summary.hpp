@@ -29,10 +29,13 @@
 #ifndef LBANN_SUMMARY_HPP_INCLUDED
 #define LBANN_SUMMARY_HPP_INCLUDED
 
+#include <future>
+#include <memory>
 #include <string>
 #include <vector>
 #include "lbann/base.hpp"
 #include "lbann/comm.hpp"
+#include "lbann/utils/threads/thread_pool.hpp"
 
 #ifdef LBANN_HAS_TBINF
 #include "TBinf.hpp"
@@ -90,8 +93,10 @@ class lbann_summary {
 
   /**
    * Write all summaries out.
-   * @todo This can be made faster by combining collective operations element-
-   * wise for each type of summary.
+   * Pending summaries of all types are packed together, so a flush
+   * takes one sum and one max reduction within each trainer and one
+   * gather among trainers (plus a world gather for reduce_scalar_all).
+   * Event files are written by a background thread on the world master.
    */
   void flush();
 
@@ -160,22 +165,19 @@ class lbann_summary {
   /** Currently-pending reduce_histograms. */
   std::vector<pending_histogram> m_pending_histograms;
 
-  /** Execute all pending mean operations. */
-  void flush_means();
-  /** Execute all pending min operations. */
-  void flush_mins();
-  /** Execute all pending max operations. */
-  void flush_maxes();
-  /** Execute all pending stdev operations. */
-  void flush_stdevs();
-  /** Execute all pending scalar operations. */
-  void flush_scalars();
-  /** Execute all pending sum-scalar operations. */
-  void flush_sum_scalars();
-  /** Execute all pending scalar-all operations. */
-  void flush_scalar_alls();
-  /** Execute all pending histogram operations. */
-  void flush_histograms();
+  /** Thread that writes event files (world master only). */
+  std::unique_ptr<thread_pool> m_writer;
+  /** Completion of the most recent event file write. */
+  std::future<void> m_write_done;
+
+  /** Gather scalar-all operations and append them to scalars. */
+  void gather_scalar_alls(std::vector<pending_op>& scalars);
+  /**
+   * Write summaries to the event file in the background (world master
+   * only). Tags must already include the model prefix.
+   */
+  void write_events(std::vector<pending_op> scalars,
+                    std::vector<pending_histogram> histograms);
 
   /** Compute the sum of elements in mat. */
   DataType local_sum(const Mat& mat) const;
@@ -189,11 +191,6 @@ class lbann_summary {
   DataType local_2norm(const Mat& mat) const;
   /** Prepend "model<model>/" to tag. */
   std::string prepend_model(const std::string tag, int model) const;
-  /** Gather and write out a scalar summary for each model. */
-  void gather_scalar_summary(const std::string tag, DataType s, int step);
-  /** Gather and write out a scalar summary for each entry in a vector. */
-  void gather_scalar_summary(const std::vector<pending_op>& ops,
-                             std::vector<DataType>& scalars);
 };
 
 #else
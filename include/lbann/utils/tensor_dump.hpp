@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_TENSOR_DUMP_HPP_INCLUDED
+#define LBANN_UTILS_TENSOR_DUMP_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/utils/threads/thread_pool.hpp"
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Binary dumps of distributed matrices.
+ *
+ *  Each process writes its own local block of a distributed matrix,
+ *  so no data is gathered to one rank. A dump with prefix @c p
+ *  consists of a JSON sidecar @c p.json, written by the trainer
+ *  master, and one block file per distinct local block,
+ *  @c p.<col_shift>_<row_shift>.npy (or @c .bin for raw blocks).
+ *  Processes holding redundant copies of a block skip it.
+ *
+ *  Block files hold the column-major local matrix: NPY files with
+ *  @c fortran_order set, or raw little-endian values. Local entry
+ *  (i,j) of the block with shifts (s,t) is global entry
+ *  (s + i*col_stride, t + j*row_stride). The sidecar records the
+ *  global height and width, the strides, the element type, optional
+ *  tensor dimensions of each column, and the block list.
+ *
+ *  Use @c lbann.util.tensor_dump.load in the Python front end to
+ *  reassemble the global matrix.
+ */
+class tensor_dump_writer {
+public:
+
+  /** Block file formats. */
+  enum class format { npy, raw };
+
+  /** @param fmt         Block file format.
+   *  @param background  Write files in a background thread.
+   */
+  tensor_dump_writer(format fmt, bool background = false);
+  /** Copies have the same settings but their own writer thread. */
+  tensor_dump_writer(const tensor_dump_writer& other);
+  tensor_dump_writer& operator=(const tensor_dump_writer& other);
+  /** Waits for outstanding writes. */
+  ~tensor_dump_writer();
+
+  /** Add a matrix to the current dump.
+   *  The local block is copied, so the matrix may change as soon as
+   *  this returns.
+   *  @param mat            Distributed matrix (on any device).
+   *  @param prefix         Path prefix for output files.
+   *  @param dims           Tensor dimensions of each column (optional).
+   *  @param write_sidecar  Whether this process writes the sidecar.
+   */
+  void add(const AbsDistMat& mat,
+           const std::string& prefix,
+           const std::vector<int>& dims,
+           bool write_sidecar);
+  /** Write the added matrices.
+   *  In background mode, this returns after the writes are queued.
+   *  Only one dump is in flight, so this first waits for the
+   *  previous one and reports its errors.
+   */
+  void flush();
+  /** Wait for outstanding writes and report their errors. */
+  void wait();
+
+  /** Parse a format name ("npy_blocks" or "raw_blocks"). */
+  static format parse_format(const std::string& name);
+
+private:
+
+  /** File contents waiting to be written. */
+  struct pending_file {
+    std::string path;
+    std::vector<char> data;
+  };
+
+  format m_format;
+  bool m_background;
+  /** Files added since the last flush. */
+  std::vector<pending_file> m_pending;
+  /** Writer thread (background mode only). */
+  std::unique_ptr<thread_pool> m_writer;
+  /** Completion of the write in flight. */
+  std::future<void> m_write_done;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_TENSOR_DUMP_HPP_INCLUDED
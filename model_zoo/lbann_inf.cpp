@@ -83,12 +83,24 @@ int main(int argc, char *argv[]) {
     /// Interleave the inference between the models so that they can use a shared data reader
     /// Enable shared testing data readers on the command line via --share_testing_data_readers=1
     El::Int num_samples = models[0]->get_num_iterations_per_epoch(execution_mode::testing);
+    const auto start_time = get_time();
     for(El::Int s = 0; s < num_samples; s++) {
       for(auto&& m : models) {
         m->evaluate(execution_mode::testing, 1);
       }
     }
 
+    // Report inference latency
+    // Note: Compare runs with and without --frozen_model to measure
+    // the benefit of the forward-only build.
+    const auto run_time = get_time() - start_time;
+    if (master && num_samples > 0) {
+      std::cout << "inference time : " << run_time << "s "
+                << "(" << 1e3 * run_time / num_samples << "ms per mini-batch"
+                << (models.front()->is_frozen_model() ? ", frozen model" : "")
+                << ")" << std::endl;
+    }
+
   } catch (std::exception& e) {
     El::ReportException(e);
     return EXIT_FAILURE;
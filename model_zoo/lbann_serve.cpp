@@ -0,0 +1,482 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+// lbann_serve.cpp - inference server application
+//
+// Loads a model and its save_model weights, listens on a Unix domain
+// socket, and runs forward prop on dynamically batched requests.
+//
+// Each request is a 32-bit unsigned sample size N followed by N
+// 32-bit floats. Each response is a 32-bit unsigned size M followed
+// by the M 32-bit floats in the output layer's tensor for that
+// sample. Responses on a connection are sent in request order. A
+// request whose sample size does not match the input layer closes the
+// connection, as does a client that does not accept its responses
+// within the write timeout.
+//
+// scripts/lbann_serve_client.py is a matching client and load
+// generator.
+//
+// Options:
+//   --socket=<path>         Unix socket path (default: lbann_serve.sock)
+//   --output_layer=<name>   Layer whose outputs are returned
+//   --max_batch_size=<int>  At most the model mini-batch size, which is
+//                           the default
+//   --max_latency_ms=<int>  Maximum time a request waits for its batch
+//                           to fill (default: 5)
+//   --write_timeout_ms=<int> Maximum time spent sending a response
+//                           before the connection is dropped
+//                           (default: 1000)
+//   --report_interval=<int> Seconds between latency reports
+//                           (default: 10)
+//   --ckpt_dir=<path>       Directory with save_model weights
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/lbann.hpp"
+#include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/protobuf_utils.hpp"
+
+#include <lbann.pb.h>
+#include <model.pb.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+
+using namespace lbann;
+
+namespace {
+
+/** Set by signal handler to request shutdown. */
+volatile std::sig_atomic_t terminate_server = 0;
+void handle_signal(int) { terminate_server = 1; }
+
+/** Client connection with partially received data. */
+struct connection {
+  int fd;
+  std::vector<char> buffer;
+};
+
+/** Request waiting to be batched. */
+struct request {
+  /** ID of client connection. */
+  El::Int connection_id;
+  /** Sample values. */
+  std::vector<float> sample;
+  /** Time when request was received. */
+  double arrival_time;
+};
+
+/** Latency and throughput statistics since the last report. */
+struct statistics {
+  std::vector<double> latencies;
+  El::Int num_batches = 0;
+  double start_time = 0;
+};
+
+/** Write entire buffer to a non-blocking socket.
+ *  Returns false if the write fails or is not complete by the
+ *  deadline (in the time base of get_time).
+ */
+bool write_all(int fd, const char* data, size_t size, double deadline) {
+  while (size > 0) {
+    const ssize_t n = ::write(fd, data, size);
+    if (n > 0) {
+      data += n;
+      size -= n;
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK
+                         || errno == EINTR)) {
+      const double wait = deadline - get_time();
+      if (wait <= 0) { return false; }
+      struct pollfd p = {fd, POLLOUT, 0};
+      ::poll(&p, 1, static_cast<int>(std::ceil(wait * 1e3)));
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+/** Send response with sample outputs. */
+bool send_response(int fd, const std::vector<float>& output,
+                   double deadline) {
+  const uint32_t size = output.size();
+  return (write_all(fd, reinterpret_cast<const char*>(&size), sizeof(size),
+                    deadline)
+          && write_all(fd,
+                       reinterpret_cast<const char*>(output.data()),
+                       size * sizeof(float),
+                       deadline));
+}
+
+/** Extract complete requests from connection buffer.
+ *  Returns false as soon as a request header has the wrong sample
+ *  size, in which case the connection should be closed.
+ */
+bool parse_requests(El::Int connection_id,
+                    connection& conn,
+                    El::Int sample_size,
+                    std::deque<request>& pending) {
+  size_t pos = 0;
+  while (conn.buffer.size() - pos >= sizeof(uint32_t)) {
+    uint32_t size;
+    std::memcpy(&size, &conn.buffer[pos], sizeof(size));
+    if (static_cast<El::Int>(size) != sample_size) { return false; }
+    const size_t frame_size = sizeof(size) + size * sizeof(float);
+    if (conn.buffer.size() - pos < frame_size) { break; }
+    request req;
+    req.connection_id = connection_id;
+    req.arrival_time = get_time();
+    req.sample.resize(size);
+    std::memcpy(req.sample.data(),
+                &conn.buffer[pos + sizeof(size)],
+                size * sizeof(float));
+    pending.emplace_back(std::move(req));
+    pos += frame_size;
+  }
+  conn.buffer.erase(conn.buffer.begin(), conn.buffer.begin() + pos);
+  return true;
+}
+
+/** Get percentile from sorted values. */
+double percentile(const std::vector<double>& sorted_values, double p) {
+  if (sorted_values.empty()) { return 0; }
+  const El::Int n = sorted_values.size();
+  const El::Int i = std::ceil(p * n) - 1;
+  return sorted_values[std::min(std::max(i, El::Int(0)), n - 1)];
+}
+
+/** Print latency and throughput statistics and reset them. */
+void report_statistics(statistics& stats) {
+  const auto& elapsed = get_time() - stats.start_time;
+  auto& latencies = stats.latencies;
+  std::sort(latencies.begin(), latencies.end());
+  std::cout << "lbann_serve: "
+            << latencies.size() << " requests in "
+            << stats.num_batches << " batches, "
+            << (elapsed > 0 ? latencies.size() / elapsed : 0)
+            << " requests/s, "
+            << "latency p50 " << 1e3 * percentile(latencies, 0.5) << "ms, "
+            << "p99 " << 1e3 * percentile(latencies, 0.99) << "ms"
+            << std::endl;
+  latencies.clear();
+  stats.num_batches = 0;
+  stats.start_time = get_time();
+}
+
+/** Run forward prop on a batch of samples.
+ *  Must be called on every process in the trainer. The samples are
+ *  broadcast from the trainer master and the outputs are gathered
+ *  to the trainer master.
+ */
+void infer_batch(lbann_comm& comm,
+                 model& m,
+                 generic_input_layer& input,
+                 const Layer& output,
+                 CPUMat& samples,
+                 CircMat<El::Device::CPU>& outputs) {
+  comm.trainer_broadcast(0, samples.Buffer(),
+                         samples.Height() * samples.Width());
+  input.set_external_samples(&samples);
+  m.infer_mini_batch();
+  input.set_external_samples(nullptr);
+  El::Copy(output.get_activations(), outputs);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int random_seed = lbann_default_random_seed;
+  auto comm = initialize(argc, argv, random_seed);
+  const bool master = comm->am_world_master();
+
+  try {
+    // Initialize options db (this parses the command line)
+    options *opts = options::get();
+    opts->init(argc, argv);
+    if (opts->has_string("h") or opts->has_string("help") or argc == 1) {
+      print_help(*comm);
+      return EXIT_SUCCESS;
+    }
+    if (comm->get_num_trainers() > 1) {
+      LBANN_ERROR("lbann_serve only supports a single trainer");
+    }
+
+    // Initalize a global I/O thread pool
+    std::shared_ptr<thread_pool> io_thread_pool
+      = construct_io_thread_pool(comm.get());
+
+    // Construct model and load weights
+    auto pbs = protobuf_utils::load_prototext(master, argc, argv);
+    pbs[0]->mutable_model()->set_frozen_model(true);
+    auto m = build_model_from_prototext(argc, argv, *pbs[0],
+                                        comm.get(), io_thread_pool, true);
+    if (!opts->has_string("ckpt_dir")) {
+      LBANN_ERROR("lbann_serve requires --ckpt_dir");
+    }
+    if (!callback::save_model::load_model_weights(
+          opts->get_string("ckpt_dir"),
+          m.get(),
+          opts->get_bool("ckptdir_is_fullpath"))) {
+      LBANN_ERROR("Unable to reload model");
+    }
+
+    // Find input and output layers
+    generic_input_layer* input = nullptr;
+    const Layer* output = nullptr;
+    const auto& output_name = opts->get_string("output_layer", "");
+    for (auto* l : m->get_layers()) {
+      if (input == nullptr) {
+        input = dynamic_cast<generic_input_layer*>(l);
+      }
+      if (l->get_name() == output_name) {
+        output = l;
+      }
+    }
+    if (input == nullptr) {
+      LBANN_ERROR("could not find input layer");
+    }
+    if (output == nullptr) {
+      LBANN_ERROR("could not find output layer \"" + output_name + "\" "
+                  "(specify with --output_layer)");
+    }
+    const El::Int sample_size = input->get_output_size(0);
+    const El::Int output_size = output->get_output_size(0);
+
+    // Serving parameters
+    const El::Int max_batch_size
+      = opts->get_int("max_batch_size", m->get_max_mini_batch_size());
+    const double max_latency = opts->get_int("max_latency_ms", 5) * 1e-3;
+    const double write_timeout
+      = opts->get_int("write_timeout_ms", 1000) * 1e-3;
+    const double report_interval = opts->get_int("report_interval", 10);
+    const auto& socket_path = opts->get_string("socket", "lbann_serve.sock");
+    if (max_batch_size < 1
+        || max_batch_size > m->get_max_mini_batch_size()) {
+      LBANN_ERROR("invalid max batch size (", max_batch_size, "), ",
+                  "expected a value in [1,", m->get_max_mini_batch_size(),
+                  "]");
+    }
+    if (write_timeout <= 0) {
+      LBANN_ERROR("invalid write timeout");
+    }
+
+    CPUMat samples;
+    CircMat<El::Device::CPU> outputs(comm->get_trainer_grid(), 0);
+
+    // Processes other than the trainer master follow the master
+    if (!comm->am_trainer_master()) {
+      while (true) {
+        El::Int batch_size;
+        comm->trainer_broadcast(0, batch_size);
+        if (batch_size < 0) { break; }
+        samples.Resize(sample_size, batch_size);
+        infer_batch(*comm, *m, *input, *output, samples, outputs);
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // Open Unix socket
+    const int listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+      LBANN_ERROR(std::string("could not create socket: ")
+                  + std::strerror(errno));
+    }
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+      LBANN_ERROR("socket path is too long (" + socket_path + ")");
+    }
+    std::strcpy(addr.sun_path, socket_path.c_str());
+    ::unlink(socket_path.c_str());
+    if (::bind(listen_fd, reinterpret_cast<struct sockaddr*>(&addr),
+               sizeof(addr)) != 0
+        || ::listen(listen_fd, 128) != 0) {
+      LBANN_ERROR("could not listen on " + socket_path + " ("
+                  + std::strerror(errno) + ")");
+    }
+    ::fcntl(listen_fd, F_SETFL, O_NONBLOCK);
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+    std::signal(SIGPIPE, SIG_IGN);
+    std::cout << "lbann_serve: listening on " << socket_path << " "
+              << "(sample size " << sample_size << ", "
+              << "output size " << output_size << ", "
+              << "max batch size " << max_batch_size << ", "
+              << "max latency " << max_latency * 1e3 << "ms)"
+              << std::endl;
+
+    // Serve requests until terminated
+    std::map<El::Int,connection> connections;
+    El::Int next_connection_id = 0;
+    std::deque<request> pending;
+    statistics stats;
+    stats.start_time = get_time();
+    std::vector<char> read_buffer(1 << 16);
+    while (!terminate_server || !pending.empty()) {
+
+      // Wait for socket activity or the oldest request's deadline
+      std::vector<struct pollfd> fds;
+      std::vector<El::Int> fd_ids;
+      fds.push_back({listen_fd, POLLIN, 0});
+      for (const auto& conn : connections) {
+        fds.push_back({conn.second.fd, POLLIN, 0});
+        fd_ids.push_back(conn.first);
+      }
+      int timeout_ms = 100;
+      if (!pending.empty()) {
+        const auto& wait = (pending.front().arrival_time + max_latency
+                            - get_time());
+        timeout_ms = std::max(0, static_cast<int>(std::ceil(wait * 1e3)));
+      }
+      if (pending.size() >= static_cast<size_t>(max_batch_size)
+          || terminate_server) {
+        timeout_ms = 0;
+      }
+      ::poll(fds.data(), fds.size(), timeout_ms);
+
+      // Accept new connections
+      if (fds[0].revents & POLLIN) {
+        int fd;
+        while ((fd = ::accept(listen_fd, nullptr, nullptr)) >= 0) {
+          ::fcntl(fd, F_SETFL, O_NONBLOCK);
+          connections[next_connection_id++].fd = fd;
+        }
+      }
+
+      // Receive requests
+      for (size_t i = 1; i < fds.size(); ++i) {
+        if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) { continue; }
+        const auto& id = fd_ids[i-1];
+        auto& conn = connections[id];
+        bool closed = false;
+        while (true) {
+          const auto& n = ::read(conn.fd, read_buffer.data(),
+                                 read_buffer.size());
+          if (n > 0) {
+            conn.buffer.insert(conn.buffer.end(),
+                               read_buffer.begin(),
+                               read_buffer.begin() + n);
+          } else {
+            closed = (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK
+                                 && errno != EINTR));
+            break;
+          }
+        }
+        if (!parse_requests(id, conn, sample_size, pending)) {
+          std::cout << "lbann_serve: closing connection " << id << " "
+                    << "after request with wrong sample size" << std::endl;
+          closed = true;
+        }
+        if (closed) {
+          ::close(conn.fd);
+          connections.erase(id);
+        }
+      }
+
+      // Dispatch a batch when it is full or its deadline has passed
+      if (pending.empty()) { continue; }
+      if (pending.size() < static_cast<size_t>(max_batch_size)
+          && get_time() < pending.front().arrival_time + max_latency
+          && !terminate_server) {
+        continue;
+      }
+      const El::Int batch_size = std::min(pending.size(),
+                                          static_cast<size_t>(max_batch_size));
+      std::vector<request> batch(pending.begin(),
+                                 pending.begin() + batch_size);
+      pending.erase(pending.begin(), pending.begin() + batch_size);
+      samples.Resize(sample_size, batch_size);
+      El::Zero(samples);
+      for (El::Int j = 0; j < batch_size; ++j) {
+        const auto& sample = batch[j].sample;
+        for (size_t i = 0; i < sample.size(); ++i) {
+          samples(i, j) = sample[i];
+        }
+      }
+      El::Int batch_size_copy = batch_size;
+      comm->trainer_broadcast(0, batch_size_copy);
+      infer_batch(*comm, *m, *input, *output, samples, outputs);
+
+      // Send responses
+      const auto& local_outputs = outputs.LockedMatrix();
+      std::vector<float> sample_output(output_size);
+      for (El::Int j = 0; j < batch_size; ++j) {
+        const auto& req = batch[j];
+        auto conn = connections.find(req.connection_id);
+        if (conn == connections.end()) { continue; }
+        for (El::Int i = 0; i < output_size; ++i) {
+          sample_output[i] = local_outputs(i, j);
+        }
+        if (!send_response(conn->second.fd, sample_output,
+                           get_time() + write_timeout)) {
+          std::cout << "lbann_serve: dropping connection "
+                    << req.connection_id << " "
+                    << "after failed or timed out write" << std::endl;
+          ::close(conn->second.fd);
+          connections.erase(conn);
+          continue;
+        }
+        stats.latencies.push_back(get_time() - req.arrival_time);
+      }
+      ++stats.num_batches;
+
+      // Report statistics
+      if (get_time() - stats.start_time >= report_interval) {
+        report_statistics(stats);
+      }
+
+    }
+
+    // Clean up
+    El::Int done = -1;
+    comm->trainer_broadcast(0, done);
+    report_statistics(stats);
+    for (const auto& conn : connections) {
+      ::close(conn.second.fd);
+    }
+    ::close(listen_fd);
+    ::unlink(socket_path.c_str());
+
+  } catch (std::exception& e) {
+    El::ReportException(e);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -16,7 +16,8 @@ class Layer(abc.ABC):
                  name=None,
                  device=None,
                  data_layout=None,
-                 hint_layer=None):
+                 hint_layer=None,
+                 activation_checkpoint=False):
         """Constructor.
 
         Args:
@@ -31,6 +32,8 @@ class Layer(abc.ABC):
             device (str, optional): Device to use, e.g. CPU or GPU.
             data_layout (str, optional): Data distribution scheme.
             hint_layer (Layer, optional): Hint for output dimensions.
+            activation_checkpoint (bool, optional): Keep output
+                tensors alive when the model recomputes activations.
 
         """
         Layer.global_count += 1
@@ -41,6 +44,7 @@ class Layer(abc.ABC):
         self.device = device
         self.data_layout = data_layout
         self.hint_layer = hint_layer
+        self.activation_checkpoint = activation_checkpoint
 
         # Initialize parents, children, and weights
         for l in make_iterable(parents):
@@ -63,6 +67,8 @@ class Layer(abc.ABC):
             proto.data_layout = self.data_layout
         if self.hint_layer:
             proto.hint_layer = self.hint_layer.name
+        if self.activation_checkpoint:
+            proto.activation_checkpoint = self.activation_checkpoint
         return proto
 
     def add_parent(self, parent):
@@ -97,11 +103,13 @@ classes = lbann.util.class_generator.generate_classes_from_protobuf_message(
     skip_fields = set([
         'name', 'parents', 'children', 'data_layout', 'device_allocation',
         'weights', 'num_neurons_from_data_reader', 'freeze', 'hint_layer',
-        'weights_data', 'top', 'bottom', 'type', 'motif_layer']),
+        'weights_data', 'top', 'bottom', 'type', 'motif_layer',
+        'activation_checkpoint']),
     base_class = Layer,
     base_kwargs = set([
         'parents', 'children', 'weights',
-        'name', 'device', 'data_layout', 'hint_layer']),
+        'name', 'device', 'data_layout', 'hint_layer',
+        'activation_checkpoint']),
     base_has_export_proto = True)
 for c in classes:
     globals()[c.__name__] = c
@@ -11,7 +11,12 @@ class Model:
     def __init__(self, mini_batch_size, epochs,
                  layers=[], weights=[], objective_function=None,
                  metrics=[], callbacks=[], random_seed=None,
-                 summary_dir=None):
+                 summary_dir=None, recompute_activations=False,
+                 activation_checkpoint_interval=None,
+                 fuse_entrywise_layers=False, frozen_model=False,
+                 reduced_precision_storage=None,
+                 num_pipeline_stages=1, num_micro_batches=1,
+                 pipeline_stage_boundaries=[]):
 
         # Scalar fields
         self.mini_batch_size = mini_batch_size
@@ -21,6 +26,14 @@ class Model:
         self.procs_per_trainer = 0      # TODO: Make configurable
         self.random_seed = random_seed
         self.summary_dir = summary_dir
+        self.recompute_activations = recompute_activations
+        self.activation_checkpoint_interval = activation_checkpoint_interval
+        self.fuse_entrywise_layers = fuse_entrywise_layers
+        self.frozen_model = frozen_model
+        self.reduced_precision_storage = reduced_precision_storage
+        self.num_pipeline_stages = num_pipeline_stages
+        self.num_micro_batches = num_micro_batches
+        self.pipeline_stage_boundaries = make_iterable(pipeline_stage_boundaries)
         # Get connected layers
         self.layers = list(lbann.layer.traverse_layer_graph(layers))
 
@@ -55,6 +68,21 @@ class Model:
             model.random_seed = self.random_seed
         if self.summary_dir is not None:
             model.summarizer.dir = self.summary_dir
+        if self.recompute_activations:
+            model.recompute_activations = True
+        if self.activation_checkpoint_interval is not None:
+            model.activation_checkpoint_interval = self.activation_checkpoint_interval
+        if self.fuse_entrywise_layers:
+            model.fuse_entrywise_layers = True
+        if self.frozen_model:
+            model.frozen_model = True
+        if self.reduced_precision_storage is not None:
+            model.reduced_precision_storage = self.reduced_precision_storage
+        if self.num_pipeline_stages > 1:
+            model.num_pipeline_stages = self.num_pipeline_stages
+            model.num_micro_batches = self.num_micro_batches
+            model.pipeline_stage_boundaries.extend(
+                self.pipeline_stage_boundaries)
 
         # Add model components
         model.layer.extend([l.export_proto() for l in self.layers])
@@ -41,13 +41,22 @@ class L2WeightRegularization(ObjectiveFunctionTerm):
 class ObjectiveFunction:
     """Objective function for optimization algorithm."""
 
-    def __init__(self, terms=[]):
+    def __init__(self, terms=[], loss_scale=None,
+                 dynamic_loss_scaling=False,
+                 loss_scale_growth_interval=None):
         """Create an objective function with layer terms and regularization.
 
         `terms` should be a sequence of `ObjectiveFunctionTerm`s and
-        `Layer`s.
+        `Layer`s. `loss_scale` multiplies gradient contributions (but
+        not the objective function value) so that small error signals
+        do not underflow. With `dynamic_loss_scaling`, the loss scale
+        is halved whenever the weight gradients overflow and doubled
+        after `loss_scale_growth_interval` steps without overflow.
 
         """
+        self.loss_scale = loss_scale
+        self.dynamic_loss_scaling = dynamic_loss_scaling
+        self.loss_scale_growth_interval = loss_scale_growth_interval
         self.terms = []
         for t in make_iterable(terms):
             self.add_term(t)
@@ -72,4 +81,9 @@ class ObjectiveFunction:
                 proto.layer_term.extend([term_message])
             elif type(term) is L2WeightRegularization:
                 proto.l2_weight_regularization.extend([term_message])
+        if self.loss_scale is not None:
+            proto.loss_scale = self.loss_scale
+        proto.dynamic_loss_scaling = self.dynamic_loss_scaling
+        if self.loss_scale_growth_interval is not None:
+            proto.loss_scale_growth_interval = self.loss_scale_growth_interval
         return proto
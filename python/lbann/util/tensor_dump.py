@@ -0,0 +1,57 @@
+"""Load binary tensor dumps written by LBANN callbacks.
+
+The dump_weights, dump_gradients, and dump_outputs callbacks can write
+each process's local block of a distributed matrix to its own file
+(formats npy_blocks and raw_blocks). A JSON sidecar describes how the
+blocks fit together.
+
+"""
+import json
+import os.path
+import numpy as np
+
+def load(path):
+    """Reassemble a tensor from a blocked dump.
+
+    Local entry (i,j) of the block with shifts (s,t) is global entry
+    (s + i*col_stride, t + j*row_stride) of the column-major matrix.
+
+    Args:
+        path (str): Path to the JSON sidecar, or the dump prefix
+            without the `.json` extension.
+
+    Returns:
+        numpy.ndarray: Global matrix with shape (height, width). If
+            the dump records tensor dimensions for each column (e.g.
+            layer outputs), an array with shape (width, *dims) with one
+            entry per mini-batch sample.
+
+    """
+    if not path.endswith('.json'):
+        path += '.json'
+    with open(path, 'r') as f:
+        meta = json.load(f)
+    dtype = np.dtype(meta['dtype'])
+    height, width = meta['height'], meta['width']
+    col_stride, row_stride = meta['col_stride'], meta['row_stride']
+    directory = os.path.dirname(path)
+
+    data = np.zeros((height, width), dtype=dtype)
+    for block in meta['blocks']:
+        block_file = os.path.join(directory, block['file'])
+        shape = (block['height'], block['width'])
+        if meta['format'] == 'npy':
+            local = np.load(block_file)
+        else:
+            local = np.fromfile(block_file, dtype=dtype)
+            local = local.reshape(shape, order='F')
+        if local.shape != shape:
+            raise RuntimeError('block {} has shape {}, expected {}'
+                               .format(block_file, local.shape, shape))
+        data[block['col_shift']::col_stride,
+             block['row_shift']::row_stride] = local
+
+    dims = meta.get('dims', [])
+    if dims:
+        return data.T.reshape([width] + dims)
+    return data
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""Client and load generator for lbann_serve.
+
+Opens one or more connections to an lbann_serve Unix socket, sends
+random Gaussian samples, and reports throughput and latency
+percentiles. Each request is a 32-bit unsigned sample size N followed
+by N 32-bit floats, and each response is a 32-bit unsigned size M
+followed by M 32-bit floats (see model_zoo/lbann_serve.cpp).
+
+By default each connection keeps one request in flight (closed
+loop). With --rate, requests are issued on a fixed schedule
+regardless of when responses arrive (open loop), which is the better
+way to measure latency under a given load.
+
+"""
+import argparse
+import math
+import random
+import socket
+import struct
+import sys
+import threading
+import time
+
+# Parse command-line arguments
+parser = argparse.ArgumentParser(
+    description='Send requests to an lbann_serve inference server.')
+parser.add_argument(
+    '--socket', action='store', default='lbann_serve.sock', type=str,
+    help='Unix socket path (default: lbann_serve.sock)', metavar='PATH')
+parser.add_argument(
+    '--sample-size', action='store', required=True, type=int,
+    help='number of entries in each sample', metavar='N')
+parser.add_argument(
+    '--num-requests', action='store', default=1000, type=int,
+    help='total number of requests (default: 1000)', metavar='N')
+parser.add_argument(
+    '--concurrency', action='store', default=1, type=int,
+    help='number of connections (default: 1)', metavar='N')
+parser.add_argument(
+    '--rate', action='store', default=0, type=float,
+    help='total requests per second, or 0 to send each request '
+    'as soon as the previous response on its connection arrives '
+    '(default: 0)', metavar='R')
+parser.add_argument(
+    '--seed', action='store', default=20191016, type=int,
+    help='random seed (default: 20191016)')
+args = parser.parse_args()
+if args.sample_size < 1 or args.num_requests < 1 or args.concurrency < 1:
+    sys.exit('sample size, number of requests, and concurrency '
+             'must be positive')
+if args.rate < 0:
+    sys.exit('rate must be non-negative')
+
+def recv_exact(sock, size):
+    """Receive exactly size bytes, or raise an error if the server
+    closes the connection."""
+    data = bytearray()
+    while len(data) < size:
+        chunk = sock.recv(size - len(data))
+        if not chunk:
+            raise ConnectionError('server closed connection')
+        data.extend(chunk)
+    return bytes(data)
+
+def run_connection(index, num_requests, results):
+    """Send requests on one connection and record latencies."""
+    rng = random.Random(args.seed + index)
+    interval = args.concurrency / args.rate if args.rate > 0 else 0
+    latencies = []
+    output_sizes = set()
+    send_times = []
+    error = None
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+        sock.connect(args.socket)
+
+        # Responses arrive in request order, so in open-loop mode a
+        # separate thread can match them to send times by position
+        def receive():
+            try:
+                for i in range(num_requests):
+                    size, = struct.unpack('=I', recv_exact(sock, 4))
+                    recv_exact(sock, 4 * size)
+                    latencies.append(time.perf_counter() - send_times[i])
+                    output_sizes.add(size)
+            except OSError:
+                pass
+        receiver = None
+        if interval > 0:
+            receiver = threading.Thread(target=receive, daemon=True)
+            receiver.start()
+
+        try:
+            start = time.perf_counter() + interval * index / args.concurrency
+            for i in range(num_requests):
+                if interval > 0:
+                    delay = start + i * interval - time.perf_counter()
+                    if delay > 0:
+                        time.sleep(delay)
+                sample = [rng.gauss(0, 1) for _ in range(args.sample_size)]
+                message = struct.pack('=I{}f'.format(args.sample_size),
+                                      args.sample_size, *sample)
+                send_times.append(time.perf_counter())
+                sock.sendall(message)
+                if interval == 0:
+                    size, = struct.unpack('=I', recv_exact(sock, 4))
+                    recv_exact(sock, 4 * size)
+                    latencies.append(time.perf_counter() - send_times[-1])
+                    output_sizes.add(size)
+            if receiver:
+                receiver.join()
+        except OSError as e:
+            error = e
+    if receiver and len(latencies) < num_requests and error is None:
+        error = ConnectionError('server closed connection')
+    results[index] = (latencies, output_sizes, error)
+
+# Split requests over connections
+counts = [args.num_requests // args.concurrency] * args.concurrency
+for i in range(args.num_requests % args.concurrency):
+    counts[i] += 1
+results = [None] * args.concurrency
+threads = [threading.Thread(target=run_connection, args=(i, counts[i], results))
+           for i in range(args.concurrency)]
+start = time.perf_counter()
+for t in threads:
+    t.start()
+for t in threads:
+    t.join()
+elapsed = time.perf_counter() - start
+
+# Report results
+latencies = sorted(l for r in results for l in r[0])
+output_sizes = set(s for r in results for s in r[1])
+errors = [r[2] for r in results if r[2] is not None]
+def percentile(p):
+    if not latencies:
+        return 0
+    i = min(max(math.ceil(p * len(latencies)) - 1, 0), len(latencies) - 1)
+    return latencies[i]
+print('{} of {} requests completed in {:.3f}s ({:.1f} requests/s)'
+      .format(len(latencies), args.num_requests, elapsed,
+              len(latencies) / elapsed if elapsed > 0 else 0))
+print('latency p50 {:.3f}ms, p90 {:.3f}ms, p99 {:.3f}ms, max {:.3f}ms'
+      .format(1e3 * percentile(0.5), 1e3 * percentile(0.9),
+              1e3 * percentile(0.99), 1e3 * percentile(1.0)))
+print('output sizes: {}'.format(sorted(output_sizes)))
+for e in errors:
+    print('error: {}'.format(e), file=sys.stderr)
+if errors or len(latencies) < args.num_requests:
+    sys.exit(1)
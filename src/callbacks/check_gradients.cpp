@@ -27,6 +27,7 @@
 #include "lbann/callbacks/check_gradients.hpp"
 #include "lbann/data_readers/data_reader.hpp"
 #include "lbann/layers/io/input/generic_input_layer.hpp"
+#include "lbann/layers/transform/evaluation.hpp"
 #include "lbann/proto/proto_common.hpp"
 #include "lbann/utils/memory.hpp"
 
@@ -36,6 +37,8 @@
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace lbann {
 namespace callback {
@@ -84,6 +87,19 @@ void check_gradients::do_check_gradients(model& m) const {
   // Return immediately if gradient check isn't currently needed
   if (!m_modes.empty() && m_modes.count(mode) == 0) { return; }
 
+  // Evaluate objective function every step while checking gradients
+  // Note: Finite difference evaluations should not be accumulated
+  // into deferred evaluation windows.
+  m.flush_deferred_evaluation();
+  std::vector<std::pair<abstract_evaluation_layer*, El::Int>> deferred_layers;
+  for (auto&& l : layers) {
+    auto* eval = dynamic_cast<abstract_evaluation_layer*>(l);
+    if (eval != nullptr) {
+      deferred_layers.emplace_back(eval, eval->get_deferred_evaluation());
+      eval->set_deferred_evaluation(0);
+    }
+  }
+
   // Reset statistics and gradients
   m.get_objective_function()->reset_statistics(mode);
   for (auto&& met : m.get_metrics()) {
@@ -225,6 +241,9 @@ void check_gradients::do_check_gradients(model& m) const {
   }
 
   // Clean up
+  for (auto&& eval : deferred_layers) {
+    eval.first->set_deferred_evaluation(eval.second);
+  }
   /// @todo tym: I'm not sure if data readers are properly reset
   for (auto&& l : m.get_layers()) {
     auto&& input = dynamic_cast<generic_input_layer*>(l);
@@ -26,12 +26,47 @@
 
 #include "lbann/callbacks/check_nan.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+#include "lbann/proto/proto_common.hpp"
+
+#include <callbacks.pb.h>
 
 namespace lbann {
 namespace callback {
 
 namespace {
 
+/** Cheap check for whether a matrix contains only finite entries.
+ *  The local entries are summed with a vectorized reduction. NaNs and
+ *  infs propagate through the sum, so a finite sum means that every
+ *  entry is finite. Large finite entries may overflow the sum, so a
+ *  non-finite sum only means that the matrix must be scanned with
+ *  has_nan and has_inf. mat is assumed to be a CPU matrix.
+ */
+bool has_finite_sum(const AbsDistMat& mat) {
+  const auto& local_mat = mat.LockedMatrix();
+  if (local_mat.IsEmpty()) { return true; }
+  DataType sum = DataType(0);
+  if (local_mat.Contiguous()) {
+    const size_t size = local_mat.Height() * local_mat.Width();
+    const auto& __restrict__ buf = local_mat.LockedBuffer();
+    LBANN_OMP_PARALLEL_FOR_ARGS(reduction(+:sum))
+    for (size_t i = 0; i < size; ++i) {
+      sum += buf[i];
+    }
+  } else {
+    const El::Int height = local_mat.Height();
+    const El::Int width = local_mat.Width();
+    LBANN_OMP_PARALLEL_FOR_ARGS(reduction(+:sum) collapse(2))
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        sum += local_mat(row, col);
+      }
+    }
+  }
+  return std::isfinite(sum);
+}
+
 /** Check whether a matrix contains a NaN.
  *  If a NaN entry is detected, return true and output the local entry
  *  position in row and col. mat is assumed to be a CPU matrix.
@@ -118,12 +153,32 @@ void dump_network(model *m) {
 
 } // namespace
 
+check_nan::check_nan(int batch_interval, bool fast, double layer_fraction)
+  : callback_base(batch_interval),
+    m_fast(fast),
+    m_layer_fraction(layer_fraction) {
+  if (layer_fraction <= 0.0 || layer_fraction > 1.0) {
+    std::stringstream err;
+    err << "check_nan callback has invalid layer fraction "
+        << "(" << layer_fraction << ")";
+    LBANN_ERROR(err.str());
+  }
+}
+
+bool check_nan::sample_layer() {
+  if (m_layer_fraction >= 1.0) { return true; }
+  std::bernoulli_distribution dist(m_layer_fraction);
+  return dist(m_rng);
+}
+
 void check_nan::on_forward_prop_end(model *m, Layer *l) {
+  if (!sample_layer()) { return; }
   std::stringstream err;
   const auto& num_outputs = l->get_num_children();
   for (int i = 0; i < num_outputs; ++i) {
     El::Int row, col;
     AbsDistMatReadProxy<El::Device::CPU> mat_proxy(l->get_activations(i));
+    if (m_fast && has_finite_sum(mat_proxy.GetLocked())) { continue; }
     if (has_nan(mat_proxy.GetLocked(), row, col)) {
       dump_network(m);
       err << "rank " << m->get_comm()->get_rank_in_world() << ": "
@@ -146,11 +201,13 @@ void check_nan::on_forward_prop_end(model *m, Layer *l) {
 }
 
 void check_nan::on_backward_prop_end(model *m, Layer *l) {
+  if (!sample_layer()) { return; }
   std::stringstream err;
   const auto& num_inputs = l->get_num_parents();
   for (int i = 0; i < num_inputs; ++i) {
     El::Int row, col;
     AbsDistMatReadProxy<El::Device::CPU> mat_proxy(l->get_error_signals(i));
+    if (m_fast && has_finite_sum(mat_proxy.GetLocked())) { continue; }
     if (has_nan(mat_proxy.GetLocked(), row, col)) {
       dump_network(m);
       err << "rank " << m->get_comm()->get_rank_in_world() << ": "
@@ -179,6 +236,7 @@ void check_nan::on_backward_prop_end(model *m) {
     if (opt != nullptr) {
       El::Int row, col;
       AbsDistMatReadProxy<El::Device::CPU> mat_proxy(opt->get_gradient());
+      if (m_fast && has_finite_sum(mat_proxy.GetLocked())) { continue; }
       if (has_nan(mat_proxy.GetLocked(), row, col)) {
         dump_network(m);
         err << "rank " << m->get_comm()->get_rank_in_world() << ": "
@@ -202,6 +260,7 @@ void check_nan::on_batch_end(model *m) {
   for (weights *w : m->get_weights()) {
     El::Int row, col;
     AbsDistMatReadProxy<El::Device::CPU> mat_proxy(w->get_values());
+    if (m_fast && has_finite_sum(mat_proxy.GetLocked())) { continue; }
     if (has_nan(mat_proxy.GetLocked(), row, col)) {
       dump_network(m);
       err << "rank " << m->get_comm()->get_rank_in_world() << ": "
@@ -219,5 +278,16 @@ void check_nan::on_batch_end(model *m) {
   }
 }
 
+std::unique_ptr<callback_base>
+build_check_nan_callback_from_pbuf(
+  const google::protobuf::Message& proto_msg, const std::shared_ptr<lbann_summary>&) {
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackCheckNaN&>(proto_msg);
+  const auto& layer_fraction = params.layer_fraction();
+  return make_unique<check_nan>(params.batch_interval(),
+                                params.fast(),
+                                layer_fraction > 0.0 ? layer_fraction : 1.0);
+}
+
 } // namespace callback
 } // namespace lbann
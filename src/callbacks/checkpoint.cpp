@@ -33,14 +33,17 @@
 
 #include <callbacks.pb.h>
 
+#include <fstream>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace lbann {
 namespace callback {
 // Load from checkpoint occurs during setup callbacks
 void checkpoint::setup(model *m) {
   p.set_cb_type(callback_type::invalid);
+  p.set_compression(parse_compression(m_compression));
   restart(m);
 }
 // Interval defined with checkpoint_epochs or ckpt_dist_epochs
@@ -121,6 +124,66 @@ bool checkpoint::need_checkpoint(model *m) {
   return (m_checkpoint_shared || m_checkpoint_dist);
 }
 
+// Full checkpoints are bases for the next full_checkpoint_interval-1 incremental ones
+bool checkpoint::begin_incremental(incremental_state& state) {
+  if (m_full_checkpoint_interval <= 1) {
+    p.clear_incremental();
+    return true;
+  }
+  if (state.base_dir.empty() || state.count + 1 >= m_full_checkpoint_interval) {
+    state.base_dir.clear();
+    state.count = 0;
+    p.set_incremental(state.base_dir, state.hashes);
+    return true;
+  }
+  ++state.count;
+  p.set_incremental(state.base_dir, state.hashes);
+  return false;
+}
+
+// Index lines of all ranks, preceded by the number of ranks
+void checkpoint::write_index(model *m, const std::string& filename) {
+  lbann_comm *comm = m->get_comm();
+  const std::string line = "rank " + std::to_string(comm->get_rank_in_trainer()) + "\n";
+  std::vector<char> local(line.begin(), line.end());
+  local.insert(local.end(), p.get_index().begin(), p.get_index().end());
+  const int count = local.size();
+  if (!comm->am_trainer_master()) {
+    comm->trainer_gather(count, comm->get_trainer_master());
+    comm->trainer_gatherv(local.data(), count, comm->get_trainer_master());
+    return;
+  }
+  const int procs = comm->get_procs_per_trainer();
+  std::vector<int> counts(procs), displs(procs, 0);
+  comm->trainer_gather(count, counts.data());
+  for (int i = 1; i < procs; ++i) {
+    displs[i] = displs[i-1] + counts[i-1];
+  }
+  std::vector<char> index(displs.back() + counts.back());
+  comm->trainer_gatherv(local.data(), count, index.data(),
+                        counts.data(), displs.data());
+  const std::string header = "ranks " + std::to_string(procs) + "\n";
+  int fd = openwrite(filename.c_str());
+  if (fd < 0) {
+    LBANN_ERROR("failed to open file (" + filename + ")");
+  }
+  write_string(fd, filename.c_str(), header.data(), header.size());
+  write_string(fd, filename.c_str(), index.data(), index.size());
+  closewrite(fd, filename.c_str());
+}
+
+int checkpoint::read_index(const std::string& filename, std::vector<char>& index) {
+  std::ifstream in(filename);
+  std::string field;
+  int ranks = 0;
+  if (!(in >> field >> ranks) || field != "ranks") {
+    return 0;
+  }
+  index.assign(std::istreambuf_iterator<char>(in),
+               std::istreambuf_iterator<char>());
+  return ranks;
+}
+
 // Checkpoint Shared/Distributed
 bool checkpoint::do_checkpoint(model *m) {
   // if the checkpoint directory is not defined, bail
@@ -164,10 +227,15 @@ bool checkpoint::do_checkpoint(model *m) {
     makedir(dir);
     // create directories per ranks
     epochdir = get_distributed_checkpoint_dirname(m, dir, epoch, step);
+    const bool full = begin_incremental(m_dist_incremental);
     p.open_checkpoint(epochdir.c_str());
     // Call top level save to checkpoint function in model, in turn calls save to checkpoint functions for other model classes (weights, layers)
     m->save_to_checkpoint_distributed(p);
     p.close_checkpoint();
+    p.clear_incremental();
+    if (full) { m_dist_incremental.base_dir = epochdir; }
+    // Global tensor index, so any number of ranks can restart
+    write_index(m, get_distributed_checkpoint_index_filename(m, dir, epoch, step));
     // Print latest checkpoint to file
     if (comm->am_trainer_master()) {
       latest_file = get_last_distributed_checkpoint_filename(m, dir);
@@ -179,6 +247,7 @@ bool checkpoint::do_checkpoint(model *m) {
     strcpy(dir, m_checkpoint_dir.c_str());
     makedir(dir);
     epochdir = get_shared_checkpoint_dirname(m, dir, epoch, step);
+    const bool full = begin_incremental(m_shared_incremental);
     if (comm->am_trainer_master()) {
       p.open_checkpoint(epochdir.c_str());
     }
@@ -187,6 +256,8 @@ bool checkpoint::do_checkpoint(model *m) {
     m->save_to_checkpoint_shared(p);
     // close our checkpoint
     p.close_checkpoint();
+    p.clear_incremental();
+    if (full) { m_shared_incremental.base_dir = epochdir; }
     if (comm->am_trainer_master()) {
       latest_file = get_last_shared_checkpoint_filename(m, dir);
       write_latest(latest_file, epoch, step);
@@ -194,6 +265,16 @@ bool checkpoint::do_checkpoint(model *m) {
   }
 
   uint64_t bytes_count = p.get_bytes();
+  uint64_t skipped_bytes = p.get_skipped_bytes();
+
+  // Compression statistics over all processes in the trainer
+  EvalType raw_bytes = 0, compressed_bytes = 0, compression_secs = 0;
+  if (p.get_compression().codec != compression_codec::none) {
+    raw_bytes = comm->trainer_allreduce(EvalType(p.get_compression_raw_bytes()));
+    compressed_bytes = comm->trainer_allreduce(EvalType(p.get_compressed_bytes()));
+    compression_secs = comm->trainer_allreduce(EvalType(p.get_compression_time()),
+                                               El::mpi::MAX);
+  }
 
   if (comm->am_trainer_master()) {
     EvalType secs = timer.Stop();
@@ -203,6 +284,20 @@ bool checkpoint::do_checkpoint(model *m) {
     }
     printf("[%s.%d] Checkpoint complete: Epoch=%d Step=%d (%f secs, %llu bytes, %f MB/sec)\n",
            m->get_name().c_str(), comm->get_trainer_rank(), epoch, step, secs, (unsigned long long) bytes_count, bw);
+    if (skipped_bytes > 0) {
+      printf("[%s.%d] Incremental checkpoint: %llu bytes unchanged since last full checkpoint\n",
+             m->get_name().c_str(), comm->get_trainer_rank(), (unsigned long long) skipped_bytes);
+    }
+    if (raw_bytes > 0 && compressed_bytes > 0) {
+      EvalType compression_bw = 0;
+      if (compression_secs > 0.0) {
+        compression_bw = raw_bytes / (compression_secs * 1024.0 * 1024.0);
+      }
+      printf("[%s.%d] Checkpoint compression (%s): ratio %f, %f MB/sec per process\n",
+             m->get_name().c_str(), comm->get_trainer_rank(),
+             to_string(p.get_compression().codec).c_str(),
+             raw_bytes / compressed_bytes, compression_bw);
+    }
     fflush(stdout);
   }
   // record last checkpoint time in case checkpoint_secs interval defined.
@@ -229,11 +324,15 @@ bool checkpoint::restart(model *m) {
   int shared = 1;
   // Grab latest checkpoint information, checks for latest in dist and shared, restarts from most recent between the two.
   if (comm->am_trainer_master()) {
+    // Distributed checkpoints are in the same directory as in do_checkpoint
+    char dist_dir[max_len_dirname];
     if(m_per_rank_dir.length()){
-      snprintf(dir, sizeof(dir), "%s/%s", m_per_rank_dir.c_str(), m_checkpoint_dir.c_str());
-      latest_file = get_last_distributed_checkpoint_filename(m, dir);
-      read_latest(latest_file, &epoch, &step);
+      snprintf(dist_dir, sizeof(dist_dir), "%s/%s", m_per_rank_dir.c_str(), m_checkpoint_dir.c_str());
+    } else {
+      strcpy(dist_dir, m_checkpoint_dir.c_str());
     }
+    latest_file = get_last_distributed_checkpoint_filename(m, dist_dir);
+    read_latest(latest_file, &epoch_dist, &step_dist);
     if(m_checkpoint_dir.length()){
       strcpy(dir, m_checkpoint_dir.c_str());
       latest_file = get_last_shared_checkpoint_filename(m, dir);
@@ -249,7 +348,7 @@ bool checkpoint::restart(model *m) {
       shared = 1;
     }
     else {
-      snprintf(dir, sizeof(dir), "%s/%s", m_per_rank_dir.c_str(), m_checkpoint_dir.c_str());
+      strcpy(dir, dist_dir);
       step = step_dist;
       epoch = epoch_dist;
       shared = 0;
@@ -295,10 +394,36 @@ bool checkpoint::restart(model *m) {
   std::string epochdir;
   // Create dir to restart from based off last recorded checkpoint (or overriden values in last.shared[distributed].checkpoint
   if(!shared){
-    epochdir = get_distributed_checkpoint_dirname(m, dir, epoch, step);
+    // Restart on a different number of ranks through the tensor index
+    std::vector<char> index;
+    int index_ranks = 0;
+    if (comm->am_trainer_master()) {
+      index_ranks = read_index(get_distributed_checkpoint_index_filename(m, dir, epoch, step),
+                               index);
+    }
+    comm->trainer_broadcast(0, index_ranks);
+    if (index_ranks > 0 && index_ranks != comm->get_procs_per_trainer()) {
+      if (comm->am_trainer_master()) {
+        printf("Restart: checkpoint was written by %d ranks, reading it with %d ranks\n",
+               index_ranks, comm->get_procs_per_trainer());
+        fflush(stdout);
+      }
+      comm->trainer_broadcast(0, index);
+      p.set_elastic_restart(std::string(index.begin(), index.end()));
+      // Scalar state is the same on all ranks, so it is read from rank 0
+      epochdir = get_distributed_checkpoint_dirname(m, dir, epoch, step, 0);
+      // Ranks that wrote the checkpoint restore their own random
+      // number generators, and added ranks reseed theirs
+      if (comm->get_rank_in_trainer() < index_ranks) {
+        p.set_rank_checkpoint_dir(get_distributed_checkpoint_dirname(m, dir, epoch, step));
+      }
+    } else {
+      epochdir = get_distributed_checkpoint_dirname(m, dir, epoch, step);
+    }
     p.open_restart(epochdir.c_str());
     m->load_from_checkpoint_distributed(p);
     p.close_restart();
+    p.clear_elastic_restart();
   }
   else {
     epochdir = get_shared_checkpoint_dirname(m, dir, epoch, step);
@@ -307,6 +432,8 @@ bool checkpoint::restart(model *m) {
     }
     // Ensure all ranks have access to checkpoint dir, needed for loading rank specific rng state
     comm->trainer_broadcast(0, &(p.m_checkpoint_dir[0]), sizeof(p.m_checkpoint_dir));
+    // Matrices missing from an incremental checkpoint are read from its base
+    comm->trainer_broadcast(0, &(p.m_base_checkpoint_dir[0]), sizeof(p.m_base_checkpoint_dir));
     m->load_from_checkpoint_shared(p);
     if(comm->am_trainer_master())
       p.close_restart();
@@ -341,7 +468,9 @@ build_checkpoint_callback_from_pbuf(
                                                 params.checkpoint_secs(),
                                                 params.per_rank_dir(),
                                                 params.ckpt_dist_epochs(),
-                                                params.ckpt_dist_steps());
+                                                params.ckpt_dist_steps(),
+                                                params.full_checkpoint_interval(),
+                                                params.compression());
 }
 
 } // namespace callback
@@ -35,6 +35,18 @@
 namespace lbann {
 namespace callback {
 
+dump_gradients::dump_gradients(std::string basename,
+                               int batch_interval,
+                               std::string format,
+                               bool background)
+  : callback_base(batch_interval),
+    m_basename(std::move(basename)),
+    m_format(format.empty() ? "ascii" : std::move(format)),
+    m_writer(m_format == "ascii" ?
+             tensor_dump_writer::format::npy :
+             tensor_dump_writer::parse_format(m_format),
+             background && m_format != "ascii") {}
+
 void dump_gradients::on_backward_prop_end(model *m) {
   for (weights *w : m->get_weights()) {
     optimizer *opt = w->get_optimizer();
@@ -46,9 +58,15 @@ void dump_gradients::on_backward_prop_end(model *m) {
            + "-step" + std::to_string(m->get_step())
            + "-" + w->get_name()
            + "-Gradient");
-      El::Write(opt->get_gradient(), file, El::ASCII);
+      if (m_format == "ascii") {
+        El::Write(opt->get_gradient(), file, El::ASCII);
+      } else {
+        m_writer.add(opt->get_gradient(), file, {},
+                     m->get_comm()->am_trainer_master());
+      }
     }
   }
+  m_writer.flush();
 }
 
 std::unique_ptr<callback_base>
@@ -57,7 +75,9 @@ build_dump_gradients_callback_from_pbuf(
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackDumpGradients&>(proto_msg);
   return make_unique<dump_gradients>(params.basename(),
-                                                    params.interval());
+                                     params.interval(),
+                                     params.format(),
+                                     params.background());
 }
 
 } // namespace callback
@@ -39,6 +39,11 @@ namespace callback {
 
 namespace {
 
+/** Whether each process writes its own block of the output. */
+bool is_block_format(const std::string& file_format) {
+  return file_format == "npy_blocks" || file_format == "raw_blocks";
+}
+
 /** Save text file.
  *
  *  Each line corresponds to a mini-batch sample. This is the
@@ -101,12 +106,17 @@ dump_outputs::dump_outputs(std::set<std::string> layer_names,
                            std::set<execution_mode> modes,
                            El::Int batch_interval,
                            std::string directory,
-                           std::string file_format)
+                           std::string file_format,
+                           bool background)
   : callback_base(std::max(batch_interval, El::Int(1))),
     m_layer_names(std::move(layer_names)),
     m_modes(std::move(modes)),
     m_directory(std::move(directory)),
-    m_file_format(std::move(file_format)) {
+    m_file_format(std::move(file_format)),
+    m_writer(is_block_format(m_file_format) ?
+             tensor_dump_writer::parse_format(m_file_format) :
+             tensor_dump_writer::format::npy,
+             background && is_block_format(m_file_format)) {
   std::stringstream err;
 
   // Initialize directory for output files
@@ -126,7 +136,8 @@ dump_outputs::dump_outputs(std::set<std::string> layer_names,
   }
 #endif // LBANN_HAS_CNPY
   if (m_file_format != "csv" && m_file_format != "tsv"
-      && m_file_format != "npy" && m_file_format != "npz") {
+      && m_file_format != "npy" && m_file_format != "npz"
+      && !is_block_format(m_file_format)) {
     err << "callback \"" << this->name() << "\" attempted "
         << "to use invalid file format (" << m_file_format << ")";
     LBANN_ERROR(err.str());
@@ -149,6 +160,23 @@ void dump_outputs::do_dump_outputs(const model& m, const Layer& l) {
   // Create directory
   file::make_directory(m_directory);
 
+  // Each process saves its local block of layer outputs
+  if (is_block_format(m_file_format)) {
+    for (int i = 0; i < l.get_num_children(); ++i) {
+      const std::string prefix = (m_directory
+                                  + m.get_name()
+                                  + "-" + to_string(mode)
+                                  + "-epoch" + std::to_string(epoch)
+                                  + "-step" + std::to_string(step)
+                                  + "-" + l.get_name()
+                                  + "-output" + std::to_string(i));
+      m_writer.add(l.get_activations(i), prefix, l.get_output_dims(i),
+                   m.get_comm()->am_trainer_master());
+    }
+    m_writer.flush();
+    return;
+  }
+
   // Save layer outputs on root process
   for (int i = 0; i < l.get_num_children(); ++i) {
     const CircMat<El::Device::CPU> circ_data(l.get_activations(i));
@@ -191,7 +219,8 @@ build_dump_outputs_callback_from_pbuf(
                                                   modes,
                                                   params.batch_interval(),
                                                   params.directory(),
-                                                  params.format());
+                                                  params.format(),
+                                                  params.background());
 }
 
 } // namespace callback
@@ -36,6 +36,17 @@
 namespace lbann {
 namespace callback {
 
+dump_weights::dump_weights(std::string basename,
+                           std::string format,
+                           bool background)
+  : callback_base(),
+    m_basename(std::move(basename)),
+    m_format(format.empty() ? "ascii" : std::move(format)),
+    m_writer(m_format == "ascii" ?
+             tensor_dump_writer::format::npy :
+             tensor_dump_writer::parse_format(m_format),
+             background && m_format != "ascii") {}
+
 void dump_weights::on_train_begin(model *m) {
   do_dump_weights(m, "initial");
 }
@@ -56,8 +67,14 @@ void dump_weights::do_dump_weights(model *m, std::string s) {
          + epoch
          + "-" + w->get_name()
          + "-Weights");
-    El::Write(w->get_values(), file, El::ASCII);
+    if (m_format == "ascii") {
+      El::Write(w->get_values(), file, El::ASCII);
+    } else {
+      m_writer.add(w->get_values(), file, {},
+                   m->get_comm()->am_trainer_master());
+    }
   }
+  m_writer.flush();
 }
 
 std::unique_ptr<callback_base>
@@ -65,7 +82,9 @@ build_dump_weights_callback_from_pbuf(
   const google::protobuf::Message& proto_msg, const std::shared_ptr<lbann_summary>&) {
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackDumpWeights&>(proto_msg);
-  return make_unique<dump_weights>(params.basename());
+  return make_unique<dump_weights>(params.basename(),
+                                   params.format(),
+                                   params.background());
 }
 
 } // namespace callback
@@ -29,6 +29,7 @@
 #include <utility>
 
 #include "lbann/callbacks/monitor_io.hpp"
+#include "lbann/io/async_file_reader.hpp"
 #include "lbann/layers/io/input/generic_input_layer.hpp"
 #include "lbann/proto/proto_common.hpp"
 
@@ -37,6 +38,32 @@
 namespace lbann {
 namespace callback {
 
+void monitor_io::report_async_io(model *m, execution_mode mode) {
+  // Only report if an input layer reads with async I/O, to avoid
+  // starting the shared reader's threads otherwise
+  bool async_io = false;
+  for (Layer *layer : m->get_layers()) {
+    auto *input = dynamic_cast<generic_input_layer *> (layer);
+    if (input != nullptr) {
+      auto *reader = input->get_data_reader(mode);
+      async_io = async_io || (reader != nullptr && reader->using_async_io());
+    }
+  }
+  if (!async_io) { return; }
+  lbann_comm *comm = m->get_comm();
+  auto& async_reader = async_file_reader::get_shared();
+  const auto stats = async_reader.get_statistics();
+  async_reader.reset_statistics();
+  std::cout << "Rank " << comm->get_trainer_rank() << "."
+            << comm->get_rank_in_trainer() << " read "
+            << stats.num_files << " files ("
+            << stats.num_bytes / (1024.0 * 1024.0) << " MB) with "
+            << async_reader.get_backend() << ": "
+            << stats.iops() << " IOPS, mean queue depth "
+            << stats.queue_depth() << " of "
+            << async_reader.get_queue_depth() << std::endl;
+}
+
 void monitor_io::on_epoch_end(model *m) {
   lbann_comm *comm = m->get_comm();
   for (Layer *layer : m->get_layers()) {
@@ -52,6 +79,7 @@ void monitor_io::on_epoch_end(model *m) {
       }
     }
   }
+  report_async_io(m, execution_mode::training);
 }
 
 void monitor_io::on_test_end(model *m) {
@@ -70,6 +98,7 @@ void monitor_io::on_test_end(model *m) {
       }
     }
   }
+  report_async_io(m, execution_mode::testing);
 }
 
 std::unique_ptr<callback_base>
@@ -0,0 +1,213 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/pipeline_plan.hpp"
+#include "lbann/utils/memory.hpp"
+#include "lbann/utils/pipeline_schedule.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <callbacks.pb.h>
+
+#include <iomanip>
+#include <sstream>
+
+namespace lbann {
+namespace callback {
+
+pipeline_plan::pipeline_plan(El::Int num_stages, El::Int num_micro_batches)
+  : callback_base(1),
+    m_num_stages(num_stages),
+    m_num_micro_batches(num_micro_batches) {
+  if (m_num_stages < 1 || m_num_micro_batches < 1) {
+    std::stringstream err;
+    err << "pipeline plan callback requires a positive number of "
+        << "stages and micro-batches "
+        << "(got " << m_num_stages << " stages and "
+        << m_num_micro_batches << " micro-batches)";
+    LBANN_ERROR(err.str());
+  }
+}
+
+void pipeline_plan::on_epoch_begin(model *m) {
+  m_num_batches = 0;
+  m_fp_times.clear();
+  m_bp_times.clear();
+}
+
+void pipeline_plan::on_epoch_end(model *m) {
+  if (!m_done && m_num_batches > 0) {
+    report_plan(*m);
+    m_done = true;
+  }
+  if (m->get_num_pipeline_stages() > 1) {
+    report_bubble(*m);
+  }
+}
+
+void pipeline_plan::on_batch_end(model *m) {
+  ++m_num_batches;
+}
+
+void pipeline_plan::on_forward_prop_begin(model *m, Layer *l) {
+  if (m_done || m->get_execution_mode() != execution_mode::training) {
+    return;
+  }
+  m_start_time = get_time();
+}
+
+void pipeline_plan::on_forward_prop_end(model *m, Layer *l) {
+  if (m_done || m->get_execution_mode() != execution_mode::training) {
+    return;
+  }
+  m_fp_times[l] += get_time() - m_start_time;
+}
+
+void pipeline_plan::on_backward_prop_begin(model *m, Layer *l) {
+  if (m_done || m->get_execution_mode() != execution_mode::training) {
+    return;
+  }
+  m_start_time = get_time();
+}
+
+void pipeline_plan::on_backward_prop_end(model *m, Layer *l) {
+  if (m_done || m->get_execution_mode() != execution_mode::training) {
+    return;
+  }
+  m_bp_times[l] += get_time() - m_start_time;
+}
+
+void pipeline_plan::report_plan(model& m) const {
+  auto& comm = *m.get_comm();
+  if (!comm.am_trainer_master()) { return; }
+
+  // Average layer times per mini-batch, in execution order
+  const auto& layers = m.get_layers();
+  const El::Int num_layers = layers.size();
+  std::vector<double> fp_times(num_layers, 0), bp_times(num_layers, 0);
+  std::vector<double> layer_times(num_layers, 0);
+  for (El::Int i = 0; i < num_layers; ++i) {
+    const auto& fp_iter = m_fp_times.find(layers[i]);
+    const auto& bp_iter = m_bp_times.find(layers[i]);
+    if (fp_iter != m_fp_times.end()) {
+      fp_times[i] = fp_iter->second / m_num_batches;
+    }
+    if (bp_iter != m_bp_times.end()) {
+      bp_times[i] = bp_iter->second / m_num_batches;
+    }
+    layer_times[i] = fp_times[i] + bp_times[i];
+  }
+
+  // Split layers into stages with balanced compute
+  const auto& stage_starts = pipeline::partition(layer_times, m_num_stages);
+  const El::Int num_stages = stage_starts.size();
+  if (num_stages == 0) { return; }
+
+  // Estimate stage costs per micro-batch
+  // Note: We assume layer times scale linearly with the number of
+  // samples, so each micro-batch costs 1/num_micro_batches of the
+  // measured mini-batch time.
+  std::vector<double> stage_fp_times(num_stages, 0);
+  std::vector<double> stage_bp_times(num_stages, 0);
+  for (El::Int stage = 0; stage < num_stages; ++stage) {
+    const auto& first = stage_starts[stage];
+    const auto& last = (stage < num_stages - 1 ?
+                        stage_starts[stage+1] - 1 :
+                        num_layers - 1);
+    for (El::Int i = first; i <= last; ++i) {
+      stage_fp_times[stage] += fp_times[i] / m_num_micro_batches;
+      stage_bp_times[stage] += bp_times[i] / m_num_micro_batches;
+    }
+  }
+
+  // Simulate 1F1B schedule
+  const auto& steps = pipeline::one_forward_one_backward(num_stages,
+                                                         m_num_micro_batches);
+  const auto& result = pipeline::simulate(steps,
+                                          stage_fp_times,
+                                          stage_bp_times);
+  double sequential_time = 0;
+  for (const auto& t : layer_times) { sequential_time += t; }
+
+  // Report pipeline plan
+  std::stringstream msg;
+  msg << m.get_name() << " pipeline plan "
+      << "(" << num_stages << " stages, "
+      << m_num_micro_batches << " micro-batches):" << std::endl;
+  for (El::Int stage = 0; stage < num_stages; ++stage) {
+    const auto& first = stage_starts[stage];
+    const auto& last = (stage < num_stages - 1 ?
+                        stage_starts[stage+1] - 1 :
+                        num_layers - 1);
+    msg << "  stage " << stage << ": "
+        << "layers " << layers[first]->get_name()
+        << " to " << layers[last]->get_name() << " "
+        << "(" << last - first + 1 << " layers, "
+        << (stage_fp_times[stage] + stage_bp_times[stage]) * m_num_micro_batches
+        << "s per mini-batch, "
+        << result.idle_times[stage] << "s idle)" << std::endl;
+  }
+  msg << "  sequential mini-batch time : " << sequential_time << "s"
+      << std::endl
+      << "  pipelined mini-batch time : " << result.total_time << "s"
+      << std::endl
+      << "  pipeline bubble : "
+      << std::setprecision(3) << 100 * result.bubble_fraction << "%"
+      << std::endl;
+  std::cout << msg.str() << std::flush;
+
+}
+
+void pipeline_plan::report_bubble(model& m) const {
+  auto& comm = *m.get_comm();
+  const auto& bubble_fraction
+    = (comm.trainer_allreduce(m.get_pipeline_bubble_fraction())
+       / comm.get_procs_per_trainer());
+  if (comm.am_trainer_master()) {
+    std::stringstream msg;
+    msg << m.get_name() << " measured pipeline bubble "
+        << "(" << m.get_num_pipeline_stages() << " stages, "
+        << m.get_num_micro_batches() << " micro-batches) : "
+        << std::setprecision(3) << 100 * bubble_fraction << "%"
+        << std::endl;
+    std::cout << msg.str() << std::flush;
+  }
+}
+
+std::unique_ptr<callback_base>
+build_pipeline_plan_callback_from_pbuf(
+  const google::protobuf::Message& proto_msg, std::shared_ptr<lbann_summary> const&) {
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackPipelinePlan&>(proto_msg);
+  const El::Int num_stages = (params.num_stages() > 0 ?
+                               params.num_stages() : 2);
+  const El::Int num_micro_batches = (params.num_micro_batches() > 0 ?
+                                      params.num_micro_batches() :
+                                      4 * num_stages);
+  return make_unique<pipeline_plan>(num_stages, num_micro_batches);
+}
+
+} // namespace callback
+} // namespace lbann
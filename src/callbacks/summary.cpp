@@ -96,6 +96,9 @@ void summary::on_epoch_end(model *m) {
     m_summarizer->reduce_scalar(phase, train_score, m->get_step(execution_mode::training));
   }
   save_histograms(m);
+  m->get_step_timing().summarize(*m_summarizer, *m->get_comm(),
+                                 execution_mode::training,
+                                 m->get_step(execution_mode::training));
   m_summarizer->flush();
   prof_region_end("summary-epoch", false);
 }
@@ -116,6 +119,9 @@ void summary::on_test_end(model *m) {
     std::string phase = "test_" + metric_name;
     m_summarizer->reduce_scalar(phase, test_score, m->get_step(execution_mode::training));
   }
+  m->get_step_timing().summarize(*m_summarizer, *comm,
+                                 execution_mode::testing,
+                                 m->get_step(execution_mode::training));
   // Reset counters incremented during test phase.
   comm->reset_stats_counters();
   for (auto&& layer : m->get_layers()) {
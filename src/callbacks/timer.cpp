@@ -27,6 +27,7 @@
 #include "lbann/callbacks/timer.hpp"
 #include "lbann/utils/timer.hpp"
 #include <algorithm>
+#include <iomanip>
 
 namespace lbann {
 namespace callback {
@@ -163,6 +164,26 @@ void timer::timing_end(model& m) {
         std::cout << " stdev" << std::endl;
       }
 
+      // Print step time breakdown for this trainer
+      const auto& timing = m.get_step_timing();
+      const auto totals = timing.get_totals(mode);
+      const auto total_time = std::accumulate(totals.begin(),
+                                              totals.end(),
+                                              zero);
+      if (total_time > zero) {
+        std::cout << m.get_name() << " (instance "
+                  << comm.get_trainer_rank() << ") " << mode_string << " "
+                  << "step time breakdown :";
+        for (int i = 0; i < step_timing::num_categories; ++i) {
+          const auto c = static_cast<step_timing::category>(i);
+          std::cout << (i > 0 ? "," : "") << " "
+                    << step_timing::category_name(c) << " "
+                    << std::setprecision(3)
+                    << 100 * totals[i] / total_time << "%";
+        }
+        std::cout << std::setprecision(6) << std::endl;
+      }
+
     }
   }
 
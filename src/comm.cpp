@@ -140,6 +140,7 @@ void lbann_comm::allreduce(AbsMat& m,
   if (El::mpi::Size(c) == 1 || m.Height() < 1 || m.Width() < 1) {
     return;
   }
+  step_timing::scope timing_scope(step_timing::category::comm_wait);
   const int local_size = m.Height() * m.Width();
   bytes_sent += sizeof(DataType) * local_size;
 #ifdef LBANN_HAS_ALUMINUM
@@ -313,6 +314,7 @@ void lbann_comm::nb_allreduce(AbsDistMat& m,
 }
 
 void lbann_comm::wait(Al::request& req) {
+  step_timing::scope timing_scope(step_timing::category::comm_wait);
 #ifdef LBANN_HAS_ALUMINUM
   if (req.mpi_req != Al::mpi_null_req) {
     ::Al::Wait<::Al::MPIBackend>(req.mpi_req);
@@ -383,6 +385,7 @@ void lbann_comm::global_barrier() {
 }
 
 void lbann_comm::barrier(const El::mpi::Comm& c) {
+  step_timing::scope timing_scope(step_timing::category::comm_wait);
   El::mpi::Barrier(c);
 }
 
@@ -128,6 +128,10 @@ int lbann::generic_data_reader::fetch_data(CPUMat& X, El::Matrix<El::Int>& indic
     }
   }
 
+  if (m_async_io) {
+    read_async_files(mb_size);
+  }
+
   /// Allow each thread to perform any preprocessing necessary on the
   /// data source prior to fetching data
   for (int t = 0; t < static_cast<int>(m_io_thread_pool->get_num_threads()); t++) {
@@ -165,6 +169,43 @@ int lbann::generic_data_reader::fetch_data(CPUMat& X, El::Matrix<El::Int>& indic
   return mb_size;
 }
 
+void lbann::generic_data_reader::read_async_files(int mb_size) {
+  m_async_sample_files.clear();
+  if (data_store_active()) {
+    return;
+  }
+
+  // Collect the files of all samples in the mini-batch
+  std::vector<std::pair<std::string, size_t>> files;
+  for (int s = 0; s < mb_size; s++) {
+    int n = m_current_pos + (s * m_sample_stride);
+    int index = m_shuffled_indices[n];
+    const size_t first = files.size();
+    get_sample_files(index, files);
+    m_async_sample_files[index] = std::make_pair(first, files.size() - first);
+  }
+  if (files.empty()) {
+    m_async_sample_files.clear();
+    return;
+  }
+
+  // Read all files at once
+  m_async_requests.resize(files.size());
+  for (size_t i = 0; i < files.size(); ++i) {
+    m_async_requests[i].path = std::move(files[i].first);
+    m_async_requests[i].length = files[i].second;
+  }
+  async_file_reader::get_shared().read_batch(m_async_requests);
+}
+
+std::vector<char>* lbann::generic_data_reader::get_async_file(int data_id, size_t file) {
+  const auto& it = m_async_sample_files.find(data_id);
+  if (it == m_async_sample_files.end() || file >= it->second.second) {
+    return nullptr;
+  }
+  return &m_async_requests[it->second.first + file].data;
+}
+
 void lbann::generic_data_reader::set_jag_variables(int mb_size) {
   // all min_batches have the same number of indices;
   // this probably causes a few indices to be discarded,
@@ -583,6 +624,12 @@ bool generic_data_reader::save_to_checkpoint_distributed(persist& p, const char
 bool lbann::generic_data_reader::load_from_checkpoint_distributed(persist& p, const char *name) {
   struct packing_header header;
   unpack_scalars(p,&header,name);
+
+  // On a different process layout, every rank reads the state of
+  // rank 0, so adjust current position as in a shared restart
+  if (p.is_elastic_restart()) {
+    m_current_pos += m_comm->get_rank_in_trainer();
+  }
   return true;
 }
 
@@ -68,6 +68,9 @@ image_data_reader& image_data_reader::operator=(const image_data_reader& rhs) {
   m_image_num_channels = rhs.m_image_num_channels;
   m_image_linearized_size = rhs.m_image_linearized_size;
   m_num_labels = rhs.m_num_labels;
+  m_use_image_shards = rhs.m_use_image_shards;
+  m_image_shards_mmap = rhs.m_image_shards_mmap;
+  m_image_shards = rhs.m_image_shards;
 
   return (*this);
 }
@@ -90,6 +93,9 @@ void image_data_reader::copy_members(const image_data_reader &rhs, const std::ve
   m_image_num_channels = rhs.m_image_num_channels;
   m_image_linearized_size = rhs.m_image_linearized_size;
   m_num_labels = rhs.m_num_labels;
+  m_use_image_shards = rhs.m_use_image_shards;
+  m_image_shards_mmap = rhs.m_image_shards_mmap;
+  m_image_shards = rhs.m_image_shards;
   //m_thread_cv_buffer = rhs.m_thread_cv_buffer
 }
 
@@ -145,19 +151,30 @@ void image_data_reader::load() {
 
   // load image list
   m_image_list.clear();
-  FILE *fplist = fopen(imageListFile.c_str(), "rt");
-  if (!fplist) {
-    LBANN_ERROR("failed to open: " + imageListFile + " for reading");
-  }
-  while (!feof(fplist)) {
-    char imagepath[512];
-    label_t imagelabel;
-    if (fscanf(fplist, "%s%d", imagepath, &imagelabel) <= 1) {
-      break;
+  if (m_use_image_shards) {
+    // Image paths are not needed with packed shards
+    m_image_shards = std::make_shared<const image_shards>(
+      imageListFile, get_file_dir(), m_image_shards_mmap);
+    const El::Int num_samples = m_image_shards->get_num_samples();
+    m_image_list.reserve(num_samples);
+    for (El::Int i = 0; i < num_samples; ++i) {
+      m_image_list.emplace_back(img_src_t(), m_image_shards->get_label(i));
+    }
+  } else {
+    FILE *fplist = fopen(imageListFile.c_str(), "rt");
+    if (!fplist) {
+      LBANN_ERROR("failed to open: " + imageListFile + " for reading");
+    }
+    while (!feof(fplist)) {
+      char imagepath[512];
+      label_t imagelabel;
+      if (fscanf(fplist, "%s%d", imagepath, &imagelabel) <= 1) {
+        break;
+      }
+      m_image_list.emplace_back(imagepath, imagelabel);
     }
-    m_image_list.emplace_back(imagepath, imagelabel);
+    fclose(fplist);
   }
-  fclose(fplist);
 
   // reset indices
   m_shuffled_indices.clear();
@@ -236,12 +253,48 @@ std::vector<image_data_reader::sample_t> image_data_reader::get_image_list_of_cu
   return ret;
 }
 
+void image_data_reader::get_sample_files(
+  int data_id,
+  std::vector<std::pair<std::string, size_t>>& files) const {
+  if (m_image_shards == nullptr) {
+    files.emplace_back(get_file_dir() + m_image_list[data_id].first, 0);
+  }
+}
+
+void image_data_reader::load_image_sample(int data_id,
+                                          El::Matrix<uint8_t>& image,
+                                          std::vector<size_t>& dims) {
+  auto* data = get_async_file(data_id, 0);
+  if (data != nullptr) {
+    // Decode the image that was read with async I/O
+    const El::Int size = data->size();
+    El::Matrix<uint8_t> encoded_image(size, 1,
+                                      reinterpret_cast<uint8_t*>(data->data()),
+                                      std::max(size, El::Int(1)));
+    decode_image(encoded_image, image, dims);
+  } else if (m_image_shards != nullptr) {
+    El::Matrix<uint8_t> encoded_image;
+    m_image_shards->read(data_id, encoded_image);
+    decode_image(encoded_image, image, dims);
+  } else {
+    load_image(get_file_dir() + m_image_list[data_id].first, image, dims);
+  }
+}
+
+void image_data_reader::read_encoded_image(int data_id,
+                                           std::vector<char>& data) const {
+  if (m_image_shards != nullptr) {
+    m_image_shards->read(data_id, data);
+  } else {
+    read_raw_data(get_file_dir() + m_image_list[data_id].first, data);
+  }
+}
+
 void image_data_reader::load_conduit_node_from_file(int data_id, conduit::Node &node) {
   node.reset();
-  const std::string filename = get_file_dir() + m_image_list[data_id].first;
   int label = m_image_list[data_id].second;
   std::vector<char> data;
-  read_raw_data(filename, data);
+  read_encoded_image(data_id, data);
   node[LBANN_DATA_ID_STR(data_id) + "/label"].set(label);
   node[LBANN_DATA_ID_STR(data_id) + "/buffer"].set(data);
   node[LBANN_DATA_ID_STR(data_id) + "/buffer_size"] = data.size();
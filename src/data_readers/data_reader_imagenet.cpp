@@ -60,7 +60,6 @@ CPUMat imagenet_reader::create_datum_view(CPUMat& X, const int mb_idx) const {
 bool imagenet_reader::fetch_datum(CPUMat& X, int data_id, int mb_idx) {
   El::Matrix<uint8_t> image;
   std::vector<size_t> dims;
-  const std::string image_path = get_file_dir() + m_image_list[data_id].first;
 
   if (m_data_store != nullptr) {
     bool have_node = true;
@@ -89,7 +88,7 @@ bool imagenet_reader::fetch_datum(CPUMat& X, int data_id, int mb_idx) {
         }
       }
       m_issue_warning = false;
-      load_image(image_path, image, dims);
+      load_image_sample(data_id, image, dims);
       have_node = false;
     }
 
@@ -103,7 +102,7 @@ bool imagenet_reader::fetch_datum(CPUMat& X, int data_id, int mb_idx) {
   
   // this block fires if not using data store
   else {
-    load_image(image_path, image, dims);
+    load_image_sample(data_id, image, dims);
   }
 
   auto X_v = create_datum_view(X, mb_idx);
@@ -29,9 +29,51 @@
 #include "lbann/data_readers/data_reader_mesh.hpp"
 #include "lbann/utils/glob.hpp"
 #include <omp.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
 
 namespace lbann {
 
+namespace {
+
+/// Header of a packed mesh file.
+struct packed_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint64_t num_samples;
+  uint32_t num_channels;
+  uint32_t height;
+  uint32_t width;
+  uint32_t reserved;
+};
+constexpr char packed_magic[8] = {'L','B','A','N','N','M','S','H'};
+constexpr uint32_t packed_version = 1;
+constexpr uint32_t packed_byte_order = 0x01020304;
+
+/// Read size bytes at offset, retrying on short reads.
+void pread_all(int fd, void* buf, size_t size, off_t offset,
+               const std::string& filename) {
+  char* ptr = static_cast<char*>(buf);
+  size_t pos = 0;
+  while (pos < size) {
+    const ssize_t bytes = pread(fd, ptr + pos, size - pos, offset + pos);
+    if (bytes < 0 && errno == EINTR) { continue; }
+    if (bytes <= 0) {
+      throw lbann_exception("mesh_reader: failed to read " + filename
+                            + (bytes < 0 ?
+                               " (" + std::string(std::strerror(errno)) + ")" :
+                               std::string()));
+    }
+    pos += bytes;
+  }
+}
+
+}  // namespace
+
 mesh_reader::mesh_reader(bool shuffle)
   : generic_data_reader(shuffle) {}
 
@@ -39,23 +81,27 @@ void mesh_reader::load() {
   if (m_data_height == 0 || m_data_width == 0) {
     throw lbann_exception("mesh_reader: data shape must be non-zero");
   }
-  // Compute total number of samples based on number of targets.
-  std::vector<std::string> matches = glob(
-    get_file_dir() + m_target_name + m_suffix + "/*.bin");
-  if (matches.size() == 0) {
-    throw lbann_exception("mesh_reader: could not find any targets");
-  }
-  m_num_samples = matches.size();
-  // Set up buffers to load data into.
-  m_load_bufs.resize(omp_get_max_threads());
-  for (auto&& buf : m_load_bufs) {
-    buf.resize(m_data_height * m_data_width);
-  }
-  // Set up the format string.
-  if (std::pow(10, m_index_length) <= m_num_samples) {
-    throw lbann_exception("mesh_reader: index length too small");
+  if (m_use_packed_file) {
+    load_packed_file();
+  } else {
+    // Compute total number of samples based on number of targets.
+    std::vector<std::string> matches = glob(
+      get_file_dir() + m_target_name + m_suffix + "/*.bin");
+    if (matches.size() == 0) {
+      throw lbann_exception("mesh_reader: could not find any targets");
+    }
+    m_num_samples = matches.size();
+    // Set up buffers to load data into.
+    m_load_bufs.resize(omp_get_max_threads());
+    for (auto&& buf : m_load_bufs) {
+      buf.resize(m_data_height * m_data_width);
+    }
+    // Set up the format string.
+    if (std::pow(10, m_index_length) <= m_num_samples) {
+      throw lbann_exception("mesh_reader: index length too small");
+    }
+    m_index_format_str = "%0" + std::to_string(m_index_length) + "d";
   }
-  m_index_format_str = "%0" + std::to_string(m_index_length) + "d";
   // Set up to record flipping if needed.
   if (m_random_flips) {
     m_flip_choices.resize(m_num_samples);
@@ -74,31 +120,75 @@ bool mesh_reader::fetch_datum(CPUMat& X, int data_id, int mb_idx) {
     m_flip_choices[data_id].first = dist(gen);
     m_flip_choices[data_id].second = dist(gen);
   }
+  if (m_use_packed_file) {
+    // All channels are contiguous in the record and in X.
+    const size_t image_size = m_data_height * m_data_width;
+    DataType* buf = X.Buffer(0, mb_idx);
+    read_packed(data_id, 0, m_channels.size() * image_size, buf);
+    if (m_random_flips) {
+      for (size_t i = 0; i < m_channels.size(); ++i) {
+        apply_flips(data_id, buf + i * image_size);
+      }
+    }
+    return true;
+  }
   for (size_t i = 0; i < m_channels.size(); ++i) {
     Mat X_view = El::View(
       X, El::IR(i*m_data_height*m_data_width, (i+1)*m_data_height*m_data_width),
       El::IR(mb_idx));
-    load_file(data_id, m_channels[i], X_view);
+    load_file(data_id, i, X_view);
   }
   return true;
 }
 
 bool mesh_reader::fetch_response(CPUMat& Y, int data_id, int mb_idx) {
+  if (m_use_packed_file) {
+    // The target follows the channels in the record.
+    const size_t image_size = m_data_height * m_data_width;
+    DataType* buf = Y.Buffer(0, mb_idx);
+    read_packed(data_id, m_channels.size() * image_size, image_size, buf);
+    if (m_random_flips) {
+      apply_flips(data_id, buf);
+    }
+    return true;
+  }
   Mat Y_view = El::View(Y, El::ALL, El::IR(mb_idx));
-  load_file(data_id, m_target_name, Y_view);
+  load_file(data_id, m_channels.size(), Y_view);
   return true;
 }
 
-void mesh_reader::load_file(int data_id, const std::string channel, Mat& mat) {
-  const std::string filename = construct_filename(channel, data_id);
-  std::ifstream f(filename, std::ios::binary);
-  if (f.fail()) {
-    throw lbann_exception("mesh_reader: failed to open " + filename);
+void mesh_reader::get_sample_files(
+  int data_id,
+  std::vector<std::pair<std::string, size_t>>& files) const {
+  if (m_use_packed_file) {
+    return;
   }
-  // Load into a local buffer.
-  DataType* buf = m_load_bufs[omp_get_thread_num()].data();
-  if (!f.read((char*) buf, m_data_height * m_data_width * sizeof(float))) {
-    throw lbann_exception("mesh_reader: failed to read " + filename);
+  const size_t size = m_data_height * m_data_width * sizeof(float);
+  for (const auto& channel : m_channels) {
+    files.emplace_back(construct_filename(channel, data_id), size);
+  }
+  files.emplace_back(construct_filename(m_target_name, data_id), size);
+}
+
+void mesh_reader::load_file(int data_id, size_t channel, Mat& mat) {
+  DataType* buf;
+  auto* data = get_async_file(data_id, channel);
+  if (data != nullptr) {
+    // Already read with async I/O.
+    buf = reinterpret_cast<DataType*>(data->data());
+  } else {
+    const std::string filename = construct_filename(
+      channel < m_channels.size() ? m_channels[channel] : m_target_name,
+      data_id);
+    std::ifstream f(filename, std::ios::binary);
+    if (f.fail()) {
+      throw lbann_exception("mesh_reader: failed to open " + filename);
+    }
+    // Load into a local buffer.
+    buf = m_load_bufs[omp_get_thread_num()].data();
+    if (!f.read((char*) buf, m_data_height * m_data_width * sizeof(float))) {
+      throw lbann_exception("mesh_reader: failed to read " + filename);
+    }
   }
   if (std::is_same<float, DataType>::value) {
     // Need to transpose from row-major to column-major order.
@@ -107,12 +197,7 @@ void mesh_reader::load_file(int data_id, const std::string channel, Mat& mat) {
     El::Transpose(tmp_mat, mat_reshape);
     // Flip if needed.
     if (m_random_flips) {
-      if (m_flip_choices[data_id].first) {
-        horizontal_flip(mat_reshape);
-      }
-      if (m_flip_choices[data_id].second) {
-        vertical_flip(mat_reshape);
-      }
+      apply_flips(data_id, mat_reshape.Buffer());
     }
   } else {
     // Need to transpose and convert from float. Not yet supported.
@@ -120,13 +205,81 @@ void mesh_reader::load_file(int data_id, const std::string channel, Mat& mat) {
   }
 }
 
-std::string mesh_reader::construct_filename(std::string channel, int data_id) {
+std::string mesh_reader::construct_filename(std::string channel, int data_id) const {
   std::string filename = get_file_dir() + channel + m_suffix + "/" + channel;
   char idx[m_index_length + 1];
   std::snprintf(idx, m_index_length + 1, m_index_format_str.c_str(), data_id);
   return filename + std::string(idx) + ".bin";
 }
 
+void mesh_reader::load_packed_file() {
+  if (!std::is_same<float, DataType>::value) {
+    throw lbann_exception("mesh_reader: does not support DataType != float");
+  }
+  const std::string filename = get_data_filename();
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw lbann_exception("mesh_reader: failed to open " + filename);
+  }
+  m_packed_fd = std::shared_ptr<const int>(new int(fd), [](const int* ptr) {
+      close(*ptr);
+      delete ptr;
+    });
+  // Check header.
+  packed_header header;
+  pread_all(fd, &header, sizeof(header), 0, filename);
+  if (std::memcmp(header.magic, packed_magic, sizeof(packed_magic)) != 0
+      || header.byte_order != packed_byte_order
+      || header.version != packed_version) {
+    throw lbann_exception("mesh_reader: " + filename
+                          + " is not a packed mesh file for this system");
+  }
+  if (header.num_channels != m_channels.size()
+      || header.height != static_cast<uint32_t>(m_data_height)
+      || header.width != static_cast<uint32_t>(m_data_width)) {
+    std::stringstream err;
+    err << "mesh_reader: " << filename << " has "
+        << header.num_channels << " channels of size "
+        << header.height << " x " << header.width << ", but expected "
+        << m_channels.size() << " channels of size "
+        << m_data_height << " x " << m_data_width;
+    throw lbann_exception(err.str());
+  }
+  const uint64_t record_size =
+    (m_channels.size() + 1) * m_data_height * m_data_width * sizeof(float);
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0
+      || static_cast<uint64_t>(file_stat.st_size)
+         != sizeof(header) + header.num_samples * record_size) {
+    throw lbann_exception("mesh_reader: " + filename
+                          + " does not match its header");
+  }
+  if (header.num_samples == 0) {
+    throw lbann_exception("mesh_reader: " + filename + " has no samples");
+  }
+  m_num_samples = header.num_samples;
+}
+
+void mesh_reader::read_packed(int data_id, size_t offset, size_t count,
+                              DataType* buf) {
+  const size_t record_values =
+    (m_channels.size() + 1) * m_data_height * m_data_width;
+  const off_t pos = sizeof(packed_header)
+    + (data_id * record_values + offset) * sizeof(float);
+  pread_all(*m_packed_fd, buf, count * sizeof(float), pos,
+            get_data_filename());
+}
+
+void mesh_reader::apply_flips(int data_id, DataType* buf) {
+  Mat mat(m_data_height, m_data_width, buf, m_data_height);
+  if (m_flip_choices[data_id].first) {
+    horizontal_flip(mat);
+  }
+  if (m_flip_choices[data_id].second) {
+    vertical_flip(mat);
+  }
+}
+
 void mesh_reader::horizontal_flip(CPUMat& mat) {
   // TODO: Could probably optimize this for better locality.
   const El::Int height = mat.Height();
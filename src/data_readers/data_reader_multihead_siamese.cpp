@@ -93,12 +93,30 @@ bool data_reader_multihead_siamese::fetch_datum(Mat& X, int data_id, int mb_idx)
   for (size_t i = 0; i < m_num_img_srcs; ++i) {
     El::Matrix<uint8_t> image;
     std::vector<size_t> dims;
-    load_image(get_file_dir() + sample.first[i], image, dims);
+    auto* data = get_async_file(data_id, i);
+    if (data != nullptr) {
+      const El::Int size = data->size();
+      El::Matrix<uint8_t> encoded_image(
+        size, 1, reinterpret_cast<uint8_t*>(data->data()),
+        std::max(size, El::Int(1)));
+      decode_image(encoded_image, image, dims);
+    } else {
+      load_image(get_file_dir() + sample.first[i], image, dims);
+    }
     m_transform_pipeline.apply(image, X_v[i], dims);
   }
   return true;
 }
 
+void data_reader_multihead_siamese::get_sample_files(
+  int data_id,
+  std::vector<std::pair<std::string, size_t>>& files) const {
+  const sample_t sample = m_samples.get_sample(data_id);
+  for (size_t i = 0; i < m_num_img_srcs; ++i) {
+    files.emplace_back(get_file_dir() + sample.first[i], 0);
+  }
+}
+
 
 bool data_reader_multihead_siamese::fetch_label(Mat& Y, int data_id, int mb_idx) {
   const label_t label = m_samples.get_label(data_id);
@@ -0,0 +1,242 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/data_readers/image_shards.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace lbann {
+
+namespace {
+
+constexpr char shard_magic[8] = {'L','B','A','N','N','S','H','D'};
+constexpr std::uint32_t shard_version = 1;
+constexpr std::uint32_t shard_byte_order = 0x01020304;
+
+} // namespace
+
+image_shards::image_shards(const std::string& list_file,
+                           const std::string& base_dir,
+                           bool use_mmap)
+  : m_use_mmap(use_mmap) {
+
+  // Read shard list
+  std::ifstream in(list_file);
+  if (!in) {
+    LBANN_ERROR("failed to open image shard list " + list_file);
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    line.erase(0, line.find_first_not_of(" \t\r"));
+    line.erase(line.find_last_not_of(" \t\r") + 1);
+    if (line.empty() || line[0] == '#') { continue; }
+    shard s;
+    s.path = (line[0] == '/' || base_dir.empty() ?
+              line : base_dir + "/" + line);
+    m_shards.push_back(s);
+  }
+  if (m_shards.empty()) {
+    LBANN_ERROR("image shard list " + list_file + " has no shards");
+  }
+
+  // Open shards
+  m_offsets.assign(1, 0);
+  for (auto& s : m_shards) {
+    open_shard(s);
+    m_offsets.push_back(m_offsets.back() + s.num_records);
+  }
+  m_num_samples = m_offsets.back();
+
+}
+
+image_shards::~image_shards() {
+  for (auto& s : m_shards) {
+    if (s.data_map != nullptr) {
+      munmap(const_cast<std::uint8_t*>(s.data_map), s.data_size);
+    }
+    if (s.index_map != nullptr) { munmap(s.index_map, s.index_map_size); }
+    if (s.fd >= 0) { close(s.fd); }
+  }
+}
+
+void image_shards::open_shard(shard& s) {
+  std::stringstream err;
+
+  // Map index file
+  const std::string index_path = s.path + ".idx";
+  const int index_fd = open(index_path.c_str(), O_RDONLY);
+  if (index_fd < 0) {
+    err << "failed to open image shard index " << index_path
+        << " (" << std::strerror(errno) << ")";
+    LBANN_ERROR(err.str());
+  }
+  struct stat index_stat;
+  if (fstat(index_fd, &index_stat) != 0
+      || index_stat.st_size < static_cast<off_t>(sizeof(index_header))) {
+    close(index_fd);
+    LBANN_ERROR("image shard index " + index_path + " is truncated");
+  }
+  s.index_map_size = index_stat.st_size;
+  s.index_map = mmap(nullptr, s.index_map_size, PROT_READ, MAP_SHARED,
+                     index_fd, 0);
+  close(index_fd);
+  if (s.index_map == MAP_FAILED) {
+    s.index_map = nullptr;
+    err << "failed to map image shard index " << index_path
+        << " (" << std::strerror(errno) << ")";
+    LBANN_ERROR(err.str());
+  }
+
+  // Check index header
+  index_header header;
+  std::memcpy(&header, s.index_map, sizeof(header));
+  if (std::memcmp(header.magic, shard_magic, sizeof(shard_magic)) != 0) {
+    LBANN_ERROR(index_path + " is not an image shard index");
+  }
+  if (header.byte_order != shard_byte_order) {
+    LBANN_ERROR("image shard index " + index_path
+                + " has a different byte order than this system");
+  }
+  if (header.version != shard_version) {
+    err << "image shard index " << index_path << " has "
+        << "unsupported version " << header.version;
+    LBANN_ERROR(err.str());
+  }
+  if (sizeof(index_header) + header.num_records * sizeof(index_record)
+      > s.index_map_size) {
+    LBANN_ERROR("image shard index " + index_path + " is truncated");
+  }
+  s.num_records = header.num_records;
+  s.data_size = header.data_size;
+  s.records = reinterpret_cast<const index_record*>(
+    static_cast<const char*>(s.index_map) + sizeof(index_header));
+
+  // Open shard file
+  s.fd = open(s.path.c_str(), O_RDONLY);
+  if (s.fd < 0) {
+    err << "failed to open image shard " << s.path
+        << " (" << std::strerror(errno) << ")";
+    LBANN_ERROR(err.str());
+  }
+  struct stat data_stat;
+  if (fstat(s.fd, &data_stat) != 0
+      || static_cast<std::uint64_t>(data_stat.st_size) != s.data_size) {
+    err << "image shard " << s.path << " does not match its index "
+        << "(expected " << s.data_size << " bytes)";
+    LBANN_ERROR(err.str());
+  }
+  for (std::uint64_t i = 0; i < s.num_records; ++i) {
+    const auto& r = s.records[i];
+    if (r.offset > s.data_size || r.length > s.data_size - r.offset) {
+      err << "record " << i << " of image shard index " << index_path << " "
+          << "is outside of the shard";
+      LBANN_ERROR(err.str());
+    }
+  }
+
+  // Map shard file
+  if (m_use_mmap && s.data_size > 0) {
+    void* data_map = mmap(nullptr, s.data_size, PROT_READ, MAP_SHARED,
+                          s.fd, 0);
+    if (data_map == MAP_FAILED) {
+      err << "failed to map image shard " << s.path
+          << " (" << std::strerror(errno) << ")";
+      LBANN_ERROR(err.str());
+    }
+    s.data_map = static_cast<const std::uint8_t*>(data_map);
+  }
+
+}
+
+const image_shards::index_record&
+image_shards::find(El::Int sample, const shard*& s) const {
+  if (sample < 0 || sample >= m_num_samples) {
+    std::stringstream err;
+    err << "attempted to access image shard sample " << sample << ", "
+        << "but there are " << m_num_samples << " samples";
+    LBANN_ERROR(err.str());
+  }
+  const auto it = std::upper_bound(m_offsets.begin(), m_offsets.end(),
+                                   sample);
+  const El::Int shard_index = std::distance(m_offsets.begin(), it) - 1;
+  s = &m_shards[shard_index];
+  return s->records[sample - m_offsets[shard_index]];
+}
+
+int image_shards::get_label(El::Int sample) const {
+  const shard* s;
+  return static_cast<int>(find(sample, s).label);
+}
+
+El::Int image_shards::get_size(El::Int sample) const {
+  const shard* s;
+  return static_cast<El::Int>(find(sample, s).length);
+}
+
+void image_shards::read(El::Int sample, std::uint8_t* buf) const {
+  const shard* s;
+  const auto& r = find(sample, s);
+  if (s->data_map != nullptr) {
+    std::memcpy(buf, s->data_map + r.offset, r.length);
+    return;
+  }
+  std::uint64_t pos = 0;
+  while (pos < r.length) {
+    const auto bytes = pread(s->fd, buf + pos, r.length - pos,
+                             r.offset + pos);
+    if (bytes < 0 && errno == EINTR) { continue; }
+    if (bytes <= 0) {
+      std::stringstream err;
+      err << "failed to read sample " << sample << " "
+          << "from image shard " << s->path;
+      if (bytes < 0) { err << " (" << std::strerror(errno) << ")"; }
+      LBANN_ERROR(err.str());
+    }
+    pos += bytes;
+  }
+}
+
+void image_shards::read(El::Int sample, El::Matrix<std::uint8_t>& buf) const {
+  buf.Resize(get_size(sample), 1);
+  read(sample, buf.Buffer());
+}
+
+void image_shards::read(El::Int sample, std::vector<char>& buf) const {
+  buf.resize(get_size(sample));
+  read(sample, reinterpret_cast<std::uint8_t*>(buf.data()));
+}
+
+} // namespace lbann
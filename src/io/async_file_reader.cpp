@@ -0,0 +1,414 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/io/async_file_reader.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+
+#ifdef LBANN_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if !defined(__NR_io_uring_setup) || !defined(__NR_io_uring_enter)
+#undef LBANN_HAS_IO_URING
+#endif
+#endif // LBANN_HAS_IO_URING
+
+namespace lbann {
+
+namespace {
+
+/** Largest read issued at once. */
+constexpr size_t max_read_size = size_t(1) << 30;
+
+/** Progress of a file that is being read. */
+struct file_state {
+  int fd = -1;
+  size_t done = 0;
+  double start = 0;
+  struct iovec iov;
+};
+
+/** Open a file and size its buffer. Returns an error message. */
+std::string open_file(async_file_reader::request& r, file_state& f) {
+  f.fd = open(r.path.c_str(), O_RDONLY);
+  if (f.fd < 0) {
+    return "failed to open " + r.path + " (" + std::strerror(errno) + ")";
+  }
+  size_t size = r.length;
+  if (size == 0) {
+    struct stat file_stat;
+    if (fstat(f.fd, &file_stat) != 0) {
+      return "failed to stat " + r.path + " (" + std::strerror(errno) + ")";
+    }
+    size = file_stat.st_size;
+  }
+  r.data.resize(size);
+  f.done = 0;
+  return std::string();
+}
+
+void close_file(file_state& f) {
+  if (f.fd >= 0) {
+    close(f.fd);
+    f.fd = -1;
+  }
+}
+
+/** Read a file with blocking reads. Returns an error message. */
+std::string read_file(async_file_reader::request& r) {
+  file_state f;
+  auto error_message = open_file(r, f);
+  while (error_message.empty() && f.done < r.data.size()) {
+    const size_t size = std::min(r.data.size() - f.done, max_read_size);
+    const ssize_t bytes = pread(f.fd, r.data.data() + f.done, size, f.done);
+    if (bytes < 0 && errno == EINTR) { continue; }
+    if (bytes < 0) {
+      error_message = ("failed to read " + r.path
+                       + " (" + std::strerror(errno) + ")");
+    } else if (bytes == 0) {
+      error_message = "unexpected end of file in " + r.path;
+    } else {
+      f.done += bytes;
+    }
+  }
+  close_file(f);
+  return error_message;
+}
+
+} // namespace
+
+#ifdef LBANN_HAS_IO_URING
+
+struct async_file_reader::uring {
+
+  int fd = -1;
+  unsigned* sq_tail = nullptr;
+  unsigned* sq_mask = nullptr;
+  unsigned* sq_array = nullptr;
+  unsigned* cq_head = nullptr;
+  unsigned* cq_tail = nullptr;
+  unsigned* cq_mask = nullptr;
+  struct io_uring_sqe* sqes = nullptr;
+  struct io_uring_cqe* cqes = nullptr;
+  void* sq_ring = MAP_FAILED;
+  size_t sq_ring_size = 0;
+  void* cq_ring = MAP_FAILED;
+  size_t cq_ring_size = 0;
+  size_t sqes_size = 0;
+
+  /** Set up rings. Returns null if io_uring is not available. */
+  static std::unique_ptr<uring> create(unsigned entries) {
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    const int fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) { return nullptr; }
+    std::unique_ptr<uring> ring(new uring());
+    ring->fd = fd;
+    ring->sq_ring_size = (params.sq_off.array
+                          + params.sq_entries * sizeof(unsigned));
+    ring->cq_ring_size = (params.cq_off.cqes
+                          + params.cq_entries * sizeof(struct io_uring_cqe));
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sq_ring = mmap(nullptr, ring->sq_ring_size,
+                         PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         fd, IORING_OFF_SQ_RING);
+    ring->cq_ring = mmap(nullptr, ring->cq_ring_size,
+                         PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         fd, IORING_OFF_CQ_RING);
+    void* sqes = mmap(nullptr, ring->sqes_size,
+                      PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_SQES);
+    if (ring->sq_ring == MAP_FAILED
+        || ring->cq_ring == MAP_FAILED
+        || sqes == MAP_FAILED) {
+      if (sqes != MAP_FAILED) { munmap(sqes, ring->sqes_size); }
+      return nullptr;
+    }
+    auto* sq = static_cast<char*>(ring->sq_ring);
+    auto* cq = static_cast<char*>(ring->cq_ring);
+    ring->sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring->cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<struct io_uring_cqe*>(
+      cq + params.cq_off.cqes);
+    ring->sqes = static_cast<struct io_uring_sqe*>(sqes);
+    return ring;
+  }
+
+  ~uring() {
+    if (sqes != nullptr) { munmap(sqes, sqes_size); }
+    if (cq_ring != MAP_FAILED) { munmap(cq_ring, cq_ring_size); }
+    if (sq_ring != MAP_FAILED) { munmap(sq_ring, sq_ring_size); }
+    if (fd >= 0) { close(fd); }
+  }
+
+  /** Add a read to the submission ring. */
+  void push_read(file_state& f, char* buf, size_t size, uint64_t user_data) {
+    const unsigned tail = *sq_tail;
+    const unsigned index = tail & *sq_mask;
+    auto& sqe = sqes[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    f.iov.iov_base = buf;
+    f.iov.iov_len = size;
+    sqe.opcode = IORING_OP_READV;
+    sqe.fd = f.fd;
+    sqe.addr = reinterpret_cast<uint64_t>(&f.iov);
+    sqe.len = 1;
+    sqe.off = f.done;
+    sqe.user_data = user_data;
+    sq_array[index] = index;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+  }
+
+  /** Submit reads and wait for completions. */
+  int enter(unsigned to_submit, unsigned min_complete) {
+    return syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+                   IORING_ENTER_GETEVENTS, nullptr, 0);
+  }
+
+  /** Process available completions. */
+  template <typename Function>
+  void reap(Function f) {
+    unsigned head = *cq_head;
+    const unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+      const auto& cqe = cqes[head & *cq_mask];
+      f(cqe.user_data, cqe.res);
+    }
+    __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+  }
+
+};
+
+#else
+
+struct async_file_reader::uring {};
+
+#endif // LBANN_HAS_IO_URING
+
+constexpr int async_file_reader::default_queue_depth;
+
+async_file_reader::async_file_reader(int queue_depth)
+  : m_queue_depth(queue_depth) {
+  if (m_queue_depth < 1) {
+    LBANN_ERROR("async_file_reader queue depth must be positive");
+  }
+#ifdef LBANN_HAS_IO_URING
+  m_uring = uring::create(m_queue_depth);
+#endif // LBANN_HAS_IO_URING
+  if (m_uring == nullptr) {
+    m_threads.reset(new thread_pool());
+    m_threads->launch_threads(m_queue_depth);
+  }
+}
+
+async_file_reader::~async_file_reader() {}
+
+async_file_reader& async_file_reader::get_shared() {
+  static async_file_reader reader;
+  return reader;
+}
+
+std::string async_file_reader::get_backend() const {
+  return m_uring != nullptr ? "io_uring" : "threads";
+}
+
+async_file_reader::statistics async_file_reader::get_statistics() const {
+  std::lock_guard<std::mutex> lock(m_stats_mutex);
+  return m_stats;
+}
+
+void async_file_reader::reset_statistics() {
+  std::lock_guard<std::mutex> lock(m_stats_mutex);
+  m_stats = statistics();
+}
+
+void async_file_reader::read_batch(std::vector<request>& requests) {
+  if (requests.empty()) { return; }
+  std::lock_guard<std::mutex> batch_lock(m_batch_mutex);
+  std::vector<double> file_times(requests.size(), 0.0);
+  const auto start = get_time();
+  if (m_uring != nullptr) {
+    read_batch_uring(requests, file_times);
+  } else {
+    read_batch_threads(requests, file_times);
+  }
+  const auto time = get_time() - start;
+
+  // Update statistics
+  uint64_t num_bytes = 0;
+  double file_time = 0;
+  for (size_t i = 0; i < requests.size(); ++i) {
+    num_bytes += requests[i].data.size();
+    file_time += file_times[i];
+  }
+  std::lock_guard<std::mutex> stats_lock(m_stats_mutex);
+  m_stats.num_files += requests.size();
+  m_stats.num_bytes += num_bytes;
+  m_stats.time += time;
+  m_stats.file_time += file_time;
+}
+
+void async_file_reader::read_batch_threads(std::vector<request>& requests,
+                                           std::vector<double>& file_times) {
+  std::atomic<size_t> next(0);
+  std::mutex error_mutex;
+  std::string error_message;
+  auto work = [&]() -> bool {
+    for (size_t i = next++; i < requests.size(); i = next++) {
+      const auto start = get_time();
+      const auto error = read_file(requests[i]);
+      file_times[i] = get_time() - start;
+      if (!error.empty()) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (error_message.empty()) { error_message = error; }
+      }
+    }
+    return true;
+  };
+  const size_t num_jobs = std::min(requests.size(),
+                                   m_threads->get_num_threads());
+  for (size_t i = 0; i < num_jobs; ++i) {
+    m_threads->submit_job_to_work_group(work);
+  }
+  m_threads->finish_work_group();
+  if (!error_message.empty()) { LBANN_ERROR(error_message); }
+}
+
+#ifdef LBANN_HAS_IO_URING
+
+void async_file_reader::read_batch_uring(std::vector<request>& requests,
+                                         std::vector<double>& file_times) {
+  auto& ring = *m_uring;
+  std::vector<file_state> files(requests.size());
+  std::deque<size_t> pending;  // Opened files with bytes left to submit
+  size_t next_file = 0;
+  size_t in_flight = 0;        // Reads in the submission ring or kernel
+  unsigned unsubmitted = 0;    // Reads not yet consumed by the kernel
+  std::string error_message;
+
+  while (true) {
+
+    // Queue reads until the queue is full
+    // Note: Stop queueing after an error, but let queued reads finish
+    // since they write into the request buffers.
+    while (error_message.empty()
+           && in_flight < static_cast<size_t>(m_queue_depth)) {
+      size_t i;
+      if (!pending.empty()) {
+        i = pending.front();
+        pending.pop_front();
+      } else if (next_file < requests.size()) {
+        i = next_file++;
+        files[i].start = get_time();
+        error_message = open_file(requests[i], files[i]);
+        if (!error_message.empty()) { break; }
+        if (requests[i].data.empty()) {
+          close_file(files[i]);
+          continue;
+        }
+      } else {
+        break;
+      }
+      auto& f = files[i];
+      auto& data = requests[i].data;
+      ring.push_read(f, data.data() + f.done,
+                     std::min(data.size() - f.done, max_read_size), i);
+      ++in_flight;
+      ++unsubmitted;
+    }
+    if (in_flight == 0) { break; }
+
+    // Submit reads and wait for at least one to finish
+    const int submitted = ring.enter(unsubmitted, 1);
+    if (submitted < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY) { continue; }
+      LBANN_ERROR(std::string("io_uring_enter failed (")
+                  + std::strerror(errno) + ")");
+    }
+    unsubmitted -= submitted;
+
+    // Process finished reads
+    ring.reap([&](uint64_t i, int res) {
+        --in_flight;
+        auto& f = files[i];
+        const auto& r = requests[i];
+        if (res == -EINTR || res == -EAGAIN) {
+          pending.push_front(i);
+          return;
+        }
+        if (res <= 0) {
+          if (error_message.empty()) {
+            error_message = (res < 0 ?
+                             ("failed to read " + r.path
+                              + " (" + std::strerror(-res) + ")") :
+                             "unexpected end of file in " + r.path);
+          }
+          close_file(f);
+          return;
+        }
+        f.done += res;
+        if (f.done < r.data.size()) {
+          pending.push_back(i);
+        } else {
+          file_times[i] = get_time() - f.start;
+          close_file(f);
+        }
+      });
+
+  }
+
+  // Clean up after errors
+  for (auto& f : files) { close_file(f); }
+  if (!error_message.empty()) { LBANN_ERROR(error_message); }
+
+}
+
+#else
+
+void async_file_reader::read_batch_uring(std::vector<request>&,
+                                         std::vector<double>&) {
+  LBANN_ERROR("LBANN was built without io_uring support");
+}
+
+#endif // LBANN_HAS_IO_URING
+
+} // namespace lbann
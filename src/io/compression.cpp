@@ -0,0 +1,316 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/io/compression.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+
+#ifdef LBANN_HAS_LZ4
+#include <lz4.h>
+#endif // LBANN_HAS_LZ4
+#ifdef LBANN_HAS_ZSTD
+#include <zstd.h>
+#endif // LBANN_HAS_ZSTD
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace lbann {
+
+namespace {
+
+constexpr char frame_magic[8] = {'L','B','A','N','N','C','M','P'};
+constexpr std::uint32_t frame_version = 1;
+
+/** Group the i-th bytes of each value together.
+ *  Trailing bytes that do not form a whole value are copied as is.
+ */
+void shuffle(const char* src, size_t size, size_t element_size, char* dst) {
+  const size_t num_values = size / element_size;
+  for (size_t b = 0; b < element_size; ++b) {
+    for (size_t i = 0; i < num_values; ++i) {
+      dst[b * num_values + i] = src[i * element_size + b];
+    }
+  }
+  const size_t tail = num_values * element_size;
+  std::memcpy(dst + tail, src + tail, size - tail);
+}
+
+/** Inverse of shuffle. */
+void unshuffle(const char* src, size_t size, size_t element_size, char* dst) {
+  const size_t num_values = size / element_size;
+  for (size_t b = 0; b < element_size; ++b) {
+    for (size_t i = 0; i < num_values; ++i) {
+      dst[i * element_size + b] = src[b * num_values + i];
+    }
+  }
+  const size_t tail = num_values * element_size;
+  std::memcpy(dst + tail, src + tail, size - tail);
+}
+
+/** Compress a chunk. Returns 0 if compression failed. */
+size_t compress_chunk(compression_codec codec, int level,
+                      const char* src, size_t size,
+                      std::vector<char>& dst) {
+  switch (codec) {
+#ifdef LBANN_HAS_LZ4
+  case compression_codec::lz4:
+    {
+      dst.resize(LZ4_compressBound(size));
+      const int stored = LZ4_compress_fast(src, dst.data(), size, dst.size(),
+                                           std::max(level, 1));
+      return stored > 0 ? stored : 0;
+    }
+#endif // LBANN_HAS_LZ4
+#ifdef LBANN_HAS_ZSTD
+  case compression_codec::zstd:
+    {
+      dst.resize(ZSTD_compressBound(size));
+      const size_t stored = ZSTD_compress(dst.data(), dst.size(),
+                                          src, size, level);
+      return ZSTD_isError(stored) ? 0 : stored;
+    }
+#endif // LBANN_HAS_ZSTD
+  default:
+    return 0;
+  }
+}
+
+/** Decompress a chunk. Returns false if decompression failed. */
+bool decompress_chunk(compression_codec codec,
+                      const char* src, size_t stored_size,
+                      char* dst, size_t size) {
+  switch (codec) {
+#ifdef LBANN_HAS_LZ4
+  case compression_codec::lz4:
+    return (LZ4_decompress_safe(src, dst, stored_size, size)
+            == static_cast<int>(size));
+#endif // LBANN_HAS_LZ4
+#ifdef LBANN_HAS_ZSTD
+  case compression_codec::zstd:
+    return ZSTD_decompress(dst, size, src, stored_size) == size;
+#endif // LBANN_HAS_ZSTD
+  default:
+    return false;
+  }
+}
+
+/** Largest chunk that every codec can compress. */
+constexpr size_t max_chunk_size = size_t(1) << 30;
+
+} // namespace
+
+std::string to_string(compression_codec codec) {
+  switch (codec) {
+  case compression_codec::none: return "none";
+  case compression_codec::lz4:  return "lz4";
+  case compression_codec::zstd: return "zstd";
+  default: LBANN_ERROR("invalid compression codec");
+  }
+  return "";
+}
+
+bool compression_available(compression_codec codec) {
+  switch (codec) {
+  case compression_codec::none: return true;
+#ifdef LBANN_HAS_LZ4
+  case compression_codec::lz4:  return true;
+#endif // LBANN_HAS_LZ4
+#ifdef LBANN_HAS_ZSTD
+  case compression_codec::zstd: return true;
+#endif // LBANN_HAS_ZSTD
+  default: return false;
+  }
+}
+
+compression_settings parse_compression(const std::string& str) {
+  compression_settings settings;
+  const auto pos = str.find(':');
+  const auto name = str.substr(0, pos);
+  if (name.empty() || name == "none") {
+    settings.codec = compression_codec::none;
+  } else if (name == "lz4") {
+    settings.codec = compression_codec::lz4;
+  } else if (name == "zstd") {
+    settings.codec = compression_codec::zstd;
+  } else {
+    LBANN_ERROR("invalid compression codec (" + name + ")");
+  }
+  if (pos != std::string::npos) {
+    std::istringstream ss(str.substr(pos + 1));
+    if (!(ss >> settings.level) || !ss.eof()) {
+      LBANN_ERROR("invalid compression level (" + str + ")");
+    }
+  }
+  if (!compression_available(settings.codec)) {
+    LBANN_ERROR("LBANN was built without " + name + " compression");
+  }
+  return settings;
+}
+
+bool compression_frame_header::valid() const {
+  return (std::memcmp(magic, frame_magic, sizeof(frame_magic)) == 0
+          && version == frame_version);
+}
+
+std::uint64_t compression_frame_header::payload_size(
+  const std::uint64_t* chunk_sizes) const {
+  std::uint64_t total = num_chunks * sizeof(std::uint64_t);
+  for (std::uint64_t i = 0; i < num_chunks; ++i) {
+    total += chunk_sizes[i];
+  }
+  return total;
+}
+
+void compress(const void* data,
+              size_t size,
+              const compression_settings& settings,
+              std::vector<char>& frame) {
+  if (!compression_available(settings.codec)) {
+    LBANN_ERROR("LBANN was built without "
+                + to_string(settings.codec) + " compression");
+  }
+
+  // Chunks hold whole values, so each can be shuffled on its own
+  const size_t element_size = std::max(settings.element_size, size_t(1));
+  size_t chunk_size = std::min(std::max(settings.chunk_size, element_size),
+                               max_chunk_size);
+  chunk_size -= chunk_size % element_size;
+  const size_t num_chunks = (size + chunk_size - 1) / chunk_size;
+
+  // Shuffle and compress chunks
+  const auto* src = static_cast<const char*>(data);
+  std::vector<std::vector<char>> chunks(num_chunks);
+  LBANN_OMP_PARALLEL_FOR
+  for (size_t i = 0; i < num_chunks; ++i) {
+    const size_t offset = i * chunk_size;
+    const size_t count = std::min(chunk_size, size - offset);
+    std::vector<char> shuffled(count);
+    shuffle(src + offset, count, element_size, shuffled.data());
+    auto& chunk = chunks[i];
+    const size_t stored = compress_chunk(settings.codec, settings.level,
+                                         shuffled.data(), count, chunk);
+    if (stored == 0 || stored >= count) {
+      chunk.swap(shuffled);
+    } else {
+      chunk.resize(stored);
+    }
+  }
+
+  // Assemble frame
+  compression_frame_header header;
+  std::memcpy(header.magic, frame_magic, sizeof(frame_magic));
+  header.version = frame_version;
+  header.codec = static_cast<std::uint32_t>(settings.codec);
+  header.level = settings.level;
+  header.element_size = element_size;
+  header.chunk_size = chunk_size;
+  header.size = size;
+  header.num_chunks = num_chunks;
+  std::vector<std::uint64_t> chunk_sizes(num_chunks);
+  for (size_t i = 0; i < num_chunks; ++i) {
+    chunk_sizes[i] = chunks[i].size();
+  }
+  frame.resize(sizeof(header) + header.payload_size(chunk_sizes.data()));
+  char* pos = frame.data();
+  std::memcpy(pos, &header, sizeof(header));
+  pos += sizeof(header);
+  std::memcpy(pos, chunk_sizes.data(), num_chunks * sizeof(std::uint64_t));
+  pos += num_chunks * sizeof(std::uint64_t);
+  for (const auto& chunk : chunks) {
+    std::memcpy(pos, chunk.data(), chunk.size());
+    pos += chunk.size();
+  }
+
+}
+
+void decompress(const compression_frame_header& header,
+                const char* payload,
+                void* data) {
+  std::stringstream err;
+  const auto codec = static_cast<compression_codec>(header.codec);
+  if (!header.valid()) {
+    LBANN_ERROR("invalid compressed frame");
+  }
+  if (header.codec > static_cast<std::uint32_t>(compression_codec::zstd)) {
+    err << "compressed frame has unknown codec (" << header.codec << ")";
+    LBANN_ERROR(err.str());
+  }
+  if (!compression_available(codec)) {
+    LBANN_ERROR("compressed frame requires " + to_string(codec) + ", "
+                "but LBANN was built without " + to_string(codec)
+                + " compression");
+  }
+  if (header.element_size == 0 || header.chunk_size == 0
+      || header.num_chunks
+         != (header.size + header.chunk_size - 1) / header.chunk_size) {
+    LBANN_ERROR("compressed frame has invalid chunk layout");
+  }
+
+  // Chunk positions in payload
+  const size_t num_chunks = header.num_chunks;
+  std::vector<std::uint64_t> chunk_sizes(num_chunks);
+  std::memcpy(chunk_sizes.data(), payload,
+              num_chunks * sizeof(std::uint64_t));
+  std::vector<std::uint64_t> offsets(num_chunks + 1,
+                                     num_chunks * sizeof(std::uint64_t));
+  for (size_t i = 0; i < num_chunks; ++i) {
+    offsets[i+1] = offsets[i] + chunk_sizes[i];
+  }
+
+  // Decompress and unshuffle chunks
+  auto* dst = static_cast<char*>(data);
+  std::vector<unsigned char> failed(num_chunks, 0);
+  LBANN_OMP_PARALLEL_FOR
+  for (size_t i = 0; i < num_chunks; ++i) {
+    const size_t offset = i * header.chunk_size;
+    const size_t count = std::min<size_t>(header.chunk_size,
+                                          header.size - offset);
+    const char* src = payload + offsets[i];
+    if (chunk_sizes[i] == count) {
+      unshuffle(src, count, header.element_size, dst + offset);
+    } else {
+      std::vector<char> shuffled(count);
+      if (chunk_sizes[i] > count
+          || !decompress_chunk(codec, src, chunk_sizes[i],
+                               shuffled.data(), count)) {
+        failed[i] = 1;
+      } else {
+        unshuffle(shuffled.data(), count, header.element_size, dst + offset);
+      }
+    }
+  }
+  for (size_t i = 0; i < num_chunks; ++i) {
+    if (failed[i]) {
+      err << "failed to decompress chunk " << i << " of compressed frame";
+      LBANN_ERROR(err.str());
+    }
+  }
+
+}
+
+} // namespace lbann
@@ -30,6 +30,7 @@
 #include <cerrno>
 #include <cstring>
 #include <cstdio>
+#include <sstream>
 
 #include "lbann/utils/exception.hpp"
 #include "lbann/io/file_io.hpp"
@@ -61,27 +62,221 @@ struct layer_header {
   uint64_t ldim;       /**< specifies padding of first dimension in local storage */
 };
 
-/** \brief Given an open file descriptor, file name, and a matrix, write the matrix
- *         to the file descriptor, return the number of bytes written */
+namespace {
 
-bool lbann::persist::write_rank_distmat(persist_type type, const char *name, const AbsDistMat& M) {
-  // TODO: store in network order
-  std::string filename = m_checkpoint_dir;
-  if (type == persist_type::train) {
-    filename += std::string("/train_") + name;
-  } else if (type == persist_type::model) {
-    filename += std::string("/model_") + name;
+/** Name of a matrix file within a checkpoint directory. */
+std::string matrix_file_name(lbann::persist_type type, const char *name) {
+  if (type == lbann::persist_type::train) {
+    return std::string("train_") + name;
+  } else if (type == lbann::persist_type::model) {
+    return std::string("model_") + name;
   } else {
     std::stringstream err;
     err << "invalid persist_type (" << static_cast<int>(type) << ")";
     LBANN_ERROR(err.str());
   }
+  return "";
+}
+
+/** Hash of the dimensions and local entries of a matrix.
+ *  64-bit FNV-1a over 8-byte words, which is fast enough to run on
+ *  every checkpoint. Any change to a single word changes the hash.
+ */
+uint64_t hash_matrix(const lbann::AbsDistMat& M) {
+  lbann::AbsDistMatReadProxy<El::Device::CPU> proxy(M);
+  const auto& local = proxy.GetLocked().LockedMatrix();
+  uint64_t hash = 14695981039346656037ull;
+  auto mix = [&hash](uint64_t word) {
+    hash = (hash ^ word) * 1099511628211ull;
+  };
+  mix(M.Height());
+  mix(M.Width());
+  const size_t col_bytes = local.Height() * sizeof(lbann::DataType);
+  for (El::Int j = 0; j < local.Width(); ++j) {
+    const auto *buf = reinterpret_cast<const char *>(local.LockedBuffer(0, j));
+    size_t pos = 0;
+    for (; pos + sizeof(uint64_t) <= col_bytes; pos += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, buf + pos, sizeof(word));
+      mix(word);
+    }
+    if (pos < col_bytes) {
+      uint64_t word = 0;
+      memcpy(&word, buf + pos, col_bytes - pos);
+      mix(word);
+    }
+  }
+  return hash;
+}
+
+/** Read from a position in a file. */
+bool pread_all(int fd, void *buf, size_t size, off_t offset) {
+  auto *pos = static_cast<char *>(buf);
+  while (size > 0) {
+    const ssize_t rc = pread(fd, pos, size, offset);
+    if (rc < 0 && errno == EINTR) { continue; }
+    if (rc <= 0) { return false; }
+    pos += rc;
+    size -= rc;
+    offset += rc;
+  }
+  return true;
+}
+
+/** Write a whole buffer. */
+bool write_all(int fd, const void *buf, size_t size) {
+  const auto *pos = static_cast<const char *>(buf);
+  while (size > 0) {
+    const ssize_t rc = write(fd, pos, size);
+    if (rc < 0 && errno == EINTR) { continue; }
+    if (rc <= 0) { return false; }
+    pos += rc;
+    size -= rc;
+  }
+  return true;
+}
+
+/** Copy local matrix entries into a contiguous column-major buffer. */
+void copy_local(const lbann::AbsDistMat& M, std::vector<lbann::DataType>& buf) {
+  const El::Int localHeight = M.LocalHeight();
+  const El::Int localWidth = M.LocalWidth();
+  buf.resize(localHeight * localWidth);
+  for (El::Int j = 0; j < localWidth; ++j) {
+    memcpy(&buf[j * localHeight], M.LockedBuffer(0, j),
+           localHeight * sizeof(lbann::DataType));
+  }
+}
+
+} // namespace
+
+constexpr size_t lbann::persist::min_compressed_size;
+
+void lbann::persist::set_compression(const compression_settings& settings) {
+  m_compression = settings;
+  m_compression.element_size = sizeof(DataType);
+}
+
+void lbann::persist::write_frame(int fd, const std::string& filename,
+                                 const void *buf, size_t size) {
+  std::vector<char> frame;
+  const double start = MPI_Wtime();
+  compress(buf, size, m_compression, frame);
+  m_compression_time += MPI_Wtime() - start;
+  m_compression_raw_bytes += size;
+  m_compressed_bytes += frame.size();
+  if (!write_all(fd, frame.data(), frame.size())) {
+    LBANN_ERROR("failed to write compressed data to file (" + filename + ")");
+  }
+  m_bytes += frame.size();
+}
+
+bool lbann::persist::read_frame(int fd, const std::string& filename,
+                                void *buf, size_t size) {
+  std::stringstream err;
+  const off_t pos = lseek(fd, 0, SEEK_CUR);
+  compression_frame_header header;
+  if (pos < 0
+      || !pread_all(fd, &header, sizeof(header), pos)
+      || !header.valid()) {
+    return false;
+  }
+  if (header.size != size) {
+    err << "compressed data in file " << filename << " "
+        << "has " << header.size << " bytes, "
+        << "but expected " << size << " bytes";
+    LBANN_ERROR(err.str());
+  }
+  std::vector<uint64_t> chunk_sizes(header.num_chunks);
+  if (!pread_all(fd, chunk_sizes.data(),
+                 chunk_sizes.size() * sizeof(uint64_t),
+                 pos + sizeof(header))) {
+    LBANN_ERROR("failed to read compressed data from file (" + filename + ")");
+  }
+  std::vector<char> payload(header.payload_size(chunk_sizes.data()));
+  if (!pread_all(fd, payload.data(), payload.size(), pos + sizeof(header))) {
+    LBANN_ERROR("failed to read compressed data from file (" + filename + ")");
+  }
+  decompress(header, payload.data(), buf);
+  lseek(fd, pos + sizeof(header) + payload.size(), SEEK_SET);
+  m_bytes += sizeof(header) + payload.size();
+  return true;
+}
+
+std::string lbann::persist::get_filename(persist_type type, const char *name) const {
+  return std::string(m_checkpoint_dir) + "/" + matrix_file_name(type, name);
+}
+
+std::string lbann::persist::get_restart_filename(persist_type type, const char *name) const {
+  const auto filename = get_filename(type, name);
+  if (m_base_checkpoint_dir[0] == '\0' || lbann::exists(filename.c_str())) {
+    return filename;
+  }
+  return std::string(m_base_checkpoint_dir) + "/" + matrix_file_name(type, name);
+}
+
+void lbann::persist::set_incremental(const std::string& base_dir,
+                                     std::unordered_map<std::string, uint64_t>& hashes) {
+  if (base_dir.size() >= sizeof(m_base_checkpoint_dir)) {
+    LBANN_ERROR("base checkpoint directory name is too long (" + base_dir + ")");
+  }
+  strcpy(m_base_checkpoint_dir, base_dir.c_str());
+  m_base_hashes = &hashes;
+  if (base_dir.empty()) {
+    hashes.clear();
+  }
+}
+
+void lbann::persist::clear_incremental() {
+  m_base_checkpoint_dir[0] = '\0';
+  m_base_hashes = nullptr;
+}
+
+bool lbann::persist::need_write(persist_type type, const char *name,
+                                const AbsDistMat& M, bool shared) {
+  if (m_base_hashes == nullptr) { return true; }
+  const auto key = matrix_file_name(type, name);
+  const auto hash = hash_matrix(M);
+
+  // Record hashes of a base checkpoint
+  if (m_base_checkpoint_dir[0] == '\0') {
+    (*m_base_hashes)[key] = hash;
+    return true;
+  }
+
+  // Skip matrices that have not changed since the base checkpoint
+  const auto it = m_base_hashes->find(key);
+  int changed = (it == m_base_hashes->end() || it->second != hash) ? 1 : 0;
+  if (shared) {
+    El::mpi::AllReduce(&changed, 1, El::mpi::MAX, M.Grid().Comm(),
+                       El::SyncInfo<El::Device::CPU>{});
+  }
+  if (!changed) {
+    const El::Int size = (shared ?
+                          M.Height() * M.Width() :
+                          M.LocalHeight() * M.LocalWidth());
+    m_skipped_bytes += size * sizeof(DataType);
+  }
+  return changed != 0;
+}
+
+/** \brief Given an open file descriptor, file name, and a matrix, write the matrix
+ *         to the file descriptor, return the number of bytes written */
+
+bool lbann::persist::write_rank_distmat(persist_type type, const char *name, const AbsDistMat& M) {
+  // TODO: store in network order
+  std::string filename = get_filename(type, name);
   // skip all of this if matrix is not held on rank
   const El::Int localHeight = M.LocalHeight();
   const El::Int localWidth = M.LocalWidth();
   // If this is the case we will try to grab the matrix from model rank 0 on reload
   if(localHeight * localWidth == 0) { return true; }
-
+  // Unchanged since the base of an incremental checkpoint
+  if(!need_write(type, name, M, false)) {
+    add_index_block(type, name, M,
+                    std::string(m_base_checkpoint_dir) + "/" + matrix_file_name(type, name));
+    return true;
+  }
+  add_index_block(type, name, M, filename);
 
   int fd = lbann::openwrite(filename.c_str());
 
@@ -103,7 +298,15 @@ bool lbann::persist::write_rank_distmat(persist_type type, const char *name, con
 
   // now write the data for our part of the distributed matrix
   const El::Int lDim = M.LDim();
-  if(localHeight == lDim) {
+  if (m_compression.codec != compression_codec::none) {
+    std::vector<DataType> contiguous;
+    const DataType *buf = M.LockedBuffer();
+    if (localHeight != lDim) {
+      copy_local(M, contiguous);
+      buf = contiguous.data();
+    }
+    write_frame(fd, filename, buf, localHeight * localWidth * sizeof(DataType));
+  } else if(localHeight == lDim) {
     // the local dimension in memory matches the local height,
     // so we can write our data in a single shot
     auto *buf = (void *) M.LockedBuffer();
@@ -135,16 +338,13 @@ bool lbann::persist::write_rank_distmat(persist_type type, const char *name, con
 bool lbann::persist::read_rank_distmat(persist_type type, const char *name, AbsDistMat& M) {
   std::stringstream err;
 
-  // read in the header
-  std::string filename = m_checkpoint_dir;
-  if (type == persist_type::train) {
-    filename += std::string("/train_") + name;
-  } else if (type == persist_type::model) {
-    filename += std::string("/model_") + name;
-  } else {
-    err << "invalid persist_type (" << static_cast<int>(type) << ")";
-    LBANN_ERROR(err.str());
+  // process layout differs from the checkpoint
+  if (m_elastic_restart) {
+    return read_elastic_distmat(type, name, M);
   }
+
+  // read in the header
+  std::string filename = get_restart_filename(type, name);
   int fd = openread(filename.c_str());
   // file does not exist. we will try to grab matrix from rank 0
    if( fd == -1 ) {return false;}
@@ -167,6 +367,24 @@ bool lbann::persist::read_rank_distmat(persist_type type, const char *name, AbsD
   // TODO: check that header values match up
   const El::Int localheight = header.localheight;
   const El::Int localwidth = header.localwidth;
+
+  // compressed data is detected from its frame header
+  {
+    std::vector<DataType> contiguous;
+    DataType *buf = M.Buffer();
+    if (localheight != M.LDim()) {
+      contiguous.resize(localheight * localwidth);
+      buf = contiguous.data();
+    }
+    if (read_frame(fd, filename, buf, localheight * localwidth * sizeof(DataType))) {
+      for (El::Int j = 0; !contiguous.empty() && j < localwidth; ++j) {
+        memcpy(M.Buffer(0, j), &contiguous[j * localheight],
+               localheight * sizeof(DataType));
+      }
+      return true;
+    }
+  }
+
   if(M.ColStride() == 1 && M.RowStride() == 1) {
     if(M.Height() == M.LDim()) {
       auto *buf = (void *) M.Buffer();
@@ -240,6 +458,159 @@ lbann::persist::persist() {
   m_model_fd = -1;
   m_train_fd = -1;
   m_validate_fd = -1;
+
+  // not an incremental checkpoint
+  m_base_hashes = nullptr;
+  m_skipped_bytes = 0;
+  m_base_checkpoint_dir[0] = '\0';
+
+  // not compressed
+  m_compression_raw_bytes = 0;
+  m_compressed_bytes = 0;
+  m_compression_time = 0;
+
+  // same process layout as the checkpoint
+  m_elastic_restart = false;
+}
+
+void lbann::persist::add_index_block(persist_type type, const char *name,
+                                     const AbsDistMat& M,
+                                     const std::string& filename) {
+  if (M.Wrap() != El::ELEMENT) {
+    LBANN_ERROR(std::string{} + "matrix " + name + " has a block "
+                + "distribution, which the checkpoint index does not support");
+  }
+  std::stringstream ss;
+  ss << "block " << matrix_file_name(type, name)
+     << " " << M.Height() << " " << M.Width()
+     << " " << M.ColShift() << " " << M.ColStride()
+     << " " << M.RowShift() << " " << M.RowStride()
+     << " " << M.LocalHeight() << " " << M.LocalWidth()
+     << " " << sizeof(layer_header)
+     << " " << filename << "\n";
+  m_index += ss.str();
+}
+
+void lbann::persist::set_elastic_restart(const std::string& index) {
+  m_index_blocks.clear();
+  std::istringstream in(index);
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream ss(line);
+    std::string kind, key;
+    ss >> kind;
+    if (kind != "block") { continue; }
+    tensor_block b;
+    ss >> key >> b.height >> b.width
+       >> b.col_shift >> b.col_stride >> b.row_shift >> b.row_stride
+       >> b.local_height >> b.local_width >> b.offset;
+    ss >> std::ws;
+    std::getline(ss, b.file);
+    if (ss.bad() || b.file.empty()) {
+      LBANN_ERROR("invalid checkpoint index entry (" + line + ")");
+    }
+    m_index_blocks[key].push_back(b);
+  }
+  m_rank_checkpoint_dir.clear();
+  m_elastic_restart = true;
+}
+
+void lbann::persist::clear_elastic_restart() {
+  m_index_blocks.clear();
+  m_elastic_restart = false;
+  m_rank_checkpoint_dir.clear();
+}
+
+bool lbann::persist::read_elastic_distmat(persist_type type, const char *name,
+                                          AbsDistMat& M) {
+  std::stringstream err;
+  const auto key = matrix_file_name(type, name);
+  const auto it = m_index_blocks.find(key);
+  if (it == m_index_blocks.end()) { return false; }
+  const auto& blocks = it->second;
+  M.Resize(blocks.front().height, blocks.front().width);
+  const El::Int localHeight = M.LocalHeight();
+  const El::Int localWidth = M.LocalWidth();
+
+  // Each local entry is read from the first block that holds it
+  // Note: Replicated matrices have many blocks with the same entries.
+  std::vector<char> filled(localHeight * localWidth, 0);
+  El::Int num_filled = 0;
+  std::vector<std::pair<El::Int, El::Int>> rows, cols;
+  std::vector<DataType> buf;
+  for (const auto& b : blocks) {
+    if (num_filled == localHeight * localWidth) { break; }
+
+    // Local rows and columns in this block, with their block indices
+    rows.clear();
+    cols.clear();
+    for (El::Int iLoc = 0; iLoc < localHeight; ++iLoc) {
+      const El::Int i = M.GlobalRow(iLoc) - b.col_shift;
+      if (i >= 0 && i % b.col_stride == 0 && i / b.col_stride < b.local_height) {
+        rows.emplace_back(iLoc, i / b.col_stride);
+      }
+    }
+    for (El::Int jLoc = 0; jLoc < localWidth; ++jLoc) {
+      const El::Int j = M.GlobalCol(jLoc) - b.row_shift;
+      if (j >= 0 && j % b.row_stride == 0 && j / b.row_stride < b.local_width) {
+        cols.emplace_back(jLoc, j / b.row_stride);
+      }
+    }
+    bool needed = false;
+    for (const auto& c : cols) {
+      for (const auto& r : rows) {
+        needed = needed || !filled[r.first + c.first * localHeight];
+      }
+    }
+    if (!needed) { continue; }
+
+    int fd = lbann::openread(b.file.c_str());
+    if (fd < 0) {
+      LBANN_ERROR("failed to read distributed matrix from file (" + b.file + ")");
+    }
+
+    // Compressed blocks are read whole, others one column at a time
+    bool whole_block = false;
+    if (lseek(fd, b.offset, SEEK_SET) == static_cast<off_t>(b.offset)) {
+      buf.resize(b.local_height * b.local_width);
+      whole_block = read_frame(fd, b.file, buf.data(),
+                               buf.size() * sizeof(DataType));
+    }
+    if (!whole_block) { buf.resize(b.local_height); }
+    for (const auto& c : cols) {
+      const DataType *col = nullptr;
+      if (whole_block) {
+        col = &buf[c.second * b.local_height];
+      } else {
+        const size_t bufsize = b.local_height * sizeof(DataType);
+        if (!pread_all(fd, buf.data(), bufsize,
+                       b.offset + c.second * bufsize)) {
+          err << "failed to read column " << c.second << " "
+              << "of distributed matrix from file " << b.file;
+          LBANN_ERROR(err.str());
+        }
+        m_bytes += bufsize;
+        col = buf.data();
+      }
+      for (const auto& r : rows) {
+        auto& f = filled[r.first + c.first * localHeight];
+        if (!f) {
+          M.SetLocal(r.first, c.first, col[r.second]);
+          f = 1;
+          ++num_filled;
+        }
+      }
+    }
+    lbann::closeread(fd, b.file.c_str());
+  }
+
+  if (num_filled != localHeight * localWidth) {
+    err << "checkpoint index does not cover distributed matrix " << key << " "
+        << "(" << localHeight * localWidth - num_filled << " of "
+        << localHeight * localWidth << " local entries are missing)";
+    LBANN_ERROR(err.str());
+  }
+  return true;
 }
 
 void lbann::persist::open_checkpoint(const char *dir) {
@@ -255,6 +626,21 @@ void lbann::persist::open_checkpoint(const char *dir) {
   // define filename for train state
   sprintf(m_train_filename, "%s/train", dir);
 
+  // start a new tensor index
+  m_index.clear();
+
+  // record base of incremental checkpoint
+  if (m_base_hashes != nullptr && m_base_checkpoint_dir[0] != '\0') {
+    const std::string base_filename = std::string(dir) + "/base";
+    int fd = lbann::openwrite(base_filename.c_str());
+    if (fd < 0) {
+      LBANN_ERROR("failed to open file (" + base_filename + ")");
+    }
+    lbann::write_string(fd, base_filename.c_str(),
+                        m_base_checkpoint_dir, strlen(m_base_checkpoint_dir));
+    lbann::closewrite(fd, base_filename.c_str());
+  }
+
   if(ckpt_type != callback_type::validation && ckpt_type != callback_type::inference){
     m_model_fd = lbann::openwrite(m_model_filename);
     if (m_model_fd < 0) {
@@ -307,6 +693,19 @@ void lbann::persist::open_restart(const char *dir) {
   // define filename for validate phase state
   sprintf(m_validate_filename, "%s/validate", dir);
 
+  // matrices missing from an incremental checkpoint are in its base
+  m_base_checkpoint_dir[0] = '\0';
+  const std::string base_filename = std::string(dir) + "/base";
+  if (lbann::exists(base_filename.c_str())) {
+    int fd = lbann::openread(base_filename.c_str());
+    ssize_t rc = read(fd, m_base_checkpoint_dir, sizeof(m_base_checkpoint_dir) - 1);
+    lbann::closeread(fd, base_filename.c_str());
+    if (rc <= 0) {
+      LBANN_ERROR("failed to read file (" + base_filename + ")");
+    }
+    m_base_checkpoint_dir[rc] = '\0';
+  }
+
   m_model_fd = lbann::openread(m_model_filename);
   if (m_model_fd < 0) {
     LBANN_ERROR(std::string{}
@@ -341,15 +740,37 @@ void lbann::persist::close_restart() {
 
 bool lbann::persist::write_distmat(persist_type type, const char *name, AbsDistMat *M) {
   // define full path to file to store matrix
-  std::string filename = m_checkpoint_dir;
-  if (type == persist_type::train) {
-    filename += std::string("/train_") + name;
-  } else if (type == persist_type::model) {
-    filename += std::string("/model_") + name;
-  } else {
-    std::stringstream err;
-    err << "invalid persist_type (" << static_cast<int>(type) << ")";
-    LBANN_ERROR(err.str());
+  std::string filename = get_filename(type, name);
+
+  // Unchanged since the base of an incremental checkpoint
+  if (!need_write(type, name, *M, true)) { return true; }
+
+  if (m_compression.codec != compression_codec::none) {
+    // Same layout as Elemental's binary format, but with a compressed
+    // frame after the dimensions. One process compresses and writes.
+    const CircMat<El::Device::CPU> circ(*M);
+    if (circ.CrossRank() == circ.Root()) {
+      filename += ".bin";
+      int fd = lbann::openwrite(filename.c_str());
+      if (fd < 0) {
+        LBANN_ERROR("failed to open file (" + filename + ")");
+      }
+      const El::Int dims[2] = {circ.Height(), circ.Width()};
+      if (!write_all(fd, dims, sizeof(dims))) {
+        LBANN_ERROR("failed to write file (" + filename + ")");
+      }
+      m_bytes += sizeof(dims);
+      std::vector<DataType> contiguous;
+      const DataType *buf = circ.LockedBuffer();
+      if (circ.LocalHeight() != circ.LDim()) {
+        copy_local(circ, contiguous);
+        buf = contiguous.data();
+      }
+      write_frame(fd, filename, buf,
+                  circ.Height() * circ.Width() * sizeof(DataType));
+      lbann::closewrite(fd, filename.c_str());
+    }
+    return true;
   }
 
   El::Write(*M, filename, El::BINARY, "");
@@ -363,16 +784,7 @@ bool lbann::persist::write_distmat(persist_type type, const char *name, AbsDistM
 
 bool lbann::persist::read_distmat(persist_type type, const char *name, AbsDistMat *M) {
   // define full path to file to store matrix
-  std::string filename = m_checkpoint_dir;
-  if (type == persist_type::train) {
-    filename += std::string("/train_") + name;
-  } else if (type == persist_type::model) {
-    filename += std::string("/model_") + name;
-  } else {
-    std::stringstream err;
-    err << "invalid persist_type (" << static_cast<int>(type) << ")";
-    LBANN_ERROR(err.str());
-  }
+  std::string filename = get_restart_filename(type, name);
 
   // check whether file exists
   int exists = lbann::exists(filename.c_str());
@@ -380,6 +792,44 @@ bool lbann::persist::read_distmat(persist_type type, const char *name, AbsDistMa
     LBANN_ERROR("failed to read distributed matrix from file (" + filename + ")");
     return false;
   }
+
+  // Check for compressed data after the matrix dimensions
+  El::Int dims[2] = {0, 0};
+  bool compressed = false;
+  {
+    int fd = lbann::openread(filename.c_str());
+    compression_frame_header header;
+    compressed = (fd >= 0
+                  && pread_all(fd, dims, sizeof(dims), 0)
+                  && pread_all(fd, &header, sizeof(header), sizeof(dims))
+                  && header.valid());
+    if (fd >= 0) { lbann::closeread(fd, filename.c_str()); }
+  }
+  if (compressed) {
+    // One process reads and decompresses
+    CircMat<El::Device::CPU> circ(M->Grid());
+    circ.Resize(dims[0], dims[1]);
+    if (circ.CrossRank() == circ.Root()) {
+      int fd = lbann::openread(filename.c_str());
+      lseek(fd, sizeof(dims), SEEK_SET);
+      m_bytes += sizeof(dims);
+      std::vector<DataType> contiguous;
+      DataType *buf = circ.Buffer();
+      if (circ.LocalHeight() != circ.LDim()) {
+        contiguous.resize(dims[0] * dims[1]);
+        buf = contiguous.data();
+      }
+      read_frame(fd, filename, buf, dims[0] * dims[1] * sizeof(DataType));
+      for (El::Int j = 0; !contiguous.empty() && j < dims[1]; ++j) {
+        memcpy(circ.Buffer(0, j), &contiguous[j * dims[0]],
+               dims[0] * sizeof(DataType));
+      }
+      lbann::closeread(fd, filename.c_str());
+    }
+    El::Copy(circ, *M);
+    return true;
+  }
+
   El::Read(*M, filename, El::BINARY, true);
   //Read_MPI(M, filename, BINARY, 1);
 
@@ -391,6 +841,11 @@ bool lbann::persist::read_distmat(persist_type type, const char *name, AbsDistMa
 
 bool lbann::persist::write_bytes(persist_type type, const char *name, const void *buf, size_t size) {
   int fd = get_fd(type);
+  if (fd >= 0 && size >= min_compressed_size
+      && m_compression.codec != compression_codec::none) {
+    write_frame(fd, name, buf, size);
+    return true;
+  }
   if (fd >= 0) {
     ssize_t rc = write(fd, buf, size);
     if (rc != (ssize_t) size) {
@@ -404,6 +859,10 @@ bool lbann::persist::write_bytes(persist_type type, const char *name, const void
 
 bool lbann::persist::read_bytes(persist_type type, const char *name, void *buf, size_t size) {
   int fd = get_fd(type);
+  if (fd >= 0 && size >= min_compressed_size
+      && read_frame(fd, name, buf, size)) {
+    return true;
+  }
   if (fd >= 0) {
     ssize_t rc = read(fd, buf, size);
     if (rc != (ssize_t) size) {
@@ -0,0 +1,89 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/io/async_file_reader.hpp>
+
+#include <lbann/utils/exception.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/** Temporary files with known contents. */
+struct test_files {
+  std::vector<std::string> paths;
+  std::vector<std::vector<char>> contents;
+  test_files(size_t num_files) {
+    for (size_t i = 0; i < num_files; ++i) {
+      paths.push_back("async_file_reader_test_" + std::to_string(i) + ".bin");
+      contents.emplace_back(97 * i + 13);
+      for (size_t j = 0; j < contents[i].size(); ++j) {
+        contents[i][j] = static_cast<char>(i + 7 * j);
+      }
+      std::ofstream f(paths[i], std::ios::binary);
+      f.write(contents[i].data(), contents[i].size());
+    }
+  }
+  ~test_files() {
+    for (const auto& p : paths) { std::remove(p.c_str()); }
+  }
+};
+
+} // namespace
+
+TEST_CASE("Testing async_file_reader", "[io][utilities]") {
+
+  using lbann::async_file_reader;
+  const size_t num_files = 50;
+  test_files files(num_files);
+  async_file_reader reader(4);
+  std::vector<async_file_reader::request> requests(num_files);
+  for (size_t i = 0; i < num_files; ++i) {
+    requests[i].path = files.paths[i];
+  }
+
+  SECTION("Whole files") {
+    // Read twice to check that reused requests are resized
+    for (int iter = 0; iter < 2; ++iter) {
+      reader.read_batch(requests);
+      for (size_t i = 0; i < num_files; ++i) {
+        CHECK(requests[i].data == files.contents[i]);
+      }
+    }
+    const auto stats = reader.get_statistics();
+    CHECK(stats.num_files == 2 * num_files);
+    CHECK(stats.queue_depth() <= reader.get_queue_depth());
+    reader.reset_statistics();
+    CHECK(reader.get_statistics().num_files == 0);
+  }
+
+  SECTION("File prefixes") {
+    for (size_t i = 0; i < num_files; ++i) {
+      requests[i].length = files.contents[i].size() / 2;
+    }
+    requests[0].length = files.contents[0].size();
+    reader.read_batch(requests);
+    for (size_t i = 0; i < num_files; ++i) {
+      const auto& expected = files.contents[i];
+      REQUIRE(requests[i].data.size() == requests[i].length);
+      CHECK(std::equal(requests[i].data.begin(), requests[i].data.end(),
+                       expected.begin()));
+    }
+  }
+
+  SECTION("Errors") {
+    requests[num_files / 2].path = "async_file_reader_test_missing.bin";
+    REQUIRE_THROWS_AS(reader.read_batch(requests), lbann::exception);
+    requests[num_files / 2].path = files.paths[num_files / 2];
+    requests[1].length = files.contents[1].size() + 1;
+    REQUIRE_THROWS_AS(reader.read_batch(requests), lbann::exception);
+    requests[1].length = 0;
+    REQUIRE_NOTHROW(reader.read_batch(requests));
+  }
+
+}
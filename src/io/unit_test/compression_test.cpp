@@ -0,0 +1,141 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/io/compression.hpp>
+
+#include <lbann/utils/exception.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+/** Smooth floating-point data, which compresses well when shuffled. */
+std::vector<float> make_data(size_t size) {
+  std::vector<float> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = std::sin(0.001f * i);
+  }
+  return data;
+}
+
+/** Decompress a frame into a buffer of the original size. */
+std::vector<char> round_trip(const std::vector<char>& frame) {
+  lbann::compression_frame_header header;
+  REQUIRE(frame.size() >= sizeof(header));
+  std::memcpy(&header, frame.data(), sizeof(header));
+  REQUIRE(header.valid());
+  const auto* payload = frame.data() + sizeof(header);
+  std::vector<std::uint64_t> chunk_sizes(header.num_chunks);
+  std::memcpy(chunk_sizes.data(), payload,
+              chunk_sizes.size() * sizeof(std::uint64_t));
+  CHECK(sizeof(header) + header.payload_size(chunk_sizes.data())
+        == frame.size());
+  std::vector<char> data(header.size);
+  lbann::decompress(header, payload, data.data());
+  return data;
+}
+
+} // namespace
+
+TEST_CASE("Testing checkpoint compression", "[io][utilities]") {
+
+  using lbann::compression_codec;
+  std::vector<compression_codec> codecs = {compression_codec::none};
+#ifdef LBANN_HAS_LZ4
+  codecs.push_back(compression_codec::lz4);
+#endif // LBANN_HAS_LZ4
+#ifdef LBANN_HAS_ZSTD
+  codecs.push_back(compression_codec::zstd);
+#endif // LBANN_HAS_ZSTD
+
+  SECTION("Round trip") {
+    // Odd sizes exercise partial chunks and partial values
+    const auto values = make_data(100003);
+    const size_t size = values.size() * sizeof(float) - 3;
+    for (const auto& codec : codecs) {
+      lbann::compression_settings settings;
+      settings.codec = codec;
+      settings.element_size = sizeof(float);
+      settings.chunk_size = 10000;
+      std::vector<char> frame;
+      lbann::compress(values.data(), size, settings, frame);
+      const auto data = round_trip(frame);
+      REQUIRE(data.size() == size);
+      CHECK(std::memcmp(data.data(), values.data(), size) == 0);
+      if (codec != compression_codec::none) {
+        CHECK(frame.size() < size);
+      }
+    }
+  }
+
+  SECTION("Empty buffer") {
+    for (const auto& codec : codecs) {
+      lbann::compression_settings settings;
+      settings.codec = codec;
+      std::vector<char> frame;
+      lbann::compress(nullptr, 0, settings, frame);
+      CHECK(round_trip(frame).empty());
+    }
+  }
+
+  SECTION("Incompressible data is stored") {
+    std::vector<char> noise(4096);
+    unsigned state = 12345;
+    for (auto& c : noise) {
+      state = state * 1103515245u + 12345u;
+      c = static_cast<char>(state >> 24);
+    }
+    for (const auto& codec : codecs) {
+      lbann::compression_settings settings;
+      settings.codec = codec;
+      std::vector<char> frame;
+      lbann::compress(noise.data(), noise.size(), settings, frame);
+      CHECK(round_trip(frame) == noise);
+    }
+  }
+
+  SECTION("Corrupt frames are detected") {
+    const auto values = make_data(1000);
+    lbann::compression_settings settings;
+    settings.codec = codecs.back();
+    std::vector<char> frame;
+    lbann::compress(values.data(), values.size() * sizeof(float),
+                    settings, frame);
+    lbann::compression_frame_header header;
+    std::memcpy(&header, frame.data(), sizeof(header));
+    std::vector<char> data(header.size);
+
+    // Chunk that is too short to decompress
+    auto payload = std::vector<char>(frame.begin() + sizeof(header),
+                                     frame.end());
+    const std::uint64_t bad_size = 1;
+    std::memcpy(payload.data(), &bad_size, sizeof(bad_size));
+    REQUIRE_THROWS_AS(lbann::decompress(header, payload.data(), data.data()),
+                      lbann::exception);
+
+    // Not a frame
+    header.magic[0] = 'X';
+    REQUIRE_THROWS_AS(lbann::decompress(header,
+                                        frame.data() + sizeof(header),
+                                        data.data()),
+                      lbann::exception);
+  }
+
+  SECTION("Parse settings") {
+    CHECK(lbann::parse_compression("").codec == compression_codec::none);
+    CHECK(lbann::parse_compression("none").codec == compression_codec::none);
+    REQUIRE_THROWS_AS(lbann::parse_compression("gzip"), lbann::exception);
+    REQUIRE_THROWS_AS(lbann::parse_compression("none:x"), lbann::exception);
+#ifdef LBANN_HAS_ZSTD
+    const auto settings = lbann::parse_compression("zstd:5");
+    CHECK(settings.codec == compression_codec::zstd);
+    CHECK(settings.level == 5);
+#else
+    REQUIRE_THROWS_AS(lbann::parse_compression("zstd"), lbann::exception);
+#endif // LBANN_HAS_ZSTD
+  }
+
+}
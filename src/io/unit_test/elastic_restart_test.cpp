@@ -0,0 +1,171 @@
+// MUST include this
+#include <catch2/catch.hpp>
+#include "MPITestHelpers.hpp"
+
+// File being tested
+#include <lbann/io/persist.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using lbann::DataType;
+
+constexpr El::Int height = 7;
+constexpr El::Int width = 5;
+
+/** Matrix entry, which identifies its global position. */
+DataType entry(El::Int i, El::Int j) {
+  return DataType(100 * i + j);
+}
+
+/** Element-wise distribution of the ranks that wrote a checkpoint. */
+struct writer_layout {
+  El::Int col_stride, row_stride;
+};
+
+/** Write the blocks of a checkpoint written by col_stride x
+ *  row_stride ranks and return their index entries.
+ *  Each block file starts with a few bytes of padding, like the
+ *  layer header of a real checkpoint.
+ */
+std::string write_blocks(const std::string& dir, const writer_layout& layout,
+                         const std::string& key) {
+  constexpr uint64_t offset = 24;
+  std::ostringstream index;
+  for (El::Int row_shift = 0; row_shift < layout.row_stride; ++row_shift) {
+    for (El::Int col_shift = 0; col_shift < layout.col_stride; ++col_shift) {
+      const auto local_height = El::Length(height, col_shift, layout.col_stride);
+      const auto local_width = El::Length(width, row_shift, layout.row_stride);
+      std::vector<DataType> data;
+      for (El::Int jLoc = 0; jLoc < local_width; ++jLoc) {
+        for (El::Int iLoc = 0; iLoc < local_height; ++iLoc) {
+          data.push_back(entry(col_shift + iLoc * layout.col_stride,
+                               row_shift + jLoc * layout.row_stride));
+        }
+      }
+      std::ostringstream file;
+      file << dir << "/" << key << "_" << col_shift << "_" << row_shift;
+      std::ofstream out(file.str(), std::ios::binary);
+      const std::vector<char> padding(offset, 0);
+      out.write(padding.data(), padding.size());
+      out.write(reinterpret_cast<const char*>(data.data()),
+                data.size() * sizeof(DataType));
+      REQUIRE(out.good());
+      index << "block " << key << " " << height << " " << width
+            << " " << col_shift << " " << layout.col_stride
+            << " " << row_shift << " " << layout.row_stride
+            << " " << local_height << " " << local_width
+            << " " << offset << " " << file.str() << "\n";
+    }
+  }
+  return index.str();
+}
+
+/** Remove the block files of write_blocks. */
+void remove_blocks(const std::string& dir, const std::string& key,
+                   const writer_layout& layout) {
+  for (El::Int row_shift = 0; row_shift < layout.row_stride; ++row_shift) {
+    for (El::Int col_shift = 0; col_shift < layout.col_stride; ++col_shift) {
+      std::ostringstream file;
+      file << dir << "/" << key << "_" << col_shift << "_" << row_shift;
+      std::remove(file.str().c_str());
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("Elastic restart reads blocks written on another layout",
+          "[io][checkpoint][mpi]") {
+
+  auto& comm = unit_test::utilities::get_current_comm();
+  const auto& grid = comm.get_trainer_grid();
+
+  std::string dir = "/tmp/lbann_elastic_restart_XXXXXX";
+  REQUIRE(mkdtemp(&dir[0]) != nullptr);
+  const std::string key = "model_elastic_test";
+
+  // Checkpoints written by a different number of ranks than this test
+  // runs on, including a replicated matrix
+  const std::vector<std::pair<std::string, writer_layout>> writers = {
+    {"STAR,STAR on 3 ranks", {1, 1}},
+    {"VC,STAR on 3 ranks", {3, 1}},
+    {"MC,MR on a 2 x 2 grid", {2, 2}},
+    {"MC,MR on a 3 x 2 grid", {3, 2}},
+    {"STAR,VR on 5 ranks", {1, 5}},
+  };
+  const std::vector<std::pair<std::string, std::pair<El::Dist, El::Dist>>> readers = {
+    {"STAR,STAR", {El::STAR, El::STAR}},
+    {"MC,MR", {El::MC, El::MR}},
+    {"VC,STAR", {El::VC, El::STAR}},
+    {"STAR,VR", {El::STAR, El::VR}},
+  };
+
+  for (const auto& writer : writers) {
+    for (const auto& reader : readers) {
+      DYNAMIC_SECTION("Written as " << writer.first << ", "
+                      << "read as " << reader.first) {
+        auto index = write_blocks(dir, writer.second, key);
+        // A replicated matrix has one block per rank with the same
+        // entries
+        if (writer.second.col_stride == 1 && writer.second.row_stride == 1) {
+          index += index + index;
+        }
+
+        lbann::persist p;
+        p.set_elastic_restart(index);
+        REQUIRE(p.is_elastic_restart());
+        std::unique_ptr<lbann::AbsDistMat> M(
+          lbann::AbsDistMat::Instantiate(grid, 0,
+                                         reader.second.first,
+                                         reader.second.second,
+                                         El::ELEMENT, El::Device::CPU));
+        REQUIRE(p.read_rank_distmat(lbann::persist_type::model,
+                                    "elastic_test", *M));
+        REQUIRE(M->Height() == height);
+        REQUIRE(M->Width() == width);
+        for (El::Int jLoc = 0; jLoc < M->LocalWidth(); ++jLoc) {
+          for (El::Int iLoc = 0; iLoc < M->LocalHeight(); ++iLoc) {
+            CHECK(M->GetLocal(iLoc, jLoc)
+                  == entry(M->GlobalRow(iLoc), M->GlobalCol(jLoc)));
+          }
+        }
+
+        // Matrices that are not in the index are not read
+        CHECK_FALSE(p.read_rank_distmat(lbann::persist_type::model,
+                                        "missing", *M));
+        p.clear_elastic_restart();
+        CHECK_FALSE(p.is_elastic_restart());
+        remove_blocks(dir, key, writer.second);
+      }
+    }
+  }
+
+  SECTION("Blocks that do not cover the matrix are an error") {
+    const writer_layout layout = {3, 1};
+    auto index = write_blocks(dir, layout, key);
+    index = index.substr(index.find('\n') + 1);
+    lbann::persist p;
+    p.set_elastic_restart(index);
+    lbann::StarMat<El::Device::CPU> M(grid);
+    CHECK_THROWS(p.read_rank_distmat(lbann::persist_type::model,
+                                     "elastic_test", M));
+    remove_blocks(dir, key, layout);
+  }
+
+  SECTION("Invalid index entries are an error") {
+    lbann::persist p;
+    CHECK_THROWS(p.set_elastic_restart("block " + key + " 7 5\n"));
+  }
+
+  rmdir(dir.c_str());
+
+}
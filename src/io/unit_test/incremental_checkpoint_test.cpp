@@ -0,0 +1,180 @@
+// MUST include this
+#include <catch2/catch.hpp>
+#include "MPITestHelpers.hpp"
+
+// File being tested
+#include <lbann/io/persist.hpp>
+
+#include <lbann/io/file_io.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ftw.h>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+using lbann::DataType;
+using lbann::persist_type;
+
+constexpr El::Int height = 5;
+constexpr El::Int width = 4;
+
+/** Fill a matrix with entries that identify their global position. */
+void fill(lbann::AbsDistMat& M, DataType offset) {
+  M.Resize(height, width);
+  for (El::Int jLoc = 0; jLoc < M.LocalWidth(); ++jLoc) {
+    for (El::Int iLoc = 0; iLoc < M.LocalHeight(); ++iLoc) {
+      M.SetLocal(iLoc, jLoc,
+                 offset + 10 * M.GlobalRow(iLoc) + M.GlobalCol(jLoc));
+    }
+  }
+}
+
+/** Check the entries written by fill. */
+void check(const lbann::AbsDistMat& M, DataType offset) {
+  REQUIRE(M.Height() == height);
+  REQUIRE(M.Width() == width);
+  for (El::Int jLoc = 0; jLoc < M.LocalWidth(); ++jLoc) {
+    for (El::Int iLoc = 0; iLoc < M.LocalHeight(); ++iLoc) {
+      CHECK(M.GetLocal(iLoc, jLoc)
+            == offset + 10 * M.GlobalRow(iLoc) + M.GlobalCol(jLoc));
+    }
+  }
+}
+
+int remove_entry(const char* path, const struct stat*, int, struct FTW*) {
+  return std::remove(path);
+}
+
+} // namespace
+
+TEST_CASE("Incremental checkpoints restart from their base",
+          "[io][checkpoint][mpi]") {
+
+  auto& comm = unit_test::utilities::get_current_comm();
+  const auto& grid = comm.get_trainer_grid();
+  const int rank = comm.get_rank_in_trainer();
+
+  // Checkpoint directory shared by all ranks
+  char root[64];
+  std::strcpy(root, "/tmp/lbann_incremental_XXXXXX");
+  if (comm.am_trainer_master()) {
+    REQUIRE(mkdtemp(root) != nullptr);
+  }
+  comm.trainer_broadcast(0, root, sizeof(root));
+
+  // One matrix changes after the full checkpoint and one does not
+  lbann::DistMat changed(grid), unchanged(grid);
+  std::unordered_map<std::string, uint64_t> hashes;
+  lbann::persist p;
+  p.set_cb_type(lbann::callback_type::batch);
+
+  SECTION("Shared checkpoints") {
+    const std::string full_dir = std::string(root) + "/shared.full";
+    const std::string inc_dir = std::string(root) + "/shared.incremental";
+
+    // Full checkpoint records hashes
+    fill(changed, 0);
+    fill(unchanged, 0);
+    p.set_incremental("", hashes);
+    if (comm.am_trainer_master()) {
+      p.open_checkpoint(full_dir.c_str());
+    }
+    comm.trainer_broadcast(0, &(p.m_checkpoint_dir[0]), sizeof(p.m_checkpoint_dir));
+    p.write_distmat(persist_type::model, "changed", &changed);
+    p.write_distmat(persist_type::model, "unchanged", &unchanged);
+    p.close_checkpoint();
+    p.clear_incremental();
+    CHECK(hashes.size() == 2);
+    CHECK(p.get_skipped_bytes() == 0);
+
+    // Incremental checkpoint only writes the changed matrix
+    fill(changed, 1000);
+    p.set_incremental(full_dir, hashes);
+    if (comm.am_trainer_master()) {
+      p.open_checkpoint(inc_dir.c_str());
+    }
+    comm.trainer_broadcast(0, &(p.m_checkpoint_dir[0]), sizeof(p.m_checkpoint_dir));
+    p.write_distmat(persist_type::model, "changed", &changed);
+    p.write_distmat(persist_type::model, "unchanged", &unchanged);
+    p.close_checkpoint();
+    p.clear_incremental();
+    CHECK(p.get_skipped_bytes() == height * width * sizeof(DataType));
+    comm.trainer_barrier();
+    CHECK(lbann::exists((inc_dir + "/model_changed.bin").c_str()));
+    CHECK_FALSE(lbann::exists((inc_dir + "/model_unchanged.bin").c_str()));
+    CHECK(lbann::exists((inc_dir + "/base").c_str()));
+
+    // Restart reads the unchanged matrix from the base
+    lbann::DistMat changed_restart(grid), unchanged_restart(grid);
+    lbann::persist restart;
+    if (comm.am_trainer_master()) {
+      restart.open_restart(inc_dir.c_str());
+    }
+    comm.trainer_broadcast(0, &(restart.m_checkpoint_dir[0]), sizeof(restart.m_checkpoint_dir));
+    comm.trainer_broadcast(0, &(restart.m_base_checkpoint_dir[0]), sizeof(restart.m_base_checkpoint_dir));
+    CHECK(std::string(restart.m_base_checkpoint_dir) == full_dir);
+    restart.read_distmat(persist_type::model, "changed.bin", &changed_restart);
+    restart.read_distmat(persist_type::model, "unchanged.bin", &unchanged_restart);
+    if (comm.am_trainer_master()) {
+      restart.close_restart();
+    }
+    check(changed_restart, 1000);
+    check(unchanged_restart, 0);
+  }
+
+  SECTION("Distributed checkpoints") {
+    const std::string full_dir = (std::string(root) + "/dist.full.rank."
+                                  + std::to_string(rank));
+    const std::string inc_dir = (std::string(root) + "/dist.incremental.rank."
+                                 + std::to_string(rank));
+
+    // Full checkpoint records hashes
+    fill(changed, 0);
+    fill(unchanged, 0);
+    p.set_incremental("", hashes);
+    p.open_checkpoint(full_dir.c_str());
+    p.write_rank_distmat(persist_type::model, "changed.bin", changed);
+    p.write_rank_distmat(persist_type::model, "unchanged.bin", unchanged);
+    p.close_checkpoint();
+    p.clear_incremental();
+
+    // Incremental checkpoint only writes the changed matrix
+    fill(changed, 1000);
+    p.set_incremental(full_dir, hashes);
+    p.open_checkpoint(inc_dir.c_str());
+    p.write_rank_distmat(persist_type::model, "changed.bin", changed);
+    p.write_rank_distmat(persist_type::model, "unchanged.bin", unchanged);
+    p.close_checkpoint();
+    p.clear_incremental();
+    if (unchanged.LocalHeight() * unchanged.LocalWidth() > 0) {
+      CHECK(lbann::exists((inc_dir + "/model_changed.bin").c_str()));
+      CHECK_FALSE(lbann::exists((inc_dir + "/model_unchanged.bin").c_str()));
+      CHECK(p.get_skipped_bytes()
+            == (unchanged.LocalHeight() * unchanged.LocalWidth()
+                * sizeof(DataType)));
+    }
+
+    // Restart reads the unchanged matrix from the base
+    lbann::DistMat changed_restart(grid), unchanged_restart(grid);
+    lbann::persist restart;
+    restart.open_restart(inc_dir.c_str());
+    CHECK(std::string(restart.m_base_checkpoint_dir) == full_dir);
+    CHECK(restart.read_rank_distmat(persist_type::model, "changed.bin",
+                                    changed_restart));
+    CHECK(restart.read_rank_distmat(persist_type::model, "unchanged.bin",
+                                    unchanged_restart));
+    restart.close_restart();
+    check(changed_restart, 1000);
+    check(unchanged_restart, 0);
+  }
+
+  comm.trainer_barrier();
+  if (comm.am_trainer_master()) {
+    nftw(root, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+  }
+
+}
@@ -158,6 +158,30 @@ struct softsign_op {
     apply_entrywise_binary_operator<op>(get_prev_activations(),         \
                                         get_prev_error_signals(),       \
                                         get_error_signals());           \
+  }                                                                     \
+  template <>                                                           \
+  void layer<data_layout::MODEL_PARALLEL, El::Device::CPU>              \
+  ::fp_compute_entrywise(const DataType* x, DataType* y,                \
+                         El::Int size) const {                          \
+    apply_entrywise_unary_operator<op>(x, y, size);                     \
+  }                                                                     \
+  template <>                                                           \
+  void layer<data_layout::MODEL_PARALLEL, El::Device::CPU>              \
+  ::bp_compute_entrywise(const DataType* x, const DataType* dy,         \
+                         DataType* dx, El::Int size) const {            \
+    apply_entrywise_binary_operator<op>(x, dy, dx, size);               \
+  }                                                                     \
+  template <>                                                           \
+  void layer<data_layout::DATA_PARALLEL, El::Device::CPU>               \
+  ::fp_compute_entrywise(const DataType* x, DataType* y,                \
+                         El::Int size) const {                          \
+    apply_entrywise_unary_operator<op>(x, y, size);                     \
+  }                                                                     \
+  template <>                                                           \
+  void layer<data_layout::DATA_PARALLEL, El::Device::CPU>               \
+  ::bp_compute_entrywise(const DataType* x, const DataType* dy,         \
+                         DataType* dx, El::Int size) const {            \
+    apply_entrywise_binary_operator<op>(x, dy, dx, size);               \
   }
   INSTANTIATE(log_sigmoid_layer, log_sigmoid_op)
   INSTANTIATE(relu_layer, relu_op)
@@ -157,7 +157,11 @@ struct softsign_op {
     cuda::apply_entrywise_binary_operator<op>(get_prev_activations(),   \
                                               get_prev_error_signals(), \
                                               get_error_signals());     \
-  }
+  }                                                                     \
+  LBANN_DEFINE_UNSUPPORTED_ENTRYWISE_FUSION(                            \
+    layer, data_layout::MODEL_PARALLEL, El::Device::GPU)                \
+  LBANN_DEFINE_UNSUPPORTED_ENTRYWISE_FUSION(                            \
+    layer, data_layout::DATA_PARALLEL, El::Device::GPU)
   INSTANTIATE(log_sigmoid_layer, log_sigmoid_op)
   INSTANTIATE(relu_layer, relu_op)
   INSTANTIATE(selu_layer, selu_op)
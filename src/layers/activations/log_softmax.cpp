@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/layers/activations/log_softmax.hpp"
+#include "lbann/utils/fast_math.hpp"
 
 namespace lbann {
 
@@ -33,7 +34,8 @@ namespace {
 void fp(lbann_comm& comm,
         const AbsDistMat& input,
         AbsDistMat& output,
-        AbsDistMat& workspace) {
+        AbsDistMat& workspace,
+        std::vector<DataType>& shifts) {
 
   // Local matrices
   const auto& local_input = input.LockedMatrix();
@@ -42,40 +44,49 @@ void fp(lbann_comm& comm,
   const auto& local_height = local_input.Height();
   const auto& local_width = local_input.Width();
 
-  // Find column-wise maximum entries
-  El::Fill(workspace, std::numeric_limits<DataType>::lowest());
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int col = 0; col < local_width; ++col) {
-    auto& max_entry = local_workspace(0, col);
-    for (El::Int row = 0; row < local_height; ++row) {
-      max_entry = std::max(max_entry, local_input(row, col));
-    }
-  }
-  comm.allreduce(workspace, workspace.RedundantComm(), El::mpi::MAX);
-
-  // Shift inputs and compute sum(exp(x)) for each column
+  // Find column-wise maximum entries and sum(exp(x-max))
   // Note: Shifting by the max prevents LogSumExp from blowing up.
+  // Both reductions are computed in a single sweep over the input.
+  shifts.resize(local_width);
   LBANN_OMP_PARALLEL_FOR
   for (El::Int col = 0; col < local_width; ++col) {
-    const auto shift = local_workspace(0, col);
+    auto max_entry = std::numeric_limits<DataType>::lowest();
     DataType sum = 0;
-    for (El::Int row = 0; row < local_height; ++row) {
-      const auto& x = local_input(row, col);
-      auto& y = local_output(row, col);
-      y = x - shift;
-      sum += std::exp(y);
-    }
+    fast_math::max_and_sum_exp(local_input.LockedBuffer(0, col),
+                               local_height, max_entry, sum);
+    shifts[col] = max_entry;
     local_workspace(0, col) = sum;
   }
-  comm.allreduce(workspace, workspace.RedundantComm());
+
+  // Combine partial reductions if columns are distributed
+  // Note: Each process's partial sum is rescaled to the global max.
+  if (workspace.RedundantSize() > 1) {
+    std::vector<DataType> local_sums(local_width);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < local_width; ++col) {
+      local_sums[col] = local_workspace(0, col);
+      local_workspace(0, col) = shifts[col];
+    }
+    comm.allreduce(workspace, workspace.RedundantComm(), El::mpi::MAX);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < local_width; ++col) {
+      const auto& shift = local_workspace(0, col);
+      local_workspace(0, col) = (local_sums[col] == DataType(0) ?
+                                 DataType(0) :
+                                 local_sums[col] * std::exp(shifts[col] - shift));
+      shifts[col] = shift;
+    }
+    comm.allreduce(workspace, workspace.RedundantComm());
+  }
 
   // Compute output by subtracting LogSumExp
   LBANN_OMP_PARALLEL_FOR
   for (El::Int col = 0; col < local_width; ++col) {
-    const DataType log_sum_exp = std::log(local_workspace(0, col));
+    const DataType log_sum_exp = shifts[col] + std::log(local_workspace(0, col));
+    const auto* __restrict__ x = local_input.LockedBuffer(0, col);
+    auto* __restrict__ y = local_output.Buffer(0, col);
     for (El::Int row = 0; row < local_height; ++row) {
-      auto& y = local_output(row, col);
-      y -= log_sum_exp;
+      y[row] = x[row] - log_sum_exp;
     }
   }
 
@@ -128,7 +139,8 @@ void log_softmax_layer<data_layout::DATA_PARALLEL, El::Device::CPU>::fp_compute(
   fp(*get_comm(),
      get_prev_activations(),
      get_activations(),
-     *m_workspace);
+     *m_workspace,
+     m_shifts);
 }
 template <>
 void log_softmax_layer<data_layout::DATA_PARALLEL, El::Device::CPU>::bp_compute() {
@@ -143,7 +155,8 @@ void log_softmax_layer<data_layout::MODEL_PARALLEL, El::Device::CPU>::fp_compute
   fp(*get_comm(),
      get_prev_activations(),
      get_activations(),
-     *m_workspace);
+     *m_workspace,
+     m_shifts);
 }
 template <>
 void log_softmax_layer<data_layout::MODEL_PARALLEL, El::Device::CPU>::bp_compute() {
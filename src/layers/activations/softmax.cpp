@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/layers/activations/softmax.hpp"
+#include "lbann/utils/fast_math.hpp"
 
 namespace lbann {
 
@@ -40,7 +41,8 @@ const DataType min_output = 0;
 void fp(lbann_comm& comm,
         const AbsDistMat& input,
         AbsDistMat& output,
-        AbsDistMat& workspace) {
+        AbsDistMat& workspace,
+        std::vector<DataType>& shifts) {
 
   // Local matrices
   const auto& local_input = input.LockedMatrix();
@@ -49,43 +51,54 @@ void fp(lbann_comm& comm,
   const auto& local_height = local_input.Height();
   const auto& local_width = local_input.Width();
 
-  // Find column-wise maximum entries
-  El::Fill(workspace, std::numeric_limits<DataType>::lowest());
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int col = 0; col < local_width; ++col) {
-    auto& max_entry = local_workspace(0, col);
-    for (El::Int row = 0; row < local_height; ++row) {
-      max_entry = std::max(max_entry, local_input(row, col));
-    }
-  }
-  comm.allreduce(workspace, workspace.RedundantComm(), El::mpi::MAX);
-
-  // Exponentiate outputs and compute column sums
+  // Find column-wise maximum entries and sum(exp(x-max))
   // Note: Subtracting by the column max prevents output from blowing
-  // up. Large negative values underflow to 0.
+  // up. Large negative values underflow to 0. Both reductions are
+  // computed in a single sweep over the input.
+  shifts.resize(local_width);
   LBANN_OMP_PARALLEL_FOR
   for (El::Int col = 0; col < local_width; ++col) {
-    const auto shift = local_workspace(0, col);
+    auto max_entry = std::numeric_limits<DataType>::lowest();
     DataType sum = 0;
-    for (El::Int row = 0; row < local_height; ++row) {
-      const auto& x = local_input(row, col);
-      auto& y = local_output(row, col);
-      y = std::exp(x - shift);
-      sum += y;
-    }
+    fast_math::max_and_sum_exp(local_input.LockedBuffer(0, col),
+                               local_height, max_entry, sum);
+    shifts[col] = max_entry;
     local_workspace(0, col) = sum;
   }
-  comm.allreduce(workspace, workspace.RedundantComm());
 
-  // Divide outputs by column sums
+  // Combine partial reductions if columns are distributed
+  // Note: Each process's partial sum is rescaled to the global max.
+  if (workspace.RedundantSize() > 1) {
+    std::vector<DataType> local_sums(local_width);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < local_width; ++col) {
+      local_sums[col] = local_workspace(0, col);
+      local_workspace(0, col) = shifts[col];
+    }
+    comm.allreduce(workspace, workspace.RedundantComm(), El::mpi::MAX);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < local_width; ++col) {
+      const auto& shift = local_workspace(0, col);
+      local_workspace(0, col) = (local_sums[col] == DataType(0) ?
+                                 DataType(0) :
+                                 local_sums[col] * std::exp(shifts[col] - shift));
+      shifts[col] = shift;
+    }
+    comm.allreduce(workspace, workspace.RedundantComm());
+  }
+
+  // Compute outputs
   // Note: Small values can be rounded to minimum output value to
   // avoid denormalized floats.
   LBANN_OMP_PARALLEL_FOR
   for (El::Int col = 0; col < local_width; ++col) {
+    const auto& shift = shifts[col];
     const auto& scale = 1 / local_workspace(0, col);
+    const auto* __restrict__ x = local_input.LockedBuffer(0, col);
+    auto* __restrict__ y = local_output.Buffer(0, col);
     for (El::Int row = 0; row < local_height; ++row) {
-      auto& y = local_output(row, col);
-      y = std::max(scale * y, min_output);
+      const DataType y_unclamped = scale * fast_math::exp(x[row] - shift);
+      y[row] = y_unclamped < min_output ? min_output : y_unclamped;
     }
   }
 
@@ -139,7 +152,8 @@ void softmax_layer<data_layout::DATA_PARALLEL, El::Device::CPU>::fp_compute() {
   fp(*get_comm(),
      get_prev_activations(),
      get_activations(),
-     *m_workspace);
+     *m_workspace,
+     m_shifts);
 }
 template <>
 void softmax_layer<data_layout::DATA_PARALLEL, El::Device::CPU>::bp_compute() {
@@ -154,7 +168,8 @@ void softmax_layer<data_layout::MODEL_PARALLEL, El::Device::CPU>::fp_compute() {
   fp(*get_comm(),
      get_prev_activations(),
      get_activations(),
-     *m_workspace);
+     *m_workspace,
+     m_shifts);
 }
 template <>
 void softmax_layer<data_layout::MODEL_PARALLEL, El::Device::CPU>::bp_compute() {
@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/layers/layer.hpp"
+#include "lbann/utils/step_timing.hpp"
 #include "lbann/utils/timer.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/io/file_io.hpp"
@@ -69,6 +70,13 @@ Layer::Layer(const Layer& other) :
   m_expected_num_child_layers(other.m_expected_num_child_layers),
   m_model(other.m_model),
   m_frozen(other.m_frozen),
+  m_activation_checkpoint(other.m_activation_checkpoint),
+  m_output_views(other.m_output_views),
+  m_error_signal_views(other.m_error_signal_views),
+  m_in_place_output(other.m_in_place_output),
+  m_in_place_error_signal(other.m_in_place_error_signal),
+  m_input_storage_format(other.m_input_storage_format),
+  m_error_signal_storage_format(other.m_error_signal_storage_format),
   m_fp_time(other.m_fp_time),
   m_fp_compute_time(other.m_fp_compute_time),
   m_bp_time(other.m_bp_time),
@@ -109,6 +117,13 @@ Layer& Layer::operator=(const Layer& other) {
   m_expected_num_child_layers = other.m_expected_num_child_layers;
   m_model = other.m_model;
   m_frozen = other.m_frozen;
+  m_activation_checkpoint = other.m_activation_checkpoint;
+  m_output_views = other.m_output_views;
+  m_error_signal_views = other.m_error_signal_views;
+  m_in_place_output = other.m_in_place_output;
+  m_in_place_error_signal = other.m_in_place_error_signal;
+  m_input_storage_format = other.m_input_storage_format;
+  m_error_signal_storage_format = other.m_error_signal_storage_format;
   m_fp_time = other.m_fp_time;
   m_fp_compute_time = other.m_fp_compute_time;
   m_bp_time = other.m_bp_time;
@@ -118,6 +133,14 @@ Layer& Layer::operator=(const Layer& other) {
   m_output_dims_list = other.m_output_dims_list;
   m_hint_layer = other.m_hint_layer;
 
+  // Stored tensors belong to the current step and are not copied
+  m_input_stored = false;
+  m_error_signal_stored = false;
+  m_stored_input_released = false;
+  m_stored_error_signal_released = false;
+  m_remote_inputs.clear();
+  m_remote_prev_error_signals.clear();
+
   // Deep matrix copies
   m_inputs.clear();
   m_outputs.clear();
@@ -257,6 +280,11 @@ void Layer::forward_prop() {
   fp_setup_inputs(mini_batch_size);
   fp_setup_outputs(mini_batch_size);
 
+  // Input is only kept for backprop during training
+  m_input_stored = (m_input_storage_format != storage_format::full
+                    && m_model->get_execution_mode() == execution_mode::training);
+  m_stored_input_released = false;
+
 #if defined(LBANN_HAS_GPU) && defined(LBANN_DEBUG)
   // Synchronize GPUs and check for errors
   if (using_gpus()) { El::GPUManager::SynchronizeDevice(true); }
@@ -264,7 +292,14 @@ void Layer::forward_prop() {
 
   // Apply layer's compute function
   const auto fp_compute_start = get_time();
-  fp_compute();
+  {
+    step_timing::scope timing_scope(step_timing::category::fp_compute);
+    if (m_input_stored) {
+      fp_compute_and_store_input(m_input_storage_format, m_stored_input);
+    } else {
+      fp_compute();
+    }
+  }
   m_fp_compute_time += get_time() - fp_compute_start;
 
   // Add this layer as a gradient source for weight optimizers
@@ -284,11 +319,26 @@ void Layer::forward_prop() {
 void Layer::back_prop() {
   const auto bp_start = get_time();
 
+  // Reconstruct error signals that children released
+  for (auto* child : m_child_layers) {
+    const_cast<Layer*>(child)->restore_stored_error_signal();
+  }
+
+  // Reallocate input tensor if it was released after forward prop
+  // Note: It is filled in by 'bp_compute_with_stored_tensors'.
+  const bool input_released = m_stored_input_released;
+  if (input_released) { restore_stored_input(false); }
+
   // Setup tensors
   const auto& mini_batch_size = m_model->get_current_mini_batch_size();
   bp_setup_gradient_wrt_outputs(mini_batch_size);
   bp_setup_gradient_wrt_inputs(mini_batch_size);
 
+  // Error signal is kept until the parent's backprop
+  m_error_signal_stored = (m_error_signal_storage_format
+                           != storage_format::full);
+  m_stored_error_signal_released = false;
+
 #if defined(LBANN_HAS_GPU) && defined(LBANN_DEBUG)
   // Synchronize GPUs and check for errors
   if (using_gpus()) { El::GPUManager::SynchronizeDevice(true); }
@@ -296,8 +346,26 @@ void Layer::back_prop() {
 
   // Backprop the compute function.
   const auto bp_compute_start = get_time();
-  bp_compute();
+  {
+    step_timing::scope timing_scope(step_timing::category::bp_compute);
+    if (input_released || m_error_signal_stored) {
+      AbsMat* local_input = nullptr;
+      if (input_released) {
+        auto& parent_output
+          = const_cast<AbsDistMat&>(m_parent_layers[0]->get_activations(*this));
+        local_input = &parent_output.Matrix();
+      }
+      bp_compute_with_stored_tensors(
+        input_released ? &m_stored_input : nullptr,
+        local_input,
+        m_error_signal_storage_format,
+        m_error_signal_stored ? &m_stored_error_signal : nullptr);
+    } else {
+      bp_compute();
+    }
+  }
   m_bp_compute_time += get_time() - bp_compute_start;
+  m_input_stored = false;
 
   // Remove this layer as a gradient source for weight optimizers
   for (auto&& w : m_weights) {
@@ -609,10 +677,174 @@ bool Layer::is_frozen() const {
   return m_frozen;
 }
 
+void Layer::free_activations() {
+  for (auto& input : m_inputs) {
+    if (input != nullptr) { input->Empty(true); }
+  }
+  for (auto& output : m_outputs) {
+    if (output != nullptr) { output->Empty(true); }
+  }
+}
+
+void Layer::release_stored_input() {
+  if (!m_input_stored || m_stored_input_released) { return; }
+  auto& parent_output
+    = const_cast<AbsDistMat&>(m_parent_layers[0]->get_activations(*this));
+  if (parent_output.Viewing()) { return; }
+  m_stored_input_alignment = {parent_output.ColAlign(),
+                              parent_output.RowAlign()};
+  m_stored_input_dims = {parent_output.Height(), parent_output.Width()};
+  parent_output.Empty(true);
+  m_stored_input_released = true;
+}
+
+void Layer::release_stored_error_signal() {
+  if (!m_error_signal_stored || m_stored_error_signal_released) { return; }
+  auto& error_signal = get_error_signals();
+  if (error_signal.Viewing()) { return; }
+  m_stored_error_signal_alignment = {error_signal.ColAlign(),
+                                     error_signal.RowAlign()};
+  m_stored_error_signal_dims = {error_signal.Height(), error_signal.Width()};
+  error_signal.Empty(true);
+  m_stored_error_signal_released = true;
+}
+
+void Layer::restore_stored_tensors() {
+  restore_stored_input(true);
+  restore_stored_error_signal();
+  m_input_stored = false;
+  m_error_signal_stored = false;
+}
+
+void Layer::restore_stored_input(bool convert) {
+  if (!m_stored_input_released) { return; }
+  auto& parent_output
+    = const_cast<AbsDistMat&>(m_parent_layers[0]->get_activations(*this));
+  parent_output.Empty(false);
+  parent_output.Align(m_stored_input_alignment.first,
+                      m_stored_input_alignment.second);
+  parent_output.Resize(m_stored_input_dims.first, m_stored_input_dims.second);
+  El::LockedView(*m_inputs[0], parent_output);
+  if (convert) { m_stored_input.load(parent_output.Matrix()); }
+  m_stored_input_released = false;
+}
+
+void Layer::restore_stored_error_signal() {
+  if (!m_stored_error_signal_released) { return; }
+  auto& error_signal = get_error_signals();
+  error_signal.Empty(false);
+  error_signal.Align(m_stored_error_signal_alignment.first,
+                     m_stored_error_signal_alignment.second);
+  error_signal.Resize(m_stored_error_signal_dims.first,
+                      m_stored_error_signal_dims.second);
+  m_stored_error_signal.load(error_signal.Matrix());
+  m_stored_error_signal_released = false;
+  m_error_signal_stored = false;
+}
+
+void Layer::fp_compute_and_store_input(
+  storage_format format, reduced_precision_matrix& stored_input) {
+  // Input may be overwritten if the output is computed in place
+  stored_input.store(format, get_local_prev_activations());
+  fp_compute();
+}
+
+void Layer::bp_compute_with_stored_tensors(
+  const reduced_precision_matrix* stored_input,
+  AbsMat* local_input,
+  storage_format error_signal_format,
+  reduced_precision_matrix* stored_error_signal) {
+  if (stored_input != nullptr) { stored_input->load(*local_input); }
+  bp_compute();
+  if (stored_error_signal != nullptr) {
+    stored_error_signal->store(error_signal_format,
+                               get_local_error_signals());
+  }
+}
+
+void Layer::set_output_view(int child_index, bool view) {
+  if (child_index < 0 || child_index >= get_num_children()) {
+    std::stringstream err;
+    err << "attempted to set output tensor " << child_index << " "
+        << "of layer \"" << get_name() << "\" as a view, "
+        << "but the layer has " << get_num_children() << " children";
+    LBANN_ERROR(err.str());
+  }
+  m_output_views.resize(get_num_children(), false);
+  m_output_views[child_index] = view;
+}
+
+bool Layer::is_output_view(int child_index) const {
+  return (0 <= child_index
+          && child_index < (int) m_output_views.size()
+          && m_output_views[child_index]);
+}
+
+void Layer::set_error_signal_view(int parent_index, bool view) {
+  if (parent_index < 0 || parent_index >= get_num_parents()) {
+    std::stringstream err;
+    err << "attempted to set error signal " << parent_index << " "
+        << "of layer \"" << get_name() << "\" as a view, "
+        << "but the layer has " << get_num_parents() << " parents";
+    LBANN_ERROR(err.str());
+  }
+  m_error_signal_views.resize(get_num_parents(), false);
+  m_error_signal_views[parent_index] = view;
+}
+
+bool Layer::is_error_signal_view(int parent_index) const {
+  return (0 <= parent_index
+          && parent_index < (int) m_error_signal_views.size()
+          && m_error_signal_views[parent_index]);
+}
+
+void Layer::set_remote_input(int parent_index, const AbsDistMat* input) {
+  if (parent_index < 0 || parent_index >= get_num_parents()) {
+    std::stringstream err;
+    err << "attempted to set input " << parent_index << " "
+        << "of layer \"" << get_name() << "\" from a remote buffer, "
+        << "but the layer has " << get_num_parents() << " parents";
+    LBANN_ERROR(err.str());
+  }
+  m_remote_inputs.resize(get_num_parents(), nullptr);
+  m_remote_inputs[parent_index] = input;
+}
+
+void Layer::set_remote_prev_error_signal(int child_index,
+                                         const AbsDistMat* gradient) {
+  if (child_index < 0 || child_index >= get_num_children()) {
+    std::stringstream err;
+    err << "attempted to set gradient w.r.t. output " << child_index << " "
+        << "of layer \"" << get_name() << "\" from a remote buffer, "
+        << "but the layer has " << get_num_children() << " children";
+    LBANN_ERROR(err.str());
+  }
+  m_remote_prev_error_signals.resize(get_num_children(), nullptr);
+  m_remote_prev_error_signals[child_index] = gradient;
+}
+
+const AbsDistMat& Layer::get_input_source(int parent_index) const {
+  if (parent_index < (int) m_remote_inputs.size()
+      && m_remote_inputs[parent_index] != nullptr) {
+    return *m_remote_inputs[parent_index];
+  }
+  return m_parent_layers[parent_index]->get_activations(*this);
+}
+
+const AbsDistMat& Layer::get_prev_error_signal_source(int child_index) const {
+  if (child_index < (int) m_remote_prev_error_signals.size()
+      && m_remote_prev_error_signals[child_index] != nullptr) {
+    return *m_remote_prev_error_signals[child_index];
+  }
+  return m_child_layers[child_index]->get_error_signals(*this);
+}
+
 void Layer::setup() {
   setup_pointers();
   setup_dims();
-  setup_matrices(m_comm->get_trainer_grid());
+  setup_matrices(m_model != nullptr ?
+                 m_model->get_layer_grid(*this) :
+                 m_comm->get_trainer_grid());
   setup_data();
   if (using_gpus()) { setup_gpu(); }
 }
@@ -786,6 +1018,9 @@ void Layer::setup_data() {
   fp_setup_inputs(mini_batch_size);
   fp_setup_outputs(mini_batch_size);
 
+  // Frozen models do not allocate backprop tensors
+  if (m_model->is_frozen_model()) { return; }
+
   // Initialize gradient w.r.t. output tensors
   // Note: We guess whether the tensor is a view or needs to allocate
   // memory, but there are some edge cases that are not handled.
@@ -954,15 +1189,14 @@ void Layer::fp_setup_inputs(El::Int mini_batch_size) {
   if (get_num_parents() < 1) { return; }
 
   // Determine distributed matrix alignment
-  const auto& alignment_dist
-    = m_parent_layers.front()->get_activations(*this).DistData();
+  const auto& alignment_dist = get_input_source(0).DistData();
 
   // Iterate through input tensors
   for (int i = 0; i < get_num_parents(); ++i) {
 
     // Initialize input tensor
     const auto& parent = *m_parent_layers[i];
-    const auto& parent_output = parent.get_activations(*this);
+    const auto& parent_output = get_input_source(i);
     auto& input = *m_inputs[i];
     input.Empty(false);
     input.AlignWith(alignment_dist);
@@ -1013,10 +1247,34 @@ void Layer::fp_setup_outputs(El::Int mini_batch_size) {
                                 get_activations().DistData());
 
   // Initialize output tensors
+  // Note: Output tensors placed in a child's memory are views into
+  // the child's tensors.
   for (int i = 0; i < get_num_children(); ++i) {
     auto& output = get_activations(i);
     output.Empty(false);
+    if (is_output_view(i)) {
+      auto& child = const_cast<Layer&>(*m_child_layers[i]);
+      child.setup_parent_output_view(*this, mini_batch_size, output);
+      continue;
+    }
     if (align_outputs) { output.AlignWith(alignment_dist); }
+
+    // Compute output in place over the parent's output if it is
+    // writable
+    if (is_in_place_output()) {
+      const auto& parent = *m_parent_layers[0];
+      auto& parent_output
+        = const_cast<AbsDistMat&>(parent.get_activations(*this));
+      if (!parent_output.Locked()
+          && (!parent_output.Viewing() || parent.is_in_place_output())
+          && parent_output.DistData() == output.DistData()
+          && parent_output.Height() == get_output_size(i)
+          && parent_output.Width() == mini_batch_size) {
+        El::View(output, parent_output);
+        continue;
+      }
+    }
+
     output.Resize(get_output_size(i), mini_batch_size);
   }
 
@@ -1027,7 +1285,7 @@ void Layer::bp_setup_gradient_wrt_outputs(El::Int mini_batch_size) {
 
     // Initialize gradient w.r.t. output tensor
     const auto& child = *m_child_layers[i];
-    const auto& child_gradient_wrt_input = child.get_error_signals(*this);
+    const auto& child_gradient_wrt_input = get_prev_error_signal_source(i);
     auto& gradient_wrt_output = *m_gradient_wrt_outputs[i];
     gradient_wrt_output.Empty(false);
     gradient_wrt_output.AlignWith(get_activations(i));
@@ -1074,11 +1332,55 @@ void Layer::bp_setup_gradient_wrt_inputs(El::Int mini_batch_size) {
   for (int i = 0; i < get_num_parents(); ++i) {
     auto& gradient_wrt_input = get_error_signals(i);
     gradient_wrt_input.Empty(false);
+    if (is_error_signal_view(i)) {
+      auto& parent = const_cast<Layer&>(*m_parent_layers[i]);
+      parent.setup_child_error_signal_view(*this, mini_batch_size,
+                                           gradient_wrt_input);
+      continue;
+    }
     gradient_wrt_input.AlignWith(get_prev_activations(i));
+
+    // Compute error signal in place over the child's error signal if
+    // it is writable
+    if (is_in_place_error_signal()) {
+      const auto& child = *m_child_layers[0];
+      auto& child_error_signal
+        = const_cast<AbsDistMat&>(child.get_error_signals(*this));
+      if (!child_error_signal.Locked()
+          && (!child_error_signal.Viewing()
+              || child.is_in_place_error_signal())
+          && child_error_signal.DistData() == gradient_wrt_input.DistData()
+          && child_error_signal.Height() == get_input_size(i)
+          && child_error_signal.Width() == mini_batch_size) {
+        El::View(gradient_wrt_input, child_error_signal);
+        continue;
+      }
+    }
+
     gradient_wrt_input.Resize(get_input_size(i), mini_batch_size);
   }
 }
 
+void Layer::setup_parent_output_view(const Layer& parent,
+                                     El::Int mini_batch_size,
+                                     AbsDistMat& output) {
+  std::stringstream err;
+  err << get_type() << " layer \"" << get_name() << "\" "
+      << "cannot provide memory for the output tensor of "
+      << "parent layer \"" << parent.get_name() << "\"";
+  LBANN_ERROR(err.str());
+}
+
+void Layer::setup_child_error_signal_view(const Layer& child,
+                                          El::Int mini_batch_size,
+                                          AbsDistMat& error_signal) {
+  std::stringstream err;
+  err << get_type() << " layer \"" << get_name() << "\" "
+      << "cannot provide memory for the error signal of "
+      << "child layer \"" << child.get_name() << "\"";
+  LBANN_ERROR(err.str());
+}
+
 std::string Layer::get_data_layout_string(data_layout d) const {
   switch(d) {
   case data_layout::DATA_PARALLEL:
@@ -29,6 +29,21 @@
 
 namespace lbann {
 
+namespace {
+
+/** Report an input entry that is not a valid dictionary index. */
+void invalid_index_error(const Layer& l,
+                         DataType index,
+                         El::Int dictionary_size) {
+  std::ostringstream err;
+  err << l.get_type() << " layer \"" << l.get_name() << "\" "
+      << "got an invalid dictionary index (" << index << ", "
+      << "expected a value less than " << dictionary_size << ")";
+  LBANN_ERROR(err.str());
+}
+
+} // namespace
+
 template <>
 void embedding_layer<data_layout::DATA_PARALLEL,El::Device::CPU>::setup_matrices(const El::Grid& grid) {
   Layer::setup_matrices(grid);
@@ -39,20 +54,6 @@ template <>
 void embedding_layer<data_layout::DATA_PARALLEL,El::Device::CPU>::setup_dims() {
   Layer::setup_dims();
 
-  // Make sure input dimensions are valid
-  if (this->get_input_size() != 1) {
-    const auto& input_dims = this->get_input_dims();
-    std::ostringstream err;
-    err << get_type() << " layer \"" << get_name() << "\" "
-        << "recieved an input tensor with invalid dimensions "
-        << "(expected 1, got ";
-    for (size_t i = 0; i < input_dims.size(); ++i) {
-      err << (i > 0 ? "x" : "") << input_dims[i];
-    }
-    err << ")";
-    LBANN_ERROR(err.str());
-  }
-
   // Output is size of embedding vector
   this->set_output_dims({static_cast<int>(m_embedding_size)});
 
@@ -83,7 +84,9 @@ void embedding_layer<data_layout::DATA_PARALLEL,El::Device::CPU>::setup_data() {
   dict.set_matrix_distribution(matrix_dist);
 
   // Initialize gradient w.r.t. dictionary
-  m_dictionary_gradient.Resize(m_embedding_size, m_dictionary_size);
+  if (!m_sparse_gradient) {
+    m_dictionary_gradient.Resize(m_embedding_size, m_dictionary_size);
+  }
 
 }
 
@@ -94,15 +97,51 @@ void embedding_layer<data_layout::DATA_PARALLEL,El::Device::CPU>::fp_compute() {
   const auto& local_dict = m_weights[0]->get_values().LockedMatrix();
   const auto& local_input = get_local_prev_activations();
   auto& local_output = get_local_activations();
+  const auto& input_size = local_input.Height();
   const auto& local_width = local_input.Width();
-
-  // Populate output matrix with appropriate columns of dictionary
-  CPUMat dict_v, output_v;
-  for (El::Int col = 0; col < local_width; ++ col) {
-    const El::Int ind = static_cast<El::Int>(local_input(0, col));
-    El::LockedView(dict_v, local_dict, El::ALL, El::IR(ind));
-    El::View(output_v, local_output, El::ALL, El::IR(col));
-    El::Copy(dict_v, output_v);
+  const auto* dict_buffer = local_dict.LockedBuffer();
+  const auto& dict_ldim = local_dict.LDim();
+  const DataType dict_size = m_dictionary_size;
+
+  // Gather dictionary columns and pool them for each sample
+  // Note: Invalid indices are skipped here and reported afterwards
+  // since errors cannot be thrown out of an OpenMP region.
+  El::Int num_invalid = 0;
+  LBANN_OMP_PARALLEL_FOR_ARGS(reduction(+:num_invalid))
+  for (El::Int col = 0; col < local_width; ++col) {
+    auto* __restrict__ y = local_output.Buffer(0, col);
+    std::fill(y, y + m_embedding_size, DataType(0));
+    El::Int count = 0;
+    for (El::Int i = 0; i < input_size; ++i) {
+      const auto& x = local_input(i, col);
+      if (x < DataType(0)) { continue; }
+      if (!(x < dict_size)) {
+        ++num_invalid;
+        continue;
+      }
+      const El::Int ind = static_cast<El::Int>(x);
+      const auto* __restrict__ w = dict_buffer + ind * dict_ldim;
+      for (El::Int row = 0; row < m_embedding_size; ++row) {
+        y[row] += w[row];
+      }
+      ++count;
+    }
+    if (m_pooling == embedding_pooling::mean && count > 1) {
+      const DataType scale = DataType(1) / count;
+      for (El::Int row = 0; row < m_embedding_size; ++row) {
+        y[row] *= scale;
+      }
+    }
+  }
+  if (num_invalid > 0) {
+    for (El::Int col = 0; col < local_width; ++col) {
+      for (El::Int i = 0; i < input_size; ++i) {
+        const auto& x = local_input(i, col);
+        if (!(x < DataType(0)) && !(x < dict_size)) {
+          invalid_index_error(*this, x, m_dictionary_size);
+        }
+      }
+    }
   }
 
 }
@@ -119,23 +158,71 @@ void embedding_layer<data_layout::DATA_PARALLEL,El::Device::CPU>::bp_compute() {
 
   // Local data
   const auto& local_input = get_local_prev_activations();
-  auto& local_dict_grad = m_dictionary_gradient.Matrix();
   const auto& local_output_grad = get_local_prev_error_signals();
+  const auto& input_size = local_input.Height();
   const auto& local_width = local_input.Width();
   const auto& mini_batch_size = this->m_model->get_effective_mini_batch_size();
 
-  // Update appropriate columns of gradient w.r.t. dictionary
-  El::Zero(local_dict_grad);
-  CPUMat dict_grad_v, output_grad_v;
-  for (El::Int col = 0; col < local_width; ++ col) {
-    const El::Int ind = static_cast<El::Int>(local_input(0, col));
-    El::View(dict_grad_v, local_dict_grad, El::ALL, El::IR(ind));
-    El::LockedView(output_grad_v, local_output_grad, El::ALL, El::IR(col));
-    El::Axpy(DataType{1}, output_grad_v, dict_grad_v);
+  // Find dictionary entries used by each sample
+  std::vector<El::Int> columns, samples;
+  std::vector<DataType> scales;
+  columns.reserve(input_size * local_width);
+  samples.reserve(input_size * local_width);
+  for (El::Int col = 0; col < local_width; ++col) {
+    const size_t first = columns.size();
+    for (El::Int i = 0; i < input_size; ++i) {
+      const auto& x = local_input(i, col);
+      if (x < DataType(0)) { continue; }
+      if (!(x < DataType(m_dictionary_size))) {
+        invalid_index_error(*this, x, m_dictionary_size);
+      }
+      columns.push_back(static_cast<El::Int>(x));
+      samples.push_back(col);
+    }
+    const size_t count = columns.size() - first;
+    const DataType scale = (m_pooling == embedding_pooling::mean && count > 1 ?
+                            DataType(1) / count : DataType(1));
+    scales.resize(columns.size(), scale);
+  }
+  const El::Int num_entries = columns.size();
+
+  if (m_sparse_gradient) {
+
+    // Send gradient w.r.t. used dictionary entries to optimizer
+    CPUMat dict_grad(m_embedding_size, num_entries);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int i = 0; i < num_entries; ++i) {
+      const auto& scale = scales[i];
+      const auto* __restrict__ dy = local_output_grad.LockedBuffer(0, samples[i]);
+      auto* __restrict__ dw = dict_grad.Buffer(0, i);
+      for (El::Int row = 0; row < m_embedding_size; ++row) {
+        dw[row] = scale * dy[row];
+      }
+    }
+    opt.add_to_sparse_gradient(columns, dict_grad,
+                               DataType{1} / mini_batch_size);
+
+  } else {
+
+    // Update appropriate columns of gradient w.r.t. dictionary
+    // Note: Entries may repeat, so accumulation is serial.
+    auto& local_dict_grad = m_dictionary_gradient.Matrix();
+    El::Zero(local_dict_grad);
+    auto* dict_grad_buffer = local_dict_grad.Buffer();
+    const auto& dict_grad_ldim = local_dict_grad.LDim();
+    for (El::Int i = 0; i < num_entries; ++i) {
+      const auto& scale = scales[i];
+      const auto* __restrict__ dy = local_output_grad.LockedBuffer(0, samples[i]);
+      auto* __restrict__ dw = dict_grad_buffer + columns[i] * dict_grad_ldim;
+      for (El::Int row = 0; row < m_embedding_size; ++row) {
+        dw[row] += scale * dy[row];
+      }
+    }
+    opt.add_to_gradient(m_dictionary_gradient,
+                        DataType{1} / mini_batch_size,
+                        true);
+
   }
-  opt.add_to_gradient(m_dictionary_gradient,
-                      DataType{1} / mini_batch_size,
-                      true);
 
 }
 
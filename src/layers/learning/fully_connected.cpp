@@ -33,7 +33,9 @@ void fully_connected_layer<data_layout::MODEL_PARALLEL, El::Device::CPU>
   ::setup_matrices(const El::Grid& grid) {
   learning_layer::setup_matrices(grid);
   deallocate_matrices();
-  m_bias_gradient = new MCStarMat<El::Device::CPU>(grid);
+  if (!m_model->is_frozen_model()) {
+    m_bias_gradient = new MCStarMat<El::Device::CPU>(grid);
+  }
 }
 
 template <>
@@ -41,7 +43,9 @@ void fully_connected_layer<data_layout::DATA_PARALLEL, El::Device::CPU>
   ::setup_matrices(const El::Grid& grid) {
   learning_layer::setup_matrices(grid);
   deallocate_matrices();
-  m_bias_gradient = new StarMat<El::Device::CPU>(grid);
+  if (!m_model->is_frozen_model()) {
+    m_bias_gradient = new StarMat<El::Device::CPU>(grid);
+  }
 }
 
 #ifdef LBANN_HAS_GPU
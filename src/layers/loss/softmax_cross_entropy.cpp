@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/layers/loss/softmax_cross_entropy.hpp"
+#include "lbann/utils/fast_math.hpp"
+
+namespace lbann {
+
+namespace {
+
+void fp(lbann_comm& comm,
+        const AbsDistMat& logits,
+        const AbsDistMat& ground_truth,
+        AbsDistMat& output,
+        AbsDistMat& workspace,
+        AbsDistMat& column_stats) {
+
+  // Initialize workspaces
+  const auto& width = logits.Width();
+  workspace.Empty(false);
+  workspace.AlignWith(logits.DistData());
+  workspace.Resize(3, width);
+  column_stats.Empty(false);
+  column_stats.AlignWith(logits.DistData());
+  column_stats.Resize(2, width);
+
+  // Local matrices
+  const auto& local_logits = logits.LockedMatrix();
+  const auto& local_ground_truth = ground_truth.LockedMatrix();
+  auto& local_workspace = workspace.Matrix();
+  auto& local_column_stats = column_stats.Matrix();
+  const auto& local_height = local_logits.Height();
+  const auto& local_width = local_logits.Width();
+
+  // Column-wise reductions
+  // Note: The max and sum(exp(x-max)) are computed in a single
+  // sweep. The label reductions reuse the column while it is still
+  // in cache.
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < local_width; ++col) {
+    const auto* __restrict__ x = local_logits.LockedBuffer(0, col);
+    const auto* __restrict__ xhat = local_ground_truth.LockedBuffer(0, col);
+    auto max_entry = std::numeric_limits<DataType>::lowest();
+    DataType sum_exp = 0;
+    fast_math::max_and_sum_exp(x, local_height, max_entry, sum_exp);
+    DataType xhat_dot_x = 0, sum_xhat = 0;
+    for (El::Int row = 0; row < local_height; ++row) {
+      xhat_dot_x += xhat[row] * x[row];
+      sum_xhat += xhat[row];
+    }
+    local_column_stats(0, col) = max_entry;
+    local_column_stats(1, col) = DataType(0);
+    local_workspace(0, col) = sum_exp;
+    local_workspace(1, col) = xhat_dot_x;
+    local_workspace(2, col) = sum_xhat;
+  }
+
+  // Combine partial reductions if columns are distributed
+  // Note: Each process's partial sum is rescaled to the global max.
+  if (workspace.RedundantSize() > 1) {
+    std::vector<DataType> local_max(local_width);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < local_width; ++col) {
+      local_max[col] = local_column_stats(0, col);
+    }
+    comm.allreduce(column_stats, column_stats.RedundantComm(), El::mpi::MAX);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < local_width; ++col) {
+      const auto& global_max = local_column_stats(0, col);
+      auto& sum_exp = local_workspace(0, col);
+      sum_exp = (sum_exp == DataType(0) ?
+                 DataType(0) :
+                 sum_exp * std::exp(local_max[col] - global_max));
+    }
+    comm.allreduce(workspace, workspace.RedundantComm());
+  }
+
+  // Compute loss and store statistics for back prop
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < local_width; ++col) {
+    const DataType log_sum_exp = (local_column_stats(0, col)
+                                  + std::log(local_workspace(0, col)));
+    const auto& xhat_dot_x = local_workspace(1, col);
+    const auto& sum_xhat = local_workspace(2, col);
+    local_column_stats(0, col) = log_sum_exp;
+    local_column_stats(1, col) = sum_xhat;
+    local_workspace(0, col) = log_sum_exp * sum_xhat - xhat_dot_x;
+  }
+  std::unique_ptr<AbsDistMat> contribution(workspace.Construct(workspace.Grid(),
+                                                               workspace.Root()));
+  El::LockedView(*contribution, workspace, El::IR(0), El::ALL);
+  El::Copy(*contribution, output);
+
+}
+
+void bp(const AbsDistMat& logits,
+        const AbsDistMat& ground_truth,
+        const AbsDistMat& gradient_wrt_output,
+        AbsDistMat& gradient_wrt_logits,
+        AbsDistMat& gradient_wrt_ground_truth,
+        AbsDistMat& workspace,
+        const AbsDistMat& column_stats) {
+
+  // Redistribute gradient w.r.t. output
+  workspace.AlignWith(logits.DistData());
+  El::Copy(gradient_wrt_output, workspace);
+
+  // Local matrices
+  const auto& local_logits = logits.LockedMatrix();
+  const auto& local_ground_truth = ground_truth.LockedMatrix();
+  const auto& local_gradient_wrt_output = workspace.LockedMatrix();
+  const auto& local_column_stats = column_stats.LockedMatrix();
+  auto& local_gradient_wrt_logits = gradient_wrt_logits.Matrix();
+  auto& local_gradient_wrt_ground_truth = gradient_wrt_ground_truth.Matrix();
+  const auto& local_height = local_logits.Height();
+  const auto& local_width = local_logits.Width();
+
+  // Compute gradients
+  // Note: dL/dx = dy * (softmax(x) * sum(y_hat) - y_hat) and
+  // dL/dy_hat = dy * (LogSumExp(x) - x).
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < local_width; ++col) {
+    const auto& log_sum_exp = local_column_stats(0, col);
+    const auto& sum_xhat = local_column_stats(1, col);
+    const auto& dy = local_gradient_wrt_output(0, col);
+    const auto* __restrict__ x = local_logits.LockedBuffer(0, col);
+    const auto* __restrict__ xhat = local_ground_truth.LockedBuffer(0, col);
+    auto* __restrict__ dx = local_gradient_wrt_logits.Buffer(0, col);
+    auto* __restrict__ dxhat = local_gradient_wrt_ground_truth.Buffer(0, col);
+    for (El::Int row = 0; row < local_height; ++row) {
+      const DataType y = fast_math::exp(x[row] - log_sum_exp);
+      dx[row] = dy * (y * sum_xhat - xhat[row]);
+      dxhat[row] = dy * (log_sum_exp - x[row]);
+    }
+  }
+
+}
+
+} // namespace
+
+template <>
+void softmax_cross_entropy_layer<data_layout::DATA_PARALLEL, El::Device::CPU>
+     ::fp_compute() {
+  fp(*get_comm(),
+     get_prev_activations(0),
+     get_prev_activations(1),
+     get_activations(),
+     *m_workspace,
+     *m_column_stats);
+}
+template <>
+void softmax_cross_entropy_layer<data_layout::DATA_PARALLEL, El::Device::CPU>
+     ::bp_compute() {
+  bp(get_prev_activations(0),
+     get_prev_activations(1),
+     get_prev_error_signals(),
+     get_error_signals(0),
+     get_error_signals(1),
+     *m_workspace,
+     *m_column_stats);
+}
+template <>
+void softmax_cross_entropy_layer<data_layout::MODEL_PARALLEL, El::Device::CPU>
+     ::fp_compute() {
+  fp(*get_comm(),
+     get_prev_activations(0),
+     get_prev_activations(1),
+     get_activations(),
+     *m_workspace,
+     *m_column_stats);
+}
+template <>
+void softmax_cross_entropy_layer<data_layout::MODEL_PARALLEL, El::Device::CPU>
+     ::bp_compute() {
+  bp(get_prev_activations(0),
+     get_prev_activations(1),
+     get_prev_error_signals(),
+     get_error_signals(0),
+     get_error_signals(1),
+     *m_workspace,
+     *m_column_stats);
+}
+
+} // namespace lbann
@@ -0,0 +1,204 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/layers/math/fused_entrywise.hpp"
+
+namespace lbann {
+
+template <data_layout Layout, El::Device Device>
+fused_entrywise_layer<Layout,Device>::fused_entrywise_layer(
+  lbann_comm* comm,
+  std::vector<std::unique_ptr<Layer>> layers)
+  : Layer(comm), m_layers(std::move(layers)) {
+  if (m_layers.empty()) {
+    LBANN_ERROR("attempted to construct fused entry-wise layer "
+                "with no layers");
+  }
+  setup_operators();
+}
+
+template <data_layout Layout, El::Device Device>
+fused_entrywise_layer<Layout,Device>::fused_entrywise_layer(
+  const fused_entrywise_layer& other)
+  : Layer(other) {
+  for (const auto& l : other.m_layers) {
+    m_layers.emplace_back(l->copy());
+  }
+  setup_operators();
+}
+
+template <data_layout Layout, El::Device Device>
+fused_entrywise_layer<Layout,Device>&
+fused_entrywise_layer<Layout,Device>::operator=(
+  const fused_entrywise_layer& other) {
+  Layer::operator=(other);
+  m_layers.clear();
+  for (const auto& l : other.m_layers) {
+    m_layers.emplace_back(l->copy());
+  }
+  setup_operators();
+  return *this;
+}
+
+template <data_layout Layout, El::Device Device>
+void fused_entrywise_layer<Layout,Device>::setup_operators() {
+  m_operators.clear();
+  for (const auto& l : m_layers) {
+    const auto* op = dynamic_cast<const entrywise_fusion_interface*>(l.get());
+    if (op == nullptr) {
+      std::stringstream err;
+      err << "attempted to fuse " << l->get_type() << " layer "
+          << "\"" << l->get_name() << "\", "
+          << "which is not an entry-wise layer";
+      LBANN_ERROR(err.str());
+    }
+    m_operators.push_back(op);
+  }
+}
+
+template <data_layout Layout, El::Device Device>
+description fused_entrywise_layer<Layout,Device>::get_description() const {
+  auto desc = Layer::get_description();
+  std::stringstream ss;
+  for (size_t i = 0; i < m_layers.size(); ++i) {
+    ss << (i > 0 ? ", " : "")
+       << m_layers[i]->get_name() << " (" << m_layers[i]->get_type() << ")";
+  }
+  desc.add("Fused layers", ss.str());
+  return desc;
+}
+
+template <>
+void fused_entrywise_layer<data_layout::DATA_PARALLEL, El::Device::CPU>
+     ::fp_compute() {
+  const auto& local_input = get_local_prev_activations();
+  auto& local_output = get_local_activations();
+  fused_entrywise_fp(m_operators,
+                     local_input.Height(), local_input.Width(),
+                     local_input.LockedBuffer(), local_input.LDim(),
+                     local_output.Buffer(), local_output.LDim());
+}
+
+template <>
+void fused_entrywise_layer<data_layout::MODEL_PARALLEL, El::Device::CPU>
+     ::fp_compute() {
+  const auto& local_input = get_local_prev_activations();
+  auto& local_output = get_local_activations();
+  fused_entrywise_fp(m_operators,
+                     local_input.Height(), local_input.Width(),
+                     local_input.LockedBuffer(), local_input.LDim(),
+                     local_output.Buffer(), local_output.LDim());
+}
+
+template <>
+void fused_entrywise_layer<data_layout::DATA_PARALLEL, El::Device::CPU>
+     ::bp_compute() {
+  const auto& local_input = get_local_prev_activations();
+  const auto& local_gradient_wrt_output = get_local_prev_error_signals();
+  auto& local_gradient_wrt_input = get_local_error_signals();
+  fused_entrywise_bp(m_operators,
+                     local_input.Height(), local_input.Width(),
+                     local_input.LockedBuffer(), local_input.LDim(),
+                     local_gradient_wrt_output.LockedBuffer(),
+                     local_gradient_wrt_output.LDim(),
+                     local_gradient_wrt_input.Buffer(),
+                     local_gradient_wrt_input.LDim(),
+                     m_workspace);
+}
+
+template <>
+void fused_entrywise_layer<data_layout::MODEL_PARALLEL, El::Device::CPU>
+     ::bp_compute() {
+  const auto& local_input = get_local_prev_activations();
+  const auto& local_gradient_wrt_output = get_local_prev_error_signals();
+  auto& local_gradient_wrt_input = get_local_error_signals();
+  fused_entrywise_bp(m_operators,
+                     local_input.Height(), local_input.Width(),
+                     local_input.LockedBuffer(), local_input.LDim(),
+                     local_gradient_wrt_output.LockedBuffer(),
+                     local_gradient_wrt_output.LDim(),
+                     local_gradient_wrt_input.Buffer(),
+                     local_gradient_wrt_input.LDim(),
+                     m_workspace);
+}
+
+template <data_layout Layout, El::Device Device>
+void fused_entrywise_layer<Layout,Device>::fp_compute_and_store_input(
+  storage_format format, reduced_precision_matrix& stored_input) {
+  const auto& local_input = get_local_prev_activations();
+  auto& local_output = get_local_activations();
+  stored_input.resize(format, local_input.Height(), local_input.Width());
+  fused_entrywise_fp(m_operators,
+                     local_input.Height(), local_input.Width(),
+                     local_input.LockedBuffer(), local_input.LDim(),
+                     local_output.Buffer(), local_output.LDim(),
+                     format, stored_input.get_buffer());
+}
+
+template <data_layout Layout, El::Device Device>
+void fused_entrywise_layer<Layout,Device>::bp_compute_with_stored_tensors(
+  const reduced_precision_matrix* stored_input,
+  AbsMat* local_input,
+  storage_format error_signal_format,
+  reduced_precision_matrix* stored_error_signal) {
+  const auto& local_prev_activations = get_local_prev_activations();
+  const auto& local_gradient_wrt_output = get_local_prev_error_signals();
+  auto& local_gradient_wrt_input = get_local_error_signals();
+  auto* input = (local_input != nullptr ?
+                 local_input->Buffer() :
+                 const_cast<DataType*>(local_prev_activations.LockedBuffer()));
+  const auto& input_ldim = (local_input != nullptr ?
+                            local_input->LDim() :
+                            local_prev_activations.LDim());
+  if (stored_error_signal != nullptr) {
+    stored_error_signal->resize(error_signal_format,
+                                local_gradient_wrt_input.Height(),
+                                local_gradient_wrt_input.Width());
+  }
+  fused_entrywise_bp(m_operators,
+                     local_gradient_wrt_input.Height(),
+                     local_gradient_wrt_input.Width(),
+                     (stored_input != nullptr ?
+                      stored_input->get_format() : storage_format::full),
+                     (stored_input != nullptr ?
+                      stored_input->get_buffer() : nullptr),
+                     input, input_ldim,
+                     local_gradient_wrt_output.LockedBuffer(),
+                     local_gradient_wrt_output.LDim(),
+                     local_gradient_wrt_input.Buffer(),
+                     local_gradient_wrt_input.LDim(),
+                     error_signal_format,
+                     (stored_error_signal != nullptr ?
+                      stored_error_signal->get_buffer() : nullptr),
+                     m_workspace);
+}
+
+template class fused_entrywise_layer<
+  data_layout::DATA_PARALLEL, El::Device::CPU>;
+template class fused_entrywise_layer<
+  data_layout::MODEL_PARALLEL, El::Device::CPU>;
+
+} // namespace lbann
@@ -369,6 +369,30 @@ struct atanh_op {
     apply_entrywise_binary_operator<op>(get_prev_activations(),         \
                                         get_prev_error_signals(),       \
                                         get_error_signals());           \
+  }                                                                     \
+  template <>                                                           \
+  void layer<data_layout::MODEL_PARALLEL, El::Device::CPU>              \
+  ::fp_compute_entrywise(const DataType* x, DataType* y,                \
+                         El::Int size) const {                          \
+    apply_entrywise_unary_operator<op>(x, y, size);                     \
+  }                                                                     \
+  template <>                                                           \
+  void layer<data_layout::MODEL_PARALLEL, El::Device::CPU>              \
+  ::bp_compute_entrywise(const DataType* x, const DataType* dy,         \
+                         DataType* dx, El::Int size) const {            \
+    apply_entrywise_binary_operator<op>(x, dy, dx, size);               \
+  }                                                                     \
+  template <>                                                           \
+  void layer<data_layout::DATA_PARALLEL, El::Device::CPU>               \
+  ::fp_compute_entrywise(const DataType* x, DataType* y,                \
+                         El::Int size) const {                          \
+    apply_entrywise_unary_operator<op>(x, y, size);                     \
+  }                                                                     \
+  template <>                                                           \
+  void layer<data_layout::DATA_PARALLEL, El::Device::CPU>               \
+  ::bp_compute_entrywise(const DataType* x, const DataType* dy,         \
+                         DataType* dx, El::Int size) const {            \
+    apply_entrywise_binary_operator<op>(x, dy, dx, size);               \
   }
   INSTANTIATE(logical_not_layer, logical_not_op)
   INSTANTIATE(abs_layer, abs_op)
@@ -369,7 +369,11 @@ struct atanh_op {
     cuda::apply_entrywise_binary_operator<op>(get_prev_activations(),   \
                                               get_prev_error_signals(), \
                                               get_error_signals());     \
-  }
+  }                                                                     \
+  LBANN_DEFINE_UNSUPPORTED_ENTRYWISE_FUSION(                            \
+    layer, data_layout::MODEL_PARALLEL, El::Device::GPU)                \
+  LBANN_DEFINE_UNSUPPORTED_ENTRYWISE_FUSION(                            \
+    layer, data_layout::DATA_PARALLEL, El::Device::GPU)
   INSTANTIATE(logical_not_layer, logical_not_op)
   INSTANTIATE(abs_layer, abs_op)
   INSTANTIATE(negative_layer, negative_op)
@@ -25,9 +25,130 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/layers/regularizers/batch_normalization.hpp"
+#include <algorithm>
+#include <vector>
 
 namespace lbann {
 
+namespace {
+
+/** Number of entries processed at a time when computing statistics.
+ *  A chunk should fit in L1 cache so it can be read twice cheaply.
+ */
+constexpr El::Int chunk_size = 1024;
+
+/** Minimum number of entries in a work block. */
+constexpr El::Int min_block_size = 8 * chunk_size;
+
+/** Count, mean, and sum of squared deviations of a set of entries. */
+struct welford_stats {
+  El::Int count = 0;
+  DataType mean = 0;
+  DataType m2 = 0;
+};
+
+/** Merge statistics from two disjoint sets of entries.
+ *  See Chan, Golub, and LeVeque. "Updating formulae and a pairwise
+ *  algorithm for computing sample variances." 1979.
+ */
+inline void merge_stats(welford_stats& a, const welford_stats& b) {
+  if (b.count == 0) { return; }
+  if (a.count == 0) { a = b; return; }
+  const El::Int count = a.count + b.count;
+  const DataType delta = b.mean - a.mean;
+  const DataType b_fraction = DataType(b.count) / count;
+  a.mean += delta * b_fraction;
+  a.m2 += b.m2 + delta * delta * a.count * b_fraction;
+  a.count = count;
+}
+
+/** Statistics of a contiguous array. Each chunk is summed, then its
+ *  squared deviations are summed while it is in cache, and chunks are
+ *  merged with merge_stats.
+ */
+welford_stats compute_stats(const DataType * __restrict__ x, El::Int size) {
+  welford_stats stats;
+  for (El::Int offset = 0; offset < size; offset += chunk_size) {
+    const El::Int count = std::min(chunk_size, size - offset);
+    const DataType * __restrict__ chunk = x + offset;
+    DataType sum = 0;
+    for (El::Int i = 0; i < count; ++i) { sum += chunk[i]; }
+    welford_stats chunk_stats;
+    chunk_stats.count = count;
+    chunk_stats.mean = sum / count;
+    for (El::Int i = 0; i < count; ++i) {
+      const DataType diff = chunk[i] - chunk_stats.mean;
+      chunk_stats.m2 += diff * diff;
+    }
+    merge_stats(stats, chunk_stats);
+  }
+  return stats;
+}
+
+/** Number of work blocks per channel.
+ *  Channels are split into blocks when there are too few channels
+ *  to occupy every thread, e.g. in early convolutional layers.
+ */
+El::Int get_blocks_per_channel(El::Int num_channels, El::Int channel_entries) {
+  const El::Int num_threads = omp_get_max_threads();
+  const El::Int target = (2 * num_threads + num_channels - 1) / num_channels;
+  const El::Int max_blocks = std::max(channel_entries / min_block_size,
+                                      El::Int(1));
+  return std::max(std::min(target, max_blocks), El::Int(1));
+}
+
+/** Apply a function to contiguous segments of a channel.
+ *  The entries of a channel are the column-major flattening of the
+ *  (channel_size x local_width) submatrix. For each segment of
+ *  entries [begin, end) in the same column, f(row, col, size) is
+ *  called.
+ */
+template <typename F>
+void for_each_segment(El::Int channel, El::Int channel_size,
+                      El::Int begin, El::Int end, F f) {
+  for (El::Int pos = begin; pos < end;) {
+    const El::Int col = pos / channel_size;
+    const El::Int offset = pos % channel_size;
+    const El::Int size = std::min(end - pos, channel_size - offset);
+    f(channel * channel_size + offset, col, size);
+    pos += size;
+  }
+}
+
+/** Compute y = a*x + b for each channel, optionally followed by
+ *  ReLU. Parallelized over (channel, column) pairs.
+ */
+void apply_affine(const AbsMat& local_input,
+                  AbsMat& local_output,
+                  const std::vector<DataType>& a,
+                  const std::vector<DataType>& b,
+                  El::Int channel_size,
+                  bool apply_relu) {
+  const El::Int num_channels = a.size();
+  const El::Int local_width = local_input.Width();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int channel = 0; channel < num_channels; ++channel) {
+    for (El::Int col = 0; col < local_width; ++col) {
+      const El::Int row = channel * channel_size;
+      const DataType * __restrict__ x = local_input.LockedBuffer(row, col);
+      DataType * __restrict__ y = local_output.Buffer(row, col);
+      const DataType scale = a[channel];
+      const DataType shift = b[channel];
+      if (apply_relu) {
+        for (El::Int i = 0; i < channel_size; ++i) {
+          y[i] = std::max(scale * x[i] + shift, DataType(0));
+        }
+      } else {
+        for (El::Int i = 0; i < channel_size; ++i) {
+          y[i] = scale * x[i] + shift;
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
 template <>
 void batch_normalization_layer<data_layout::DATA_PARALLEL, El::Device::CPU>::fp_compute() {
   constexpr DataType zero = 0;
@@ -46,6 +167,18 @@ void batch_normalization_layer<data_layout::DATA_PARALLEL, El::Device::CPU>::fp_
   const auto& num_channels = output_dims[0];
   const auto& channel_size = get_output_size() / num_channels;
 
+  // Folded layers output a view into their inputs, unless they
+  // apply a fused ReLU
+  if (m_folded) {
+    if (m_fused_relu) {
+      apply_affine(local_input, local_output,
+                   std::vector<DataType>(num_channels, one),
+                   std::vector<DataType>(num_channels, zero),
+                   channel_size, true);
+    }
+    return;
+  }
+
   // Compute statistics
   if (is_training) {
 
@@ -55,22 +188,42 @@ void batch_normalization_layer<data_layout::DATA_PARALLEL, El::Device::CPU>::fp_
     auto& local_running_mean = this->m_weights[2]->get_values().Matrix();
     auto& local_running_var = this->m_weights[3]->get_values().Matrix();
 
-    // Compute sums and sums of squares
+    // Compute local statistics for blocks of each channel
+    const El::Int channel_entries = channel_size * local_width;
+    const El::Int num_blocks = get_blocks_per_channel(num_channels,
+                                                      channel_entries);
+    std::vector<welford_stats> block_stats(num_channels * num_blocks);
+    LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+    for (El::Int channel = 0; channel < num_channels; ++channel) {
+      for (El::Int block = 0; block < num_blocks; ++block) {
+        auto& stats = block_stats[channel * num_blocks + block];
+        for_each_segment(
+          channel, channel_size,
+          (block * channel_entries) / num_blocks,
+          ((block+1) * channel_entries) / num_blocks,
+          [&](El::Int row, El::Int col, El::Int size) {
+            merge_stats(stats,
+                        compute_stats(local_input.LockedBuffer(row, col),
+                                      size));
+          });
+      }
+    }
+
+    // Merge blocks and convert to sums of entries and squares
+    // Note: Sums are shifted by the running mean, which is identical
+    // on every process that aggregates statistics. This avoids
+    // cancellation when the mean is large compared to the standard
+    // deviation, while keeping a single sum allreduce.
     LBANN_OMP_PARALLEL_FOR
     for (El::Int channel = 0; channel < num_channels; ++channel) {
-      DataType sum = zero;
-      DataType sqsum = zero;
-      const auto& row_start = channel * channel_size;
-      const auto& row_end = (channel+1) * channel_size;
-      for (El::Int col = 0; col < local_width; ++col) {
-        for (El::Int row = row_start; row < row_end; ++row) {
-          const auto& x = local_input(row, col);
-          sum += x;
-          sqsum += x * x;
-        }
+      welford_stats stats;
+      for (El::Int block = 0; block < num_blocks; ++block) {
+        merge_stats(stats, block_stats[channel * num_blocks + block]);
       }
-      local_mean(channel, 0) = sum;
-      local_var(channel, 0) = sqsum;
+      const DataType shift = local_running_mean(channel, 0);
+      const DataType diff = stats.mean - shift;
+      local_mean(channel, 0) = stats.count * diff;
+      local_var(channel, 0) = stats.m2 + stats.count * diff * diff;
     }
     El::Int num_per_sum;
     if (m_statistics_group_size == 0) {
@@ -98,18 +251,23 @@ void batch_normalization_layer<data_layout::DATA_PARALLEL, El::Device::CPU>::fp_
 
     // Compute minibatch statistics
     if (num_per_sum <= 1) {
+      for (El::Int channel = 0; channel < num_channels; ++channel) {
+        local_mean(channel, 0) += local_running_mean(channel, 0);
+      }
       El::Fill(local_var, one);
     } else {
       LBANN_OMP_PARALLEL_FOR
       for (El::Int channel = 0; channel < num_channels; ++channel) {
-        const auto& mean = local_mean(channel, 0) / num_per_sum;
-        const auto& sqmean = local_var(channel, 0) / num_per_sum;
-        auto var = num_per_sum * (sqmean - mean * mean) / (num_per_sum - 1);
+        const auto& shifted_sum = local_mean(channel, 0);
+        const auto& shifted_sqsum = local_var(channel, 0);
+        auto& running_mean = local_running_mean(channel, 0);
+        auto& running_var = local_running_var(channel, 0);
+        const auto& mean = running_mean + shifted_sum / num_per_sum;
+        const auto& m2 = shifted_sqsum - shifted_sum * shifted_sum / num_per_sum;
+        auto var = m2 / (num_per_sum - 1);
         var = std::max(var, m_epsilon);
         local_mean(channel, 0) = mean;
         local_var(channel, 0) = var;
-        auto& running_mean = local_running_mean(channel, 0);
-        auto& running_var = local_running_var(channel, 0);
         running_mean = m_decay * running_mean + (one - m_decay) * mean;
         running_var = m_decay * running_var + (one - m_decay) * var;
       }
@@ -127,30 +285,16 @@ void batch_normalization_layer<data_layout::DATA_PARALLEL, El::Device::CPU>::fp_
                            m_var_v->LockedMatrix() :
                            this->m_weights[3]->get_values().LockedMatrix());
 
-  // Iterate through channels
-  LBANN_OMP_PARALLEL_FOR
+  // Normalization, scale, and bias are a per-channel affine transform
+  std::vector<DataType> a(num_channels), b(num_channels);
   for (El::Int channel = 0; channel < num_channels; ++channel) {
-
-    // Get channel parameters
     const auto& mean = local_mean(channel, 0);
     const auto& var = local_var(channel, 0);
     const DataType inv_stdev = 1 / std::sqrt(var + m_epsilon);
-    const auto& scale = local_scale(channel, 0);
-    const auto& bias = local_bias(channel, 0);
-
-    // Apply batch normalization to inputs in channel
-    const auto& row_start = channel * channel_size;
-    const auto& row_end = (channel+1) * channel_size;
-    for (El::Int col = 0; col < local_width; ++col) {
-      for (El::Int row = row_start; row < row_end; ++row) {
-        const auto& x = local_input(row, col);
-        const auto& xhat = (x - mean) * inv_stdev;
-        auto& y = local_output(row, col);
-        y = scale * xhat + bias;
-      }
-    }
-
+    a[channel] = local_scale(channel, 0) * inv_stdev;
+    b[channel] = local_bias(channel, 0) - a[channel] * mean;
   }
+  apply_affine(local_input, local_output, a, b, channel_size, m_fused_relu);
 
 }
 
@@ -169,6 +313,7 @@ void batch_normalization_layer<data_layout::DATA_PARALLEL, El::Device::CPU>::bp_
                            this->m_weights[3]->get_values().LockedMatrix());
   const auto& input = get_prev_activations();
   const auto& local_input = input.LockedMatrix();
+  const auto& local_output = get_local_activations();
   const auto& local_gradient_wrt_output = get_local_prev_error_signals();
   auto& local_gradient_wrt_input = get_local_error_signals();
   auto& local_mean_gradient = m_mean_gradient_v->Matrix();
@@ -183,42 +328,67 @@ void batch_normalization_layer<data_layout::DATA_PARALLEL, El::Device::CPU>::bp_
   const auto& output_dims = get_output_dims();
   const auto& num_channels = output_dims[0];
   const auto& channel_size = get_output_size() / num_channels;
+  const bool apply_relu = m_fused_relu;
+
+  // Compute sums of dy and dy*(x-mean) for blocks of each channel
+  // Note: dy is masked by the fused ReLU, which is inactive where
+  // the output is not positive.
+  const El::Int channel_entries = channel_size * local_width;
+  const El::Int num_blocks = get_blocks_per_channel(num_channels,
+                                                    channel_entries);
+  std::vector<DataType> block_sums(2 * num_channels * num_blocks);
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int channel = 0; channel < num_channels; ++channel) {
+    for (El::Int block = 0; block < num_blocks; ++block) {
+      const auto& mean = local_mean(channel, 0);
+      DataType dy_sum = 0, dy_dev_sum = 0;
+      for_each_segment(
+        channel, channel_size,
+        (block * channel_entries) / num_blocks,
+        ((block+1) * channel_entries) / num_blocks,
+        [&](El::Int row, El::Int col, El::Int size) {
+          const DataType * __restrict__ x = local_input.LockedBuffer(row, col);
+          const DataType * __restrict__ y = local_output.LockedBuffer(row, col);
+          const DataType * __restrict__ dy
+            = local_gradient_wrt_output.LockedBuffer(row, col);
+          if (apply_relu) {
+            for (El::Int i = 0; i < size; ++i) {
+              const DataType dy_i = y[i] > DataType(0) ? dy[i] : DataType(0);
+              dy_sum += dy_i;
+              dy_dev_sum += dy_i * (x[i] - mean);
+            }
+          } else {
+            for (El::Int i = 0; i < size; ++i) {
+              dy_sum += dy[i];
+              dy_dev_sum += dy[i] * (x[i] - mean);
+            }
+          }
+        });
+      const El::Int index = 2 * (channel * num_blocks + block);
+      block_sums[index] = dy_sum;
+      block_sums[index+1] = dy_dev_sum;
+    }
+  }
 
   // Compute local gradients
+  // Note: All gradients are linear in the two sums, e.g.
+  // d(mean) = -scale * inv_stdev * sum(dy).
   LBANN_OMP_PARALLEL_FOR
   for (El::Int channel = 0; channel < num_channels; ++channel) {
-
-    // Initialize channel parameters and gradients
-    const auto& mean = local_mean(channel, 0);
+    DataType dy_sum = 0, dy_dev_sum = 0;
+    for (El::Int block = 0; block < num_blocks; ++block) {
+      const El::Int index = 2 * (channel * num_blocks + block);
+      dy_sum += block_sums[index];
+      dy_dev_sum += block_sums[index+1];
+    }
     const auto& var = local_var(channel, 0);
     const auto& scale = local_scale(channel, 0);
     const DataType inv_stdev = 1 / std::sqrt(var + m_epsilon);
     const auto& dvar_factor = inv_stdev * inv_stdev * inv_stdev / 2;
-    DataType dmean = 0;
-    DataType dvar = 0;
-    DataType dscale = 0;
-    DataType dbias = 0;
-
-    // Compute gradient contributions from local entries
-    const auto& row_start = channel * channel_size;
-    const auto& row_end = (channel+1) * channel_size;
-    for (El::Int col = 0; col < local_width; ++col) {
-      for (El::Int row = row_start; row < row_end; ++row) {
-        const auto& x = local_input(row, col);
-        const auto& xhat = (x - mean) * inv_stdev;
-        const auto& dy = local_gradient_wrt_output(row, col);
-        dscale += dy * xhat;
-        dbias += dy;
-        const auto& dxhat = dy * scale;
-        dmean += - dxhat * inv_stdev;
-        dvar += - dxhat * (x - mean) * dvar_factor;
-      }
-    }
-    local_mean_gradient(channel, 0) = dmean;
-    local_var_gradient(channel, 0) = dvar;
-    local_scale_gradient(channel, 0) = dscale;
-    local_bias_gradient(channel, 0) = dbias;
-
+    local_mean_gradient(channel, 0) = - scale * inv_stdev * dy_sum;
+    local_var_gradient(channel, 0) = - scale * dvar_factor * dy_dev_sum;
+    local_scale_gradient(channel, 0) = inv_stdev * dy_dev_sum;
+    local_bias_gradient(channel, 0) = dy_sum;
   }
 
   // Accumulate gradients
@@ -266,34 +436,37 @@ void batch_normalization_layer<data_layout::DATA_PARALLEL, El::Device::CPU>::bp_
   if (num_per_sum <= 1) {
     El::Zero(local_gradient_wrt_input);
   } else {
-    LBANN_OMP_PARALLEL_FOR
+    LBANN_OMP_PARALLEL_FOR_COLLAPSE2
     for (El::Int channel = 0; channel < num_channels; ++channel) {
-
-      // Initialize channel parameters and gradients
-      const auto& mean = local_mean(channel, 0);
-      const auto& var = local_var(channel, 0);
-      const auto& scale = local_scale(channel, 0);
-      const auto& dmean = local_mean_gradient(channel, 0);
-      const auto& dvar = local_var_gradient(channel, 0);
-
-      // Compute useful constants
-      const DataType inv_stdev = 1 / std::sqrt(var + m_epsilon);
-      const auto& dmean_term = dmean / num_per_sum;
-      const auto& dvar_term = dvar * 2 / (num_per_sum - 1);
-
-      // Compute error signal for current channel
-      const auto& row_start = channel * channel_size;
-      const auto& row_end = (channel+1) * channel_size;
       for (El::Int col = 0; col < local_width; ++col) {
-        for (El::Int row = row_start; row < row_end; ++row) {
-          const auto& x = local_input(row, col);
-          const auto& dy = local_gradient_wrt_output(row, col);
-          const auto& dxhat = dy * scale;
-          auto& dx = local_gradient_wrt_input(row, col);
-          dx = dxhat * inv_stdev + dmean_term + dvar_term * (x - mean);
+
+        // Channel parameters
+        const auto& mean = local_mean(channel, 0);
+        const auto& var = local_var(channel, 0);
+        const DataType inv_stdev = 1 / std::sqrt(var + m_epsilon);
+        const DataType dy_factor = local_scale(channel, 0) * inv_stdev;
+        const DataType dmean_term = local_mean_gradient(channel, 0) / num_per_sum;
+        const DataType dvar_term = local_var_gradient(channel, 0) * 2 / (num_per_sum - 1);
+
+        // Compute error signal for current channel and column
+        const El::Int row = channel * channel_size;
+        const DataType * __restrict__ x = local_input.LockedBuffer(row, col);
+        const DataType * __restrict__ y = local_output.LockedBuffer(row, col);
+        const DataType * __restrict__ dy
+          = local_gradient_wrt_output.LockedBuffer(row, col);
+        DataType * __restrict__ dx = local_gradient_wrt_input.Buffer(row, col);
+        if (apply_relu) {
+          for (El::Int i = 0; i < channel_size; ++i) {
+            const DataType dy_i = y[i] > DataType(0) ? dy[i] : DataType(0);
+            dx[i] = dy_i * dy_factor + dmean_term + dvar_term * (x[i] - mean);
+          }
+        } else {
+          for (El::Int i = 0; i < channel_size; ++i) {
+            dx[i] = dy[i] * dy_factor + dmean_term + dvar_term * (x[i] - mean);
+          }
         }
-      }
 
+      }
     }
   }
 
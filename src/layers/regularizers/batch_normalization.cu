@@ -295,6 +295,9 @@ __global__ void backprop2_kernel(
 
 template <>
 void batch_normalization_layer<data_layout::DATA_PARALLEL, El::Device::GPU>::fp_compute() {
+  // Folded layers output a view into their inputs
+  if (m_folded) { return; }
+
   constexpr DataType one = 1;
   const bool is_training = this->m_model->get_execution_mode() == execution_mode::training;
 
@@ -34,32 +34,35 @@ namespace lbann {
 
 namespace {
 
-/** CPU implementation of evaluation layer forward prop. */
-void fp_cpu(lbann_comm& comm,
-            const AbsDistMat& input,
-            DataType& value,
-            Al::request& req) {
+/** Sum of local input matrix entries (CPU). */
+DataType local_sum_cpu(const AbsDistMat& input) {
   const auto& local_input = input.LockedMatrix();
   const auto& local_height = local_input.Height();
   const auto& local_width = local_input.Width();
-  const auto& mini_batch_size = input.Width();
-  value = 0;
-  LBANN_OMP_PARALLEL_FOR_ARGS(reduction(+:value) collapse(2))
+  DataType sum = 0;
+  LBANN_OMP_PARALLEL_FOR_ARGS(reduction(+:sum) collapse(2))
   for (El::Int col = 0; col < local_width; ++col) {
     for (El::Int row = 0; row < local_height; ++row) {
-      value += local_input(row, col);
+      sum += local_input(row, col);
     }
   }
-  value = value / mini_batch_size;
-  comm.nb_allreduce(&value, 1, input.DistComm(), req);
+  return sum;
 }
 
-#ifdef LBANN_HAS_GPU
-/** GPU implementation of evaluation layer forward prop. */
-void fp_gpu(lbann_comm& comm,
+/** CPU implementation of evaluation layer forward prop. */
+void fp_cpu(lbann_comm& comm,
             const AbsDistMat& input,
             DataType& value,
-            cuda::event_wrapper& copy_event) {
+            Al::request& req) {
+  value = local_sum_cpu(input) / input.Width();
+  comm.nb_allreduce(&value, 1, input.DistComm(), req);
+}
+
+#ifdef LBANN_HAS_GPU
+/** Sum of local input matrix entries (GPU).
+ *  The result is stored in a 1 x 1 GPU matrix.
+ */
+void local_sum_gpu(const AbsDistMat& input, GPUMat& sum_d) {
   constexpr DataType zero = 0;
   constexpr DataType one = 1;
 
@@ -67,17 +70,14 @@ void fp_gpu(lbann_comm& comm,
   const auto& local_input = input.LockedMatrix();
   const auto& local_height = local_input.Height();
   const auto& local_width = local_input.Width();
-  const auto& mini_batch_size = input.Width();
 
   // GPU objects
-  GPUMat sum_d, ones_d;
+  GPUMat ones_d;
 #ifdef HYDROGEN_HAVE_CUB
-  sum_d.SetMemoryMode(1);  // Use CUB GPU memory pool
   ones_d.SetMemoryMode(1); // Use CUB GPU memory pool
 #endif // HYDROGEN_HAVE_CUB
   sum_d.Resize(1, 1);
   auto&& handle = El::GPUManager::cuBLASHandle();
-  auto&& stream = El::GPUManager::Stream();
   CHECK_CUBLAS(cublasSetPointerMode(handle, CUBLAS_POINTER_MODE_DEVICE));
 
   // Compute sum of local input matrix entries
@@ -120,8 +120,23 @@ void fp_gpu(lbann_comm& comm,
   }
   CHECK_CUBLAS(cublasSetPointerMode(handle, CUBLAS_POINTER_MODE_HOST));
 
+}
+
+/** GPU implementation of evaluation layer forward prop. */
+void fp_gpu(lbann_comm& comm,
+            const AbsDistMat& input,
+            DataType& value,
+            cuda::event_wrapper& copy_event) {
+  constexpr DataType one = 1;
+  auto&& stream = El::GPUManager::Stream();
+  GPUMat sum_d;
+#ifdef HYDROGEN_HAVE_CUB
+  sum_d.SetMemoryMode(1);  // Use CUB GPU memory pool
+#endif // HYDROGEN_HAVE_CUB
+  local_sum_gpu(input, sum_d);
+
   // Compute average value across mini-batch
-  El::Scale(one / mini_batch_size, sum_d);
+  El::Scale(one / input.Width(), sum_d);
   comm.allreduce(static_cast<AbsMat&>(sum_d), input.DistComm());
   CHECK_CUDA(cudaMemcpyAsync(&value,
                              sum_d.LockedBuffer(),
@@ -136,6 +151,50 @@ void fp_gpu(lbann_comm& comm,
 } // namespace
 
 EvalType abstract_evaluation_layer::get_value(bool scaled) {
+  if (m_deferred_window > 1) {
+    // Reduce the local value of the current step
+    if (!m_value_reduced) {
+      const auto& dist_comm = get_prev_activations().DistComm();
+      switch (get_device_allocation()) {
+      case El::Device::CPU:
+        m_value(0, 0) = get_comm()->allreduce(m_value(0, 0), dist_comm);
+        break;
+#ifdef LBANN_HAS_GPU
+      case El::Device::GPU:
+        El::Scale(DataType(1) / m_mini_batch_size, m_step_sum_d);
+        get_comm()->allreduce(static_cast<AbsMat&>(m_step_sum_d), dist_comm);
+        CHECK_CUDA(cudaMemcpyAsync(m_value.Buffer(),
+                                   m_step_sum_d.LockedBuffer(),
+                                   sizeof(DataType),
+                                   cudaMemcpyDeviceToHost,
+                                   El::GPUManager::Stream()));
+        CHECK_CUDA(cudaStreamSynchronize(El::GPUManager::Stream()));
+        break;
+#endif // LBANN_HAS_GPU
+      default: LBANN_ERROR("invalid device");
+      }
+      m_value_reduced = true;
+    }
+  } else {
+    switch (get_device_allocation()) {
+    case El::Device::CPU: get_comm()->wait(m_allreduce_req); break;
+#ifdef LBANN_HAS_GPU
+    case El::Device::GPU: m_copy_event.synchronize(); break;
+#endif // LBANN_HAS_GPU
+    default: LBANN_ERROR("invalid device");
+    }
+  }
+  if (scaled) { return m_scale * m_value(0, 0); }
+  else        { return m_value(0, 0); }
+}
+
+void abstract_evaluation_layer::set_value(EvalType value) {
+  if (m_deferred_window > 1) {
+    std::stringstream err;
+    err << "attempted to set the value of " << get_type() << " layer "
+        << "\"" << get_name() << "\" with deferred evaluation";
+    LBANN_ERROR(err.str());
+  }
   switch (get_device_allocation()) {
   case El::Device::CPU: get_comm()->wait(m_allreduce_req); break;
 #ifdef LBANN_HAS_GPU
@@ -143,8 +202,114 @@ EvalType abstract_evaluation_layer::get_value(bool scaled) {
 #endif // LBANN_HAS_GPU
   default: LBANN_ERROR("invalid device");
   }
-  if (scaled) { return m_scale * m_value(0, 0); }
-  else        { return m_value(0, 0); }
+  m_value(0, 0) = value;
+  m_value_reduced = true;
+}
+
+void abstract_evaluation_layer::set_deferred_evaluation(El::Int window) {
+  // Complete the current window before changing its length
+  if (m_deferred_steps > 0 || m_deferred_pending) {
+    start_deferred_reduction();
+    finish_deferred_reduction(true);
+  }
+  m_deferred_window = window;
+}
+
+int abstract_evaluation_layer::add_deferred_consumer() {
+  m_deferred_collected.push_back(EvalType(0));
+  return m_deferred_collected.size() - 1;
+}
+
+EvalType abstract_evaluation_layer::collect_deferred_value(int consumer,
+                                                           bool flush) {
+  if (consumer < 0 || consumer >= (int) m_deferred_collected.size()) {
+    std::stringstream err;
+    err << get_type() << " layer \"" << get_name() << "\" "
+        << "has no deferred value consumer " << consumer;
+    LBANN_ERROR(err.str());
+  }
+  if (flush && m_deferred_steps > 0) { start_deferred_reduction(); }
+  finish_deferred_reduction(flush);
+  const auto value = m_deferred_collected[consumer];
+  m_deferred_collected[consumer] = EvalType(0);
+  return value;
+}
+
+void abstract_evaluation_layer::fp_compute_deferred() {
+  const auto& input = get_prev_activations();
+  m_mini_batch_size = input.Width();
+  m_value_reduced = false;
+  switch (get_device_allocation()) {
+  case El::Device::CPU:
+    {
+      const auto sum = local_sum_cpu(input);
+      m_value(0, 0) = sum / m_mini_batch_size;
+      m_deferred_local_sum += sum;
+    }
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    local_sum_gpu(input, m_step_sum_d);
+    El::Axpy(DataType(1), m_step_sum_d, m_deferred_sum_d);
+    break;
+#endif // LBANN_HAS_GPU
+  default: LBANN_ERROR("invalid device");
+  }
+  if (++m_deferred_steps >= m_deferred_window) {
+    start_deferred_reduction();
+  }
+}
+
+void abstract_evaluation_layer::start_deferred_reduction() {
+  // At most one reduction is in flight
+  finish_deferred_reduction(true);
+  const auto& dist_comm = get_prev_activations().DistComm();
+  switch (get_device_allocation()) {
+  case El::Device::CPU:
+    m_deferred_value(0, 0) = m_deferred_local_sum;
+    m_deferred_local_sum = 0;
+    get_comm()->nb_allreduce(m_deferred_value.Buffer(), 1, dist_comm,
+                             m_allreduce_req);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    {
+      auto&& stream = El::GPUManager::Stream();
+      get_comm()->allreduce(static_cast<AbsMat&>(m_deferred_sum_d), dist_comm);
+      CHECK_CUDA(cudaMemcpyAsync(m_deferred_value.Buffer(),
+                                 m_deferred_sum_d.LockedBuffer(),
+                                 sizeof(DataType),
+                                 cudaMemcpyDeviceToHost,
+                                 stream));
+      m_copy_event.record(stream);
+      El::Zero(m_deferred_sum_d);
+    }
+    break;
+#endif // LBANN_HAS_GPU
+  default: LBANN_ERROR("invalid device");
+  }
+  m_deferred_steps = 0;
+  m_deferred_pending = true;
+}
+
+bool abstract_evaluation_layer::finish_deferred_reduction(bool wait) {
+  if (!m_deferred_pending) { return true; }
+  switch (get_device_allocation()) {
+  case El::Device::CPU:
+    if (wait) { get_comm()->wait(m_allreduce_req); }
+    else if (!get_comm()->test(m_allreduce_req)) { return false; }
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    if (wait) { m_copy_event.synchronize(); }
+    else if (!m_copy_event.query()) { return false; }
+    break;
+#endif // LBANN_HAS_GPU
+  default: LBANN_ERROR("invalid device");
+  }
+  for (auto& v : m_deferred_collected) { v += m_deferred_value(0, 0); }
+  m_deferred_pending = false;
+  return true;
 }
 
 abstract_evaluation_layer::abstract_evaluation_layer(lbann_comm *comm)
@@ -174,9 +339,20 @@ void abstract_evaluation_layer::setup_data() {
   m_value.SetMemoryMode(1); // Use pinned memory on host
 #endif // LBANN_HAS_GPU
   El::Zeros(m_value, 1, 1);
+#ifdef LBANN_HAS_GPU
+  m_deferred_value.SetMemoryMode(1); // Use pinned memory on host
+  if (get_device_allocation() == El::Device::GPU) {
+    El::Zeros(m_deferred_sum_d, 1, 1);
+  }
+#endif // LBANN_HAS_GPU
+  El::Zeros(m_deferred_value, 1, 1);
 }
 
 void abstract_evaluation_layer::fp_compute() {
+  if (m_deferred_window > 1) {
+    fp_compute_deferred();
+    return;
+  }
   switch (get_device_allocation()) {
   case El::Device::CPU:
     fp_cpu(*get_comm(), get_prev_activations(), m_value(0, 0),
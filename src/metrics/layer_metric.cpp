@@ -74,7 +74,7 @@ void layer_metric::set_layer_pointers(std::vector<Layer*> layers) {
 
 void layer_metric::setup(model& m) {
   metric::setup(m);
-  get_evaluation_layer();
+  m_deferred_consumer = get_evaluation_layer().add_deferred_consumer();
 }
 
 EvalType layer_metric::evaluate(execution_mode mode,
@@ -88,6 +88,25 @@ EvalType layer_metric::evaluate(execution_mode mode,
   return value;
 }
 
+void layer_metric::evaluate_deferred(execution_mode mode,
+                                     int mini_batch_size) {
+  const auto& start = get_time();
+  auto value = get_evaluation_layer().collect_deferred_value(m_deferred_consumer,
+                                                             false);
+  get_evaluate_time() += get_time() - start;
+  if (m_unit == "%") { value *= 100; }
+  get_statistics()[mode].add_value(value, mini_batch_size);
+}
+
+void layer_metric::flush_deferred(execution_mode mode) {
+  const auto& start = get_time();
+  auto value = get_evaluation_layer().collect_deferred_value(m_deferred_consumer,
+                                                             true);
+  get_evaluate_time() += get_time() - start;
+  if (m_unit == "%") { value *= 100; }
+  get_statistics()[mode].add_value(value, 0);
+}
+
 abstract_evaluation_layer& layer_metric::get_evaluation_layer() {
   auto& l = get_layer();
   auto* eval = dynamic_cast<abstract_evaluation_layer*>(&l);
@@ -32,17 +32,25 @@
 #include "lbann/layers/transform/dummy.hpp"
 #include "lbann/layers/transform/split.hpp"
 #include "lbann/layers/transform/evaluation.hpp"
+#include "lbann/layers/math/fused_entrywise.hpp"
+#include "lbann/layers/activations/activations.hpp"
+#include "lbann/layers/regularizers/batch_normalization.hpp"
 #include "lbann/objective_functions/layer_term.hpp"
 #include "lbann/metrics/layer_metric.hpp"
 #include "lbann/utils/random.hpp"
 #include "lbann/utils/omp_diagnostics.hpp"
 #include "lbann/utils/description.hpp"
+#include "lbann/utils/memory.hpp"
+#include "lbann/utils/memory_planner.hpp"
+#include "lbann/utils/pipeline_schedule.hpp"
 #include "lbann/data_store/data_store_conduit.hpp"
 
 #include <model.pb.h>
 
 #include <mpi.h>
 
+#include <algorithm>
+#include <cmath>
 #include <string>
 #include <unistd.h>
 #include <iomanip>
@@ -51,6 +59,26 @@
 
 namespace lbann {
 
+namespace {
+
+/** Whether all local entries in a distributed matrix are finite. */
+bool is_finite_local(const AbsDistMat& mat) {
+  AbsDistMatReadProxy<El::Device::CPU> proxy(mat);
+  const auto& local_mat = static_cast<const CPUMat&>(proxy.GetLocked().LockedMatrix());
+  const El::Int height = local_mat.Height();
+  const El::Int width = local_mat.Width();
+  bool finite = true;
+  LBANN_OMP_PARALLEL_FOR_ARGS(reduction(&&:finite) collapse(2))
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      finite = finite && std::isfinite(local_mat(row, col));
+    }
+  }
+  return finite;
+}
+
+} // namespace
+
 // =============================================
 // Life cycle functions
 // =============================================
@@ -83,7 +111,42 @@ model::model(const model& other) :
   m_current_mini_batch_size(other.m_current_mini_batch_size),
   m_max_mini_batch_size(other.m_max_mini_batch_size),
   m_effective_mini_batch_size(other.m_effective_mini_batch_size),
-  m_background_io_allowed(other.m_background_io_allowed) {
+  m_background_io_allowed(other.m_background_io_allowed),
+  m_recompute_activations(other.m_recompute_activations),
+  m_activation_checkpoint_interval(other.m_activation_checkpoint_interval),
+  m_recompute_segments(other.m_recompute_segments),
+  m_free_activations(other.m_free_activations),
+  m_rerun_forward_prop(other.m_rerun_forward_prop),
+  m_naive_activation_memory(other.m_naive_activation_memory),
+  m_in_place_activation_memory(other.m_in_place_activation_memory),
+  m_planned_activation_memory(other.m_planned_activation_memory),
+  m_fuse_entrywise_layers(other.m_fuse_entrywise_layers),
+  m_num_fused_layers(other.m_num_fused_layers),
+  m_num_saved_memory_passes(other.m_num_saved_memory_passes),
+  m_num_output_views(other.m_num_output_views),
+  m_num_error_signal_views(other.m_num_error_signal_views),
+  m_num_in_place_outputs(other.m_num_in_place_outputs),
+  m_num_in_place_error_signals(other.m_num_in_place_error_signals),
+  m_reduced_precision_storage(other.m_reduced_precision_storage),
+  m_num_stored_inputs(other.m_num_stored_inputs),
+  m_num_stored_error_signals(other.m_num_stored_error_signals),
+  m_reduced_precision_saved_memory(other.m_reduced_precision_saved_memory),
+  m_frozen_model(other.m_frozen_model),
+  m_folded_for_inference(other.m_folded_for_inference),
+  m_frozen_saved_memory(other.m_frozen_saved_memory),
+  m_constant_layers(other.m_constant_layers),
+  m_constant_mini_batch_sizes(other.m_constant_mini_batch_sizes),
+  m_step_timing(other.m_step_timing),
+  m_deferred_evaluation_window(other.m_deferred_evaluation_window),
+  m_deferred_evaluation_mode(other.m_deferred_evaluation_mode),
+  m_num_pipeline_stages(other.m_num_pipeline_stages),
+  m_num_micro_batches(other.m_num_micro_batches),
+  m_pipeline_stage_boundaries(other.m_pipeline_stage_boundaries),
+  m_pipeline_stages(other.m_pipeline_stages),
+  m_pipeline_stage(other.m_pipeline_stage),
+  m_pipeline_grid(other.m_pipeline_grid),
+  m_pipeline_time(other.m_pipeline_time),
+  m_pipeline_wait_time(other.m_pipeline_wait_time) {
 
   // Deep copies
   m_default_optimizer = (other.m_default_optimizer ?
@@ -144,6 +207,42 @@ model& model::operator=(const model& other) {
   m_max_mini_batch_size = other.m_max_mini_batch_size;
   m_effective_mini_batch_size = other.m_effective_mini_batch_size;
   m_background_io_allowed = other.m_background_io_allowed;
+  m_recompute_activations = other.m_recompute_activations;
+  m_activation_checkpoint_interval = other.m_activation_checkpoint_interval;
+  m_recompute_segments = other.m_recompute_segments;
+  m_free_activations = other.m_free_activations;
+  m_rerun_forward_prop = other.m_rerun_forward_prop;
+  m_naive_activation_memory = other.m_naive_activation_memory;
+  m_in_place_activation_memory = other.m_in_place_activation_memory;
+  m_planned_activation_memory = other.m_planned_activation_memory;
+  m_fuse_entrywise_layers = other.m_fuse_entrywise_layers;
+  m_num_fused_layers = other.m_num_fused_layers;
+  m_num_saved_memory_passes = other.m_num_saved_memory_passes;
+  m_num_output_views = other.m_num_output_views;
+  m_num_error_signal_views = other.m_num_error_signal_views;
+  m_num_in_place_outputs = other.m_num_in_place_outputs;
+  m_num_in_place_error_signals = other.m_num_in_place_error_signals;
+  m_reduced_precision_storage = other.m_reduced_precision_storage;
+  m_num_stored_inputs = other.m_num_stored_inputs;
+  m_num_stored_error_signals = other.m_num_stored_error_signals;
+  m_reduced_precision_saved_memory = other.m_reduced_precision_saved_memory;
+  m_frozen_model = other.m_frozen_model;
+  m_folded_for_inference = other.m_folded_for_inference;
+  m_frozen_saved_memory = other.m_frozen_saved_memory;
+  m_constant_layers = other.m_constant_layers;
+  m_constant_mini_batch_sizes = other.m_constant_mini_batch_sizes;
+  m_step_timing = other.m_step_timing;
+  m_deferred_evaluation_window = other.m_deferred_evaluation_window;
+  m_deferred_evaluation_mode = other.m_deferred_evaluation_mode;
+  m_num_pipeline_stages = other.m_num_pipeline_stages;
+  m_num_micro_batches = other.m_num_micro_batches;
+  m_pipeline_stage_boundaries = other.m_pipeline_stage_boundaries;
+  m_pipeline_stages = other.m_pipeline_stages;
+  m_pipeline_stage = other.m_pipeline_stage;
+  m_pipeline_grid = other.m_pipeline_grid;
+  m_pipeline_time = other.m_pipeline_time;
+  m_pipeline_wait_time = other.m_pipeline_wait_time;
+  m_pipeline_transfers.clear();
 
   // Deep copies
   m_objective_function = other.m_objective_function;
@@ -206,6 +305,72 @@ description model::get_description() const {
   // Construct description object
   description desc(get_name());
   desc.add("Type", get_type());
+  if (m_recompute_activations) {
+    desc.add("Activation recomputation segments",
+             m_recompute_segments.size());
+  }
+  if (m_fuse_entrywise_layers) {
+    std::stringstream ss;
+    ss << m_num_fused_layers << " layers "
+       << "(" << m_num_saved_memory_passes << " fewer memory passes "
+       << "per training step)";
+    desc.add("Fused entry-wise layers", ss.str());
+  }
+  if (m_num_output_views > 0 || m_num_error_signal_views > 0) {
+    std::stringstream ss;
+    ss << m_num_output_views << " outputs, "
+       << m_num_error_signal_views << " error signals";
+    desc.add("Zero-copy tensor views", ss.str());
+  }
+  if (m_num_in_place_outputs > 0 || m_num_in_place_error_signals > 0) {
+    std::stringstream ss;
+    ss << m_num_in_place_outputs << " outputs, "
+       << m_num_in_place_error_signals << " error signals";
+    desc.add("In-place entry-wise layers", ss.str());
+  }
+  if (m_reduced_precision_storage != storage_format::full) {
+    std::stringstream ss;
+    ss << to_string(m_reduced_precision_storage) << ", "
+       << m_num_stored_inputs << " inputs, "
+       << m_num_stored_error_signals << " error signals "
+       << "(" << std::fixed << std::setprecision(1)
+       << m_reduced_precision_saved_memory / 1048576.0 << " MB "
+       << "per process saved)";
+    desc.add("Reduced-precision storage", ss.str());
+  }
+  if (m_num_pipeline_stages > 1) {
+    std::stringstream ss;
+    ss << m_num_pipeline_stages << " stages";
+    if (!m_pipeline_stages.empty()) {
+      ss << " of ";
+      for (El::Int stage = 0; stage < m_num_pipeline_stages; ++stage) {
+        ss << (stage > 0 ? ", " : "")
+           << std::count(m_pipeline_stages.begin(),
+                         m_pipeline_stages.end(),
+                         stage);
+      }
+      ss << " layers";
+    }
+    ss << ", " << m_num_micro_batches << " micro-batches";
+    desc.add("Pipeline parallelism", ss.str());
+  }
+  if (m_frozen_model) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1)
+       << m_frozen_saved_memory / 1048576.0 << " MB per process of "
+       << "backprop tensors and weight gradients not allocated";
+    desc.add("Frozen model", ss.str());
+  }
+  if (m_naive_activation_memory > 0) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1)
+       << m_naive_activation_memory / 1048576.0 << " MB allocated "
+       << "(" << m_in_place_activation_memory / 1048576.0 << " MB "
+       << "saved by in-place layers), "
+       << m_planned_activation_memory / 1048576.0 << " MB with "
+       << "full static buffer reuse (not applied)";
+    desc.add("Activation memory per process", ss.str());
+  }
 
   // Layer topology
   description layer_topology_desc("Layer topology:");
@@ -485,13 +650,66 @@ void model::copy_trained_weights_from(std::vector<weights*>& new_weights) {
 }
 
 optimizer* model::create_optimizer() const {
-  if (m_default_optimizer != nullptr) {
+  if (m_default_optimizer != nullptr && !m_frozen_model) {
     return m_default_optimizer->copy();
   } else {
     return nullptr;
   }
 }
 
+void model::set_activation_recomputation(bool enable,
+                                         El::Int checkpoint_interval) {
+  m_recompute_activations = enable;
+  m_activation_checkpoint_interval = checkpoint_interval;
+}
+
+void model::set_pipeline_parallelism(El::Int num_stages,
+                                     El::Int num_micro_batches,
+                                     std::vector<std::string> stage_boundaries) {
+  if (num_stages < 1 || num_micro_batches < 1) {
+    std::stringstream err;
+    err << "pipeline parallelism requires a positive number of "
+        << "stages and micro-batches "
+        << "(got " << num_stages << " stages and "
+        << num_micro_batches << " micro-batches)";
+    LBANN_ERROR(err.str());
+  }
+  if (!stage_boundaries.empty()
+      && (El::Int) stage_boundaries.size() != num_stages - 1) {
+    std::stringstream err;
+    err << "pipeline with " << num_stages << " stages "
+        << "expects " << num_stages - 1 << " stage boundaries, "
+        << "but got " << stage_boundaries.size();
+    LBANN_ERROR(err.str());
+  }
+  m_num_pipeline_stages = num_stages;
+  m_num_micro_batches = num_micro_batches;
+  m_pipeline_stage_boundaries = std::move(stage_boundaries);
+}
+
+El::Int model::get_pipeline_stage(const Layer& l) const {
+  const El::Int num_layers = std::min(m_layers.size(),
+                                      m_pipeline_stages.size());
+  for (El::Int i = 0; i < num_layers; ++i) {
+    if (m_layers[i].get() == &l) { return m_pipeline_stages[i]; }
+  }
+  return -1;
+}
+
+const El::Grid& model::get_layer_grid(const Layer& l) const {
+  if (m_pipeline_grid != nullptr
+      && get_pipeline_stage(l) == m_pipeline_stage) {
+    return *m_pipeline_grid;
+  }
+  return m_comm->get_trainer_grid();
+}
+
+EvalType model::get_pipeline_bubble_fraction() const {
+  return (m_pipeline_time > EvalType(0) ?
+          m_pipeline_wait_time / m_pipeline_time :
+          EvalType(0));
+}
+
 bool model::is_execution_mode_valid(execution_mode mode) const {
   for (El::Int i = 0; i < get_num_layers(); ++i) {
     const auto* input = dynamic_cast<const generic_input_layer*>(&get_layer(i));
@@ -600,11 +818,47 @@ void model::setup(std::shared_ptr<thread_pool> io_thread_pool) {
   // Setup layers
   setup_layer_topology();
   setup_layer_execution_order();
+  if (m_fuse_entrywise_layers) {
+    fuse_entrywise_layers();
+  }
+  if (m_num_pipeline_stages > 1) {
+    setup_pipeline_stages();
+  }
   setup_layers();
+  setup_activation_recomputation();
+  setup_tensor_views();
+  setup_in_place_tensors();
+  setup_reduced_precision_storage();
+  plan_activation_memory();
 
   // Setup weights
+  if (m_frozen_model) {
+    for (auto& w : m_weights) { w->set_optimizer(nullptr); }
+  }
   setup_weights();
 
+  // Estimate memory saved by frozen model
+  // Note: A training build allocates an error signal for each layer
+  // input and a gradient for each unfrozen weights.
+  if (m_frozen_model) {
+    m_frozen_saved_memory = 0;
+    for (El::Int i = 0; i < get_num_layers(); ++i) {
+      const auto& l = get_layer(i);
+      for (int j = 0; j < l.get_num_parents(); ++j) {
+        const auto& input = l.get_prev_activations(j);
+        m_frozen_saved_memory += (input.LocalHeight() * input.LocalWidth()
+                                  * sizeof(DataType));
+      }
+    }
+    for (const auto& w : m_weights) {
+      if (!w->is_frozen()) {
+        const auto& values = w->get_values();
+        m_frozen_saved_memory += (values.LocalHeight() * values.LocalWidth()
+                                  * sizeof(DataType));
+      }
+    }
+  }
+
   // Setup objective function
   m_objective_function->setup(*this);
 
@@ -613,6 +867,14 @@ void model::setup(std::shared_ptr<thread_pool> io_thread_pool) {
     m->setup(*this);
   }
 
+  // Deferred evaluation
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    auto* eval = dynamic_cast<abstract_evaluation_layer*>(&get_layer(i));
+    if (eval != nullptr) {
+      eval->set_deferred_evaluation(m_deferred_evaluation_window);
+    }
+  }
+
   // Set up callbacks
   for (const auto& cb : m_callbacks) {
     cb->setup(this);
@@ -695,6 +957,351 @@ void model::setup_layer_execution_order() {
 
 }
 
+void model::fuse_entrywise_layers() {
+  m_num_fused_layers = 0;
+  m_num_saved_memory_passes = 0;
+
+  // Layers that are referenced outside of the parent/child graph
+  // Note: Fusion removes layers and changes the output of a batch
+  // normalization layer with a fused ReLU, so objective function
+  // terms, metrics, hint layers and callbacks would silently refer
+  // to different tensors. These layers are not fused away.
+  std::unordered_set<const Layer*> referenced_layers;
+  std::unordered_set<std::string> referenced_names;
+  if (m_objective_function != nullptr) {
+    for (const auto* l : m_objective_function->get_layer_pointers()) {
+      referenced_layers.insert(l);
+    }
+  }
+  for (const auto& m : m_metrics) {
+    for (const auto* l : m->get_layer_pointers()) {
+      referenced_layers.insert(l);
+    }
+  }
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    referenced_layers.insert(get_layer(i).get_hint_layer());
+  }
+  for (const auto* cb : m_callbacks) {
+    for (const auto& name : cb->get_layer_names()) {
+      referenced_names.insert(name);
+    }
+  }
+  const auto& is_referenced = [&](const Layer& l) -> bool {
+    return (referenced_layers.count(&l) > 0
+            || referenced_names.count(l.get_name()) > 0);
+  };
+
+  // Fuse ReLU layers into preceding CPU batch normalization layers
+  // Note: The batch normalization layer applies the ReLU in the same
+  // sweeps as normalization. It keeps its name and the ReLU layer is
+  // removed from the model.
+  using cpu_batch_normalization_layer
+    = batch_normalization_layer<data_layout::DATA_PARALLEL, El::Device::CPU>;
+  using cpu_relu_layer = relu_layer<data_layout::DATA_PARALLEL, El::Device::CPU>;
+  std::unordered_map<Layer*,Layer*> relu_map;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    auto* bn = dynamic_cast<cpu_batch_normalization_layer*>(&get_layer(i));
+    if (bn == nullptr
+        || bn->has_fused_relu()
+        || bn->get_num_children() != 1) {
+      continue;
+    }
+    const auto* relu
+      = dynamic_cast<const cpu_relu_layer*>(bn->get_child_layers().front());
+    if (relu == nullptr
+        || relu->get_num_parents() != 1
+        || relu->get_num_children() != 1
+        || relu->is_activation_checkpoint()
+        || is_referenced(*bn)
+        || is_referenced(*relu)) {
+      continue;
+    }
+    bn->fuse_relu();
+    bn->clear_child_layers();
+    bn->add_child_layer(relu->get_child_layers().front());
+    relu_map[const_cast<cpu_relu_layer*>(relu)] = bn;
+    ++m_num_fused_layers;
+    m_num_saved_memory_passes += 5;
+  }
+  if (!relu_map.empty()) {
+    remap_pointers(relu_map, std::unordered_map<weights*,weights*>());
+    for (auto& l : m_layers) {
+      if (relu_map.count(l.get()) > 0) { l.reset(); }
+    }
+    m_layers.erase(std::remove(m_layers.begin(), m_layers.end(), nullptr),
+                   m_layers.end());
+  }
+  const auto& num_layers = get_num_layers();
+
+  // Layer positions in execution order
+  std::unordered_map<const Layer*,El::Int> positions;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    positions[&get_layer(i)] = i;
+  }
+
+  // Find chains of entry-wise layers
+  // Note: Layers are topologically sorted, so chains are found
+  // starting from their first layer. The fused layer produces the
+  // last layer's output, so only the last layer in a chain may be
+  // referenced.
+  const auto& is_fusable = [](const Layer& l) -> bool {
+    return (dynamic_cast<const entrywise_fusion_interface*>(&l) != nullptr
+            && l.get_device_allocation() == El::Device::CPU
+            && l.get_num_parents() == 1
+            && l.get_num_children() == 1
+            && !l.is_activation_checkpoint());
+  };
+  std::vector<std::vector<El::Int>> chains;
+  std::vector<bool> in_chain(num_layers, false);
+  for (El::Int i = 0; i < num_layers; ++i) {
+    if (in_chain[i] || !is_fusable(get_layer(i))) { continue; }
+    std::vector<El::Int> chain = {i};
+    while (true) {
+      const auto& l = get_layer(chain.back());
+      const auto& child = *l.get_child_layers().front();
+      if (is_referenced(l)
+          || !is_fusable(child)
+          || child.get_data_layout() != l.get_data_layout()) {
+        break;
+      }
+      chain.push_back(positions.at(&child));
+    }
+    if (chain.size() > 1) {
+      for (const auto& j : chain) { in_chain[j] = true; }
+      chains.push_back(std::move(chain));
+    }
+  }
+
+  // Replace each chain with a fused layer
+  // Note: The fused layer takes the position of the first layer in
+  // the chain and the name of the last layer.
+  std::unordered_map<Layer*,Layer*> layer_map;
+  for (const auto& chain : chains) {
+    const auto& first = get_layer(chain.front());
+    const auto& last = get_layer(chain.back());
+    const auto* parent = first.get_parent_layers().front();
+    const auto* child = last.get_child_layers().front();
+    const auto name = last.get_name();
+    const auto layout = first.get_data_layout();
+    std::vector<Layer*> chain_pointers;
+    std::vector<std::unique_ptr<Layer>> chain_layers;
+    for (const auto& j : chain) {
+      chain_pointers.push_back(m_layers[j].get());
+      chain_layers.push_back(std::move(m_layers[j]));
+    }
+    std::unique_ptr<Layer> fused;
+    switch (layout) {
+    case data_layout::DATA_PARALLEL:
+      fused = make_unique<fused_entrywise_layer<data_layout::DATA_PARALLEL, El::Device::CPU>>(
+                m_comm, std::move(chain_layers));
+      break;
+    case data_layout::MODEL_PARALLEL:
+      fused = make_unique<fused_entrywise_layer<data_layout::MODEL_PARALLEL, El::Device::CPU>>(
+                m_comm, std::move(chain_layers));
+      break;
+    default:
+      LBANN_ERROR("invalid data layout for fused entry-wise layer");
+    }
+    fused->set_name(name);
+    fused->set_model(this);
+    fused->add_parent_layer(parent);
+    fused->add_child_layer(child);
+    for (auto* ptr : chain_pointers) { layer_map[ptr] = fused.get(); }
+    m_layers[chain.front()] = std::move(fused);
+
+    // Each fused layer avoids reading and writing an intermediate
+    // tensor in forward prop, and reading an intermediate input and
+    // error signal and writing an error signal in backprop
+    m_num_fused_layers += chain.size();
+    m_num_saved_memory_passes += 5 * (chain.size() - 1);
+
+  }
+
+  // Remove fused layers from layer list and fix pointers
+  m_layers.erase(std::remove(m_layers.begin(), m_layers.end(), nullptr),
+                 m_layers.end());
+  remap_pointers(layer_map, std::unordered_map<weights*,weights*>());
+
+}
+
+void model::setup_pipeline_stages() {
+  const auto& num_layers = get_num_layers();
+  const auto& num_stages = m_num_pipeline_stages;
+  const El::Int num_procs = m_comm->get_procs_per_trainer();
+  std::stringstream err;
+
+  // Check that model can be pipelined
+  if (num_procs % num_stages != 0) {
+    err << "model \"" << get_name() << "\" has " << num_stages << " "
+        << "pipeline stages, which do not evenly divide the "
+        << num_procs << " processes per trainer";
+    LBANN_ERROR(err.str());
+  }
+  if (m_frozen_model) {
+    err << "frozen model \"" << get_name() << "\" "
+        << "does not support pipeline parallelism";
+    LBANN_ERROR(err.str());
+  }
+  if (m_recompute_activations
+      || m_reduced_precision_storage != storage_format::full
+      || m_deferred_evaluation_window > 1) {
+    err << "model \"" << get_name() << "\" uses pipeline parallelism, "
+        << "which does not support activation recomputation, "
+        << "reduced-precision storage, or deferred evaluation";
+    LBANN_ERROR(err.str());
+  }
+
+  // Layers other than input layers are split into stages
+  std::vector<El::Int> stage_layers;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    if (dynamic_cast<generic_input_layer*>(&get_layer(i)) == nullptr) {
+      stage_layers.push_back(i);
+    }
+  }
+  std::vector<El::Int> stage_starts;
+  if (m_pipeline_stage_boundaries.empty()) {
+    const std::vector<double> costs(stage_layers.size(), 1);
+    stage_starts = pipeline::partition(costs, num_stages);
+  } else {
+    stage_starts.push_back(0);
+    for (const auto& name : m_pipeline_stage_boundaries) {
+      El::Int start = stage_layers.size();
+      for (size_t j = 0; j < stage_layers.size(); ++j) {
+        if (get_layer(stage_layers[j]).get_name() == name) { start = j; }
+      }
+      if (start >= (El::Int) stage_layers.size()
+          || start <= stage_starts.back()) {
+        err << "pipeline stage boundary \"" << name << "\" "
+            << "in model \"" << get_name() << "\" is not a layer "
+            << "that runs after the first layer of the previous stage";
+        LBANN_ERROR(err.str());
+      }
+      stage_starts.push_back(start);
+    }
+  }
+  if ((El::Int) stage_starts.size() != num_stages) {
+    err << "model \"" << get_name() << "\" has fewer layers "
+        << "than pipeline stages (" << num_stages << ")";
+    LBANN_ERROR(err.str());
+  }
+  stage_starts.push_back(stage_layers.size());
+  m_pipeline_stages.assign(num_layers, -1);
+  for (El::Int stage = 0; stage < num_stages; ++stage) {
+    for (El::Int j = stage_starts[stage]; j < stage_starts[stage+1]; ++j) {
+      m_pipeline_stages[stage_layers[j]] = stage;
+    }
+  }
+
+  // Check that layers can run in their stage
+  // Note: Stages other than the last recompute forward prop before
+  // backprop. Evaluation layers are recomputed, but their values are
+  // only taken from the first forward prop.
+  for (const auto& i : stage_layers) {
+    const auto& l = get_layer(i);
+    const auto& stage = m_pipeline_stages[i];
+    if (l.get_data_layout() != data_layout::DATA_PARALLEL
+        || l.get_device_allocation() != El::Device::CPU) {
+      err << l.get_type() << " layer \"" << l.get_name() << "\" "
+          << "is not a data-parallel CPU layer, "
+          << "which pipeline stages require";
+      LBANN_ERROR(err.str());
+    }
+    if (l.get_type() == "embedding") {
+      err << "embedding layer \"" << l.get_name() << "\" "
+          << "has sparse gradients, "
+          << "which pipeline stages do not support";
+      LBANN_ERROR(err.str());
+    }
+    if (stage < num_stages - 1
+        && !l.supports_recomputation()
+        && dynamic_cast<const abstract_evaluation_layer*>(&l) == nullptr) {
+      err << l.get_type() << " layer \"" << l.get_name() << "\" "
+          << "cannot be recomputed, so it must be in the last "
+          << "pipeline stage (it is in stage " << stage << ")";
+      LBANN_ERROR(err.str());
+    }
+  }
+
+  // Process grid of this process's stage
+  // Note: The grid duplicates the communicator.
+  const El::Int stage_size = num_procs / num_stages;
+  m_pipeline_stage = m_comm->get_rank_in_trainer() / stage_size;
+  El::mpi::Comm stage_comm;
+  El::mpi::Split(m_comm->get_trainer_comm(),
+                 m_pipeline_stage,
+                 m_comm->get_rank_in_trainer(),
+                 stage_comm);
+  m_pipeline_grid = std::make_shared<Grid>(stage_comm.GetMPIComm());
+  El::mpi::Free(stage_comm);
+  m_pipeline_transfers.clear();
+
+}
+
+void model::setup_pipeline_transfers() {
+  const auto& num_layers = get_num_layers();
+  const auto& num_micro_batches = m_num_micro_batches;
+  std::unordered_map<const Layer*,El::Int> positions;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    positions[&get_layer(i)] = i;
+  }
+
+  // Tensors exchanged along layer graph edges between stages
+  // Note: Transfers are ordered by parent position and output index,
+  // which is the order in which forward prop sends them. Processes
+  // either send or receive along an edge in each direction, so send
+  // buffers and requests are shared.
+  m_pipeline_transfers.clear();
+  for (El::Int i = 0; i < num_layers; ++i) {
+    const auto& parent = get_layer(i);
+    const auto& children = parent.get_child_layers();
+    for (int j = 0; j < parent.get_num_children(); ++j) {
+      const auto& child_pos = positions.at(children[j]);
+      const auto& child = get_layer(child_pos);
+      const auto& parent_stage = m_pipeline_stages[i];
+      const auto& child_stage = m_pipeline_stages[child_pos];
+      if (parent_stage == child_stage) { continue; }
+      const auto& parents_of_child = child.get_parent_layers();
+      m_pipeline_transfers.emplace_back();
+      auto& t = m_pipeline_transfers.back();
+      t.parent_pos = i;
+      t.child_pos = child_pos;
+      t.output_index = j;
+      t.input_index = (std::find(parents_of_child.begin(),
+                                 parents_of_child.end(),
+                                 &parent)
+                       - parents_of_child.begin());
+
+      // Input layers run on every process, so their outputs are
+      // replicated instead of sent
+      if (parent_stage < 0) {
+        t.replicated_output.reset(
+          new StarMat<El::Device::CPU>(m_comm->get_trainer_grid()));
+      }
+
+      // Received tensors are kept for each micro-batch since stages
+      // recompute forward prop before backprop
+      if (child_stage == m_pipeline_stage) {
+        const auto& input = child.get_prev_activations(t.input_index);
+        for (El::Int k = 0; k < num_micro_batches; ++k) {
+          t.inputs.emplace_back(AbsDistMat::Instantiate(input.DistData()));
+          t.inputs.back()->AlignWith(input);
+        }
+      }
+      if (parent_stage == m_pipeline_stage) {
+        const auto& output = parent.get_activations(j);
+        for (El::Int k = 0; k < num_micro_batches; ++k) {
+          t.gradients.emplace_back(AbsDistMat::Instantiate(output.DistData()));
+          t.gradients.back()->AlignWith(output);
+        }
+      }
+      t.send_buffers.resize(num_micro_batches);
+      t.recv_requests.resize(num_micro_batches);
+      t.send_requests.resize(num_micro_batches);
+    }
+  }
+
+}
+
 void model::setup_layers() {
   for (El::Int i = 0; i < get_num_layers(); ++i) {
     auto& l = get_layer(i);
@@ -704,6 +1311,474 @@ void model::setup_layers() {
   }
 }
 
+void model::setup_activation_recomputation() {
+  const auto& num_layers = get_num_layers();
+  m_recompute_segments.clear();
+  m_free_activations.assign(num_layers, false);
+  m_rerun_forward_prop.assign(num_layers, false);
+  if (!m_recompute_activations) { return; }
+
+  // Layer positions in execution order
+  std::unordered_map<const Layer*,El::Int> positions;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    positions[&get_layer(i)] = i;
+  }
+
+  // Choose checkpoints at cut points if none are specified
+  // Note: A layer is a cut point if no earlier layer has a child
+  // after it, i.e. its outputs are the only tensors that cross it.
+  bool has_checkpoints = false;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    has_checkpoints = has_checkpoints || get_layer(i).is_activation_checkpoint();
+  }
+  if (!has_checkpoints) {
+    auto interval = m_activation_checkpoint_interval;
+    if (interval <= 0) {
+      interval = std::max(El::Int(1),
+                          El::Int(std::ceil(std::sqrt(num_layers))));
+    }
+    El::Int max_child_pos = 0;
+    El::Int last_checkpoint = 0;
+    for (El::Int i = 0; i < num_layers; ++i) {
+      auto& l = get_layer(i);
+      if (max_child_pos <= i && i - last_checkpoint >= interval) {
+        l.set_activation_checkpoint(true);
+        last_checkpoint = i;
+      }
+      for (const auto* child : l.get_child_layers()) {
+        max_child_pos = std::max(max_child_pos, positions.at(child));
+      }
+    }
+  }
+
+  // Segments are maximal runs of recomputable layers
+  for (El::Int i = 0; i < num_layers; ++i) {
+    const auto& l = get_layer(i);
+    if (l.is_activation_checkpoint() || !l.supports_recomputation()) {
+      continue;
+    }
+    if (m_recompute_segments.empty()
+        || m_recompute_segments.back().second != i - 1) {
+      m_recompute_segments.emplace_back(i, i);
+    } else {
+      m_recompute_segments.back().second = i;
+    }
+  }
+
+  // Free layer activations if they are only needed within segment
+  for (const auto& segment : m_recompute_segments) {
+    for (El::Int i = segment.first; i <= segment.second; ++i) {
+      const auto& children = get_layer(i).get_child_layers();
+      bool free = !children.empty();
+      for (const auto* child : children) {
+        const auto& pos = positions.at(child);
+        free = free && segment.first <= pos && pos <= segment.second;
+      }
+      m_free_activations[i] = free;
+    }
+  }
+
+  // Rerun forward prop for freed layers and their children
+  for (const auto& segment : m_recompute_segments) {
+    for (El::Int i = segment.first; i <= segment.second; ++i) {
+      bool rerun = m_free_activations[i];
+      for (const auto* parent : get_layer(i).get_parent_layers()) {
+        rerun = rerun || m_free_activations[positions.at(parent)];
+      }
+      m_rerun_forward_prop[i] = rerun;
+    }
+  }
+
+  // Remove segments without freed layers
+  auto&& free_activations = m_free_activations;
+  m_recompute_segments.erase(
+    std::remove_if(m_recompute_segments.begin(),
+                   m_recompute_segments.end(),
+                   [&free_activations](const std::pair<El::Int,El::Int>& segment) {
+                     for (El::Int i = segment.first; i <= segment.second; ++i) {
+                       if (free_activations[i]) { return false; }
+                     }
+                     return true;
+                   }),
+    m_recompute_segments.end());
+
+}
+
+void model::setup_tensor_views() {
+  const auto& num_layers = get_num_layers();
+  m_num_output_views = 0;
+  m_num_error_signal_views = 0;
+
+  // Layer positions in execution order
+  std::unordered_map<const Layer*,El::Int> positions;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    positions[&get_layer(i)] = i;
+  }
+  const auto& compatible = [](const Layer& l1, const Layer& l2) -> bool {
+    return (l1.get_data_layout() == l2.get_data_layout()
+            && l1.get_device_allocation() == l2.get_device_allocation());
+  };
+  const auto& same_stage = [this](El::Int pos1, El::Int pos2) -> bool {
+    return (m_pipeline_stages.empty()
+            || m_pipeline_stages[pos1] == m_pipeline_stages[pos2]);
+  };
+  for (El::Int i = 0; i < num_layers; ++i) {
+    auto& l = get_layer(i);
+    for (int j = 0; j < l.get_num_children(); ++j) {
+      l.set_output_view(j, false);
+    }
+    for (int j = 0; j < l.get_num_parents(); ++j) {
+      l.set_error_signal_view(j, false);
+    }
+  }
+
+  for (El::Int i = 0; i < num_layers; ++i) {
+    auto& l = get_layer(i);
+
+    // Parent outputs in layer's output tensor
+    // Note: The parent's output must only be consumed by this layer
+    // and must stay alive as long as this layer's output.
+    const auto& parents = l.get_parent_layers();
+    for (int j = 0; j < l.get_num_parents(); ++j) {
+      const auto& parent_pos = positions.at(parents[j]);
+      auto& parent = get_layer(parent_pos);
+      if (l.provides_parent_output_view(j)
+          && parent.supports_output_views()
+          && parent.get_num_children() == 1
+          && compatible(l, parent)
+          && same_stage(i, parent_pos)
+          && !m_free_activations[i]
+          && !m_free_activations[parent_pos]) {
+        parent.set_output_view(0, true);
+        ++m_num_output_views;
+      }
+    }
+
+    // Child error signals in layer's error signal
+    if (m_frozen_model) { continue; }
+    const auto& children = l.get_child_layers();
+    for (int j = 0; j < l.get_num_children(); ++j) {
+      const auto& child_pos = positions.at(children[j]);
+      auto& child = get_layer(child_pos);
+      if (l.provides_child_error_signal_view(j)
+          && child.supports_error_signal_views()
+          && child.get_num_parents() == 1
+          && compatible(l, child)
+          && same_stage(i, child_pos)) {
+        child.set_error_signal_view(0, true);
+        ++m_num_error_signal_views;
+      }
+    }
+
+  }
+
+}
+
+void model::setup_in_place_tensors() {
+  const auto& num_layers = get_num_layers();
+  m_num_in_place_outputs = 0;
+  m_num_in_place_error_signals = 0;
+
+  // Layer positions in execution order
+  std::unordered_map<const Layer*,El::Int> positions;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    positions[&get_layer(i)] = i;
+  }
+  const auto& compatible = [](const Layer& l1, const Layer& l2) -> bool {
+    return (l1.get_data_layout() == l2.get_data_layout()
+            && l1.get_device_allocation() == l2.get_device_allocation());
+  };
+  const auto& same_stage = [this](El::Int pos1, El::Int pos2) -> bool {
+    return (m_pipeline_stages.empty()
+            || m_pipeline_stages[pos1] == m_pipeline_stages[pos2]);
+  };
+
+  for (El::Int i = 0; i < num_layers; ++i) {
+    auto& l = get_layer(i);
+    l.set_in_place_output(false);
+    l.set_in_place_error_signal(false);
+    if (l.get_num_parents() != 1 || l.get_num_children() != 1) {
+      continue;
+    }
+    const auto& parent_pos = positions.at(l.get_parent_layers().front());
+    const auto& child_pos = positions.at(l.get_child_layers().front());
+    auto& parent = get_layer(parent_pos);
+    auto& child = get_layer(child_pos);
+
+    // Outputs overwrite the parent's outputs
+    // Note: Only done in frozen models since backprop needs the
+    // inputs. The parent's output must only be consumed by this
+    // layer. Layers with constant parents are excluded once they
+    // are known (see fold_layers_for_inference).
+    if (m_frozen_model
+        && l.supports_in_place_forward_prop()
+        && !l.is_output_view(0)
+        && parent.get_num_children() == 1
+        && !parent.is_output_view(0)
+        && compatible(l, parent)
+        && same_stage(i, parent_pos)
+        && l.get_input_size() == l.get_output_size()
+        && !m_free_activations[i]
+        && !m_free_activations[parent_pos]) {
+      l.set_in_place_output(true);
+      ++m_num_in_place_outputs;
+    }
+
+    // Error signals overwrite the child's error signals
+    if (!m_frozen_model
+        && l.supports_in_place_backprop()
+        && !l.is_error_signal_view(0)
+        && compatible(l, child)
+        && same_stage(i, child_pos)
+        && l.get_input_size() == l.get_output_size()) {
+      l.set_in_place_error_signal(true);
+      ++m_num_in_place_error_signals;
+    }
+
+  }
+
+}
+
+void model::setup_reduced_precision_storage() {
+  const auto& num_layers = get_num_layers();
+  m_num_stored_inputs = 0;
+  m_num_stored_error_signals = 0;
+  m_reduced_precision_saved_memory = 0;
+  const auto& format = m_reduced_precision_storage;
+  const bool enable = (format != storage_format::full && !m_frozen_model);
+
+  // Layer positions in execution order
+  std::unordered_map<const Layer*,El::Int> positions;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    positions[&get_layer(i)] = i;
+  }
+  const auto& compatible = [](const Layer& l1, const Layer& l2) -> bool {
+    return (l1.get_data_layout() == l2.get_data_layout()
+            && l1.get_device_allocation() == l2.get_device_allocation());
+  };
+  const auto& saved_bytes = [](const AbsDistMat& mat) -> El::Int {
+    return (mat.LocalHeight() * mat.LocalWidth()
+            * (sizeof(DataType) - sizeof(uint16_t)));
+  };
+
+  for (El::Int i = 0; i < num_layers; ++i) {
+    auto& l = get_layer(i);
+    l.set_input_storage_format(storage_format::full);
+    l.set_error_signal_storage_format(storage_format::full);
+    if (!enable
+        || !l.supports_reduced_precision_storage()
+        || l.get_device_allocation() != El::Device::CPU
+        || l.get_num_parents() != 1) {
+      continue;
+    }
+    const auto& parent_pos = positions.at(l.get_parent_layers().front());
+    const auto& parent = get_layer(parent_pos);
+    if (!compatible(l, parent)) { continue; }
+
+    // Inputs replace the parent's output until backprop
+    // Note: Recomputed layers regenerate their outputs in backprop
+    // instead.
+    if (parent.get_num_children() == 1
+        && !parent.is_output_view(0)
+        && !l.is_in_place_output()
+        && !m_free_activations[parent_pos]
+        && !m_rerun_forward_prop[parent_pos]
+        && !m_rerun_forward_prop[i]) {
+      l.set_input_storage_format(format);
+      ++m_num_stored_inputs;
+      m_reduced_precision_saved_memory += saved_bytes(l.get_prev_activations());
+    }
+
+    // Error signals are kept until the parent's backprop
+    // Note: Backprop runs in reverse execution order, so nothing
+    // runs in between if the parent immediately precedes the layer.
+    // Input layers do not use error signals.
+    bool child_error_signal_views = false;
+    for (const auto* child : l.get_child_layers()) {
+      child_error_signal_views = (child_error_signal_views
+                                  || child->is_error_signal_view(0));
+    }
+    if (parent_pos < i - 1
+        && parent.get_num_parents() > 0
+        && !l.is_error_signal_view(0)
+        && !l.is_in_place_error_signal()
+        && !child_error_signal_views) {
+      l.set_error_signal_storage_format(format);
+      ++m_num_stored_error_signals;
+      m_reduced_precision_saved_memory += saved_bytes(l.get_error_signals());
+    }
+
+  }
+
+}
+
+void model::plan_activation_memory() {
+  const auto& num_layers = get_num_layers();
+  std::map<El::Device, memory_planner> planners;
+
+  // Layer positions in execution order
+  // Note: Backprop of the layer at position i happens at time step
+  // 2*num_layers-1-i.
+  std::unordered_map<const Layer*,El::Int> positions;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    positions[&get_layer(i)] = i;
+  }
+  const auto& bp_step = [num_layers](El::Int pos) -> El::Int {
+    return 2 * num_layers - 1 - pos;
+  };
+  const auto& buffer_size = [](const AbsDistMat& mat) -> El::Int {
+    return mat.LocalHeight() * mat.LocalWidth() * sizeof(DataType);
+  };
+
+  // Segment containing a layer's position
+  std::vector<El::Int> segment_end(num_layers, -1);
+  for (const auto& segment : m_recompute_segments) {
+    for (El::Int i = segment.first; i <= segment.second; ++i) {
+      segment_end[i] = segment.second;
+    }
+  }
+
+  // Forward prop tensors
+  // Note: Outputs are needed until the layer's backprop step. Since
+  // lifetimes are nested, outputs that are views into a parent's
+  // outputs can be ignored. Freed outputs are planned twice, once for
+  // forward prop and once after recomputation. In-place outputs
+  // share the parent's output buffer.
+  std::map<std::pair<const Layer*,int>,El::Int> output_ids;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    const auto& l = get_layer(i);
+    for (int j = 0; j < l.get_num_parents(); ++j) {
+      const auto& input = l.get_prev_activations(j);
+      if (!input.Viewing() && buffer_size(input) > 0) {
+        planners[input.GetLocalDevice()].add_buffer(buffer_size(input),
+                                                    i, bp_step(i));
+      }
+    }
+    for (int j = 0; j < l.get_num_children(); ++j) {
+      const auto& output = l.get_activations(j);
+      if (output.Viewing()
+          || l.is_output_view(j)
+          || buffer_size(output) <= 0) {
+        continue;
+      }
+
+      // Parents that write into the output extend its lifetime
+      El::Int first_use = i;
+      for (const auto* parent : l.get_parent_layers()) {
+        if (parent->is_output_view(0)) {
+          first_use = std::min(first_use, positions.at(parent));
+        }
+      }
+
+      auto& planner = planners[output.GetLocalDevice()];
+      const auto& parent_output_id
+        = (l.is_in_place_output() ?
+           output_ids.find({l.get_parent_layers().front(), 0}) :
+           output_ids.end());
+      if (parent_output_id != output_ids.end()) {
+        output_ids[{&l, j}] = planner.add_alias(parent_output_id->second,
+                                                first_use, bp_step(i));
+      } else if (m_free_activations[i]) {
+        output_ids[{&l, j}]
+          = planner.add_buffer(buffer_size(output),
+                               first_use, segment_end[i]);
+        planner.add_buffer(buffer_size(output),
+                           bp_step(segment_end[i]), bp_step(i));
+      } else {
+        output_ids[{&l, j}] = planner.add_buffer(buffer_size(output),
+                                                 first_use, bp_step(i));
+      }
+    }
+  }
+
+  // Backprop tensors
+  // Note: Error signals are needed until the parent's backprop
+  // step. Views extend the lifetime of the viewed buffer. Backprop
+  // tensors are only bound to their neighbors' tensors during
+  // backprop, so buffers are matched using the layer graph.
+  std::map<std::pair<const Layer*,int>,El::Int> error_signal_ids;
+  std::map<std::pair<const Layer*,int>,El::Int> gradient_wrt_output_ids;
+  for (El::Int i = num_layers - 1; i >= 0 && !m_frozen_model; --i) {
+    const auto& l = get_layer(i);
+
+    // Gradients w.r.t. outputs are views into the child's error
+    // signal unless a copy is needed for a different distribution
+    const auto& children = l.get_child_layers();
+    for (int j = 0; j < l.get_num_children(); ++j) {
+      const auto& child = *children[j];
+      const auto& output = l.get_activations(j);
+      const auto& parents_of_child = child.get_parent_layers();
+      const int index_in_child = (std::find(parents_of_child.begin(),
+                                            parents_of_child.end(), &l)
+                                  - parents_of_child.begin());
+      const auto& child_error_signal
+        = child.get_error_signals(index_in_child);
+      const auto& child_id
+        = error_signal_ids.find({&child, index_in_child});
+      if (child_error_signal.DistData() == output.DistData()
+          && child_id != error_signal_ids.end()) {
+        gradient_wrt_output_ids[{&l, j}] = child_id->second;
+      } else if (buffer_size(output) > 0) {
+        auto& planner = planners[output.GetLocalDevice()];
+        gradient_wrt_output_ids[{&l, j}]
+          = planner.add_buffer(buffer_size(output),
+                               bp_step(positions.at(&child)),
+                               bp_step(i));
+      }
+    }
+
+    // Error signals
+    const auto& parents = l.get_parent_layers();
+    for (int j = 0; j < l.get_num_parents(); ++j) {
+      const auto& gradient_wrt_input = l.get_error_signals(j);
+      if (l.is_error_signal_view(j)
+          || buffer_size(gradient_wrt_input) <= 0) {
+        continue;
+      }
+      auto& planner = planners[gradient_wrt_input.GetLocalDevice()];
+      const auto& last_use = bp_step(positions.at(parents[j]));
+
+      // Children that write into the error signal extend its lifetime
+      El::Int first_use = bp_step(i);
+      for (const auto* child : children) {
+        if (child->is_error_signal_view(0)) {
+          first_use = std::min(first_use, bp_step(positions.at(child)));
+        }
+      }
+
+      // In-place error signals and views share the gradient w.r.t.
+      // output buffer
+      const auto& reused_id
+        = ((l.is_in_place_error_signal() || gradient_wrt_input.Viewing())
+           && l.get_num_children() == 1 ?
+           gradient_wrt_output_ids.find({&l, 0}) :
+           gradient_wrt_output_ids.end());
+      if (reused_id != gradient_wrt_output_ids.end()) {
+        error_signal_ids[{&l, j}] = planner.add_alias(reused_id->second,
+                                                      first_use, last_use);
+      } else if (!gradient_wrt_input.Viewing()) {
+        error_signal_ids[{&l, j}]
+          = planner.add_buffer(buffer_size(gradient_wrt_input),
+                               first_use, last_use);
+      }
+
+    }
+  }
+
+  // Compute memory plan for each device
+  m_naive_activation_memory = 0;
+  m_in_place_activation_memory = 0;
+  m_planned_activation_memory = 0;
+  for (auto& device_planner : planners) {
+    auto& planner = device_planner.second;
+    planner.plan();
+    m_naive_activation_memory += planner.get_naive_size();
+    m_in_place_activation_memory += planner.get_aliased_size();
+    m_planned_activation_memory += planner.get_planned_size();
+  }
+
+}
+
 void model::setup_weights() {
 
   // List of used and unused weights
@@ -746,6 +1821,36 @@ void model::setup_weights() {
               return x->get_name().compare(y->get_name()) < 0;
             });
 
+  // Weights are replicated over the trainer in pipelined models
+  // Note: Each stage adds gradient contributions from its own
+  // processes (see optimizer::add_to_gradient).
+  if (m_num_pipeline_stages > 1) {
+    std::unordered_map<const weights*,El::Int> weights_stages;
+    for (El::Int i = 0; i < get_num_layers(); ++i) {
+      const auto& l = get_layer(i);
+      for (const auto* w : l.get_weights()) {
+        const auto& stage = m_pipeline_stages[i];
+        if (weights_stages.emplace(w, stage).first->second != stage) {
+          std::stringstream err;
+          err << "weights \"" << w->get_name() << "\" are shared "
+              << "by layers in different pipeline stages";
+          LBANN_ERROR(err.str());
+        }
+      }
+    }
+    for (auto* w : m_weights) {
+      auto dist = w->get_matrix_distribution();
+      if (dist.colDist != El::STAR || dist.rowDist != El::STAR) {
+        std::stringstream err;
+        err << "weights \"" << w->get_name() << "\" are not "
+            << "replicated, which pipeline stages require";
+        LBANN_ERROR(err.str());
+      }
+      dist.grid = &m_comm->get_trainer_grid();
+      w->set_matrix_distribution(dist);
+    }
+  }
+
   // Setup weights
   for (auto* w : m_weights) { w->setup(); }
 
@@ -975,24 +2080,31 @@ void model::evaluate(execution_mode mode, int num_batches) {
   }
 
   // Evaluate on all mini-batches
+  flush_deferred_evaluation();
   reset_epoch_statistics(mode);
   reset_mode_and_model(mode);
+  m_step_timing.reset(mode);
   do_evaluate_begin_cbs(mode);
   if (num_batches > 0) {
     for (int i = 0; i < num_batches; i++) { evaluate_mini_batch(mode); }
   } else {
     while (!evaluate_mini_batch(mode)) {}
   }
+  flush_deferred_evaluation();
   do_evaluate_end_cbs(mode);
 }
 
 void model::train(int num_epochs, int num_batches) {
+  if (m_frozen_model) {
+    LBANN_ERROR("attempted to train frozen model \"" + get_name() + "\"");
+  }
   do_train_begin_cbs();
   for (int epoch = m_epoch; epoch < num_epochs; ++epoch) {
     if (get_terminate_training()) { break; }
 
     // Initialize epoch
     reset_mode_and_model(execution_mode::training);
+    m_step_timing.reset(execution_mode::training);
     do_epoch_begin_cbs();
 
     // Training iterations
@@ -1005,6 +2117,7 @@ void model::train(int num_epochs, int num_batches) {
     // Finalize epoch
     ++m_epoch;
     reconcile_weight_values();
+    flush_deferred_evaluation();
     do_epoch_end_cbs();
     reset_epoch_statistics(execution_mode::training);
 
@@ -1059,6 +2172,39 @@ void model::reset_mode_and_model(execution_mode mode) {
   }
 }
 
+void model::flush_deferred_evaluation() {
+  if (m_deferred_evaluation_window <= 1
+      || m_deferred_evaluation_mode == execution_mode::invalid) {
+    return;
+  }
+  m_objective_function->flush_deferred_evaluation(m_deferred_evaluation_mode);
+  for (const auto& m : m_metrics) {
+    m->flush_deferred(m_deferred_evaluation_mode);
+  }
+  m_deferred_evaluation_mode = execution_mode::invalid;
+}
+
+// Objective function and metric statistics for a mini-batch step
+void model::evaluate_statistics(execution_mode mode) {
+  const auto mini_batch_size = get_current_mini_batch_size();
+  if (m_deferred_evaluation_window > 1) {
+    // Values are reduced once per window
+    if (m_deferred_evaluation_mode != mode) {
+      flush_deferred_evaluation();
+      m_deferred_evaluation_mode = mode;
+    }
+    m_objective_function->finish_deferred_evaluation(mode, mini_batch_size);
+    for (const auto& m : m_metrics) {
+      m->evaluate_deferred(mode, mini_batch_size);
+    }
+  } else {
+    m_objective_function->finish_evaluation(mode, mini_batch_size);
+    for (const auto& m : m_metrics) {
+      m->evaluate(mode, mini_batch_size);
+    }
+  }
+}
+
 // At the end of the epoch, clean up the objective function and metrics
 void model::reset_epoch_statistics(execution_mode mode) {
   m_objective_function->reset_statistics(mode);
@@ -1068,14 +2214,12 @@ void model::reset_epoch_statistics(execution_mode mode) {
 }
 
 bool model::evaluate_mini_batch(execution_mode mode) {
+  m_step_timing.begin_step();
   reset_mode_and_model(mode);
   do_batch_begin_cbs(mode);
   forward_prop(mode);
   m_objective_function->start_evaluation(mode, get_current_mini_batch_size());
-  m_objective_function->finish_evaluation(mode, get_current_mini_batch_size());
-  for (const auto& m : m_metrics) {
-    m->evaluate(mode, get_current_mini_batch_size());
-  }
+  evaluate_statistics(mode);
   const bool finished = update_layers();
 
   // Increment mini-batch step
@@ -1084,11 +2228,31 @@ bool model::evaluate_mini_batch(execution_mode mode) {
   ++m_step[mode];
 
   do_batch_end_cbs(mode);
+  m_step_timing.end_step(mode);
   return finished;
 }
 
+void model::infer_mini_batch() {
+  reset_mode_and_model(execution_mode::testing);
+  if (m_frozen_model && !m_folded_for_inference) {
+    fold_layers_for_inference();
+  }
+  if (m_num_pipeline_stages > 1) {
+    pipeline_forward_backward_prop(execution_mode::testing, false);
+    return;
+  }
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    auto& l = get_layer(i);
+    if (dynamic_cast<abstract_evaluation_layer*>(&l) == nullptr
+        && !reuse_constant_outputs(i)) {
+      l.forward_prop();
+    }
+  }
+}
+
 bool model::train_mini_batch() {
   constexpr execution_mode mode = execution_mode::training;
+  m_step_timing.begin_step();
   reset_mode_and_model(mode);
   do_batch_begin_cbs(mode);
 
@@ -1100,23 +2264,30 @@ bool model::train_mini_batch() {
   {
     #pragma omp single
     {
+    step_timing::thread_binding timing_binding(m_step_timing);
 #endif
   // Forward prop step
   clear_gradients();
-  forward_prop(mode);
-  // Result is not needed until the end of the mini-batch.
-  m_objective_function->start_evaluation(mode, get_current_mini_batch_size());
+  if (m_num_pipeline_stages > 1) {
+    // Stages interleave forward and backward prop over micro-batches
+    m_objective_function->differentiate();
+    pipeline_forward_backward_prop(mode, true);
+    m_objective_function->start_evaluation(mode,
+                                           get_current_mini_batch_size());
+  } else {
+    forward_prop(mode);
+    // Result is not needed until the end of the mini-batch.
+    m_objective_function->start_evaluation(mode,
+                                           get_current_mini_batch_size());
 
-  // Backward prop step
-  m_objective_function->differentiate();
-  backward_prop();
+    // Backward prop step
+    m_objective_function->differentiate();
+    backward_prop();
+  }
   m_objective_function->compute_weight_regularization();
 
   // Finish evaluation.
-  m_objective_function->finish_evaluation(mode, get_current_mini_batch_size());
-  for (const auto& m : m_metrics) {
-    m->evaluate(mode, get_current_mini_batch_size());
-  }
+  evaluate_statistics(mode);
 
   // Update step
   update_weights();
@@ -1132,36 +2303,182 @@ bool model::train_mini_batch() {
   ++m_step[mode];
 
   do_batch_end_cbs(execution_mode::training);
+  m_step_timing.end_step(mode);
   return finished;
 }
 
 void model::clear_gradients() {
+  // Loss scale is removed as gradient contributions are accumulated
+  const auto& gradient_scale
+    = DataType(EvalType(1) / m_objective_function->get_loss_scale());
   for (const auto& w : m_weights) {
     optimizer* opt = w->get_optimizer();
-    if (opt != nullptr) { opt->clear_gradient(); }
+    if (opt != nullptr) {
+      opt->clear_gradient();
+      opt->set_gradient_scale(gradient_scale);
+    }
   }
 }
 
 void model::forward_prop(execution_mode mode) {
+  if (m_frozen_model && !m_folded_for_inference) {
+    fold_layers_for_inference();
+  }
+  if (m_num_pipeline_stages > 1) {
+    pipeline_forward_backward_prop(mode, false);
+    return;
+  }
   do_model_forward_prop_begin_cbs(mode);
+  const bool free_activations = (mode == execution_mode::training);
+  auto segment = m_recompute_segments.cbegin();
   for (El::Int i = 0; i < get_num_layers(); ++i) {
     auto& l = get_layer(i);
     do_layer_forward_prop_begin_cbs(mode, &l);
-    l.forward_prop();
+    if (!reuse_constant_outputs(i)) { l.forward_prop(); }
     do_layer_forward_prop_end_cbs(mode, &l);
+    l.release_stored_input();
+
+    // Free activations that are recomputed during backprop
+    if (free_activations
+        && segment != m_recompute_segments.cend()
+        && segment->second == i) {
+      for (El::Int j = segment->first; j <= i; ++j) {
+        if (m_free_activations[j]) { get_layer(j).free_activations(); }
+      }
+      ++segment;
+    }
+
   }
   do_model_forward_prop_end_cbs(mode);
 }
 
+void model::fold_layers_for_inference() {
+  m_folded_for_inference = true;
+  const auto& num_layers = get_num_layers();
+  std::unordered_map<const Layer*,El::Int> positions;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    positions[&get_layer(i)] = i;
+  }
+
+  // Count layers that use each weights object
+  std::unordered_map<const weights*,int> num_weights_users;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    for (const auto* w : get_layer(i).get_weights()) {
+      ++num_weights_users[w];
+    }
+  }
+
+  // Fold layers into parents' weights
+  // Note: Folding modifies the parent's weights, so it is skipped if
+  // they are shared with other layers.
+  El::Int num_folded_layers = 0;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    auto& l = get_layer(i);
+    if (l.get_num_parents() != 1) { continue; }
+    auto& parent = get_layer(positions.at(l.get_parent_layers().front()));
+    bool shared_weights = false;
+    for (const auto* w : parent.get_weights()) {
+      shared_weights = shared_weights || num_weights_users[w] > 1;
+    }
+    if (parent.get_num_children() == 1
+        && !shared_weights
+        && l.fold_into_parent(parent)) {
+      ++num_folded_layers;
+
+      // Folded layers may no longer write into children's memory
+      // and children may no longer overwrite their outputs
+      if (!l.supports_output_views()) {
+        for (int j = 0; j < l.get_num_children(); ++j) {
+          if (l.is_output_view(j)) {
+            l.set_output_view(j, false);
+            --m_num_output_views;
+          }
+          auto& child = get_layer(positions.at(l.get_child_layers()[j]));
+          if (child.is_in_place_output()) {
+            child.set_in_place_output(false);
+            --m_num_in_place_outputs;
+          }
+        }
+      }
+
+    }
+  }
+
+  // Find layers with constant outputs
+  // Note: Layers are in topological order, so parents are visited
+  // before their children. Layers with nondeterministic or stateful
+  // forward prop cannot be recomputed and are never constant.
+  El::Int num_constant_layers = 0;
+  m_constant_layers.assign(num_layers, false);
+  m_constant_mini_batch_sizes.assign(num_layers, -1);
+  for (El::Int i = 0; i < num_layers; ++i) {
+    const auto& l = get_layer(i);
+    bool is_constant = l.has_constant_outputs();
+    if (!is_constant
+        && l.get_num_parents() > 0
+        && l.supports_recomputation()) {
+      is_constant = true;
+      for (const auto* parent : l.get_parent_layers()) {
+        is_constant = is_constant && m_constant_layers[positions.at(parent)];
+      }
+    }
+    m_constant_layers[i] = is_constant;
+    if (is_constant) { ++num_constant_layers; }
+  }
+
+  // Constant outputs are reused, so children may not overwrite them
+  for (El::Int i = 0; i < num_layers; ++i) {
+    auto& l = get_layer(i);
+    if (l.is_in_place_output()
+        && m_constant_layers[positions.at(l.get_parent_layers().front())]) {
+      l.set_in_place_output(false);
+      --m_num_in_place_outputs;
+    }
+  }
+
+  if (m_comm->am_world_master()) {
+    std::cout << get_name() << ": "
+              << "folded " << num_folded_layers << " layers "
+              << "into parent layer weights, "
+              << "found " << num_constant_layers << " layers "
+              << "with constant outputs" << std::endl;
+  }
+
+}
+
+bool model::reuse_constant_outputs(El::Int pos) {
+  if (m_constant_layers.empty() || !m_constant_layers[pos]) {
+    return false;
+  }
+  const El::Int mini_batch_size = get_current_mini_batch_size();
+  if (m_constant_mini_batch_sizes[pos] == mini_batch_size) {
+    return true;
+  }
+  m_constant_mini_batch_sizes[pos] = mini_batch_size;
+  return false;
+}
+
 void model::backward_prop() {
   do_model_backward_prop_begin_cbs();
+  auto segment = m_recompute_segments.crbegin();
   for (El::Int i = get_num_layers()-1; i >= 0; --i) {
 
+    // Recompute activations when entering a segment
+    // Note: Callbacks are not invoked since this is not a new
+    // forward prop step.
+    if (segment != m_recompute_segments.crend() && segment->second == i) {
+      for (El::Int j = segment->first; j <= i; ++j) {
+        if (m_rerun_forward_prop[j]) { get_layer(j).forward_prop(); }
+      }
+      ++segment;
+    }
+
     // Perform backward prop step on current layer
     auto& l = get_layer(i);
     do_layer_backward_prop_begin_cbs(&l);
     l.back_prop();
     do_layer_backward_prop_end_cbs(&l);
+    l.release_stored_error_signal();
 
     // Terminate early if all gradients have been computed
     bool all_gradients_computed = true;
@@ -1175,11 +2492,300 @@ void model::backward_prop() {
     if (all_gradients_computed) { break; }
 
   }
+
+  // Reconstruct tensors that layers skipped by early termination
+  // would have restored
+  if (m_num_stored_inputs > 0 || m_num_stored_error_signals > 0) {
+    for (El::Int i = 0; i < get_num_layers(); ++i) {
+      get_layer(i).restore_stored_tensors();
+    }
+  }
   do_model_backward_prop_end_cbs();
 }
 
+void model::pipeline_forward_backward_prop(execution_mode mode,
+                                           bool backprop) {
+  const auto start = get_time();
+  EvalType wait_time = 0;
+  if (m_pipeline_transfers.empty()) { setup_pipeline_transfers(); }
+  const auto& num_layers = get_num_layers();
+  const auto& trainer = m_comm->get_trainer_rank();
+  const El::Int stage_size = (m_comm->get_procs_per_trainer()
+                              / m_num_pipeline_stages);
+  const El::Int rank_in_stage = m_comm->get_rank_in_trainer() % stage_size;
+  const auto& peer = [stage_size, rank_in_stage](El::Int stage) -> int {
+    return stage * stage_size + rank_in_stage;
+  };
+  const auto& is_local = [this](El::Int pos) -> bool {
+    return m_pipeline_stages[pos] == m_pipeline_stage;
+  };
+
+  // Input layers run on every process
+  do_model_forward_prop_begin_cbs(mode);
+  for (El::Int i = 0; i < num_layers; ++i) {
+    if (m_pipeline_stages[i] < 0) {
+      auto& l = get_layer(i);
+      do_layer_forward_prop_begin_cbs(mode, &l);
+      l.forward_prop();
+      do_layer_forward_prop_end_cbs(mode, &l);
+    }
+  }
+  for (auto& t : m_pipeline_transfers) {
+    if (t.replicated_output != nullptr) {
+      El::Copy(get_layer(t.parent_pos).get_activations(t.output_index),
+               *t.replicated_output);
+    }
+  }
+
+  // Split mini-batch into micro-batches
+  const El::Int mini_batch_size = get_current_mini_batch_size();
+  const El::Int num_micro_batches
+    = std::max(El::Int(1), std::min(m_num_micro_batches, mini_batch_size));
+  std::vector<El::Int> offsets(num_micro_batches + 1);
+  for (El::Int k = 0; k <= num_micro_batches; ++k) {
+    offsets[k] = k * mini_batch_size / num_micro_batches;
+  }
+
+  // Transfers in the order that backprop sends error signals
+  std::vector<pipeline_transfer*> backward_transfers;
+  for (auto& t : m_pipeline_transfers) { backward_transfers.push_back(&t); }
+  std::stable_sort(backward_transfers.begin(), backward_transfers.end(),
+                   [](const pipeline_transfer* a,
+                      const pipeline_transfer* b) {
+                     return (a->child_pos > b->child_pos
+                             || (a->child_pos == b->child_pos
+                                 && a->input_index < b->input_index));
+                   });
+
+  // Post receives for all micro-batches
+  // Note: Messages between a pair of processes are matched in the
+  // order they are posted.
+  for (El::Int k = 0; k < num_micro_batches; ++k) {
+    const auto& width = offsets[k+1] - offsets[k];
+    for (auto& t : m_pipeline_transfers) {
+      const auto& parent_stage = m_pipeline_stages[t.parent_pos];
+      if (is_local(t.child_pos)) {
+        const auto& child = get_layer(t.child_pos);
+        auto& input = *t.inputs[k];
+        input.Resize(child.get_input_size(t.input_index), width);
+        if (parent_stage >= 0) {
+          m_comm->nb_recv(input.Matrix(), trainer, peer(parent_stage),
+                          t.recv_requests[k]);
+        }
+      }
+    }
+    for (auto* t : backward_transfers) {
+      if (backprop && is_local(t->parent_pos)) {
+        const auto& parent = get_layer(t->parent_pos);
+        auto& gradient = *t->gradients[k];
+        gradient.Resize(parent.get_output_size(t->output_index), width);
+        m_comm->nb_recv(gradient.Matrix(), trainer,
+                        peer(m_pipeline_stages[t->child_pos]),
+                        t->recv_requests[k]);
+      }
+    }
+  }
+
+  // Every process takes part in each gradient allreduce, so gradients
+  // are held until all micro-batches are done
+  if (backprop) {
+    for (auto* w : m_weights) {
+      auto* opt = w->get_optimizer();
+      if (opt != nullptr) {
+        DataType buf_scale, in_scale;
+        auto& gradient = opt->get_gradient_buffer(buf_scale, in_scale, true);
+        if (buf_scale == DataType(0)) { El::Zero(gradient); }
+        else                          { El::Scale(buf_scale, gradient); }
+        opt->add_gradient_source(this);
+      }
+    }
+  }
+
+  // Send a local tensor to the corresponding process in a stage
+  std::vector<El::mpi::Request<DataType>*> pending_sends;
+  const auto& send = [&](pipeline_transfer& t, El::Int k,
+                         const AbsDistMat& x, El::Int stage) {
+    auto& buffer = t.send_buffers[k];
+    El::Copy(static_cast<const CPUMat&>(x.LockedMatrix()), buffer);
+    m_comm->nb_send(buffer, trainer, peer(stage), t.send_requests[k]);
+    pending_sends.push_back(&t.send_requests[k]);
+  };
+
+  // Forward prop of this stage's layers on a micro-batch
+  // Note: Callbacks, sends, and evaluation values are skipped when
+  // forward prop is recomputed before backprop.
+  std::vector<EvalType> eval_sums(num_layers, EvalType(0));
+  El::Int resident_micro_batch = -1;
+  const auto& forward = [&](El::Int k, bool first) {
+    set_current_mini_batch_size(offsets[k+1] - offsets[k]);
+    for (auto& t : m_pipeline_transfers) {
+      if (!is_local(t.child_pos)) { continue; }
+      auto& input = *t.inputs[k];
+      if (first && t.replicated_output != nullptr) {
+        const auto& replicated
+          = static_cast<const CPUMat&>(t.replicated_output->LockedMatrix());
+        auto& local_input = static_cast<CPUMat&>(input.Matrix());
+        for (El::Int col = 0; col < input.LocalWidth(); ++col) {
+          const auto& replicated_col = offsets[k] + input.GlobalCol(col);
+          for (El::Int row = 0; row < input.LocalHeight(); ++row) {
+            local_input(row, col) = replicated(input.GlobalRow(row),
+                                               replicated_col);
+          }
+        }
+      } else if (first) {
+        const auto wait_start = get_time();
+        m_comm->wait(t.recv_requests[k]);
+        wait_time += get_time() - wait_start;
+      }
+      get_layer(t.child_pos).set_remote_input(t.input_index, &input);
+    }
+    for (El::Int i = 0; i < num_layers; ++i) {
+      if (!is_local(i)) { continue; }
+      auto& l = get_layer(i);
+      if (first) { do_layer_forward_prop_begin_cbs(mode, &l); }
+      l.forward_prop();
+      if (first) { do_layer_forward_prop_end_cbs(mode, &l); }
+      auto* eval = dynamic_cast<abstract_evaluation_layer*>(&l);
+      if (eval != nullptr) {
+        const auto& value = eval->get_value(false);
+        if (first) { eval_sums[i] += value * (offsets[k+1] - offsets[k]); }
+      }
+      for (auto& t : m_pipeline_transfers) {
+        if (first && t.parent_pos == i) {
+          send(t, k, l.get_activations(t.output_index),
+               m_pipeline_stages[t.child_pos]);
+        }
+      }
+    }
+    resident_micro_batch = k;
+  };
+
+  // Backprop of this stage's layers on a micro-batch
+  const auto& backward = [&](El::Int k) {
+    if (resident_micro_batch != k) { forward(k, false); }
+    for (auto* t : backward_transfers) {
+      if (!is_local(t->parent_pos)) { continue; }
+      const auto wait_start = get_time();
+      m_comm->wait(t->recv_requests[k]);
+      wait_time += get_time() - wait_start;
+      get_layer(t->parent_pos).set_remote_prev_error_signal(
+        t->output_index, t->gradients[k].get());
+    }
+    for (El::Int i = num_layers - 1; i >= 0; --i) {
+      if (!is_local(i)) { continue; }
+      auto& l = get_layer(i);
+      do_layer_backward_prop_begin_cbs(&l);
+      l.back_prop();
+      do_layer_backward_prop_end_cbs(&l);
+      for (auto* t : backward_transfers) {
+        if (t->child_pos == i && m_pipeline_stages[t->parent_pos] >= 0) {
+          send(*t, k, l.get_error_signals(t->input_index),
+               m_pipeline_stages[t->parent_pos]);
+        }
+      }
+    }
+    resident_micro_batch = -1;
+  };
+
+  // Run this stage's schedule
+  if (backprop) {
+    do_model_backward_prop_begin_cbs();
+    const auto& steps
+      = pipeline::one_forward_one_backward(m_num_pipeline_stages,
+                                           num_micro_batches);
+    for (const auto& op : steps[m_pipeline_stage]) {
+      if (op.forward) { forward(op.micro_batch, true); }
+      else            { backward(op.micro_batch); }
+    }
+  } else {
+    for (El::Int k = 0; k < num_micro_batches; ++k) { forward(k, true); }
+  }
+  for (auto* req : pending_sends) { m_comm->wait(*req); }
+  set_current_mini_batch_size(mini_batch_size);
+
+  // Start gradient allreduces in the same order on every process
+  if (backprop) {
+    for (auto* w : m_weights) {
+      auto* opt = w->get_optimizer();
+      if (opt != nullptr) { opt->remove_gradient_source(this); }
+    }
+  }
+
+  // Share evaluation values from the stage that computed them
+  for (El::Int i = 0; i < num_layers; ++i) {
+    auto* eval = dynamic_cast<abstract_evaluation_layer*>(&get_layer(i));
+    if (eval != nullptr && m_pipeline_stages[i] >= 0) {
+      EvalType value = EvalType(0);
+      if (is_local(i) && mini_batch_size > 0) {
+        value = eval_sums[i] / mini_batch_size;
+      }
+      m_comm->trainer_broadcast(m_pipeline_stages[i] * stage_size, value);
+      eval->set_value(value);
+    }
+  }
+
+  // Weights without optimizers may be changed by their layers
+  // (e.g. batch normalization statistics)
+  if (backprop) {
+    std::unordered_set<weights*> shared_weights;
+    for (El::Int i = 0; i < num_layers; ++i) {
+      for (auto* w : get_layer(i).get_weights()) {
+        if (w->get_optimizer() == nullptr
+            && shared_weights.insert(w).second) {
+          El::Broadcast(w->get_values().Matrix(),
+                        m_comm->get_trainer_comm(),
+                        m_pipeline_stages[i] * stage_size);
+        }
+      }
+    }
+  }
+
+  do_model_forward_prop_end_cbs(mode);
+  if (backprop) { do_model_backward_prop_end_cbs(); }
+  m_pipeline_time += get_time() - start;
+  m_pipeline_wait_time += wait_time;
+}
+
 void model::update_weights() {
+  step_timing::scope timing_scope(step_timing::category::optimizer);
   do_model_optimize_begin_cbs();
+
+  // Check for overflow in loss-scaled gradients
+  // Note: Optimizers remove the loss scale as gradient contributions
+  // are accumulated (see clear_gradients). The optimization step is
+  // skipped if any gradient has overflowed. With dynamic loss
+  // scaling, gradients are checked even when the loss scale is one
+  // so that it can grow again.
+  const EvalType loss_scale = m_objective_function->get_loss_scale();
+  if (m_objective_function->get_dynamic_loss_scaling()
+      || loss_scale != EvalType(1)) {
+    int gradients_finite = 1;
+    for (const auto& w : m_weights) {
+      auto* opt = w->get_optimizer();
+      if (opt != nullptr) {
+        const auto& gradient = opt->get_gradient();
+        if (gradients_finite && !is_finite_local(gradient)) {
+          gradients_finite = 0;
+        }
+      }
+    }
+    gradients_finite = m_comm->trainer_allreduce(gradients_finite,
+                                                 El::mpi::MIN);
+    if (!m_objective_function->update_loss_scale(gradients_finite)) {
+      if (m_comm->am_trainer_master()) {
+        std::cout << "model \"" << get_name() << "\" "
+                  << "skipped optimization step "
+                  << get_step(execution_mode::training) << " "
+                  << "due to non-finite gradients "
+                  << "(loss scale is now "
+                  << m_objective_function->get_loss_scale() << ")"
+                  << std::endl;
+      }
+      do_model_optimize_end_cbs();
+      return;
+    }
+  }
+
   for (El::Int i = m_weights.size()-1; i >= 0; --i) {
     auto& w = *m_weights[i];
     optimizer* opt = w.get_optimizer();
@@ -1195,6 +2801,11 @@ void model::update_weights() {
 bool model::update_layers() {
   bool finished = true;
   for (El::Int i = get_num_layers()-1; i >= 0; --i) {
+    if (!m_pipeline_stages.empty()
+        && m_pipeline_stages[i] >= 0
+        && m_pipeline_stages[i] != m_pipeline_stage) {
+      continue;
+    }
     finished = get_layer(i).update() && finished;
   }
   return finished;
@@ -1269,6 +2880,7 @@ void model::do_epoch_end_cbs() {
 }
 
 void model::do_batch_begin_cbs(execution_mode mode) {
+  step_timing::scope timing_scope(step_timing::category::callbacks);
   for (const auto& cb : m_callbacks) {
     switch (mode) {
     case execution_mode::training:
@@ -1287,6 +2899,7 @@ void model::do_batch_begin_cbs(execution_mode mode) {
 }
 
 void model::do_batch_end_cbs(execution_mode mode) {
+  step_timing::scope timing_scope(step_timing::category::callbacks);
   for (const auto& cb : m_callbacks) {
     switch (mode) {
     case execution_mode::training:
@@ -1305,6 +2918,7 @@ void model::do_batch_end_cbs(execution_mode mode) {
 }
 
 void model::do_model_forward_prop_begin_cbs(execution_mode mode) {
+  step_timing::scope timing_scope(step_timing::category::callbacks);
   for (const auto& cb : m_callbacks) {
     switch (mode) {
     case execution_mode::training:
@@ -1323,6 +2937,7 @@ void model::do_model_forward_prop_begin_cbs(execution_mode mode) {
 }
 
 void model::do_model_forward_prop_end_cbs(execution_mode mode) {
+  step_timing::scope timing_scope(step_timing::category::callbacks);
   for (const auto& cb : m_callbacks) {
     switch (mode) {
     case execution_mode::training:
@@ -1344,6 +2959,7 @@ void model::do_model_forward_prop_end_cbs(execution_mode mode) {
  *  modes
  */
 void model::do_layer_forward_prop_begin_cbs(execution_mode mode, Layer *l) {
+  step_timing::scope timing_scope(step_timing::category::callbacks);
   for (const auto& cb : m_callbacks) {
     switch (mode) {
     case execution_mode::training:
@@ -1365,6 +2981,7 @@ void model::do_layer_forward_prop_begin_cbs(execution_mode mode, Layer *l) {
  *  modes
  */
 void model::do_layer_forward_prop_end_cbs(execution_mode mode, Layer *l) {
+  step_timing::scope timing_scope(step_timing::category::callbacks);
   for (const auto& cb : m_callbacks) {
     switch (mode) {
     case execution_mode::training:
@@ -1383,6 +3000,7 @@ void model::do_layer_forward_prop_end_cbs(execution_mode mode, Layer *l) {
 }
 
 void model::do_model_backward_prop_begin_cbs() {
+  step_timing::scope timing_scope(step_timing::category::callbacks);
   for (const auto& cb : m_callbacks) {
     if (get_step() % cb->get_batch_interval() == 0) {
       cb->on_backward_prop_begin(this);
@@ -1391,6 +3009,7 @@ void model::do_model_backward_prop_begin_cbs() {
 }
 
 void model::do_model_backward_prop_end_cbs() {
+  step_timing::scope timing_scope(step_timing::category::callbacks);
   for (const auto& cb : m_callbacks) {
     if (get_step() % cb->get_batch_interval() == 0) {
       cb->on_backward_prop_end(this);
@@ -1399,6 +3018,7 @@ void model::do_model_backward_prop_end_cbs() {
 }
 
 void model::do_layer_backward_prop_begin_cbs(Layer *l) {
+  step_timing::scope timing_scope(step_timing::category::callbacks);
   for (const auto& cb : m_callbacks) {
     if (get_step() % cb->get_batch_interval() == 0) {
       cb->on_backward_prop_begin(this, l);
@@ -1407,6 +3027,7 @@ void model::do_layer_backward_prop_begin_cbs(Layer *l) {
 }
 
 void model::do_layer_backward_prop_end_cbs(Layer *l) {
+  step_timing::scope timing_scope(step_timing::category::callbacks);
   for (const auto& cb : m_callbacks) {
     if (get_step() % cb->get_batch_interval() == 0) {
       cb->on_backward_prop_end(this, l);
@@ -1415,6 +3036,7 @@ void model::do_layer_backward_prop_end_cbs(Layer *l) {
 }
 
 void model::do_model_optimize_begin_cbs() {
+  step_timing::scope timing_scope(step_timing::category::callbacks);
   for (const auto& cb : m_callbacks) {
     if (get_step() % cb->get_batch_interval() == 0) {
       cb->on_optimize_begin(this);
@@ -1423,6 +3045,7 @@ void model::do_model_optimize_begin_cbs() {
 }
 
 void model::do_model_optimize_end_cbs() {
+  step_timing::scope timing_scope(step_timing::category::callbacks);
   for (const auto& cb : m_callbacks) {
     if (get_step() % cb->get_batch_interval() == 0) {
       cb->on_optimize_end(this);
@@ -1431,6 +3054,7 @@ void model::do_model_optimize_end_cbs() {
 }
 
 void model::do_weight_optimize_begin_cbs(weights *w) {
+  step_timing::scope timing_scope(step_timing::category::callbacks);
   for (const auto& cb : m_callbacks) {
     if (get_step() % cb->get_batch_interval() == 0) {
       cb->on_optimize_begin(this, w);
@@ -1439,6 +3063,7 @@ void model::do_weight_optimize_begin_cbs(weights *w) {
 }
 
 void model::do_weight_optimize_end_cbs(weights *w) {
+  step_timing::scope timing_scope(step_timing::category::callbacks);
   for (const auto& cb : m_callbacks) {
     if (get_step() % cb->get_batch_interval() == 0) {
       cb->on_optimize_end(this, w);
@@ -1466,6 +3091,12 @@ void model::summarize_stats(lbann_summary& summarizer) {
     m_objective_function->get_differentiation_time(),
     get_step(execution_mode::training));
   m_objective_function->reset_counters();
+  if (m_objective_function->get_dynamic_loss_scaling()
+      || m_objective_function->get_loss_scale() != EvalType(1)) {
+    summarizer.reduce_scalar("loss_scale",
+                             m_objective_function->get_loss_scale(),
+                             get_step(execution_mode::training));
+  }
   double total_metric_time = 0.0;
   for (auto&& m : m_metrics) {
     total_metric_time += m->get_evaluate_time();
@@ -1515,6 +3146,7 @@ bool model::save_to_checkpoint_shared(persist& p) {
       if(p.get_cb_type() == callback_type::batch)
         p.write_uint64(persist_type::validate, "validation_step",       (uint64_t) get_step(execution_mode::validation));
     }
+    m_objective_function->save_to_checkpoint_shared(p, *m_comm);
 
     for (weights *w : m_weights) {
       w->save_to_checkpoint_shared(p);
@@ -1590,6 +3222,7 @@ bool model::load_from_checkpoint_shared(persist& p) {
     m_current_mini_batch_size = (int)       header.current_mini_batch_size;
     // set state of persist object to know which type of ckpt we are returning from.
     p.set_cb_type((callback_type) header.callback_type);
+    m_objective_function->load_from_checkpoint_shared(p, *m_comm);
   } else {
     m_step[execution_mode::validation] = (int) header.validation_step;
   }
@@ -1628,6 +3261,7 @@ bool model::save_to_checkpoint_distributed(persist& p){
     p.write_uint32(persist_type::train, "persist_callback_type",      (uint32_t) p.get_cb_type());
     if(p.get_cb_type() == callback_type::batch)
       p.write_uint64(persist_type::validate, "validataion_step",       (uint64_t) get_step(execution_mode::validation));
+    m_objective_function->save_to_checkpoint_distributed(p);
 
     for (weights *w : m_weights) {
       w->save_to_checkpoint_distributed(p);
@@ -1674,6 +3308,7 @@ bool model::load_from_checkpoint_distributed(persist& p){
   p.read_uint32(persist_type::train, "max_mini_batch_size",      &header.max_mini_batch_size);
   p.read_uint32(persist_type::train, "current_mini_batch_size",      &header.current_mini_batch_size);
   p.read_uint32(persist_type::train, "persist_callback_type",     &header.callback_type);
+  m_objective_function->load_from_checkpoint_distributed(p, *m_comm);
 
   m_execution_mode     = (execution_mode) header.execution_mode;
   m_terminate_training = (bool)           header.terminate_training;
@@ -0,0 +1,163 @@
+// MUST include this
+#include <catch2/catch.hpp>
+#include "MPITestHelpers.hpp"
+
+// File being tested
+#include <lbann/models/directed_acyclic_graph.hpp>
+
+#include <lbann/layers/activations/activations.hpp>
+#include <lbann/layers/learning/fully_connected.hpp>
+#include <lbann/layers/loss/l2_norm2.hpp>
+#include <lbann/layers/transform/transform.hpp>
+#include <lbann/objective_functions/layer_term.hpp>
+#include <lbann/optimizers/sgd.hpp>
+#include <lbann/utils/memory.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using lbann::DataType;
+using lbann::data_layout;
+
+constexpr El::Int mini_batch_size = 6;
+constexpr El::Int num_micro_batches = 3;
+constexpr int num_steps = 3;
+
+/** Parentless layer with a fixed pattern in each sample.
+ *  Samples repeat with period 2, so each micro-batch of an even size
+ *  holds the same samples as the mini-batch in the same proportions.
+ */
+class pattern_layer : public lbann::transform_layer {
+public:
+  pattern_layer(lbann::lbann_comm* comm) : transform_layer(comm) {
+    set_output_dims({5});
+    this->m_expected_num_parent_layers = 0;
+  }
+  pattern_layer* copy() const override { return new pattern_layer(*this); }
+  std::string get_type() const override { return "pattern"; }
+  data_layout get_data_layout() const override {
+    return data_layout::DATA_PARALLEL;
+  }
+  El::Device get_device_allocation() const override {
+    return El::Device::CPU;
+  }
+protected:
+  void fp_compute() override {
+    auto& output = get_activations();
+    for (El::Int col = 0; col < output.LocalWidth(); ++col) {
+      const auto& sample = output.GlobalCol(col) % 2;
+      for (El::Int row = 0; row < output.LocalHeight(); ++row) {
+        const auto& i = output.GlobalRow(row);
+        output.SetLocal(row, col,
+                        DataType(0.3) * (i + 1) - DataType(0.5) * sample);
+      }
+    }
+  }
+};
+
+/** Construct a model with layers data -> fc1 -> relu -> fc2 -> loss.
+ *  With two stages, fc1 and relu run in the first stage and fc2 in
+ *  the second.
+ */
+std::unique_ptr<lbann::model> make_model(lbann::lbann_comm& comm,
+                                         bool pipelined) {
+  constexpr auto layout = data_layout::DATA_PARALLEL;
+  constexpr auto device = El::Device::CPU;
+  auto* obj = new lbann::objective_function();
+  auto* term = new lbann::layer_term();
+  obj->add_term(term);
+  auto m = lbann::make_unique<lbann::directed_acyclic_graph_model>(
+    &comm, mini_batch_size, obj, new lbann::sgd(&comm, 0.1));
+  std::vector<std::unique_ptr<lbann::Layer>> layers;
+  layers.emplace_back(new pattern_layer(&comm));
+  layers.emplace_back(
+    new lbann::fully_connected_layer<layout,device>(&comm, 4));
+  layers.emplace_back(new lbann::relu_layer<layout,device>(&comm));
+  layers.emplace_back(
+    new lbann::fully_connected_layer<layout,device>(&comm, 3));
+  layers.emplace_back(new lbann::l2_norm2_layer<layout,device>(&comm));
+  const std::vector<std::string> names = {"data", "fc1", "relu", "fc2", "loss"};
+  for (size_t i = 0; i < layers.size(); ++i) {
+    layers[i]->set_name(names[i]);
+    if (i > 0) {
+      layers[i]->add_parent_layer(layers[i-1].get());
+      layers[i-1]->add_child_layer(layers[i].get());
+    }
+  }
+  term->set_layer(*layers.back());
+  for (auto& l : layers) { m->add_layer(std::move(l)); }
+  if (pipelined) { m->set_pipeline_parallelism(2, num_micro_batches); }
+  m->setup(nullptr);
+  return m;
+}
+
+/** Weights of a model with a given name. */
+lbann::weights& find_weights(lbann::model& m, const std::string& name) {
+  for (auto* w : m.get_weights()) {
+    if (w->get_name() == name) { return *w; }
+  }
+  FAIL("weights \"" << name << "\" not found");
+  return *m.get_weights().front();
+}
+
+/** Layer of a model with a given name. */
+const lbann::Layer& find_layer(const lbann::model& m, const std::string& name) {
+  for (const auto* l : m.get_layers()) {
+    if (l->get_name() == name) { return *l; }
+  }
+  FAIL("layer \"" << name << "\" not found");
+  return *m.get_layers().front();
+}
+
+} // namespace
+
+TEST_CASE("Pipelined training matches sequential training",
+          "[model][pipeline][mpi]") {
+
+  auto& comm = unit_test::utilities::get_current_comm();
+  const El::Int num_procs = comm.get_procs_per_trainer();
+
+  // Two stages need an even number of processes
+  if (num_procs < 2 || num_procs % 2 != 0) { return; }
+
+  auto reference = make_model(comm, false);
+  auto pipelined = make_model(comm, true);
+  for (auto* w : pipelined->get_weights()) {
+    w->set_values(find_weights(*reference, w->get_name()).get_values());
+  }
+
+  SECTION("Layers are split into stages") {
+    CHECK(pipelined->get_num_pipeline_stages() == 2);
+    CHECK(pipelined->get_pipeline_stage(find_layer(*pipelined, "data")) == 0);
+    CHECK(pipelined->get_pipeline_stage(find_layer(*pipelined, "relu")) == 0);
+    CHECK(pipelined->get_pipeline_stage(find_layer(*pipelined, "fc2")) == 1);
+    CHECK(pipelined->get_pipeline_stage(find_layer(*pipelined, "loss")) == 1);
+    CHECK(pipelined->get_pipeline_stage()
+          == comm.get_rank_in_trainer() / (num_procs / 2));
+  }
+
+  SECTION("Weights match after training steps") {
+    reference->train(1, num_steps);
+    pipelined->train(1, num_steps);
+    for (auto* w : pipelined->get_weights()) {
+      const auto& expected = find_weights(*reference, w->get_name());
+      const auto& actual_vals = w->get_values();
+      const auto& expected_vals = expected.get_values();
+      REQUIRE(actual_vals.LocalHeight() == expected_vals.LocalHeight());
+      REQUIRE(actual_vals.LocalWidth() == expected_vals.LocalWidth());
+      for (El::Int j = 0; j < actual_vals.LocalWidth(); ++j) {
+        for (El::Int i = 0; i < actual_vals.LocalHeight(); ++i) {
+          CHECK(actual_vals.GetLocal(i, j)
+                == Approx(expected_vals.GetLocal(i, j)).margin(1e-5));
+        }
+      }
+    }
+    const auto& bubble_fraction = pipelined->get_pipeline_bubble_fraction();
+    CHECK(bubble_fraction >= 0);
+    CHECK(bubble_fraction < 1);
+  }
+
+}
@@ -66,6 +66,7 @@ abstract_evaluation_layer& layer_term::get_evaluation_layer() {
 void layer_term::setup(model& m) {
   objective_function_term::setup(m);
   get_evaluation_layer().set_scale(m_scale_factor);
+  m_deferred_consumer = get_evaluation_layer().add_deferred_consumer();
 }
 
 void layer_term::start_evaluation() {}
@@ -77,8 +78,14 @@ EvalType layer_term::finish_evaluation() {
   return eval.get_value();
 }
 
+EvalType layer_term::collect_deferred_evaluation(bool flush) {
+  auto& eval = get_evaluation_layer();
+  const auto value = eval.collect_deferred_value(m_deferred_consumer, flush);
+  return m_scale_factor * value;
+}
+
 void layer_term::differentiate() {
-  get_evaluation_layer().set_scale(m_scale_factor);
+  get_evaluation_layer().set_scale(m_scale_factor * m_loss_scale);
 }
 
 }  // namespace lbann
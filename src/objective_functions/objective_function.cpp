@@ -27,6 +27,11 @@
 #include "lbann/objective_functions/objective_function.hpp"
 #include "lbann/utils/timer.hpp"
 #include "lbann/utils/profiling.hpp"
+#include "lbann/io/file_io.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
 #include <numeric>
 
 namespace lbann {
@@ -34,7 +39,11 @@ namespace lbann {
 objective_function::objective_function(const objective_function& other)
   : m_statistics(other.m_statistics),
     m_evaluation_time(other.m_evaluation_time),
-    m_differentiation_time(other.m_differentiation_time) {
+    m_differentiation_time(other.m_differentiation_time),
+    m_loss_scale(other.m_loss_scale),
+    m_dynamic_loss_scaling(other.m_dynamic_loss_scaling),
+    m_loss_scale_growth_interval(other.m_loss_scale_growth_interval),
+    m_num_finite_steps(other.m_num_finite_steps) {
   m_terms = other.m_terms;
   for (auto& term : m_terms) {
     term = term->copy();
@@ -52,6 +61,10 @@ objective_function& objective_function::operator=(const objective_function& othe
   m_statistics = other.m_statistics;
   m_evaluation_time = other.m_evaluation_time;
   m_differentiation_time = other.m_differentiation_time;
+  m_loss_scale = other.m_loss_scale;
+  m_dynamic_loss_scaling = other.m_dynamic_loss_scaling;
+  m_loss_scale_growth_interval = other.m_loss_scale_growth_interval;
+  m_num_finite_steps = other.m_num_finite_steps;
   return *this;
 }
 
@@ -103,11 +116,43 @@ EvalType objective_function::finish_evaluation(execution_mode mode,
   return value;
 }
 
+void objective_function::finish_deferred_evaluation(execution_mode mode,
+                                                    int mini_batch_size) {
+  const auto start_time = get_time();
+  EvalType value = EvalType(0);
+  EvalType deferred_value = EvalType(0);
+  prof_region_begin("obj-finish-eval", prof_colors[0], false);
+  for (const auto& term : m_terms) {
+    if (term->supports_deferred_evaluation()) {
+      deferred_value += term->collect_deferred_evaluation(false);
+    } else {
+      value += term->finish_evaluation();
+    }
+  }
+  prof_region_end("obj-finish-eval", false);
+  m_statistics[mode].add_value(mini_batch_size * value + deferred_value,
+                               mini_batch_size);
+  m_evaluation_time += get_time() - start_time;
+}
+
+void objective_function::flush_deferred_evaluation(execution_mode mode) {
+  const auto start_time = get_time();
+  EvalType deferred_value = EvalType(0);
+  for (const auto& term : m_terms) {
+    if (term->supports_deferred_evaluation()) {
+      deferred_value += term->collect_deferred_evaluation(true);
+    }
+  }
+  m_statistics[mode].add_value(deferred_value, 0);
+  m_evaluation_time += get_time() - start_time;
+}
+
 void objective_function::differentiate() {
   const auto start_time = get_time();
   prof_region_begin("obj-differentiate", prof_colors[0], false);
   for (const auto& term : m_terms) {
     prof_region_begin(("obj-differentiate-" + term->name()).c_str(), prof_colors[1], false);
+    term->set_loss_scale(m_loss_scale);
     term->differentiate();
     prof_region_end(("obj-differentiate-" + term->name()).c_str(), false);
   }
@@ -120,6 +165,7 @@ void objective_function::compute_weight_regularization() {
   prof_region_begin("obj-weight-regularization", prof_colors[0], false);
   for (const auto& term : m_terms) {
     prof_region_begin(("obj-weight-regularization-" + term->name()).c_str(), prof_colors[1], false);
+    term->set_loss_scale(m_loss_scale);
     term->compute_weight_regularization();
     prof_region_end(("obj-weight-regularization-" + term->name()).c_str(), false);
   }
@@ -127,6 +173,114 @@ void objective_function::compute_weight_regularization() {
   m_differentiation_time += get_time() - start_time;
 }
 
+void objective_function::set_loss_scale(EvalType loss_scale) {
+  if (loss_scale <= EvalType(0)) {
+    std::stringstream err;
+    err << "attempted to set objective function loss scale "
+        << "to a non-positive value (" << loss_scale << ")";
+    LBANN_ERROR(err.str());
+  }
+  m_loss_scale = loss_scale;
+  m_num_finite_steps = 0;
+}
+
+void objective_function::set_dynamic_loss_scaling(bool enable,
+                                                  El::Int growth_interval) {
+  if (growth_interval <= 0) {
+    std::stringstream err;
+    err << "attempted to set loss scale growth interval "
+        << "to a non-positive value (" << growth_interval << ")";
+    LBANN_ERROR(err.str());
+  }
+  m_dynamic_loss_scaling = enable;
+  m_loss_scale_growth_interval = growth_interval;
+  m_num_finite_steps = 0;
+}
+
+bool objective_function::update_loss_scale(bool gradients_finite) {
+  if (!m_dynamic_loss_scaling) { return gradients_finite; }
+  if (gradients_finite) {
+    ++m_num_finite_steps;
+    if (m_num_finite_steps >= m_loss_scale_growth_interval) {
+      m_loss_scale *= EvalType(2);
+      m_num_finite_steps = 0;
+    }
+  } else {
+    m_loss_scale = std::max(m_loss_scale / EvalType(2), EvalType(1));
+    m_num_finite_steps = 0;
+  }
+  return gradients_finite;
+}
+
+bool objective_function::save_to_checkpoint_shared(persist& p,
+                                                   lbann_comm& comm) {
+  if (m_dynamic_loss_scaling && comm.am_trainer_master()) {
+    write_loss_scale(p.m_checkpoint_dir);
+  }
+  return true;
+}
+
+bool objective_function::load_from_checkpoint_shared(persist& p,
+                                                     lbann_comm& comm) {
+  if (m_dynamic_loss_scaling) {
+    read_loss_scale(p.m_checkpoint_dir, comm);
+  }
+  return true;
+}
+
+bool objective_function::save_to_checkpoint_distributed(persist& p) {
+  if (m_dynamic_loss_scaling) {
+    write_loss_scale(p.m_checkpoint_dir);
+  }
+  return true;
+}
+
+bool objective_function::load_from_checkpoint_distributed(persist& p,
+                                                          lbann_comm& comm) {
+  if (m_dynamic_loss_scaling) {
+    read_loss_scale(p.get_rank_checkpoint_dir(), comm);
+  }
+  return true;
+}
+
+void objective_function::write_loss_scale(const std::string& dir) const {
+  const auto& file_name = dir + "/loss_scale";
+  std::ofstream out(file_name);
+  out << std::setprecision(17) << m_loss_scale << " "
+      << m_num_finite_steps << std::endl;
+  if (!out.good()) {
+    LBANN_ERROR("failed to write loss scale to " + file_name);
+  }
+}
+
+void objective_function::read_loss_scale(const std::string& dir,
+                                         lbann_comm& comm) {
+  int found = 0;
+  EvalType loss_scale = m_loss_scale;
+  El::Int num_finite_steps = m_num_finite_steps;
+  if (comm.am_trainer_master()) {
+    const auto& file_name = dir + "/loss_scale";
+    if (exists(file_name.c_str())) {
+      std::ifstream in(file_name);
+      in >> loss_scale >> num_finite_steps;
+      if (in.fail() || loss_scale <= EvalType(0)) {
+        LBANN_ERROR("failed to read loss scale from " + file_name);
+      }
+      found = 1;
+    } else {
+      std::cout << "checkpoint in " << dir << " has no loss scale, "
+                << "keeping loss scale " << m_loss_scale << std::endl;
+    }
+  }
+  comm.trainer_broadcast(0, found);
+  if (found) {
+    comm.trainer_broadcast(0, loss_scale);
+    comm.trainer_broadcast(0, num_finite_steps);
+    m_loss_scale = loss_scale;
+    m_num_finite_steps = num_finite_steps;
+  }
+}
+
 EvalType objective_function::get_mean_value(execution_mode mode) const {
   if (m_statistics.count(mode) == 0
       || m_statistics.at(mode).get_num_samples() == 0) {
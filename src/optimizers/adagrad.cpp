@@ -101,6 +101,27 @@ void adagrad::step_compute_cpu(AbsDistMat& values, const AbsDistMat& gradient) {
 
 }
 
+void adagrad::sparse_step_compute(AbsDistMat& values,
+                                  const std::vector<El::Int>& columns,
+                                  const CPUMat& gradient) {
+  const auto& learning_rate = get_learning_rate();
+  auto& local_values = values.Matrix();
+  auto& local_cache = m_cache->Matrix();
+  const El::Int height = gradient.Height();
+  const El::Int num_columns = columns.size();
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int i = 0; i < num_columns; ++i) {
+    const auto& col = columns[i];
+    for (El::Int row = 0; row < height; ++row) {
+      auto& x = local_values(row, col);
+      const auto& g = gradient(row, i);
+      auto& c = local_cache(row, col);
+      c += g * g;
+      x -= learning_rate * g / (std::sqrt(c) + m_eps);
+    }
+  }
+}
+
 // =============================================
 // Checkpointing
 // =============================================
@@ -176,6 +176,40 @@ void adam::step_compute_cpu(AbsDistMat& values, const AbsDistMat& gradient) {
 
 }
 
+void adam::sparse_step_compute(AbsDistMat& values,
+                               const std::vector<El::Int>& columns,
+                               const CPUMat& gradient) {
+  constexpr DataType one = 1;
+
+  // Precompute the bias correction and learning rate.
+  m_current_beta1 *= m_beta1;
+  m_current_beta2 *= m_beta2;
+  const DataType correction = this->get_learning_rate() *
+                              (std::sqrt(one - m_current_beta2)
+                               / (one - m_current_beta1));
+
+  // Update columns with nonzero gradient
+  auto& local_values = values.Matrix();
+  auto& local_moment1 = m_moment1->Matrix();
+  auto& local_moment2 = m_moment2->Matrix();
+  const El::Int height = gradient.Height();
+  const El::Int num_columns = columns.size();
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int i = 0; i < num_columns; ++i) {
+    const auto& col = columns[i];
+    for (El::Int row = 0; row < height; ++row) {
+      auto& x = local_values(row, col);
+      const auto& g = gradient(row, i) + m_eps; // Avoid denormalized floats
+      auto& m1 = local_moment1(row, col);
+      auto& m2 = local_moment2(row, col);
+      m1 = m_beta1 * m1 + (one - m_beta1) * g;
+      m2 = m_beta2 * m2 + (one - m_beta2) * g * g;
+      x -= correction * m1 / (std::sqrt(m2) + m_eps);
+    }
+  }
+
+}
+
 // =============================================
 // Checkpointing
 // =============================================
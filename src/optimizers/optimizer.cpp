@@ -27,8 +27,49 @@
 #include "lbann/optimizers/optimizer.hpp"
 #include "lbann/utils/timer.hpp"
 
+#include <algorithm>
+#include <numeric>
+
 namespace lbann {
 
+namespace {
+
+/** @brief Sum matrix columns that share the same index.
+ *
+ *  The merged indices are sorted. Columns with equal indices are
+ *  accumulated in their original order, so every process that
+ *  merges the same data gets bitwise identical results.
+ */
+void merge_sparse_columns(const std::vector<El::Int>& indices,
+                          const DataType* values,
+                          El::Int ldim,
+                          El::Int height,
+                          DataType scale,
+                          std::vector<El::Int>& merged_indices,
+                          std::vector<DataType>& merged_values) {
+  std::vector<size_t> order(indices.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&indices] (size_t a, size_t b) {
+                     return indices[a] < indices[b];
+                   });
+  merged_indices.clear();
+  merged_values.clear();
+  for (const auto& i : order) {
+    if (merged_indices.empty() || merged_indices.back() != indices[i]) {
+      merged_indices.push_back(indices[i]);
+      merged_values.resize(merged_values.size() + height, DataType(0));
+    }
+    auto* __restrict__ dst = &merged_values[merged_values.size() - height];
+    const auto* __restrict__ src = &values[i * ldim];
+    for (El::Int row = 0; row < height; ++row) {
+      dst[row] += scale * src[row];
+    }
+  }
+}
+
+} // namespace
+
 std::string to_string(optimizer_gradient_status status) {
   switch (status) {
   case optimizer_gradient_status::ready:
@@ -56,8 +97,11 @@ optimizer::optimizer(const optimizer& other)
     m_weights(other.m_weights),
     m_gradient(other.m_gradient ? other.m_gradient->Copy() : nullptr),
     m_gradient_v(other.m_gradient_v ? other.m_gradient_v->Copy() : nullptr),
+    m_sparse_gradient_columns(other.m_sparse_gradient_columns),
+    m_sparse_gradient_values(other.m_sparse_gradient_values),
     m_gradient_sources(other.m_gradient_sources),
     m_gradient_status(other.m_gradient_status),
+    m_gradient_scale(other.m_gradient_scale),
     m_learning_rate(other.m_learning_rate),
     m_step_time(other.m_step_time) {
   if (m_gradient_status == optimizer_gradient_status::allreduce_started) {
@@ -71,8 +115,11 @@ optimizer& optimizer::operator=(const optimizer& other) {
   m_weights = other.m_weights;
   m_gradient.reset(other.m_gradient ? other.m_gradient->Copy() : nullptr);
   m_gradient_v.reset(other.m_gradient_v ? other.m_gradient_v->Copy() : nullptr);
+  m_sparse_gradient_columns = other.m_sparse_gradient_columns;
+  m_sparse_gradient_values = other.m_sparse_gradient_values;
   m_gradient_sources = other.m_gradient_sources;
   m_gradient_status = other.m_gradient_status;
+  m_gradient_scale = other.m_gradient_scale;
   m_learning_rate = other.m_learning_rate;
   m_step_time = other.m_step_time;
   if (m_gradient_status == optimizer_gradient_status::allreduce_started) {
@@ -122,6 +169,7 @@ AbsDistMat& optimizer::get_gradient() {
         << "but found \"" << to_string(m_gradient_status) << "\")";
     LBANN_ERROR(err.str());
   }
+  densify_sparse_gradient();
 
   // Return gradient
   return *m_gradient;
@@ -137,6 +185,7 @@ void optimizer::add_to_gradient(const AbsDistMat& gradient,
     LBANN_ERROR("attempted to access gradient before it is set up");
   }
   if (scale == DataType(0)) { return; }
+  scale *= m_gradient_scale;
 
   // Make sure input matrix is in correct distribution
   // Note: If input matrix is already in correct distribution, just
@@ -146,6 +195,29 @@ void optimizer::add_to_gradient(const AbsDistMat& gradient,
   m_gradient_v->AlignWith(*m_gradient);
   if (m_gradient_v->DistData() == gradient.DistData()) {
     El::LockedView(*m_gradient_v, gradient);
+  } else if (&gradient.Grid() != &m_gradient->Grid()) {
+    // Contribution from a subset of the processes (e.g. a pipeline
+    // stage) that cannot be redistributed. Each process adds its
+    // local copy and the gradient allreduce sums them, so a
+    // contribution that is already reduced is divided by the number
+    // of copies.
+    const auto& dist = gradient.DistData();
+    const auto& gradient_dist = m_gradient->DistData();
+    if (dist.colDist != El::STAR || dist.rowDist != El::STAR
+        || gradient_dist.colDist != El::STAR
+        || gradient_dist.rowDist != El::STAR
+        || dist.device != El::Device::CPU
+        || gradient_dist.device != El::Device::CPU) {
+      LBANN_ERROR("gradient contributions from a different process grid "
+                  "are only supported for replicated CPU weights");
+    }
+    m_gradient_v->Resize(gradient.Height(), gradient.Width());
+    El::Copy(static_cast<const CPUMat&>(gradient.LockedMatrix()),
+             static_cast<CPUMat&>(m_gradient_v->Matrix()));
+    if (!allreduce_needed) {
+      scale /= gradient.RedundantSize();
+      allreduce_needed = true;
+    }
   } else if (allreduce_needed) {
     std::unique_ptr<AbsDistMat> temp(gradient.Copy());
     get_comm().allreduce(*temp, temp->RedundantComm());
@@ -196,12 +268,119 @@ void optimizer::add_to_gradient(const AbsDistMat& gradient,
 
 }
 
+void optimizer::add_to_sparse_gradient(const std::vector<El::Int>& columns,
+                                       const CPUMat& gradient,
+                                       DataType scale) {
+
+  // Check inputs
+  if (m_gradient == nullptr) {
+    LBANN_ERROR("attempted to access gradient before it is set up");
+  }
+  const El::Int height = m_gradient->Height();
+  if (gradient.Height() != height
+      || gradient.Width() != static_cast<El::Int>(columns.size())) {
+    std::ostringstream err;
+    err << "attempted to add a " << gradient.Height() << " x "
+        << gradient.Width() << " sparse gradient contribution "
+        << "with " << columns.size() << " column indices "
+        << "to a " << height << " x " << m_gradient->Width() << " gradient";
+    LBANN_ERROR(err.str());
+  }
+  if (scale == DataType(0)) { return; }
+
+  // Densify contribution if gradient is not a replicated CPU matrix
+  // Note: Each process has different contributions, so they are
+  // summed over the whole grid before being copied into the
+  // gradient's distribution. Copying first would drop
+  // contributions to entries owned by other processes.
+  const auto& dist = m_gradient->DistData();
+  if (dist.colDist != El::STAR || dist.rowDist != El::STAR
+      || m_gradient->GetLocalDevice() != El::Device::CPU) {
+    StarMat<El::Device::CPU> dense(m_gradient->Grid(), m_gradient->Root());
+    El::Zeros(dense, height, m_gradient->Width());
+    auto& local_dense = dense.Matrix();
+    for (size_t i = 0; i < columns.size(); ++i) {
+      for (El::Int row = 0; row < height; ++row) {
+        local_dense(row, columns[i]) += gradient(row, i);
+      }
+    }
+    get_comm().allreduce(dense, dense.RedundantComm());
+    add_to_gradient(dense, scale, false);
+    return;
+  }
+
+  // Merge local contributions with the same column
+  std::vector<El::Int> local_columns;
+  std::vector<DataType> local_values;
+  // Note: The gradient scale is applied here since the densified
+  // path applies it in add_to_gradient.
+  merge_sparse_columns(columns, gradient.LockedBuffer(), gradient.LDim(),
+                       height, scale * m_gradient_scale,
+                       local_columns, local_values);
+
+  // Exchange contributions with allgathers
+  const auto& comm = m_gradient->RedundantComm();
+  const int num_procs = El::mpi::Size(comm);
+  int local_count = local_columns.size();
+  std::vector<int> counts(num_procs), displacements(num_procs, 0);
+  get_comm().all_gather(local_count, counts, comm);
+  std::partial_sum(counts.begin(), counts.end() - 1,
+                   displacements.begin() + 1);
+  const El::Int total_count = displacements.back() + counts.back();
+  std::vector<El::Int> all_columns(total_count);
+  El::mpi::AllGather(local_columns.data(), local_count,
+                     all_columns.data(),
+                     counts.data(), displacements.data(),
+                     comm, El::SyncInfo<El::Device::CPU>{});
+  for (int i = 0; i < num_procs; ++i) {
+    counts[i] *= height;
+    displacements[i] *= height;
+  }
+  std::vector<DataType> all_values(total_count * height);
+  El::mpi::AllGather(local_values.data(), local_count * height,
+                     all_values.data(),
+                     counts.data(), displacements.data(),
+                     comm, El::SyncInfo<El::Device::CPU>{});
+
+  // Merge with pending sparse contributions
+  all_columns.insert(all_columns.begin(),
+                     m_sparse_gradient_columns.begin(),
+                     m_sparse_gradient_columns.end());
+  all_values.insert(all_values.begin(),
+                    m_sparse_gradient_values.begin(),
+                    m_sparse_gradient_values.end());
+  merge_sparse_columns(all_columns, all_values.data(), height,
+                       height, DataType(1),
+                       m_sparse_gradient_columns,
+                       m_sparse_gradient_values);
+
+}
+
+void optimizer::densify_sparse_gradient() {
+  if (m_sparse_gradient_columns.empty()) { return; }
+  const El::Int height = m_gradient->Height();
+  const El::Int num_columns = m_sparse_gradient_columns.size();
+  auto& local_gradient = m_gradient->Matrix();
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int i = 0; i < num_columns; ++i) {
+    const auto& col = m_sparse_gradient_columns[i];
+    const auto* values = &m_sparse_gradient_values[i * height];
+    for (El::Int row = 0; row < height; ++row) {
+      local_gradient(row, col) += values[row];
+    }
+  }
+  m_sparse_gradient_columns.clear();
+  m_sparse_gradient_values.clear();
+}
+
 void optimizer::clear_gradient() {
   if (m_gradient_status == optimizer_gradient_status::allreduce_started) {
     finish_gradient_allreduce();
   }
   m_gradient_status = optimizer_gradient_status::cleared;
   m_gradient_sources.clear();
+  m_sparse_gradient_columns.clear();
+  m_sparse_gradient_values.clear();
 }
 
 AbsDistMat& optimizer::get_gradient_buffer(DataType& buf_scale,
@@ -244,6 +423,7 @@ AbsDistMat& optimizer::get_gradient_buffer(DataType& buf_scale,
     LBANN_ERROR("unexpected gradient status ("
                 + to_string(m_gradient_status) + ")");
   }
+  in_scale *= m_gradient_scale;
   return *m_gradient;
 }
 
@@ -296,10 +476,32 @@ void optimizer::step() {
     LBANN_ERROR("attempted to perform optimization step without weights");
   }
   const auto start_time = get_time();
-  step_compute(m_weights->get_values(), get_gradient());
+  if (!m_sparse_gradient_columns.empty()
+      && m_gradient_status == optimizer_gradient_status::cleared
+      && supports_sparse_step()) {
+    // Lazy update if all gradient contributions are sparse
+    CPUMat gradient;
+    gradient.LockedAttach(m_gradient->Height(),
+                          m_sparse_gradient_columns.size(),
+                          m_sparse_gradient_values.data(),
+                          m_gradient->Height());
+    sparse_step_compute(m_weights->get_values(),
+                        m_sparse_gradient_columns,
+                        gradient);
+    m_sparse_gradient_columns.clear();
+    m_sparse_gradient_values.clear();
+  } else {
+    step_compute(m_weights->get_values(), get_gradient());
+  }
   m_step_time += get_time() - start_time;
 }
 
+void optimizer::sparse_step_compute(AbsDistMat& values,
+                                    const std::vector<El::Int>& columns,
+                                    const CPUMat& gradient) {
+  LBANN_ERROR(get_type() + " optimizer does not support sparse steps");
+}
+
 DataType optimizer::get_learning_rate() const {
   return m_learning_rate;
 }
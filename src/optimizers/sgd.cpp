@@ -162,6 +162,33 @@ void sgd::momentum_step_cpu(AbsDistMat& values, const AbsDistMat& gradient) {
 
 }
 
+void sgd::sparse_step_compute(AbsDistMat& values,
+                              const std::vector<El::Int>& columns,
+                              const CPUMat& gradient) {
+  const auto& learning_rate = this->get_learning_rate();
+  auto& local_values = values.Matrix();
+  auto& local_velocity = m_velocity->Matrix();
+  const El::Int height = gradient.Height();
+  const El::Int num_columns = columns.size();
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int i = 0; i < num_columns; ++i) {
+    const auto& col = columns[i];
+    for (El::Int row = 0; row < height; ++row) {
+      const auto& g = gradient(row, i);
+      auto& x = local_values(row, col);
+      if (m_momentum == DataType(0)) {
+        x -= learning_rate * g;
+      } else {
+        auto& v = local_velocity(row, col);
+        v = m_momentum * v + g;
+        x -= (m_nesterov ?
+              learning_rate * (m_momentum * v + g) :
+              learning_rate * v);
+      }
+    }
+  }
+}
+
 // =============================================
 // Checkpointing
 // =============================================
@@ -0,0 +1,229 @@
+// MUST include this
+#include <catch2/catch.hpp>
+#include "MPITestHelpers.hpp"
+
+// File being tested
+#include <lbann/optimizers/optimizer.hpp>
+
+#include <lbann/optimizers/adagrad.hpp>
+#include <lbann/optimizers/adam.hpp>
+#include <lbann/optimizers/sgd.hpp>
+#include <lbann/utils/memory.hpp>
+#include <lbann/weights/initializer.hpp>
+#include <lbann/weights/weights.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace {
+
+using lbann::DataType;
+using optimizer_factory
+  = std::function<std::unique_ptr<lbann::optimizer>(lbann::lbann_comm&)>;
+
+/** Weights matrix dimensions.
+ *  Contributions only use the first width-1 columns.
+ */
+constexpr El::Int height = 3;
+constexpr El::Int width = 7;
+
+/** Sparse gradient contribution of a process.
+ *  Every used column appears at least once on every process and some
+ *  columns repeat, so sparse and dense steps update the same
+ *  entries.
+ */
+void get_contribution(int rank,
+                      int step,
+                      std::vector<El::Int>& columns,
+                      lbann::CPUMat& values) {
+  columns = {3, 0, 1, 2, 4, 5, 2, 4, (rank + step) % (width - 1), 2};
+  values.Resize(height, columns.size());
+  for (El::Int j = 0; j < values.Width(); ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      values(i, j) = (DataType(0.1) * (i + 1)
+                      - DataType(0.03) * j
+                      + DataType(0.02) * (rank + 1) * (step + 1));
+    }
+  }
+}
+
+/** Dense matrix with the same entries as a sparse contribution. */
+void densify(const std::vector<El::Int>& columns,
+             const lbann::CPUMat& values,
+             lbann::AbsDistMat& dense) {
+  El::Zeros(dense, height, width);
+  auto& local_dense = dense.Matrix();
+  for (size_t j = 0; j < columns.size(); ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      local_dense(i, columns[j]) += values(i, j);
+    }
+  }
+}
+
+/** Construct weights with an optimizer. */
+std::unique_ptr<lbann::weights> make_weights(lbann::lbann_comm& comm,
+                                             const optimizer_factory& make_opt,
+                                             El::Dist col_dist = El::STAR,
+                                             El::Dist row_dist = El::STAR) {
+  auto w = lbann::make_unique<lbann::weights>(&comm);
+  w->set_dims({static_cast<int>(height)}, {static_cast<int>(width)});
+  auto dist = w->get_matrix_distribution();
+  dist.colDist = col_dist;
+  dist.rowDist = row_dist;
+  w->set_matrix_distribution(dist);
+  std::vector<DataType> init(height * width);
+  for (size_t k = 0; k < init.size(); ++k) {
+    init[k] = DataType(0.05) * k - DataType(0.4);
+  }
+  w->set_initializer(lbann::make_unique<lbann::value_initializer>(init));
+  w->set_optimizer(make_opt(comm));
+  w->setup();
+  return w;
+}
+
+/** Check that weights have the same values on every process. */
+void check_values(const lbann::weights& actual,
+                  const lbann::weights& expected) {
+  const auto& grid = expected.get_values().Grid();
+  lbann::StarMat<El::Device::CPU> actual_vals(grid), expected_vals(grid);
+  El::Copy(actual.get_values(), actual_vals);
+  El::Copy(expected.get_values(), expected_vals);
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      CHECK(actual_vals.GetLocal(i, j)
+            == Approx(expected_vals.GetLocal(i, j)).margin(1e-5));
+    }
+  }
+}
+
+/** Optimizers with sparse steps. */
+std::vector<std::pair<std::string,optimizer_factory>> get_optimizers() {
+  return {
+    {"SGD", [](lbann::lbann_comm& comm) {
+        return lbann::make_unique<lbann::sgd>(&comm, 0.1);
+      }},
+    {"Momentum SGD", [](lbann::lbann_comm& comm) {
+        return lbann::make_unique<lbann::sgd>(&comm, 0.1, 0.9);
+      }},
+    {"Nesterov SGD", [](lbann::lbann_comm& comm) {
+        return lbann::make_unique<lbann::sgd>(&comm, 0.1, 0.9, true);
+      }},
+    {"Adam", [](lbann::lbann_comm& comm) {
+        return lbann::make_unique<lbann::adam>(&comm, 0.01);
+      }},
+    {"AdaGrad", [](lbann::lbann_comm& comm) {
+        return lbann::make_unique<lbann::adagrad>(&comm, 0.1);
+      }},
+  };
+}
+
+} // namespace
+
+TEST_CASE("Sparse gradient steps match dense steps",
+          "[optimizer][sparse][mpi]") {
+
+  auto& comm = unit_test::utilities::get_current_comm();
+  const int rank = comm.get_rank_in_trainer();
+  const auto& grid = comm.get_trainer_grid();
+  constexpr DataType scale = 0.5;
+  constexpr int num_steps = 3;
+
+  for (const auto& opt : get_optimizers()) {
+    DYNAMIC_SECTION(opt.first) {
+
+      SECTION("Sparse contributions with repeated columns") {
+        auto sparse = make_weights(comm, opt.second);
+        auto dense = make_weights(comm, opt.second);
+        std::vector<El::Int> columns;
+        lbann::CPUMat values;
+        lbann::StarMat<El::Device::CPU> dense_values(grid);
+        for (int step = 0; step < num_steps; ++step) {
+          get_contribution(rank, step, columns, values);
+          densify(columns, values, dense_values);
+          sparse->get_optimizer()->add_to_sparse_gradient(columns, values,
+                                                          scale);
+          dense->get_optimizer()->add_to_gradient(dense_values, scale, true);
+          sparse->get_optimizer()->step();
+          dense->get_optimizer()->step();
+          sparse->get_optimizer()->clear_gradient();
+          dense->get_optimizer()->clear_gradient();
+          check_values(*sparse, *dense);
+        }
+      }
+
+      SECTION("Sparse and dense contributions in the same step") {
+        auto mixed = make_weights(comm, opt.second);
+        auto dense = make_weights(comm, opt.second);
+        std::vector<El::Int> columns;
+        lbann::CPUMat values;
+        lbann::StarMat<El::Device::CPU> dense_values(grid), extra(grid);
+        El::Ones(extra, height, width);
+        for (int step = 0; step < num_steps; ++step) {
+          get_contribution(rank, step, columns, values);
+          densify(columns, values, dense_values);
+          mixed->get_optimizer()->add_to_sparse_gradient(columns, values,
+                                                         scale);
+          mixed->get_optimizer()->add_to_gradient(extra, scale, true);
+          dense->get_optimizer()->add_to_gradient(dense_values, scale, true);
+          dense->get_optimizer()->add_to_gradient(extra, scale, true);
+          mixed->get_optimizer()->step();
+          dense->get_optimizer()->step();
+          mixed->get_optimizer()->clear_gradient();
+          dense->get_optimizer()->clear_gradient();
+          check_values(*mixed, *dense);
+        }
+      }
+
+      SECTION("Distributed weights densify sparse contributions") {
+        auto distributed = make_weights(comm, opt.second, El::MC, El::MR);
+        auto dense = make_weights(comm, opt.second);
+        std::vector<El::Int> columns;
+        lbann::CPUMat values;
+        lbann::StarMat<El::Device::CPU> dense_values(grid);
+        for (int step = 0; step < num_steps; ++step) {
+          get_contribution(rank, step, columns, values);
+          densify(columns, values, dense_values);
+          distributed->get_optimizer()->add_to_sparse_gradient(columns, values,
+                                                               scale);
+          dense->get_optimizer()->add_to_gradient(dense_values, scale, true);
+          distributed->get_optimizer()->step();
+          dense->get_optimizer()->step();
+          distributed->get_optimizer()->clear_gradient();
+          dense->get_optimizer()->clear_gradient();
+          check_values(*distributed, *dense);
+        }
+      }
+
+    }
+  }
+
+}
+
+TEST_CASE("Sparse steps do not update unused columns",
+          "[optimizer][sparse][mpi]") {
+
+  auto& comm = unit_test::utilities::get_current_comm();
+  const int rank = comm.get_rank_in_trainer();
+
+  // Adam moves entries with zero gradient in a dense step, so only a
+  // lazy update leaves them unchanged
+  for (const auto& opt : get_optimizers()) {
+    DYNAMIC_SECTION(opt.first) {
+      auto w = make_weights(comm, opt.second);
+      lbann::StarMat<El::Device::CPU> initial(w->get_values().Grid());
+      El::Copy(w->get_values(), initial);
+      std::vector<El::Int> columns;
+      lbann::CPUMat values;
+      get_contribution(rank, 0, columns, values);
+      w->get_optimizer()->add_to_sparse_gradient(columns, values);
+      w->get_optimizer()->step();
+      const auto& local_values = w->get_values().LockedMatrix();
+      for (El::Int i = 0; i < height; ++i) {
+        CHECK(local_values(i, width - 1) == initial.GetLocal(i, width - 1));
+        CHECK(local_values(i, 0) != initial.GetLocal(i, 0));
+      }
+    }
+  }
+
+}
@@ -52,6 +52,7 @@
 #include "lbann/layers/loss/l2_norm2.hpp"
 #include "lbann/layers/loss/mean_absolute_error.hpp"
 #include "lbann/layers/loss/mean_squared_error.hpp"
+#include "lbann/layers/loss/softmax_cross_entropy.hpp"
 #include "lbann/layers/loss/top_k_categorical_accuracy.hpp"
 #include "lbann/layers/math/binary.hpp"
 #include "lbann/layers/math/clamp.hpp"
@@ -272,10 +273,18 @@ std::unique_ptr<Layer> construct_layer(
   // Learning layers
   if (proto_layer.has_embedding()) {
     const auto& params = proto_layer.embedding();
+    embedding_pooling pooling = embedding_pooling::sum;
+    if (params.pooling() == "mean") {
+      pooling = embedding_pooling::mean;
+    } else if (!params.pooling().empty() && params.pooling() != "sum") {
+      LBANN_ERROR("invalid embedding pooling mode "
+                  "(" + params.pooling() + ")");
+    }
     if (Layout == data_layout::DATA_PARALLEL
         && Device == El::Device::CPU) {
       return lbann::make_unique<embedding_layer<data_layout::DATA_PARALLEL,El::Device::CPU>>(
-               comm, params.dictionary_size(), params.embedding_size());
+               comm, params.dictionary_size(), params.embedding_size(),
+               pooling, params.sparse_gradient());
     } else {
       LBANN_ERROR("embedding layer is only supported with "
                   "data-parallel data layout and on CPU");
@@ -675,6 +684,13 @@ std::unique_ptr<Layer> construct_layer(
   CONSTRUCT_LAYER(boolean_accuracy);
   CONSTRUCT_LAYER(boolean_false_negative);
   CONSTRUCT_LAYER(boolean_false_positive);
+  if (proto_layer.has_softmax_cross_entropy()) {
+    if (Device == El::Device::CPU) {
+      return lbann::make_unique<softmax_cross_entropy_layer<Layout, El::Device::CPU>>(comm);
+    } else {
+      LBANN_ERROR("softmax cross entropy layer is only supported on CPU");
+    }
+  }
 
   // Image layers
   if (proto_layer.has_bilinear_resize()) {
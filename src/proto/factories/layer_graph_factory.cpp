@@ -266,6 +266,9 @@ std::vector<std::unique_ptr<Layer>> construct_layer_graph(
       #endif
       l->freeze();
     }
+    if (proto_layer.activation_checkpoint()) {
+      l->set_activation_checkpoint(true);
+    }
     // Add layer to list
     layers.emplace_back(std::move(l));
 
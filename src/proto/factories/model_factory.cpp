@@ -36,6 +36,7 @@
 #include <model.pb.h>
 #include <objective_functions.pb.h>
 
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -290,6 +291,32 @@ std::unique_ptr<model> construct_model(
   if (!name.empty()) {
     m->set_name(name);
   }
+
+  // Activation recomputation is implied by checkpoint layers
+  bool recompute_activations = proto_model.recompute_activations();
+  for (int i=0; i<proto_model.layer_size(); ++i) {
+    recompute_activations = (recompute_activations
+                             || proto_model.layer(i).activation_checkpoint());
+  }
+  if (recompute_activations) {
+    m->set_activation_recomputation(
+      true,
+      proto_model.activation_checkpoint_interval());
+  }
+
+  m->set_entrywise_layer_fusion(proto_model.fuse_entrywise_layers());
+  m->set_frozen_model(proto_model.frozen_model());
+  m->set_deferred_evaluation(proto_model.deferred_evaluation_window());
+  m->set_reduced_precision_storage(
+    storage_format_from_string(proto_model.reduced_precision_storage()));
+  if (proto_model.num_pipeline_stages() > 1) {
+    const auto& boundaries = proto_model.pipeline_stage_boundaries();
+    m->set_pipeline_parallelism(
+      proto_model.num_pipeline_stages(),
+      std::max<El::Int>(proto_model.num_micro_batches(), 1),
+      std::vector<std::string>(boundaries.begin(), boundaries.end()));
+  }
+
   for (auto t : data_readers) {
     t.second->set_model(m.get());
   }
@@ -52,6 +52,19 @@ construct_objective_function(const lbann_data::ObjectiveFunction& proto_obj) {
     obj->add_term(new layer_term(params.scale_factor()));
   }
 
+  // Loss scaling
+  if (proto_obj.loss_scale() != 0.0) {
+    obj->set_loss_scale(proto_obj.loss_scale());
+  }
+  if (proto_obj.dynamic_loss_scaling()) {
+    const auto& growth_interval = proto_obj.loss_scale_growth_interval();
+    obj->set_dynamic_loss_scaling(true,
+                                  growth_interval > 0 ? growth_interval : 2000);
+    if (proto_obj.loss_scale() == 0.0) {
+      obj->set_loss_scale(65536);
+    }
+  }
+
   // Return objective function
   return obj;
 
@@ -87,7 +87,15 @@ void init_image_data_reader(const lbann_data::Reader& pb_readme, const lbann_dat
   }
 
   if (name == "imagenet") {
-    reader = new imagenet_reader(shuffle);
+    auto* reader_imagenet = new imagenet_reader(shuffle);
+    // Read samples from packed image shards instead of image files
+    const std::string& format = pb_readme.format();
+    if (format == "image_shards") {
+      reader_imagenet->set_use_image_shards(true, false);
+    } else if (format == "image_shards_mmap") {
+      reader_imagenet->set_use_image_shards(true, true);
+    }
+    reader = reader_imagenet;
   } else if (name == "multihead_siamese") {
     reader = new data_reader_multihead_siamese(pb_readme.num_image_srcs(), shuffle);
   } else if (name == "moving_mnist") {
@@ -323,7 +323,11 @@ void init_data_readers(
           shuffle);
       }
     } else if (name == "mesh") {
-      reader = new mesh_reader(shuffle);
+      auto* reader_mesh = new mesh_reader(shuffle);
+      if (readme.format() == "mesh_packed") {
+        reader_mesh->set_use_packed_file(true);
+      }
+      reader = reader_mesh;
     } else if (name == "moving_mnist") {
       reader = new moving_mnist_reader(7, 40, 40, 2);
     } else if (name == "python") {
@@ -403,6 +407,9 @@ void init_data_readers(
     }
 
     reader->set_master(master);
+    if (opts->get_bool("async_io")) {
+      reader->set_async_io(true);
+    }
 
     reader->load();
 
@@ -798,6 +805,9 @@ void get_cmdline_overrides(const lbann_comm& comm, lbann_data::LbannPB& p)
   if(opts->get_bool("serialize_io")) {
     model->set_serialize_io(opts->get_bool("serialize_io"));
   }
+  if (opts->get_bool("frozen_model")) {
+    model->set_frozen_model(true);
+  }
 
 }
 
@@ -861,6 +871,9 @@ void print_help(std::ostream& os)
        "  --num_parallel_readers=<int>\n"
        "  --num_io_threads=<int>\n"
        "      # of threads used for I/O by the data readers\n"
+       "  --async_io=<bool>\n"
+       "      read the files of each mini-batch with batched asynchronous\n"
+       "      reads (io_uring if available)\n"
        "  --serialize_io=<bool>\n"
        "      force data readers to use a single thread for I/O\n"
        "  --disable_background_io_activity=<bool>\n"
@@ -868,6 +881,9 @@ void print_help(std::ostream& os)
        "  --disable_cuda=<bool>\n"
        "     has no effect unless lbann was compiled with: LBANN_HAS_CUDNN\n"
        "  --random_seed=<int>\n"
+       "  --frozen_model=<bool>\n"
+       "      build model for forward-only inference (no optimizers or\n"
+       "      backprop tensors, batch normalization folded)\n"
        "  --objective_function<string>\n"
        "      <string> must be: categorical_cross_entropy or mean_squared_error\n"
        "  --data_layout<string>\n"
@@ -0,0 +1,397 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/direct_pooling.hpp"
+#include "lbann/utils/exception.hpp"
+#include <algorithm>
+
+namespace lbann {
+
+namespace {
+
+/** Pooling geometry for a single (sample, channel) plane.
+ *  1D and 2D data are treated as 3D data with unit leading
+ *  dimensions.
+ */
+struct pool_geometry {
+  int input_dims[3];
+  int output_dims[3];
+  int window_dims[3];
+  int pads[3];
+  int strides[3];
+  El::Int input_size;
+  El::Int output_size;
+  El::Int window_size;
+};
+
+pool_geometry make_geometry(int num_dims,
+                            const int * input_dims,
+                            const int * pads,
+                            const int * window_dims,
+                            const int * strides) {
+  if (!direct_pooling_supported(num_dims)) {
+    LBANN_ERROR("direct pooling kernels only support 1D, 2D, and 3D data "
+                "(got " + std::to_string(num_dims) + "D data)");
+  }
+  pool_geometry g;
+  const int offset = 3 - num_dims;
+  for (int d = 0; d < 3; ++d) {
+    if (d < offset) {
+      g.input_dims[d] = 1;
+      g.window_dims[d] = 1;
+      g.pads[d] = 0;
+      g.strides[d] = 1;
+    } else {
+      g.input_dims[d] = input_dims[d-offset];
+      g.window_dims[d] = window_dims[d-offset];
+      g.pads[d] = pads[d-offset];
+      g.strides[d] = strides[d-offset];
+    }
+    const int effective_dim = (g.input_dims[d] + 2 * g.pads[d]
+                               - g.window_dims[d] + 1);
+    g.output_dims[d] = (effective_dim + g.strides[d] - 1) / g.strides[d];
+  }
+  g.input_size = El::Int(g.input_dims[0]) * g.input_dims[1] * g.input_dims[2];
+  g.output_size = El::Int(g.output_dims[0]) * g.output_dims[1] * g.output_dims[2];
+  g.window_size = El::Int(g.window_dims[0]) * g.window_dims[1] * g.window_dims[2];
+  return g;
+}
+
+/** Range of output positions whose window entry at 'offset' lies
+ *  inside the input, i.e. 0 <= pos*stride - pad + offset < input_dim.
+ */
+inline void valid_range(const pool_geometry& g, int d, int offset,
+                        int& begin, int& end) {
+  const int shift = offset - g.pads[d];
+  const int stride = g.strides[d];
+  begin = (shift >= 0 ? 0 : (stride - 1 - shift) / stride);
+  end = (g.input_dims[d] - shift + stride - 1) / stride;
+  begin = std::min(begin, g.output_dims[d]);
+  end = std::max(std::min(end, g.output_dims[d]), begin);
+}
+
+/** Input position for an output position and window offset, or -1
+ *  if the position is in the padding.
+ */
+inline int input_pos(const pool_geometry& g, int d, int output_pos, int offset) {
+  const int pos = output_pos * g.strides[d] - g.pads[d] + offset;
+  return (0 <= pos && pos < g.input_dims[d]) ? pos : -1;
+}
+
+/** Update running maxima with a strided row of input entries. */
+template <typename Index>
+inline void max_update(DataType * __restrict__ output,
+                       Index * __restrict__ indices,
+                       const DataType * __restrict__ input,
+                       int stride, int begin, int end, Index index) {
+  for (int i = begin; i < end; ++i) {
+    const DataType x = input[i * stride];
+    const bool is_max = x > output[i];
+    output[i] = is_max ? x : output[i];
+    indices[i] = is_max ? index : indices[i];
+  }
+}
+
+/** Update running maxima with padding entries. */
+template <typename Index>
+inline void max_update_pad(DataType * __restrict__ output,
+                           Index * __restrict__ indices,
+                           int begin, int end, Index index) {
+  for (int i = begin; i < end; ++i) {
+    const bool is_max = DataType(0) > output[i];
+    output[i] = is_max ? DataType(0) : output[i];
+    indices[i] = is_max ? index : indices[i];
+  }
+}
+
+template <typename Index>
+void max_pool_forward_impl(const CPUMat& input,
+                           CPUMat& output,
+                           Index * indices,
+                           int num_channels,
+                           const pool_geometry& g) {
+  const int num_samples = input.Width();
+  const El::Int output_height = output.Height();
+  const int out_y_dim = g.output_dims[1];
+  const int out_x_dim = g.output_dims[2];
+  const int stride_x = g.strides[2];
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (int sample = 0; sample < num_samples; ++sample) {
+    for (int channel = 0; channel < num_channels; ++channel) {
+      const DataType * __restrict__ x = (input.LockedBuffer(0, sample)
+                                         + channel * g.input_size);
+      DataType * __restrict__ y = (output.Buffer(0, sample)
+                                   + channel * g.output_size);
+      Index * __restrict__ ind = (indices + sample * output_height
+                                  + channel * g.output_size);
+      for (int oz = 0; oz < g.output_dims[0]; ++oz) {
+        for (int oy = 0; oy < out_y_dim; ++oy) {
+          const El::Int row_offset = (El::Int(oz) * out_y_dim + oy) * out_x_dim;
+          DataType * __restrict__ y_row = y + row_offset;
+          Index * __restrict__ ind_row = ind + row_offset;
+
+          // Window entries are visited in the same order as the im2col
+          // implementation, so ties resolve to the same position
+          Index window_pos = 0;
+          for (int wz = 0; wz < g.window_dims[0]; ++wz) {
+            const int iz = input_pos(g, 0, oz, wz);
+            for (int wy = 0; wy < g.window_dims[1]; ++wy) {
+              const int iy = input_pos(g, 1, oy, wy);
+              const bool row_valid = iz >= 0 && iy >= 0;
+              const DataType * __restrict__ x_row
+                = (row_valid ?
+                   x + (El::Int(iz) * g.input_dims[1] + iy) * g.input_dims[2] :
+                   x + g.pads[2]);
+              for (int wx = 0; wx < g.window_dims[2]; ++wx, ++window_pos) {
+                int begin = 0, end = 0;
+                if (row_valid) { valid_range(g, 2, wx, begin, end); }
+                const DataType * __restrict__ x_start
+                  = x_row + (wx - g.pads[2]);
+                if (window_pos == 0) {
+                  std::fill(y_row, y_row + out_x_dim, DataType(0));
+                  std::fill(ind_row, ind_row + out_x_dim, Index(0));
+                  for (int ox = begin; ox < end; ++ox) {
+                    y_row[ox] = x_start[ox * stride_x];
+                  }
+                } else {
+                  max_update_pad(y_row, ind_row, 0, begin, window_pos);
+                  max_update(y_row, ind_row, x_start, stride_x,
+                             begin, end, window_pos);
+                  max_update_pad(y_row, ind_row, end, out_x_dim, window_pos);
+                }
+              }
+            }
+          }
+
+        }
+      }
+    }
+  }
+}
+
+template <typename Index>
+void max_pool_backward_impl(const CPUMat& gradient_wrt_output,
+                            const Index * indices,
+                            CPUMat& gradient_wrt_input,
+                            int num_channels,
+                            const pool_geometry& g) {
+  const int num_samples = gradient_wrt_output.Width();
+  const El::Int output_height = gradient_wrt_output.Height();
+  const int window_yx = g.window_dims[1] * g.window_dims[2];
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (int sample = 0; sample < num_samples; ++sample) {
+    for (int channel = 0; channel < num_channels; ++channel) {
+      const DataType * __restrict__ dy
+        = (gradient_wrt_output.LockedBuffer(0, sample)
+           + channel * g.output_size);
+      const Index * __restrict__ ind = (indices + sample * output_height
+                                        + channel * g.output_size);
+      DataType * __restrict__ dx = (gradient_wrt_input.Buffer(0, sample)
+                                    + channel * g.input_size);
+      std::fill(dx, dx + g.input_size, DataType(0));
+      El::Int output_index = 0;
+      for (int oz = 0; oz < g.output_dims[0]; ++oz) {
+        for (int oy = 0; oy < g.output_dims[1]; ++oy) {
+          for (int ox = 0; ox < g.output_dims[2]; ++ox, ++output_index) {
+            const int window_pos = ind[output_index];
+            const int wz = window_pos / window_yx;
+            const int wy = (window_pos % window_yx) / g.window_dims[2];
+            const int wx = window_pos % g.window_dims[2];
+            const int iz = input_pos(g, 0, oz, wz);
+            const int iy = input_pos(g, 1, oy, wy);
+            const int ix = input_pos(g, 2, ox, wx);
+            if (iz >= 0 && iy >= 0 && ix >= 0) {
+              const El::Int input_index
+                = ((El::Int(iz) * g.input_dims[1] + iy) * g.input_dims[2] + ix);
+              dx[input_index] += dy[output_index];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+void max_pool_forward(const CPUMat& input,
+                      CPUMat& output,
+                      max_pool_indices& indices,
+                      const int num_channels,
+                      const int num_dims,
+                      const int * input_dims,
+                      const int * pads,
+                      const int * window_dims,
+                      const int * strides) {
+  const auto& g = make_geometry(num_dims, input_dims, pads,
+                                window_dims, strides);
+  indices.resize(output.Height() * output.Width(), g.window_size);
+  if (indices.is_wide()) {
+    max_pool_forward_impl(input, output, indices.wide_data(),
+                          num_channels, g);
+  } else {
+    max_pool_forward_impl(input, output, indices.narrow_data(),
+                          num_channels, g);
+  }
+}
+
+void max_pool_backward(const CPUMat& gradient_wrt_output,
+                       const max_pool_indices& indices,
+                       CPUMat& gradient_wrt_input,
+                       const int num_channels,
+                       const int num_dims,
+                       const int * input_dims,
+                       const int * pads,
+                       const int * window_dims,
+                       const int * strides) {
+  const auto& g = make_geometry(num_dims, input_dims, pads,
+                                window_dims, strides);
+  if (indices.size() != (gradient_wrt_output.Height()
+                         * gradient_wrt_output.Width())) {
+    LBANN_ERROR("max pooling indices do not match gradient w.r.t. output "
+                "(did forward propagation run with the same mini-batch?)");
+  }
+  if (indices.is_wide()) {
+    max_pool_backward_impl(gradient_wrt_output, indices.wide_data(),
+                           gradient_wrt_input, num_channels, g);
+  } else {
+    max_pool_backward_impl(gradient_wrt_output, indices.narrow_data(),
+                           gradient_wrt_input, num_channels, g);
+  }
+}
+
+void average_pool_forward(const CPUMat& input,
+                          CPUMat& output,
+                          const int num_channels,
+                          const int num_dims,
+                          const int * input_dims,
+                          const int * pads,
+                          const int * window_dims,
+                          const int * strides) {
+  const auto& g = make_geometry(num_dims, input_dims, pads,
+                                window_dims, strides);
+  const int num_samples = input.Width();
+  const int out_y_dim = g.output_dims[1];
+  const int out_x_dim = g.output_dims[2];
+  const int stride_x = g.strides[2];
+  const DataType window_size = g.window_size;
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (int sample = 0; sample < num_samples; ++sample) {
+    for (int channel = 0; channel < num_channels; ++channel) {
+      const DataType * __restrict__ x = (input.LockedBuffer(0, sample)
+                                         + channel * g.input_size);
+      DataType * __restrict__ y = (output.Buffer(0, sample)
+                                   + channel * g.output_size);
+      for (int oz = 0; oz < g.output_dims[0]; ++oz) {
+        for (int oy = 0; oy < out_y_dim; ++oy) {
+          DataType * __restrict__ y_row
+            = y + (El::Int(oz) * out_y_dim + oy) * out_x_dim;
+          std::fill(y_row, y_row + out_x_dim, DataType(0));
+          for (int wz = 0; wz < g.window_dims[0]; ++wz) {
+            const int iz = input_pos(g, 0, oz, wz);
+            if (iz < 0) { continue; }
+            for (int wy = 0; wy < g.window_dims[1]; ++wy) {
+              const int iy = input_pos(g, 1, oy, wy);
+              if (iy < 0) { continue; }
+              const DataType * __restrict__ x_row
+                = x + (El::Int(iz) * g.input_dims[1] + iy) * g.input_dims[2];
+              for (int wx = 0; wx < g.window_dims[2]; ++wx) {
+                int begin, end;
+                valid_range(g, 2, wx, begin, end);
+                const DataType * __restrict__ x_start
+                  = x_row + (wx - g.pads[2]);
+                for (int ox = begin; ox < end; ++ox) {
+                  y_row[ox] += x_start[ox * stride_x];
+                }
+              }
+            }
+          }
+          for (int ox = 0; ox < out_x_dim; ++ox) {
+            y_row[ox] /= window_size;
+          }
+        }
+      }
+    }
+  }
+}
+
+void average_pool_backward(const CPUMat& gradient_wrt_output,
+                           CPUMat& gradient_wrt_input,
+                           const int num_channels,
+                           const int num_dims,
+                           const int * input_dims,
+                           const int * pads,
+                           const int * window_dims,
+                           const int * strides) {
+  const auto& g = make_geometry(num_dims, input_dims, pads,
+                                window_dims, strides);
+  const int num_samples = gradient_wrt_output.Width();
+  const int out_y_dim = g.output_dims[1];
+  const int out_x_dim = g.output_dims[2];
+  const int stride_x = g.strides[2];
+  const DataType window_size = g.window_size;
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (int sample = 0; sample < num_samples; ++sample) {
+    for (int channel = 0; channel < num_channels; ++channel) {
+      const DataType * __restrict__ dy
+        = (gradient_wrt_output.LockedBuffer(0, sample)
+           + channel * g.output_size);
+      DataType * __restrict__ dx = (gradient_wrt_input.Buffer(0, sample)
+                                    + channel * g.input_size);
+      std::fill(dx, dx + g.input_size, DataType(0));
+      std::vector<DataType> dy_row(out_x_dim);
+      for (int oz = 0; oz < g.output_dims[0]; ++oz) {
+        for (int oy = 0; oy < out_y_dim; ++oy) {
+          const DataType * __restrict__ dy_start
+            = dy + (El::Int(oz) * out_y_dim + oy) * out_x_dim;
+          for (int ox = 0; ox < out_x_dim; ++ox) {
+            dy_row[ox] = dy_start[ox] / window_size;
+          }
+          for (int wz = 0; wz < g.window_dims[0]; ++wz) {
+            const int iz = input_pos(g, 0, oz, wz);
+            if (iz < 0) { continue; }
+            for (int wy = 0; wy < g.window_dims[1]; ++wy) {
+              const int iy = input_pos(g, 1, oy, wy);
+              if (iy < 0) { continue; }
+              DataType * __restrict__ dx_row
+                = dx + (El::Int(iz) * g.input_dims[1] + iy) * g.input_dims[2];
+              for (int wx = 0; wx < g.window_dims[2]; ++wx) {
+                int begin, end;
+                valid_range(g, 2, wx, begin, end);
+                DataType * __restrict__ dx_start = dx_row + (wx - g.pads[2]);
+                for (int ox = begin; ox < end; ++ox) {
+                  dx_start[ox * stride_x] += dy_row[ox];
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace lbann
@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/fused_entrywise.hpp"
+#include <algorithm>
+
+namespace lbann {
+
+namespace {
+
+/** Number of entries processed at a time.
+ *  Intermediate values for a tile should fit in L1 cache.
+ */
+constexpr El::Int tile_size = 1024;
+
+/** Forward prop through a chain of operators.
+ *  If @c stored_input is not null, each input tile is also written
+ *  to it in reduced precision before the operators are applied.
+ */
+void fused_fp_impl(
+  const std::vector<const entrywise_fusion_interface*>& ops,
+  El::Int height, El::Int width,
+  const DataType* input, El::Int input_ldim,
+  DataType* output, El::Int output_ldim,
+  storage_format stored_input_format, uint16_t* stored_input) {
+  if (ops.empty()) { return; }
+  const El::Int num_tiles = (height + tile_size - 1) / tile_size;
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int tile = 0; tile < num_tiles; ++tile) {
+      const El::Int offset = tile * tile_size;
+      const El::Int size = std::min(tile_size, height - offset);
+      const auto* x = input + offset + col * input_ldim;
+      auto* y = output + offset + col * output_ldim;
+      if (stored_input != nullptr) {
+        encode_reduced_precision(stored_input_format, x,
+                                 stored_input + offset + col * height,
+                                 size);
+      }
+      ops.front()->fp_compute_entrywise(x, y, size);
+      for (size_t i = 1; i < ops.size(); ++i) {
+        ops[i]->fp_compute_entrywise(y, y, size);
+      }
+    }
+  }
+}
+
+/** Backprop through a chain of operators.
+ *  If @c stored_input is not null, each input tile is first decoded
+ *  from it into @c input. If @c stored_gradient_wrt_input is not
+ *  null, each tile of the result is also written to it in reduced
+ *  precision.
+ */
+void fused_bp_impl(
+  const std::vector<const entrywise_fusion_interface*>& ops,
+  El::Int height, El::Int width,
+  storage_format stored_input_format, const uint16_t* stored_input,
+  DataType* input, El::Int input_ldim,
+  const DataType* gradient_wrt_output, El::Int gradient_wrt_output_ldim,
+  DataType* gradient_wrt_input, El::Int gradient_wrt_input_ldim,
+  storage_format stored_gradient_wrt_input_format,
+  uint16_t* stored_gradient_wrt_input,
+  std::vector<DataType>& workspace) {
+  if (ops.empty()) { return; }
+  const El::Int num_tiles = (height + tile_size - 1) / tile_size;
+  const El::Int num_ops = ops.size();
+
+  // Each thread stores intermediate values for one tile
+  const El::Int thread_workspace_size = (num_ops - 1) * tile_size;
+  workspace.resize(omp_get_max_threads() * thread_workspace_size);
+
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int tile = 0; tile < num_tiles; ++tile) {
+      const El::Int offset = tile * tile_size;
+      const El::Int size = std::min(tile_size, height - offset);
+      auto* x = input + offset + col * input_ldim;
+      const auto* dy = (gradient_wrt_output + offset
+                        + col * gradient_wrt_output_ldim);
+      auto* dx = (gradient_wrt_input + offset
+                  + col * gradient_wrt_input_ldim);
+      auto* ws = (workspace.data()
+                  + omp_get_thread_num() * thread_workspace_size);
+
+      // Restore input tile from reduced-precision storage
+      if (stored_input != nullptr) {
+        decode_reduced_precision(stored_input_format,
+                                 stored_input + offset + col * height,
+                                 x, size);
+      }
+
+      // Recompute inputs to each fused operator
+      // Note: The input to operator i is stored in workspace
+      // position i-1.
+      for (El::Int i = 1; i < num_ops; ++i) {
+        const auto* in = (i == 1) ? x : ws + (i-2) * tile_size;
+        ops[i-1]->fp_compute_entrywise(in, ws + (i-1) * tile_size, size);
+      }
+
+      // Apply backprop functions in reverse order
+      const DataType* grad = dy;
+      for (El::Int i = num_ops - 1; i >= 0; --i) {
+        const auto* in = (i == 0) ? x : ws + (i-1) * tile_size;
+        ops[i]->bp_compute_entrywise(in, grad, dx, size);
+        grad = dx;
+      }
+
+      // Store result in reduced precision
+      if (stored_gradient_wrt_input != nullptr) {
+        encode_reduced_precision(stored_gradient_wrt_input_format, dx,
+                                 (stored_gradient_wrt_input
+                                  + offset + col * height),
+                                 size);
+      }
+
+    }
+  }
+
+}
+
+} // namespace
+
+void fused_entrywise_fp(
+  const std::vector<const entrywise_fusion_interface*>& ops,
+  El::Int height, El::Int width,
+  const DataType* input, El::Int input_ldim,
+  DataType* output, El::Int output_ldim) {
+  fused_fp_impl(ops, height, width, input, input_ldim,
+                output, output_ldim, storage_format::full, nullptr);
+}
+
+void fused_entrywise_fp(
+  const std::vector<const entrywise_fusion_interface*>& ops,
+  El::Int height, El::Int width,
+  const DataType* input, El::Int input_ldim,
+  DataType* output, El::Int output_ldim,
+  storage_format stored_input_format, uint16_t* stored_input) {
+  fused_fp_impl(ops, height, width, input, input_ldim,
+                output, output_ldim, stored_input_format, stored_input);
+}
+
+void fused_entrywise_bp(
+  const std::vector<const entrywise_fusion_interface*>& ops,
+  El::Int height, El::Int width,
+  const DataType* input, El::Int input_ldim,
+  const DataType* gradient_wrt_output, El::Int gradient_wrt_output_ldim,
+  DataType* gradient_wrt_input, El::Int gradient_wrt_input_ldim,
+  std::vector<DataType>& workspace) {
+  fused_bp_impl(ops, height, width,
+                storage_format::full, nullptr,
+                const_cast<DataType*>(input), input_ldim,
+                gradient_wrt_output, gradient_wrt_output_ldim,
+                gradient_wrt_input, gradient_wrt_input_ldim,
+                storage_format::full, nullptr,
+                workspace);
+}
+
+void fused_entrywise_bp(
+  const std::vector<const entrywise_fusion_interface*>& ops,
+  El::Int height, El::Int width,
+  storage_format stored_input_format, const uint16_t* stored_input,
+  DataType* input, El::Int input_ldim,
+  const DataType* gradient_wrt_output, El::Int gradient_wrt_output_ldim,
+  DataType* gradient_wrt_input, El::Int gradient_wrt_input_ldim,
+  storage_format stored_gradient_wrt_input_format,
+  uint16_t* stored_gradient_wrt_input,
+  std::vector<DataType>& workspace) {
+  fused_bp_impl(ops, height, width,
+                stored_input_format, stored_input,
+                input, input_ldim,
+                gradient_wrt_output, gradient_wrt_output_ldim,
+                gradient_wrt_input, gradient_wrt_input_ldim,
+                stored_gradient_wrt_input_format, stored_gradient_wrt_input,
+                workspace);
+}
+
+} // namespace lbann
@@ -0,0 +1,390 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/grouped_convolution.hpp"
+#include "lbann/utils/exception.hpp"
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+namespace lbann {
+
+namespace {
+
+/** Convolution geometry. 1D and 2D data are treated as 3D data with
+ *  unit leading dimensions.
+ */
+struct conv_geometry {
+  int input_dims[3];
+  int output_dims[3];
+  int kernel_dims[3];
+  int pads[3];
+  int strides[3];
+  El::Int input_size;
+  El::Int output_size;
+  El::Int kernel_size;
+  int num_input_channels;
+  int num_output_channels;
+  int input_channels_per_group;
+  int output_channels_per_group;
+};
+
+conv_geometry make_geometry(int num_input_channels,
+                            int num_output_channels,
+                            int num_groups,
+                            int num_dims,
+                            const int * input_dims,
+                            const int * pads,
+                            const int * kernel_dims,
+                            const int * strides) {
+  if (!direct_grouped_convolution_supported(num_dims)) {
+    LBANN_ERROR("direct grouped convolution kernels only support "
+                "1D, 2D, and 3D data "
+                "(got " + std::to_string(num_dims) + "D data)");
+  }
+  if (num_groups < 1
+      || num_input_channels % num_groups != 0
+      || num_output_channels % num_groups != 0) {
+    std::stringstream err;
+    err << "invalid number of groups (" << num_groups << ") "
+        << "for convolution with " << num_input_channels << " input "
+        << "channels and " << num_output_channels << " output channels";
+    LBANN_ERROR(err.str());
+  }
+  conv_geometry g;
+  const int offset = 3 - num_dims;
+  for (int d = 0; d < 3; ++d) {
+    if (d < offset) {
+      g.input_dims[d] = 1;
+      g.kernel_dims[d] = 1;
+      g.pads[d] = 0;
+      g.strides[d] = 1;
+    } else {
+      g.input_dims[d] = input_dims[d-offset];
+      g.kernel_dims[d] = kernel_dims[d-offset];
+      g.pads[d] = pads[d-offset];
+      g.strides[d] = strides[d-offset];
+    }
+    const int effective_dim = (g.input_dims[d] + 2 * g.pads[d]
+                               - g.kernel_dims[d] + 1);
+    g.output_dims[d] = (effective_dim + g.strides[d] - 1) / g.strides[d];
+  }
+  g.input_size = El::Int(g.input_dims[0]) * g.input_dims[1] * g.input_dims[2];
+  g.output_size = El::Int(g.output_dims[0]) * g.output_dims[1] * g.output_dims[2];
+  g.kernel_size = El::Int(g.kernel_dims[0]) * g.kernel_dims[1] * g.kernel_dims[2];
+  g.num_input_channels = num_input_channels;
+  g.num_output_channels = num_output_channels;
+  g.input_channels_per_group = num_input_channels / num_groups;
+  g.output_channels_per_group = num_output_channels / num_groups;
+  return g;
+}
+
+/** Make sure matrix dimensions match convolution geometry. */
+void check_matrices(const conv_geometry& g,
+                    const CPUMat& input,
+                    const CPUMat& output,
+                    const CPUMat& kernel) {
+  const El::Int kernel_size = (g.kernel_size * g.num_output_channels
+                               * g.input_channels_per_group);
+  if (input.Height() != g.input_size * g.num_input_channels
+      || output.Height() != g.output_size * g.num_output_channels
+      || input.Width() != output.Width()
+      || kernel.Height() * kernel.Width() != kernel_size
+      || (kernel.Width() > 1 && kernel.LDim() != kernel.Height())) {
+    std::stringstream err;
+    err << "grouped convolution expected "
+        << g.input_size * g.num_input_channels << " x " << input.Width()
+        << " input, "
+        << g.output_size * g.num_output_channels << " x " << input.Width()
+        << " output, and contiguous kernel with " << kernel_size
+        << " entries, but got "
+        << input.Height() << " x " << input.Width() << " input, "
+        << output.Height() << " x " << output.Width() << " output, and "
+        << kernel.Height() << " x " << kernel.Width() << " kernel";
+    LBANN_ERROR(err.str());
+  }
+}
+
+/** Range of output positions whose kernel entry at 'offset' lies
+ *  inside the input, i.e. 0 <= pos*stride - pad + offset < input_dim.
+ */
+inline void valid_range(const conv_geometry& g, int d, int offset,
+                        int& begin, int& end) {
+  const int shift = offset - g.pads[d];
+  const int stride = g.strides[d];
+  begin = (shift >= 0 ? 0 : (stride - 1 - shift) / stride);
+  end = (g.input_dims[d] - shift + stride - 1) / stride;
+  begin = std::min(begin, g.output_dims[d]);
+  end = std::max(std::min(end, g.output_dims[d]), begin);
+}
+
+/** Input position for an output position and kernel offset, or -1
+ *  if the position is in the padding.
+ */
+inline int input_pos(const conv_geometry& g, int d, int output_pos, int offset) {
+  const int pos = output_pos * g.strides[d] - g.pads[d] + offset;
+  return (0 <= pos && pos < g.input_dims[d]) ? pos : -1;
+}
+
+/** Compute y[i] += a * x[i*stride+offset] over a range. */
+inline void axpy_row(DataType a,
+                     const DataType * __restrict__ x,
+                     DataType * __restrict__ y,
+                     int stride, int offset, int begin, int end) {
+  for (int i = begin; i < end; ++i) {
+    y[i] += a * x[i * stride + offset];
+  }
+}
+
+/** Compute x[i*stride+offset] += a * y[i] over a range. */
+inline void scatter_axpy_row(DataType a,
+                             const DataType * __restrict__ y,
+                             DataType * __restrict__ x,
+                             int stride, int offset, int begin, int end) {
+  for (int i = begin; i < end; ++i) {
+    x[i * stride + offset] += a * y[i];
+  }
+}
+
+/** Compute z[i] += x[i*stride+offset] * y[i] over a range. */
+inline void multiply_add_row(const DataType * __restrict__ x,
+                             const DataType * __restrict__ y,
+                             DataType * __restrict__ z,
+                             int stride, int offset, int begin, int end) {
+  for (int i = begin; i < end; ++i) {
+    z[i] += x[i * stride + offset] * y[i];
+  }
+}
+
+} // namespace
+
+void grouped_convolution_forward(const CPUMat& input,
+                                 const CPUMat& kernel,
+                                 CPUMat& output,
+                                 const int num_input_channels,
+                                 const int num_output_channels,
+                                 const int num_groups,
+                                 const int num_dims,
+                                 const int * input_dims,
+                                 const int * pads,
+                                 const int * kernel_dims,
+                                 const int * strides) {
+  const auto& g = make_geometry(num_input_channels, num_output_channels,
+                                num_groups, num_dims, input_dims,
+                                pads, kernel_dims, strides);
+  check_matrices(g, input, output, kernel);
+  const int num_samples = input.Width();
+  const int out_y_dim = g.output_dims[1];
+  const int out_x_dim = g.output_dims[2];
+  const int stride_x = g.strides[2];
+  const DataType * w = kernel.LockedBuffer();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (int sample = 0; sample < num_samples; ++sample) {
+    for (int out_channel = 0; out_channel < num_output_channels; ++out_channel) {
+      const int group = out_channel / g.output_channels_per_group;
+      DataType * __restrict__ y = (output.Buffer(0, sample)
+                                   + out_channel * g.output_size);
+      std::fill(y, y + g.output_size, DataType(0));
+      for (int oz = 0; oz < g.output_dims[0]; ++oz) {
+        for (int oy = 0; oy < out_y_dim; ++oy) {
+          DataType * __restrict__ y_row
+            = y + (El::Int(oz) * out_y_dim + oy) * out_x_dim;
+          for (int i = 0; i < g.input_channels_per_group; ++i) {
+            const int in_channel = group * g.input_channels_per_group + i;
+            const DataType * __restrict__ x
+              = (input.LockedBuffer(0, sample) + in_channel * g.input_size);
+            const DataType * __restrict__ w_channel
+              = w + (El::Int(out_channel) * g.input_channels_per_group + i) * g.kernel_size;
+            for (int kz = 0; kz < g.kernel_dims[0]; ++kz) {
+              const int iz = input_pos(g, 0, oz, kz);
+              if (iz < 0) { continue; }
+              for (int ky = 0; ky < g.kernel_dims[1]; ++ky) {
+                const int iy = input_pos(g, 1, oy, ky);
+                if (iy < 0) { continue; }
+                const DataType * __restrict__ x_row
+                  = x + (El::Int(iz) * g.input_dims[1] + iy) * g.input_dims[2];
+                const DataType * __restrict__ w_row
+                  = w_channel + (kz * g.kernel_dims[1] + ky) * g.kernel_dims[2];
+                for (int kx = 0; kx < g.kernel_dims[2]; ++kx) {
+                  int begin, end;
+                  valid_range(g, 2, kx, begin, end);
+                  axpy_row(w_row[kx], x_row, y_row,
+                           stride_x, kx - g.pads[2], begin, end);
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+void grouped_convolution_backward_data(const CPUMat& gradient_wrt_output,
+                                       const CPUMat& kernel,
+                                       CPUMat& gradient_wrt_input,
+                                       const int num_input_channels,
+                                       const int num_output_channels,
+                                       const int num_groups,
+                                       const int num_dims,
+                                       const int * input_dims,
+                                       const int * pads,
+                                       const int * kernel_dims,
+                                       const int * strides) {
+  const auto& g = make_geometry(num_input_channels, num_output_channels,
+                                num_groups, num_dims, input_dims,
+                                pads, kernel_dims, strides);
+  check_matrices(g, gradient_wrt_input, gradient_wrt_output, kernel);
+  const int num_samples = gradient_wrt_output.Width();
+  const int out_y_dim = g.output_dims[1];
+  const int out_x_dim = g.output_dims[2];
+  const int stride_x = g.strides[2];
+  const DataType * w = kernel.LockedBuffer();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (int sample = 0; sample < num_samples; ++sample) {
+    for (int in_channel = 0; in_channel < num_input_channels; ++in_channel) {
+      const int group = in_channel / g.input_channels_per_group;
+      const int i = in_channel % g.input_channels_per_group;
+      DataType * __restrict__ dx = (gradient_wrt_input.Buffer(0, sample)
+                                    + in_channel * g.input_size);
+      std::fill(dx, dx + g.input_size, DataType(0));
+      for (int oz = 0; oz < g.output_dims[0]; ++oz) {
+        for (int oy = 0; oy < out_y_dim; ++oy) {
+          for (int j = 0; j < g.output_channels_per_group; ++j) {
+            const int out_channel = group * g.output_channels_per_group + j;
+            const DataType * __restrict__ dy_row
+              = (gradient_wrt_output.LockedBuffer(0, sample)
+                 + out_channel * g.output_size
+                 + (El::Int(oz) * out_y_dim + oy) * out_x_dim);
+            const DataType * __restrict__ w_channel
+              = w + (El::Int(out_channel) * g.input_channels_per_group + i) * g.kernel_size;
+            for (int kz = 0; kz < g.kernel_dims[0]; ++kz) {
+              const int iz = input_pos(g, 0, oz, kz);
+              if (iz < 0) { continue; }
+              for (int ky = 0; ky < g.kernel_dims[1]; ++ky) {
+                const int iy = input_pos(g, 1, oy, ky);
+                if (iy < 0) { continue; }
+                DataType * __restrict__ dx_row
+                  = dx + (El::Int(iz) * g.input_dims[1] + iy) * g.input_dims[2];
+                const DataType * __restrict__ w_row
+                  = w_channel + (kz * g.kernel_dims[1] + ky) * g.kernel_dims[2];
+                for (int kx = 0; kx < g.kernel_dims[2]; ++kx) {
+                  int begin, end;
+                  valid_range(g, 2, kx, begin, end);
+                  scatter_axpy_row(w_row[kx], dy_row, dx_row,
+                                   stride_x, kx - g.pads[2], begin, end);
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+void grouped_convolution_backward_filter(const CPUMat& input,
+                                         const CPUMat& gradient_wrt_output,
+                                         CPUMat& gradient_wrt_kernel,
+                                         const DataType scale,
+                                         const int num_input_channels,
+                                         const int num_output_channels,
+                                         const int num_groups,
+                                         const int num_dims,
+                                         const int * input_dims,
+                                         const int * pads,
+                                         const int * kernel_dims,
+                                         const int * strides) {
+  const auto& g = make_geometry(num_input_channels, num_output_channels,
+                                num_groups, num_dims, input_dims,
+                                pads, kernel_dims, strides);
+  check_matrices(g, input, gradient_wrt_output, gradient_wrt_kernel);
+  const int num_samples = input.Width();
+  const int in_channels_per_group = g.input_channels_per_group;
+  const int out_y_dim = g.output_dims[1];
+  const int out_x_dim = g.output_dims[2];
+  const int stride_x = g.strides[2];
+  DataType * dw = gradient_wrt_kernel.Buffer();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (int out_channel = 0; out_channel < num_output_channels; ++out_channel) {
+    for (int i = 0; i < in_channels_per_group; ++i) {
+      const int group = out_channel / g.output_channels_per_group;
+      const int in_channel = group * in_channels_per_group + i;
+
+      // Accumulate products elementwise along the output rows so the
+      // inner loop vectorizes, then reduce once at the end
+      std::vector<DataType> partial_sums(g.kernel_size * out_x_dim,
+                                         DataType(0));
+      for (int sample = 0; sample < num_samples; ++sample) {
+        const DataType * __restrict__ x = (input.LockedBuffer(0, sample)
+                                           + in_channel * g.input_size);
+        const DataType * __restrict__ dy
+          = (gradient_wrt_output.LockedBuffer(0, sample)
+             + out_channel * g.output_size);
+        for (int oz = 0; oz < g.output_dims[0]; ++oz) {
+          for (int oy = 0; oy < out_y_dim; ++oy) {
+            const DataType * __restrict__ dy_row
+              = dy + (El::Int(oz) * out_y_dim + oy) * out_x_dim;
+            for (int kz = 0; kz < g.kernel_dims[0]; ++kz) {
+              const int iz = input_pos(g, 0, oz, kz);
+              if (iz < 0) { continue; }
+              for (int ky = 0; ky < g.kernel_dims[1]; ++ky) {
+                const int iy = input_pos(g, 1, oy, ky);
+                if (iy < 0) { continue; }
+                const DataType * __restrict__ x_row
+                  = x + (El::Int(iz) * g.input_dims[1] + iy) * g.input_dims[2];
+                for (int kx = 0; kx < g.kernel_dims[2]; ++kx) {
+                  int begin, end;
+                  valid_range(g, 2, kx, begin, end);
+                  const El::Int kernel_pos
+                    = (El::Int(kz) * g.kernel_dims[1] + ky) * g.kernel_dims[2] + kx;
+                  multiply_add_row(x_row, dy_row,
+                                   &partial_sums[kernel_pos * out_x_dim],
+                                   stride_x, kx - g.pads[2], begin, end);
+                }
+              }
+            }
+          }
+        }
+      }
+
+      // Reduce partial sums and update kernel gradient
+      DataType * __restrict__ dw_channel
+        = dw + (El::Int(out_channel) * in_channels_per_group + i) * g.kernel_size;
+      for (El::Int kernel_pos = 0; kernel_pos < g.kernel_size; ++kernel_pos) {
+        const DataType * partial_row = &partial_sums[kernel_pos * out_x_dim];
+        DataType sum = 0;
+        for (int ox = 0; ox < out_x_dim; ++ox) {
+          sum += partial_row[ox];
+        }
+        dw_channel[kernel_pos] += scale * sum;
+      }
+
+    }
+  }
+}
+
+} // namespace lbann
@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/memory_planner.hpp"
+#include "lbann/utils/exception.hpp"
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <utility>
+
+namespace lbann {
+
+El::Int memory_planner::add_buffer(El::Int size,
+                                   El::Int first_use,
+                                   El::Int last_use) {
+  if (size < 0 || first_use > last_use) {
+    std::stringstream err;
+    err << "attempted to add buffer with invalid size or lifetime "
+        << "(size=" << size << ", "
+        << "first use=" << first_use << ", "
+        << "last use=" << last_use << ")";
+    LBANN_ERROR(err.str());
+  }
+  m_buffers.push_back({size, first_use, last_use, -1, 0});
+  m_planned_size = -1;
+  return m_buffers.size() - 1;
+}
+
+El::Int memory_planner::add_alias(El::Int buffer,
+                                  El::Int first_use,
+                                  El::Int last_use) {
+  if (buffer < 0 || buffer >= get_num_buffers()) {
+    std::stringstream err;
+    err << "attempted to alias invalid buffer index " << buffer << " "
+        << "(" << get_num_buffers() << " buffers registered)";
+    LBANN_ERROR(err.str());
+  }
+  if (first_use > last_use) {
+    std::stringstream err;
+    err << "attempted to add alias with invalid lifetime "
+        << "(first use=" << first_use << ", "
+        << "last use=" << last_use << ")";
+    LBANN_ERROR(err.str());
+  }
+
+  // Extend lifetime of aliased storage
+  const auto& root = get_root(buffer);
+  auto& root_info = m_buffers[root];
+  root_info.first_use = std::min(root_info.first_use, first_use);
+  root_info.last_use = std::max(root_info.last_use, last_use);
+
+  m_buffers.push_back({root_info.size, first_use, last_use, root, 0});
+  m_planned_size = -1;
+  return m_buffers.size() - 1;
+}
+
+El::Int memory_planner::get_root(El::Int buffer) const {
+  while (m_buffers[buffer].alias >= 0) {
+    buffer = m_buffers[buffer].alias;
+  }
+  return buffer;
+}
+
+void memory_planner::plan() {
+
+  // Place large buffers first
+  std::vector<El::Int> order;
+  for (El::Int i = 0; i < get_num_buffers(); ++i) {
+    if (m_buffers[i].alias < 0) { order.push_back(i); }
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [this](El::Int a, El::Int b) {
+                     const auto& info_a = m_buffers[a];
+                     const auto& info_b = m_buffers[b];
+                     if (info_a.size != info_b.size) {
+                       return info_a.size > info_b.size;
+                     }
+                     return info_a.first_use < info_b.first_use;
+                   });
+
+  // Assign each buffer to the smallest gap between placed buffers
+  // with overlapping lifetimes
+  m_planned_size = 0;
+  std::vector<El::Int> placed;
+  std::vector<std::pair<El::Int,El::Int>> conflicts;
+  for (const auto& i : order) {
+    auto& info = m_buffers[i];
+    conflicts.clear();
+    for (const auto& j : placed) {
+      const auto& other = m_buffers[j];
+      if (other.first_use <= info.last_use
+          && info.first_use <= other.last_use) {
+        conflicts.emplace_back(other.offset, other.offset + other.size);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end());
+    El::Int best_offset = -1;
+    El::Int best_gap = std::numeric_limits<El::Int>::max();
+    El::Int gap_start = 0;
+    for (const auto& range : conflicts) {
+      const auto& gap = range.first - gap_start;
+      if (gap >= info.size && gap < best_gap) {
+        best_offset = gap_start;
+        best_gap = gap;
+      }
+      gap_start = std::max(gap_start, range.second);
+    }
+    info.offset = (best_offset >= 0 ? best_offset : gap_start);
+    m_planned_size = std::max(m_planned_size, info.offset + info.size);
+    placed.push_back(i);
+  }
+
+  // Aliases share storage with aliased buffer
+  for (auto& info : m_buffers) {
+    if (info.alias >= 0) {
+      info.offset = m_buffers[get_root(info.alias)].offset;
+    }
+  }
+
+}
+
+El::Int memory_planner::get_offset(El::Int buffer) const {
+  if (m_planned_size < 0) {
+    LBANN_ERROR("attempted to access buffer offset before planning");
+  }
+  if (buffer < 0 || buffer >= get_num_buffers()) {
+    std::stringstream err;
+    err << "attempted to access invalid buffer index " << buffer << " "
+        << "(" << get_num_buffers() << " buffers registered)";
+    LBANN_ERROR(err.str());
+  }
+  return m_buffers[buffer].offset;
+}
+
+El::Int memory_planner::get_planned_size() const {
+  if (m_planned_size < 0) {
+    LBANN_ERROR("attempted to access planned size before planning");
+  }
+  return m_planned_size;
+}
+
+El::Int memory_planner::get_naive_size() const {
+  El::Int size = 0;
+  for (const auto& info : m_buffers) {
+    if (info.alias < 0) { size += info.size; }
+  }
+  return size;
+}
+
+El::Int memory_planner::get_aliased_size() const {
+  El::Int size = 0;
+  for (const auto& info : m_buffers) {
+    if (info.alias >= 0) { size += info.size; }
+  }
+  return size;
+}
+
+El::Int memory_planner::get_peak_live_size() const {
+
+  // Sweep over allocation and deallocation events
+  // Note: Deallocations are ordered before allocations at the same
+  // time step.
+  std::vector<std::pair<El::Int,El::Int>> events;
+  for (const auto& info : m_buffers) {
+    if (info.alias < 0) {
+      events.emplace_back(info.first_use, info.size);
+      events.emplace_back(info.last_use + 1, -info.size);
+    }
+  }
+  std::sort(events.begin(), events.end());
+  El::Int live = 0, peak = 0;
+  for (const auto& event : events) {
+    live += event.second;
+    peak = std::max(peak, live);
+  }
+  return peak;
+
+}
+
+} // namespace lbann
@@ -0,0 +1,210 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/pipeline_schedule.hpp"
+#include "lbann/utils/exception.hpp"
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace lbann {
+namespace pipeline {
+
+std::vector<El::Int> partition(const std::vector<double>& costs,
+                               El::Int num_stages) {
+  if (num_stages < 1) {
+    std::stringstream err;
+    err << "attempted to partition into " << num_stages << " stages";
+    LBANN_ERROR(err.str());
+  }
+  const El::Int num_items = costs.size();
+  if (num_items == 0) { return {}; }
+  num_stages = std::min(num_stages, num_items);
+
+  // Prefix sums of costs
+  std::vector<double> prefix(num_items + 1, 0);
+  for (El::Int i = 0; i < num_items; ++i) {
+    prefix[i+1] = prefix[i] + costs[i];
+  }
+
+  // Dynamic programming over number of stages
+  // Note: best[k][i] is the minimum max-stage cost for splitting the
+  // first i items into k stages, and start[k][i] is the first item
+  // of the last stage in that split.
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  std::vector<std::vector<double>> best(num_stages + 1,
+                                        std::vector<double>(num_items + 1, inf));
+  std::vector<std::vector<El::Int>> start(num_stages + 1,
+                                          std::vector<El::Int>(num_items + 1, 0));
+  best[0][0] = 0;
+  for (El::Int k = 1; k <= num_stages; ++k) {
+    for (El::Int i = k; i <= num_items; ++i) {
+      for (El::Int j = k - 1; j < i; ++j) {
+        const double cost = std::max(best[k-1][j], prefix[i] - prefix[j]);
+        if (cost < best[k][i]) {
+          best[k][i] = cost;
+          start[k][i] = j;
+        }
+      }
+    }
+  }
+
+  // Recover stage boundaries
+  std::vector<El::Int> stage_starts(num_stages);
+  El::Int end = num_items;
+  for (El::Int k = num_stages; k >= 1; --k) {
+    stage_starts[k-1] = start[k][end];
+    end = stage_starts[k-1];
+  }
+  return stage_starts;
+
+}
+
+schedule one_forward_one_backward(El::Int num_stages,
+                                  El::Int num_micro_batches) {
+  if (num_stages < 1 || num_micro_batches < 1) {
+    std::stringstream err;
+    err << "attempted to construct pipeline schedule with "
+        << num_stages << " stages and "
+        << num_micro_batches << " micro-batches";
+    LBANN_ERROR(err.str());
+  }
+  schedule steps(num_stages);
+  for (El::Int stage = 0; stage < num_stages; ++stage) {
+    auto& stage_steps = steps[stage];
+    El::Int num_forward = 0, num_backward = 0;
+    const El::Int num_warmup = std::min(num_stages - stage - 1,
+                                        num_micro_batches);
+    while (num_forward < num_warmup) {
+      stage_steps.push_back({true, num_forward++});
+    }
+    while (num_forward < num_micro_batches) {
+      stage_steps.push_back({true, num_forward++});
+      stage_steps.push_back({false, num_backward++});
+    }
+    while (num_backward < num_micro_batches) {
+      stage_steps.push_back({false, num_backward++});
+    }
+  }
+  return steps;
+}
+
+simulation_result simulate(const schedule& steps,
+                           const std::vector<double>& forward_costs,
+                           const std::vector<double>& backward_costs,
+                           double transfer_time) {
+  const El::Int num_stages = steps.size();
+  if (forward_costs.size() != steps.size()
+      || backward_costs.size() != steps.size()) {
+    std::stringstream err;
+    err << "attempted to simulate pipeline with " << num_stages << " "
+        << "stages, but got " << forward_costs.size() << " forward costs "
+        << "and " << backward_costs.size() << " backward costs";
+    LBANN_ERROR(err.str());
+  }
+
+  // Completion times for each step
+  El::Int num_micro_batches = 0;
+  for (const auto& stage_steps : steps) {
+    for (const auto& op : stage_steps) {
+      num_micro_batches = std::max(num_micro_batches, op.micro_batch + 1);
+    }
+  }
+  constexpr double not_done = -1;
+  std::vector<std::vector<double>> forward_end(
+    num_stages, std::vector<double>(num_micro_batches, not_done));
+  std::vector<std::vector<double>> backward_end(
+    num_stages, std::vector<double>(num_micro_batches, not_done));
+
+  // Perform steps in order until every stage is finished
+  std::vector<size_t> next_step(num_stages, 0);
+  std::vector<double> stage_time(num_stages, 0), busy_time(num_stages, 0);
+  bool done = false;
+  while (!done) {
+    done = true;
+    bool progress = false;
+    for (El::Int stage = 0; stage < num_stages; ++stage) {
+      const auto& stage_steps = steps[stage];
+      while (next_step[stage] < stage_steps.size()) {
+        const auto& op = stage_steps[next_step[stage]];
+        const auto& mb = op.micro_batch;
+
+        // Check whether step dependencies are satisfied
+        double ready_time = stage_time[stage];
+        if (op.forward && stage > 0) {
+          const auto& dep = forward_end[stage-1][mb];
+          if (dep == not_done) { break; }
+          ready_time = std::max(ready_time, dep + transfer_time);
+        }
+        if (!op.forward) {
+          const auto& own = forward_end[stage][mb];
+          if (own == not_done) { break; }
+          ready_time = std::max(ready_time, own);
+          if (stage < num_stages - 1) {
+            const auto& dep = backward_end[stage+1][mb];
+            if (dep == not_done) { break; }
+            ready_time = std::max(ready_time, dep + transfer_time);
+          }
+        }
+
+        // Perform step
+        const auto& cost = (op.forward ?
+                            forward_costs[stage] :
+                            backward_costs[stage]);
+        stage_time[stage] = ready_time + cost;
+        busy_time[stage] += cost;
+        (op.forward ? forward_end : backward_end)[stage][mb] = stage_time[stage];
+        ++next_step[stage];
+        progress = true;
+
+      }
+      done = done && next_step[stage] == stage_steps.size();
+    }
+    if (!done && !progress) {
+      LBANN_ERROR("pipeline schedule has a circular dependency");
+    }
+  }
+
+  // Compute statistics
+  simulation_result result;
+  result.total_time = *std::max_element(stage_time.begin(),
+                                        stage_time.end());
+  result.idle_times.resize(num_stages);
+  double total_idle_time = 0;
+  for (El::Int stage = 0; stage < num_stages; ++stage) {
+    result.idle_times[stage] = result.total_time - busy_time[stage];
+    total_idle_time += result.idle_times[stage];
+  }
+  if (result.total_time > 0) {
+    result.bubble_fraction = (total_idle_time
+                              / (num_stages * result.total_time));
+  }
+  return result;
+
+}
+
+} // namespace pipeline
+} // namespace lbann
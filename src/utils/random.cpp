@@ -180,9 +180,23 @@ bool load_rng_from_checkpoint_shared(persist& p, const lbann_comm* comm) {
     rank_in_world = std::to_string(comm->get_rank_in_world());
   }
 
-  /// @todo - Note that the RNG with thread local data is not correct
+  // Rank-specific generators are in the rank's own directory, which
+  // does not exist if the rank was added by an elastic restart
+  const auto rank_dirname = p.get_rank_checkpoint_dir();
+  dirname = rank_dirname + "/rng_state";
   rng_name = dirname + "/rng_io_generator_" + rank_in_world;
-  std::ifstream rng_io(rng_name);
+  std::ifstream rng_io;
+  if (!rank_dirname.empty()) { rng_io.open(rng_name); }
+  if (!rng_io.is_open()) {
+    LBANN_WARNING("checkpoint has no random number generator state "
+                  "for rank ", rank_in_world, ", "
+                  "so its generators are reseeded from the "
+                  "data sequence generator");
+    reseed_rank_rng_from_checkpoint(std::stoi(rank_in_world));
+    return true;
+  }
+
+  /// @todo - Note that the RNG with thread local data is not correct
   rng_io >> ::io_generator;
 
   /// @todo - Note that the RNG with thread local data is not correct
@@ -209,11 +223,40 @@ bool load_rng_from_checkpoint_shared(persist& p, const lbann_comm* comm) {
     rng_name = dirname + "/rng_fast_generator_" + rank_in_world;
     std::ifstream rng_fast(rng_name);
     rng_fast >> ::fast_generator;
-   }
 #endif
   return true;
 }
 
+void reseed_rank_rng_from_checkpoint(int rank) {
+  // Seed with the restored data sequence generator, which is the
+  // same on all ranks, without advancing it
+  rng_gen seeder = ::data_seq_generator;
+  const auto seed = static_cast<unsigned>(seeder());
+  {
+    std::seed_seq seq{seed, 0u, static_cast<unsigned>(rank)};
+    ::io_generator.seed(seq);
+  }
+  {
+    std::seed_seq seq{seed, 1u, static_cast<unsigned>(rank)};
+    ::fast_io_generator.seed(seq);
+  }
+#ifdef _OPENMP
+  #pragma omp parallel
+  {
+    const auto thread = static_cast<unsigned>(omp_get_thread_num());
+    std::seed_seq seq{seed, 2u, static_cast<unsigned>(rank), thread};
+    ::generator.seed(seq);
+    std::seed_seq fast_seq{seed, 3u, static_cast<unsigned>(rank), thread};
+    ::fast_generator.seed(fast_seq);
+  }
+#else
+  std::seed_seq seq{seed, 2u, static_cast<unsigned>(rank)};
+  ::generator.seed(seq);
+  std::seed_seq fast_seq{seed, 3u, static_cast<unsigned>(rank)};
+  ::fast_generator.seed(fast_seq);
+#endif
+}
+
 void init_random(int seed, lbann_comm *comm) {
   if (seed != -1) {
     // Seed every OpenMP thread, if present.
@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/reduced_precision.hpp"
+#include "lbann/utils/exception.hpp"
+#include <sstream>
+
+namespace lbann {
+
+std::string to_string(storage_format format) {
+  switch (format) {
+  case storage_format::full:
+    return "full";
+  case storage_format::bfloat16:
+    return "bfloat16";
+  case storage_format::float16:
+    return "float16";
+  default:
+    LBANN_ERROR("invalid storage format");
+  }
+}
+
+storage_format storage_format_from_string(const std::string& name) {
+  if (name.empty() || name == "full") {
+    return storage_format::full;
+  }
+  if (name == "bfloat16" || name == "bf16") {
+    return storage_format::bfloat16;
+  }
+  if (name == "float16" || name == "fp16") {
+    return storage_format::float16;
+  }
+  LBANN_ERROR("invalid storage format (" + name + ")");
+}
+
+void encode_reduced_precision(storage_format format,
+                              const DataType* x,
+                              uint16_t* y,
+                              El::Int size) {
+  switch (format) {
+  case storage_format::bfloat16:
+    for (El::Int i = 0; i < size; ++i) {
+      y[i] = float_to_bfloat16(static_cast<float>(x[i]));
+    }
+    break;
+  case storage_format::float16:
+    for (El::Int i = 0; i < size; ++i) {
+      y[i] = float_to_float16(static_cast<float>(x[i]));
+    }
+    break;
+  default:
+    LBANN_ERROR("attempted to encode entries in " + to_string(format)
+                + " precision, which is not a reduced-precision format");
+  }
+}
+
+void decode_reduced_precision(storage_format format,
+                              const uint16_t* x,
+                              DataType* y,
+                              El::Int size) {
+  switch (format) {
+  case storage_format::bfloat16:
+    for (El::Int i = 0; i < size; ++i) {
+      y[i] = bfloat16_to_float(x[i]);
+    }
+    break;
+  case storage_format::float16:
+    for (El::Int i = 0; i < size; ++i) {
+      y[i] = float16_to_float(x[i]);
+    }
+    break;
+  default:
+    LBANN_ERROR("attempted to decode entries in " + to_string(format)
+                + " precision, which is not a reduced-precision format");
+  }
+}
+
+void reduced_precision_matrix::resize(storage_format format,
+                                      El::Int height,
+                                      El::Int width) {
+  if (format == storage_format::full) {
+    LBANN_ERROR("attempted to store a matrix in full precision "
+                "in a reduced-precision matrix");
+  }
+  m_format = format;
+  m_height = height;
+  m_width = width;
+  m_data.resize(height * width);
+}
+
+void reduced_precision_matrix::store(storage_format format,
+                                     const AbsMat& x) {
+  resize(format, x.Height(), x.Width());
+  const El::Int height = m_height;
+  const El::Int width = m_width;
+  const auto* x_buffer = x.LockedBuffer();
+  const El::Int x_ldim = x.LDim();
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < width; ++col) {
+    encode_reduced_precision(format,
+                             x_buffer + col * x_ldim,
+                             &m_data[col * height],
+                             height);
+  }
+}
+
+void reduced_precision_matrix::load(AbsMat& x) const {
+  if (x.Height() != m_height || x.Width() != m_width) {
+    std::stringstream err;
+    err << "attempted to load a " << m_height << " x " << m_width << " "
+        << "reduced-precision matrix into a "
+        << x.Height() << " x " << x.Width() << " matrix";
+    LBANN_ERROR(err.str());
+  }
+  const El::Int height = m_height;
+  const El::Int width = m_width;
+  auto* x_buffer = x.Buffer();
+  const El::Int x_ldim = x.LDim();
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < width; ++col) {
+    decode_reduced_precision(m_format,
+                             &m_data[col * height],
+                             x_buffer + col * x_ldim,
+                             height);
+  }
+}
+
+} // namespace lbann
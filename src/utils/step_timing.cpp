@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/step_timing.hpp"
+#include "lbann/comm.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/summary.hpp"
+#include <algorithm>
+
+namespace lbann {
+
+constexpr int step_timing::num_categories;
+
+std::string step_timing::category_name(category c) {
+  switch (c) {
+  case category::data_wait:  return "data_wait";
+  case category::fp_compute: return "fp_compute";
+  case category::bp_compute: return "bp_compute";
+  case category::comm_wait:  return "comm_wait";
+  case category::optimizer:  return "optimizer";
+  case category::callbacks:  return "callbacks";
+  case category::other:      return "other";
+  default: LBANN_ERROR("invalid step time category");
+  }
+  return "";
+}
+
+step_timing*& step_timing::active() {
+  static thread_local step_timing* timing = nullptr;
+  return timing;
+}
+
+step_timing::step_timing(const step_timing& other)
+  : m_steps(other.m_steps) {}
+
+step_timing& step_timing::operator=(const step_timing& other) {
+  m_steps = other.m_steps;
+  return *this;
+}
+
+step_timing::~step_timing() {
+  if (active() == this) { active() = nullptr; }
+}
+
+void step_timing::begin_step() {
+  m_in_step = true;
+  m_category = category::other;
+  m_current.fill(EvalType(0));
+  m_last_time = get_time();
+  active() = this;
+}
+
+void step_timing::end_step(execution_mode mode) {
+  if (!m_in_step) {
+    LBANN_ERROR("attempted to end a step that was not started");
+  }
+  switch_category(category::other);
+  m_steps[mode].push_back(m_current);
+  m_in_step = false;
+  if (active() == this) { active() = nullptr; }
+}
+
+const std::vector<step_timing::step_record>&
+step_timing::get_steps(execution_mode mode) const {
+  static const std::vector<step_record> empty;
+  const auto& it = m_steps.find(mode);
+  return it != m_steps.end() ? it->second : empty;
+}
+
+step_timing::step_record step_timing::get_totals(execution_mode mode) const {
+  step_record totals = {};
+  for (const auto& s : get_steps(mode)) {
+    for (int i = 0; i < num_categories; ++i) {
+      totals[i] += s[i];
+    }
+  }
+  return totals;
+}
+
+void step_timing::reset(execution_mode mode) {
+  m_steps[mode].clear();
+}
+
+void step_timing::summarize(lbann_summary& summarizer,
+                            lbann_comm& comm,
+                            execution_mode mode,
+                            int step) const {
+  const auto& steps = get_steps(mode);
+  const std::string prefix = "step_time/" + to_string(mode) + "/";
+
+  // Processes may record different numbers of steps if an epoch was
+  // interrupted, so only the common steps are compared
+  const El::Int num_steps = comm.trainer_allreduce(El::Int(steps.size()),
+                                                   El::mpi::MIN);
+  if (num_steps < 1) { return; }
+  const El::Int num_procs = comm.get_procs_per_trainer();
+
+  // Per-process totals for each category and for the whole step
+  // Note: The last entry is the step time.
+  std::vector<EvalType> totals(num_categories + 1, EvalType(0));
+  for (El::Int i = 0; i < num_steps; ++i) {
+    for (int j = 0; j < num_categories; ++j) {
+      totals[j] += steps[i][j];
+      totals[num_categories] += steps[i][j];
+    }
+  }
+  std::vector<EvalType> max_totals(totals.size()), sum_totals(totals.size());
+  comm.trainer_allreduce(totals.data(), totals.size(), max_totals.data(),
+                         El::mpi::MAX);
+  comm.trainer_allreduce(totals.data(), totals.size(), sum_totals.data(),
+                         El::mpi::SUM);
+
+  // Histogram of step times over steps and processes
+  // Note: Each process owns one column.
+  StarVCMat<El::Device::CPU> times(comm.get_trainer_grid());
+  times.Resize(num_steps, num_procs);
+  auto& local_times = times.Matrix();
+  for (int j = 0; j <= num_categories; ++j) {
+    const auto name = (j < num_categories ?
+                       category_name(static_cast<category>(j)) :
+                       std::string("step"));
+    for (El::Int col = 0; col < local_times.Width(); ++col) {
+      for (El::Int i = 0; i < num_steps; ++i) {
+        EvalType t = 0;
+        if (j < num_categories) {
+          t = steps[i][j];
+        } else {
+          for (const auto& x : steps[i]) { t += x; }
+        }
+        local_times(i, col) = t;
+      }
+    }
+    summarizer.reduce_histogram(prefix + name, times, step);
+
+    // Mean time per step and rank imbalance
+    const auto mean_total = sum_totals[j] / num_procs;
+    summarizer.reduce_scalar(prefix + name + "_mean",
+                             mean_total / num_steps, step);
+    if (mean_total > EvalType(0)) {
+      summarizer.reduce_scalar(prefix + name + "_imbalance",
+                               max_totals[j] / mean_total, step);
+    }
+  }
+
+}
+
+} // namespace lbann
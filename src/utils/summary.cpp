@@ -36,6 +36,8 @@ lbann_summary::lbann_summary(std::string logdir, lbann_comm *comm)
   : m_comm(comm) {
   if (m_comm->am_world_master()) {
     m_sw = new TBinf::SummaryWriter(logdir);
+    m_writer.reset(new thread_pool());
+    m_writer->launch_threads(1);
   } else {
     m_sw = nullptr;
   }
@@ -44,6 +46,9 @@ lbann_summary::lbann_summary(std::string logdir, lbann_comm *comm)
 
 lbann_summary::~lbann_summary() {
   flush();
+  if (m_write_done.valid()) {
+    m_write_done.wait();
+  }
   if (m_sw != nullptr) {
     delete m_sw;
   }
@@ -186,157 +191,153 @@ void lbann_summary::reduce_2norm(const std::string tag, const AbsDistMat& mat,
 }
 
 void lbann_summary::flush() {
-  flush_means();
-  flush_mins();
-  flush_maxes();
-  flush_stdevs();
-  flush_scalars();
-  flush_sum_scalars();
-  flush_scalar_alls();
-  flush_histograms();
-  if (m_sw != nullptr) {
-    m_sw->flush();
-  }
-}
+  const size_t num_buckets = m_histogram_buckets.size();
 
-void lbann_summary::flush_means() {
-  if (m_pending_means.empty()) {
-    return;
-  }
+  // Pack values to reduce within the trainer
+  // Note: Minimums are reduced as maximums of negated values.
   std::vector<DataType> local_sums;
+  std::vector<DataType> local_maxes;
   for (const auto& op : m_pending_means) {
     local_sums.push_back(op.local);
   }
-  if (m_comm->am_trainer_master()) {
-    std::vector<DataType> global_sums(local_sums.size());
-    m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
-                         global_sums.data());
-    // Compute the means in-place.
-    for (unsigned i = 0; i < global_sums.size(); ++i) {
-      global_sums[i] /= m_pending_means[i].num;
-    }
-    gather_scalar_summary(m_pending_means, global_sums);
-  } else {
-    m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
-                         m_comm->get_trainer_master());
+  for (const auto& op : m_pending_stdevs) {
+    local_sums.push_back(op.local);
+    local_sums.push_back(op.local2);
   }
-  m_pending_means.clear();
-}
-
-void lbann_summary::flush_mins() {
-  if (m_pending_mins.empty()) {
-    return;
+  for (const auto& op : m_pending_sum_scalars) {
+    local_sums.push_back(op.local);
   }
-  std::vector<DataType> local_mins;
   for (const auto& op : m_pending_mins) {
-    local_mins.push_back(op.local);
-  }
-  if (m_comm->am_trainer_master()) {
-    std::vector<DataType> global_mins(local_mins.size());
-    m_comm->trainer_reduce(local_mins.data(), local_mins.size(),
-                         global_mins.data(), El::mpi::MIN);
-    gather_scalar_summary(m_pending_mins, global_mins);
-  } else {
-    m_comm->trainer_reduce(local_mins.data(), local_mins.size(),
-                         m_comm->get_trainer_master(), El::mpi::MIN);
-  }
-  m_pending_mins.clear();
-}
-
-void lbann_summary::flush_maxes() {
-  if (m_pending_maxes.empty()) {
-    return;
+    local_maxes.push_back(-op.local);
   }
-  std::vector<DataType> local_maxes;
   for (const auto& op : m_pending_maxes) {
     local_maxes.push_back(op.local);
   }
-  if (m_comm->am_trainer_master()) {
-    std::vector<DataType> global_maxes(local_maxes.size());
-    m_comm->trainer_reduce(local_maxes.data(), local_maxes.size(),
-                         global_maxes.data(), El::mpi::MAX);
-    gather_scalar_summary(m_pending_maxes, global_maxes);
-  } else {
-    m_comm->trainer_reduce(local_maxes.data(), local_maxes.size(),
-                         m_comm->get_trainer_master(), El::mpi::MAX);
+  for (const auto& op : m_pending_histograms) {
+    local_sums.push_back(op.sum);
+    local_sums.push_back(op.sqsum);
+    local_sums.insert(local_sums.end(), op.buckets.begin(), op.buckets.end());
+    local_maxes.push_back(-op.min);
+    local_maxes.push_back(op.max);
   }
-  m_pending_maxes.clear();
-}
 
-void lbann_summary::flush_stdevs() {
-  if (m_pending_stdevs.empty()) {
-    return;
-  }
-  std::vector<DataType> local_sums;
-  std::vector<DataType> local_sqsums;
-  for (const auto& op : m_pending_stdevs) {
-    local_sums.push_back(op.local);
-    local_sqsums.push_back(op.local2);
-  }
+  // Reduce to the trainer master
+  std::vector<DataType> sums(local_sums.size());
+  std::vector<DataType> maxes(local_maxes.size());
   if (m_comm->am_trainer_master()) {
-    // Compute the model sample standard deviation as:
-    // sqrt[1/(n-1) (sqsum - (1/n)*sum^2)]
-    // The n-1 is to use an unbiased variance estimate.
-    // This unrolls the usual formulation of standard deviation some, to avoid
-    // global operations when pushing the operation.
-    std::vector<DataType> global_sums(local_sums.size());
-    std::vector<DataType> global_sqsums(local_sqsums.size());
-    m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
-                         global_sums.data());
-    m_comm->trainer_reduce(local_sqsums.data(), local_sqsums.size(),
-                         global_sqsums.data());
-    // Re-use the global_sums vector for the standard deviation.
-    for (unsigned i = 0; i < global_sums.size(); ++i) {
-      global_sums[i] = std::sqrt(
-                         (global_sqsums[i] -
-                          global_sums[i] * global_sums[i] / m_pending_stdevs[i].num) /
-                         (m_pending_stdevs[i].num - 1));
+    if (!local_sums.empty()) {
+      m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
+                             sums.data());
+    }
+    if (!local_maxes.empty()) {
+      m_comm->trainer_reduce(local_maxes.data(), local_maxes.size(),
+                             maxes.data(), El::mpi::MAX);
     }
-    gather_scalar_summary(m_pending_stdevs, global_sums);
   } else {
-    m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
-                         m_comm->get_trainer_master());
-    m_comm->trainer_reduce(local_sqsums.data(), local_sqsums.size(),
-                         m_comm->get_trainer_master());
+    if (!local_sums.empty()) {
+      m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
+                             m_comm->get_trainer_master());
+    }
+    if (!local_maxes.empty()) {
+      m_comm->trainer_reduce(local_maxes.data(), local_maxes.size(),
+                             m_comm->get_trainer_master(), El::mpi::MAX);
+    }
   }
-  m_pending_stdevs.clear();
-}
 
-void lbann_summary::flush_scalars() {
-  if (m_pending_scalars.empty()) {
-    return;
-  }
+  // Compute summaries on the trainer master and gather them to the
+  // world master
+  std::vector<pending_op> scalar_events;
+  std::vector<pending_histogram> histogram_events;
   if (m_comm->am_trainer_master()) {
-    std::vector<DataType> local_scalars;
+    std::vector<DataType> values;
+    size_t sum_pos = 0, max_pos = 0;
+    for (const auto& op : m_pending_means) {
+      values.push_back(sums[sum_pos++] / op.num);
+    }
+    for (size_t i = 0; i < m_pending_mins.size(); ++i) {
+      values.push_back(-maxes[max_pos++]);
+    }
+    for (size_t i = 0; i < m_pending_maxes.size(); ++i) {
+      values.push_back(maxes[max_pos++]);
+    }
+    for (const auto& op : m_pending_stdevs) {
+      // Compute the model sample standard deviation as:
+      // sqrt[1/(n-1) (sqsum - (1/n)*sum^2)]
+      // The n-1 is to use an unbiased variance estimate.
+      // This unrolls the usual formulation of standard deviation some, to avoid
+      // global operations when pushing the operation.
+      const DataType sum = sums[sum_pos++];
+      const DataType sqsum = sums[sum_pos++];
+      values.push_back(std::sqrt((sqsum - sum * sum / op.num) / (op.num - 1)));
+    }
     for (const auto& op : m_pending_scalars) {
-      local_scalars.push_back(op.local);
+      values.push_back(op.local);
+    }
+    for (size_t i = 0; i < m_pending_sum_scalars.size(); ++i) {
+      values.push_back(sums[sum_pos++]);
+    }
+    for (size_t i = 0; i < m_pending_histograms.size(); ++i) {
+      values.push_back(-maxes[max_pos++]);
+      values.push_back(maxes[max_pos++]);
+      values.insert(values.end(),
+                    sums.begin() + sum_pos,
+                    sums.begin() + sum_pos + 2 + num_buckets);
+      sum_pos += 2 + num_buckets;
+    }
+    if (!values.empty()) {
+      if (m_comm->am_world_master()) {
+        std::vector<DataType> data(m_comm->get_num_trainers() * values.size());
+        m_comm->intertrainer_gather(values.data(), values.size(), data.data());
+        for (int model = 0; model < m_comm->get_num_trainers(); ++model) {
+          const DataType* model_values = &data[model * values.size()];
+          auto add_scalars = [&](const std::vector<pending_op>& ops) {
+            for (const auto& op : ops) {
+              scalar_events.emplace_back(prepend_model(op.tag, model),
+                                         op.step, *model_values++);
+            }
+          };
+          add_scalars(m_pending_means);
+          add_scalars(m_pending_mins);
+          add_scalars(m_pending_maxes);
+          add_scalars(m_pending_stdevs);
+          add_scalars(m_pending_scalars);
+          add_scalars(m_pending_sum_scalars);
+          for (const auto& op : m_pending_histograms) {
+            const DataType min = *model_values++;
+            const DataType max = *model_values++;
+            const DataType sum = *model_values++;
+            const DataType sqsum = *model_values++;
+            std::vector<float> buckets(model_values,
+                                       model_values + num_buckets);
+            model_values += num_buckets;
+            histogram_events.emplace_back(prepend_model(op.tag, model),
+                                          op.step, std::move(buckets),
+                                          min, max, op.num, sum, sqsum);
+          }
+        }
+      } else {
+        m_comm->intertrainer_gather(values.data(), values.size(),
+                                    m_comm->get_intertrainer_master());
+      }
     }
-    gather_scalar_summary(m_pending_scalars, local_scalars);
   }
+  gather_scalar_alls(scalar_events);
+
+  m_pending_means.clear();
+  m_pending_mins.clear();
+  m_pending_maxes.clear();
+  m_pending_stdevs.clear();
   m_pending_scalars.clear();
-}
+  m_pending_sum_scalars.clear();
+  m_pending_scalar_alls.clear();
+  m_pending_histograms.clear();
 
-void lbann_summary::flush_sum_scalars() {
-  if (m_pending_sum_scalars.empty()) {
-    return;
-  }
-  std::vector<DataType> local_sums;
-  for (const auto& op : m_pending_sum_scalars) {
-    local_sums.push_back(op.local);
-  }
-  if (m_comm->am_trainer_master()) {
-    std::vector<DataType> global_sums(local_sums.size());
-    m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
-                         global_sums.data());
-    gather_scalar_summary(m_pending_sum_scalars, global_sums);
-  } else {
-    m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
-                         m_comm->get_trainer_master());
+  if (m_sw != nullptr) {
+    write_events(std::move(scalar_events), std::move(histogram_events));
   }
-  m_pending_sum_scalars.clear();
 }
 
-void lbann_summary::flush_scalar_alls() {
+void lbann_summary::gather_scalar_alls(std::vector<pending_op>& scalars) {
   if (m_pending_scalar_alls.empty()) {
     return;
   }
@@ -346,117 +347,47 @@ void lbann_summary::flush_scalar_alls() {
     local_scalars.push_back(op.local);
   }
   if (m_comm->am_world_master()) {
-    std::vector<DataType> scalars(
+    std::vector<DataType> data(
       m_comm->get_procs_in_world()*local_scalars.size());
     m_comm->gather(local_scalars.data(), local_scalars.size(),
-                   scalars.data(), m_comm->get_world_comm());
-    for (size_t i = 0; i < scalars.size(); ++i) {
+                   data.data(), m_comm->get_world_comm());
+    for (size_t i = 0; i < data.size(); ++i) {
       int rank = i / local_scalars.size();
       int model = rank / m_comm->get_procs_per_trainer();
       int pos = i % local_scalars.size();
-      m_sw->add_scalar(
+      scalars.emplace_back(
         prepend_model("rank" + std::to_string(rank) + "/" +
                       m_pending_scalar_alls[pos].tag, model),
-        scalars[i], m_pending_scalar_alls[pos].step);
+        m_pending_scalar_alls[pos].step, data[i]);
     }
   } else {
     m_comm->gather(local_scalars.data(), local_scalars.size(),
                    m_comm->get_world_master(), m_comm->get_world_comm());
   }
-  m_pending_scalar_alls.clear();
 }
 
-void lbann_summary::flush_histograms() {
-  if (m_pending_histograms.empty()) {
-    return;
-  }
-  std::vector<DataType> local_mins;
-  std::vector<DataType> local_maxes;
-  std::vector<DataType> local_sums;
-  std::vector<DataType> local_sqsums;
-  std::vector<float> buckets;
-  for (const auto& op : m_pending_histograms) {
-    local_mins.push_back(op.min);
-    local_maxes.push_back(op.max);
-    local_sums.push_back(op.sum);
-    local_sqsums.push_back(op.sqsum);
-    buckets.insert(buckets.end(), op.buckets.begin(), op.buckets.end());
-  }
-  if (m_comm->am_trainer_master()) {
-    std::vector<DataType> model_mins(local_mins.size());
-    std::vector<DataType> model_maxes(local_maxes.size());
-    std::vector<DataType> model_sums(local_sums.size());
-    std::vector<DataType> model_sqsums(local_sqsums.size());
-    std::vector<float> model_buckets(buckets.size());
-    m_comm->trainer_reduce(local_mins.data(), local_mins.size(),
-                         model_mins.data(), El::mpi::MIN);
-    m_comm->trainer_reduce(local_maxes.data(), local_maxes.size(),
-                         model_maxes.data(), El::mpi::MAX);
-    m_comm->trainer_reduce(local_sums.data(), model_sums.size(),
-                         model_sums.data());
-    m_comm->trainer_reduce(local_sqsums.data(), local_sqsums.size(),
-                         model_sqsums.data());
-    m_comm->trainer_reduce(buckets.data(), buckets.size(),
-                         model_buckets.data());
-    // Gather to the world master for writing out.
-    if (m_comm->am_world_master()) {
-      std::vector<DataType> global_mins(
-        m_comm->get_num_trainers() * model_mins.size());
-      std::vector<DataType> global_maxes(
-        m_comm->get_num_trainers() * model_maxes.size());
-      std::vector<DataType> global_sums(
-        m_comm->get_num_trainers() * model_sums.size());
-      std::vector<DataType> global_sqsums(
-        m_comm->get_num_trainers() * model_sqsums.size());
-      std::vector<float> global_buckets(
-        m_comm->get_num_trainers() * model_buckets.size());
-      m_comm->intertrainer_gather(model_mins.data(), model_mins.size(),
-                                global_mins.data());
-      m_comm->intertrainer_gather(model_maxes.data(), model_maxes.size(),
-                                global_maxes.data());
-      m_comm->intertrainer_gather(model_sums.data(), model_sums.size(),
-                                global_sums.data());
-      m_comm->intertrainer_gather(model_sqsums.data(), model_sqsums.size(),
-                                global_sqsums.data());
-      m_comm->intertrainer_gather(model_buckets.data(), model_buckets.size(),
-                                global_buckets.data());
-      for (unsigned i = 0; i < global_mins.size(); ++i) {
-        int model = i / m_pending_histograms.size();
-        unsigned ops_pos = i % m_pending_histograms.size();
-        std::vector<float> tmp_buckets(
-          global_buckets.begin() + i*m_histogram_buckets.size(),
-          global_buckets.begin() + (i+1)*m_histogram_buckets.size());
-        m_sw->add_histogram(prepend_model(m_pending_histograms[ops_pos].tag, model),
-                            tmp_buckets, global_mins[i], global_maxes[i],
-                            m_pending_histograms[ops_pos].num,
-                            global_sums[i], global_sqsums[i],
-                            m_pending_histograms[ops_pos].step);
+void lbann_summary::write_events(std::vector<pending_op> scalars,
+                                 std::vector<pending_histogram> histograms) {
+  // Only one write is in flight, so the writer does not fall behind.
+  // Getting the previous result also reports its errors.
+  if (m_write_done.valid()) {
+    m_write_done.get();
+  }
+  auto* sw = m_sw;
+  auto scalars_ptr = std::make_shared<std::vector<pending_op>>(
+    std::move(scalars));
+  auto histograms_ptr = std::make_shared<std::vector<pending_histogram>>(
+    std::move(histograms));
+  m_write_done = m_writer->submit_job([sw, scalars_ptr, histograms_ptr]() {
+      for (const auto& op : *scalars_ptr) {
+        sw->add_scalar(op.tag, op.local, op.step);
       }
-    } else {
-      m_comm->intertrainer_gather(model_mins.data(), model_mins.size(),
-                                m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_maxes.data(), model_maxes.size(),
-                                m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_sums.data(), model_sums.size(),
-                                m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_sqsums.data(), model_sqsums.size(),
-                                m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_buckets.data(), model_buckets.size(),
-                                m_comm->get_intertrainer_master());
-    }
-  } else {
-    m_comm->trainer_reduce(local_mins.data(), local_mins.size(),
-                         m_comm->get_trainer_master(), El::mpi::MIN);
-    m_comm->trainer_reduce(local_maxes.data(), local_maxes.size(),
-                         m_comm->get_trainer_master(), El::mpi::MAX);
-    m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
-                         m_comm->get_trainer_master());
-    m_comm->trainer_reduce(local_sqsums.data(), local_sqsums.size(),
-                         m_comm->get_trainer_master());
-    m_comm->trainer_reduce(buckets.data(), buckets.size(),
-                         m_comm->get_trainer_master());
-  }
-  m_pending_histograms.clear();
+      for (const auto& op : *histograms_ptr) {
+        sw->add_histogram(op.tag, op.buckets, op.min, op.max, op.num,
+                          op.sum, op.sqsum, op.step);
+      }
+      sw->flush();
+    });
 }
 
 DataType lbann_summary::local_sum(const Mat& mat) const {
@@ -587,37 +518,6 @@ std::string lbann_summary::prepend_model(const std::string tag,
   return "model" + std::to_string(model) + "/" + tag;
 }
 
-void lbann_summary::gather_scalar_summary(
-  const std::vector<pending_op>& ops, std::vector<DataType>& scalars) {
-  if (m_comm->am_world_master()) {
-    std::vector<DataType> data(m_comm->get_num_trainers() * scalars.size());
-    m_comm->intertrainer_gather(scalars.data(), scalars.size(), data.data());
-    for (unsigned i = 0; i < data.size(); ++i) {
-      int model = i / ops.size();
-      unsigned ops_pos = i % ops.size();
-      m_sw->add_scalar(prepend_model(ops[ops_pos].tag, model),
-                       data[i], ops[ops_pos].step);
-    }
-  } else {
-    m_comm->intertrainer_gather(scalars.data(), scalars.size(),
-                              m_comm->get_intertrainer_master());
-  }
-}
-
-void lbann_summary::gather_scalar_summary(const std::string tag,
-                                          DataType s,
-                                          int step) {
-  if (m_comm->am_world_master()) {
-    std::vector<DataType> data(m_comm->get_num_trainers());
-    m_comm->intertrainer_gather(s, data);
-    for (size_t model = 0; model < data.size(); ++model) {
-      m_sw->add_scalar(prepend_model(tag, model), data[model], step);
-    }
-  } else {
-    m_comm->intertrainer_gather(s, m_comm->get_intertrainer_master());
-  }
-}
-
 #endif  // LBANN_HAS_TBINF
 
 }  // namespace lbann
@@ -0,0 +1,249 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/tensor_dump.hpp"
+#include "lbann/utils/exception.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <type_traits>
+
+namespace lbann {
+
+namespace {
+
+/** NumPy type string for DataType. */
+std::string npy_descr() {
+  static_assert(std::is_same<DataType, float>::value
+                || std::is_same<DataType, double>::value,
+                "tensor dumps only support float and double");
+  return std::is_same<DataType, float>::value ? "<f4" : "<f8";
+}
+
+/** Header of a version 1.0 NPY file with a column-major matrix.
+ *  The header is padded so that the data is 64-byte aligned.
+ */
+std::string npy_header(El::Int height, El::Int width) {
+  std::stringstream dict;
+  dict << "{'descr': '" << npy_descr() << "', "
+       << "'fortran_order': True, "
+       << "'shape': (" << height << ", " << width << "), }";
+  std::string header = dict.str();
+  const size_t prelude_size = 10;
+  const size_t padded_size
+    = (prelude_size + header.size() + 1 + 63) / 64 * 64;
+  header.append(padded_size - prelude_size - header.size() - 1, ' ');
+  header.push_back('\n');
+  const auto header_size = static_cast<std::uint16_t>(header.size());
+  std::string prelude("\x93NUMPY\x01\x00", 8);
+  prelude.push_back(static_cast<char>(header_size & 0xFF));
+  prelude.push_back(static_cast<char>(header_size >> 8));
+  return prelude + header;
+}
+
+/** File name without directories. */
+std::string base_name(const std::string& path) {
+  const auto pos = path.find_last_of('/');
+  return pos == std::string::npos ? path : path.substr(pos + 1);
+}
+
+/** Name of a block file. */
+std::string block_name(const std::string& prefix,
+                       El::Int col_shift,
+                       El::Int row_shift,
+                       tensor_dump_writer::format fmt) {
+  std::stringstream ss;
+  ss << prefix << "." << col_shift << "_" << row_shift
+     << (fmt == tensor_dump_writer::format::npy ? ".npy" : ".bin");
+  return ss.str();
+}
+
+void write_file(const std::string& path, const std::vector<char>& data) {
+  std::ofstream fs(path, std::ios::binary | std::ios::trunc);
+  if (!fs.is_open()) {
+    LBANN_ERROR("failed to open dump file (" + path + ")");
+  }
+  fs.write(data.data(), data.size());
+  if (!fs) {
+    LBANN_ERROR("failed to write dump file (" + path + ")");
+  }
+}
+
+} // namespace
+
+tensor_dump_writer::tensor_dump_writer(format fmt, bool background)
+  : m_format(fmt), m_background(background) {
+  if (m_background) {
+    m_writer.reset(new thread_pool());
+    m_writer->launch_threads(1);
+  }
+}
+
+tensor_dump_writer::tensor_dump_writer(const tensor_dump_writer& other)
+  : tensor_dump_writer(other.m_format, other.m_background) {}
+
+tensor_dump_writer&
+tensor_dump_writer::operator=(const tensor_dump_writer& other) {
+  if (this != &other) {
+    wait();
+    m_format = other.m_format;
+    m_background = other.m_background;
+    m_pending.clear();
+    m_writer.reset();
+    if (m_background) {
+      m_writer.reset(new thread_pool());
+      m_writer->launch_threads(1);
+    }
+  }
+  return *this;
+}
+
+tensor_dump_writer::~tensor_dump_writer() {
+  if (m_write_done.valid()) {
+    m_write_done.wait();
+  }
+}
+
+tensor_dump_writer::format
+tensor_dump_writer::parse_format(const std::string& name) {
+  if (name == "npy_blocks") { return format::npy; }
+  if (name == "raw_blocks") { return format::raw; }
+  LBANN_ERROR("invalid tensor dump format (" + name + ")");
+  return format::npy;
+}
+
+void tensor_dump_writer::add(const AbsDistMat& mat,
+                             const std::string& prefix,
+                             const std::vector<int>& dims,
+                             bool write_sidecar) {
+  AbsDistMatReadProxy<El::Device::CPU> proxy(mat);
+  const auto& cpu_mat = proxy.GetLocked();
+  const auto& local_mat = cpu_mat.LockedMatrix();
+  const El::Int height = cpu_mat.Height();
+  const El::Int width = cpu_mat.Width();
+  const El::Int col_stride = cpu_mat.ColStride();
+  const El::Int row_stride = cpu_mat.RowStride();
+
+  // Copy local block if no other process writes it
+  const El::Int local_height = local_mat.Height();
+  const El::Int local_width = local_mat.Width();
+  if (cpu_mat.CrossRank() == cpu_mat.Root()
+      && cpu_mat.RedundantRank() == 0
+      && local_height > 0 && local_width > 0) {
+    pending_file f;
+    f.path = block_name(prefix, cpu_mat.ColShift(), cpu_mat.RowShift(),
+                        m_format);
+    const std::string header = (m_format == format::npy ?
+                                npy_header(local_height, local_width) :
+                                std::string());
+    const size_t col_bytes = local_height * sizeof(DataType);
+    f.data.resize(header.size() + local_width * col_bytes);
+    std::memcpy(f.data.data(), header.data(), header.size());
+    char* buf = f.data.data() + header.size();
+    if (local_mat.Contiguous()) {
+      std::memcpy(buf, local_mat.LockedBuffer(), local_width * col_bytes);
+    } else {
+      for (El::Int col = 0; col < local_width; ++col) {
+        std::memcpy(buf + col * col_bytes,
+                    local_mat.LockedBuffer(0, col),
+                    col_bytes);
+      }
+    }
+    m_pending.push_back(std::move(f));
+  }
+
+  // Sidecar lists every non-empty block
+  if (write_sidecar) {
+    std::stringstream json;
+    json << "{\n"
+         << "  \"format\": \""
+         << (m_format == format::npy ? "npy" : "raw") << "\",\n"
+         << "  \"dtype\": \"" << npy_descr() << "\",\n"
+         << "  \"height\": " << height << ",\n"
+         << "  \"width\": " << width << ",\n"
+         << "  \"dims\": [";
+    for (size_t i = 0; i < dims.size(); ++i) {
+      json << (i > 0 ? ", " : "") << dims[i];
+    }
+    json << "],\n"
+         << "  \"col_stride\": " << col_stride << ",\n"
+         << "  \"row_stride\": " << row_stride << ",\n"
+         << "  \"blocks\": [";
+    bool first = true;
+    for (El::Int t = 0; t < row_stride; ++t) {
+      for (El::Int s = 0; s < col_stride; ++s) {
+        const El::Int block_height = El::Length(height, s, col_stride);
+        const El::Int block_width = El::Length(width, t, row_stride);
+        if (block_height < 1 || block_width < 1) { continue; }
+        json << (first ? "\n" : ",\n")
+             << "    {\"file\": \""
+             << base_name(block_name(prefix, s, t, m_format)) << "\", "
+             << "\"col_shift\": " << s << ", "
+             << "\"row_shift\": " << t << ", "
+             << "\"height\": " << block_height << ", "
+             << "\"width\": " << block_width << "}";
+        first = false;
+      }
+    }
+    json << (first ? "" : "\n  ") << "]\n"
+         << "}\n";
+    pending_file f;
+    f.path = prefix + ".json";
+    const auto json_str = json.str();
+    f.data.assign(json_str.begin(), json_str.end());
+    m_pending.push_back(std::move(f));
+  }
+
+}
+
+void tensor_dump_writer::flush() {
+  if (m_pending.empty()) { return; }
+  if (!m_background) {
+    for (const auto& f : m_pending) {
+      write_file(f.path, f.data);
+    }
+    m_pending.clear();
+    return;
+  }
+  wait();
+  auto files = std::make_shared<std::vector<pending_file>>(
+    std::move(m_pending));
+  m_pending.clear();
+  m_write_done = m_writer->submit_job([files]() {
+      for (const auto& f : *files) {
+        write_file(f.path, f.data);
+      }
+    });
+}
+
+void tensor_dump_writer::wait() {
+  if (m_write_done.valid()) {
+    m_write_done.get();
+  }
+}
+
+} // namespace lbann
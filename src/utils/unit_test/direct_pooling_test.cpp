@@ -0,0 +1,206 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/direct_pooling.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+/** Pooling configuration for a single test case. */
+struct pool_config {
+  int num_samples;
+  int num_channels;
+  std::vector<int> input_dims;
+  std::vector<int> window_dims;
+  std::vector<int> pads;
+  std::vector<int> strides;
+};
+
+std::vector<int> get_output_dims(const pool_config& c) {
+  std::vector<int> dims(c.input_dims.size());
+  for (size_t d = 0; d < dims.size(); ++d) {
+    const int effective_dim = (c.input_dims[d] + 2 * c.pads[d]
+                               - c.window_dims[d] + 1);
+    dims[d] = (effective_dim + c.strides[d] - 1) / c.strides[d];
+  }
+  return dims;
+}
+
+int product(const std::vector<int>& dims) {
+  int size = 1;
+  for (const auto& d : dims) { size *= d; }
+  return size;
+}
+
+/** Input index for an output position and window position within a
+ *  channel, or -1 if the entry is in the padding.
+ */
+int input_index(const pool_config& c, const std::vector<int>& output_dims,
+                int output_pos, int window_pos) {
+  const int num_dims = c.input_dims.size();
+  std::vector<int> out(num_dims), win(num_dims);
+  for (int d = num_dims - 1; d >= 0; --d) {
+    out[d] = output_pos % output_dims[d];
+    output_pos /= output_dims[d];
+    win[d] = window_pos % c.window_dims[d];
+    window_pos /= c.window_dims[d];
+  }
+  int index = 0;
+  for (int d = 0; d < num_dims; ++d) {
+    const int pos = out[d] * c.strides[d] - c.pads[d] + win[d];
+    if (pos < 0 || pos >= c.input_dims[d]) { return -1; }
+    index = index * c.input_dims[d] + pos;
+  }
+  return index;
+}
+
+/** Check direct kernels against a naive implementation. Padding
+ *  entries are treated as zeros.
+ */
+void check_pooling(const pool_config& c) {
+  const int num_dims = c.input_dims.size();
+  const auto output_dims = get_output_dims(c);
+  const int input_size = product(c.input_dims);
+  const int output_size = product(output_dims);
+  const int window_size = product(c.window_dims);
+  const int input_height = input_size * c.num_channels;
+  const int output_height = output_size * c.num_channels;
+
+  lbann::CPUMat input(input_height, c.num_samples);
+  lbann::CPUMat gradient_wrt_output(output_height, c.num_samples);
+  for (int col = 0; col < c.num_samples; ++col) {
+    for (int row = 0; row < input_height; ++row) {
+      // Mix of positive and negative values with repeats
+      input(row, col) = lbann::DataType((row * 7 + col * 13) % 23) - 11;
+    }
+    for (int row = 0; row < output_height; ++row) {
+      gradient_wrt_output(row, col) = lbann::DataType((row + col) % 5) + 1;
+    }
+  }
+
+  // Naive reference
+  lbann::CPUMat max_output(output_height, c.num_samples);
+  lbann::CPUMat avg_output(output_height, c.num_samples);
+  lbann::CPUMat max_gradient(input_height, c.num_samples);
+  lbann::CPUMat avg_gradient(input_height, c.num_samples);
+  std::vector<int> max_indices(output_height * c.num_samples);
+  El::Zero(max_gradient);
+  El::Zero(avg_gradient);
+  for (int col = 0; col < c.num_samples; ++col) {
+    for (int channel = 0; channel < c.num_channels; ++channel) {
+      for (int j = 0; j < output_size; ++j) {
+        const int row = channel * output_size + j;
+        lbann::DataType max_entry = 0, sum = 0;
+        int max_pos = 0;
+        for (int w = 0; w < window_size; ++w) {
+          const int i = input_index(c, output_dims, j, w);
+          const lbann::DataType x
+            = (i < 0 ? 0 : input(channel * input_size + i, col));
+          if (w == 0 || x > max_entry) { max_entry = x; max_pos = w; }
+          sum += x;
+        }
+        max_output(row, col) = max_entry;
+        avg_output(row, col) = sum / window_size;
+        max_indices[col * output_height + row] = max_pos;
+        const auto dy = gradient_wrt_output(row, col);
+        const int max_i = input_index(c, output_dims, j, max_pos);
+        if (max_i >= 0) {
+          max_gradient(channel * input_size + max_i, col) += dy;
+        }
+        for (int w = 0; w < window_size; ++w) {
+          const int i = input_index(c, output_dims, j, w);
+          if (i >= 0) {
+            avg_gradient(channel * input_size + i, col) += dy / window_size;
+          }
+        }
+      }
+    }
+  }
+
+  // Direct kernels
+  lbann::CPUMat output(output_height, c.num_samples);
+  lbann::CPUMat gradient_wrt_input(input_height, c.num_samples);
+  lbann::max_pool_indices indices;
+  lbann::max_pool_forward(input, output, indices, c.num_channels, num_dims,
+                          c.input_dims.data(), c.pads.data(),
+                          c.window_dims.data(), c.strides.data());
+  REQUIRE(indices.size() == output_height * c.num_samples);
+  CHECK(indices.is_wide() == (window_size > 65536));
+  for (int col = 0; col < c.num_samples; ++col) {
+    for (int row = 0; row < output_height; ++row) {
+      CHECK(output(row, col) == max_output(row, col));
+      CHECK(indices.get(col * output_height + row)
+            == max_indices[col * output_height + row]);
+    }
+  }
+  lbann::max_pool_backward(gradient_wrt_output, indices, gradient_wrt_input,
+                           c.num_channels, num_dims,
+                           c.input_dims.data(), c.pads.data(),
+                           c.window_dims.data(), c.strides.data());
+  for (int col = 0; col < c.num_samples; ++col) {
+    for (int row = 0; row < input_height; ++row) {
+      CHECK(gradient_wrt_input(row, col) == max_gradient(row, col));
+    }
+  }
+
+  lbann::average_pool_forward(input, output, c.num_channels, num_dims,
+                              c.input_dims.data(), c.pads.data(),
+                              c.window_dims.data(), c.strides.data());
+  lbann::average_pool_backward(gradient_wrt_output, gradient_wrt_input,
+                               c.num_channels, num_dims,
+                               c.input_dims.data(), c.pads.data(),
+                               c.window_dims.data(), c.strides.data());
+  for (int col = 0; col < c.num_samples; ++col) {
+    for (int row = 0; row < output_height; ++row) {
+      CHECK(std::fabs(output(row, col) - avg_output(row, col)) <= 1e-5f);
+    }
+    for (int row = 0; row < input_height; ++row) {
+      CHECK(std::fabs(gradient_wrt_input(row, col) - avg_gradient(row, col))
+            <= 1e-5f);
+    }
+  }
+
+}
+
+} // namespace
+
+TEST_CASE("Testing direct pooling kernels", "[pooling][utilities]") {
+
+  SECTION("1D pooling") {
+    check_pooling({3, 2, {17}, {3}, {1}, {2}});
+  }
+
+  SECTION("2D pooling with overlapping windows and padding") {
+    check_pooling({2, 3, {11, 9}, {3, 3}, {1, 1}, {2, 2}});
+  }
+
+  SECTION("2D pooling with non-overlapping windows") {
+    check_pooling({2, 4, {8, 8}, {2, 2}, {0, 0}, {2, 2}});
+  }
+
+  SECTION("2D pooling with anisotropic parameters") {
+    check_pooling({1, 2, {7, 10}, {2, 4}, {1, 2}, {1, 3}});
+  }
+
+  SECTION("3D pooling") {
+    check_pooling({2, 2, {6, 5, 7}, {3, 2, 3}, {1, 0, 1}, {2, 2, 2}});
+  }
+
+  SECTION("Global pooling with 32-bit indices") {
+    check_pooling({2, 1, {300, 300}, {300, 300}, {0, 0}, {1, 1}});
+  }
+
+  SECTION("Unsupported dimensions") {
+    lbann::CPUMat input(16, 1), output(1, 1);
+    lbann::max_pool_indices indices;
+    const std::vector<int> dims(4, 2);
+    const std::vector<int> pads(4, 0);
+    CHECK_THROWS(lbann::max_pool_forward(input, output, indices, 1, 4,
+                                         dims.data(), pads.data(),
+                                         dims.data(), dims.data()));
+  }
+
+}
@@ -0,0 +1,97 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/fast_math.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+TEST_CASE("Testing fast math utilities", "[math][utilities]") {
+
+  SECTION("Single-precision exp matches std::exp") {
+    for (float x = -80.f; x <= 80.f; x += 0.037f) {
+      const float expected = std::exp(x);
+      const float actual = lbann::fast_math::exp(x);
+      CHECK(std::fabs(actual - expected) <= 4e-7f * expected);
+    }
+  }
+
+  SECTION("Single-precision exp does not underflow") {
+    CHECK(lbann::fast_math::exp(-1000.f) > 0.f);
+    CHECK(lbann::fast_math::exp(-std::numeric_limits<float>::max()) > 0.f);
+  }
+
+  SECTION("Single-precision exp of non-finite values") {
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    CHECK(std::isnan(lbann::fast_math::exp(nan)));
+    CHECK(std::isnan(lbann::fast_math::exp(-nan)));
+    CHECK(lbann::fast_math::exp(inf) == inf);
+    CHECK(lbann::fast_math::exp(-inf) == 0.f);
+  }
+
+  SECTION("Double-precision exp falls back to std::exp") {
+    CHECK(lbann::fast_math::exp(1.5) == std::exp(1.5));
+  }
+
+  SECTION("Single-sweep max and sum of exponentials") {
+    // Increasing entries force the running sum to be rescaled in
+    // every block
+    std::vector<double> x(1000);
+    for (size_t i = 0; i < x.size(); ++i) {
+      x[i] = 0.01 * i + std::sin(double(i));
+    }
+    double expected_max = std::numeric_limits<double>::lowest();
+    for (const auto& xi : x) { expected_max = std::max(expected_max, xi); }
+    double expected_sum = 0;
+    for (const auto& xi : x) { expected_sum += std::exp(xi - expected_max); }
+
+    double max = std::numeric_limits<double>::lowest(), sum = 0;
+    lbann::fast_math::max_and_sum_exp(x.data(), x.size(), max, sum);
+    CHECK(max == expected_max);
+    CHECK(sum == Approx(expected_sum));
+
+    // Partial reductions can be continued
+    max = std::numeric_limits<double>::lowest();
+    sum = 0;
+    lbann::fast_math::max_and_sum_exp(x.data(), size_t(300), max, sum);
+    lbann::fast_math::max_and_sum_exp(x.data() + 300, x.size() - 300, max, sum);
+    CHECK(max == expected_max);
+    CHECK(sum == Approx(expected_sum));
+  }
+
+  SECTION("NaN entries propagate to max and sum") {
+    std::vector<float> x(1000);
+    for (size_t i = 0; i < x.size(); ++i) { x[i] = std::sin(float(i)); }
+    x[517] = std::numeric_limits<float>::quiet_NaN();
+    float max = std::numeric_limits<float>::lowest(), sum = 0.f;
+    lbann::fast_math::max_and_sum_exp(x.data(), x.size(), max, sum);
+    CHECK(std::isnan(max));
+    CHECK(std::isnan(sum));
+  }
+
+  SECTION("Infinite entries") {
+    const float inf = std::numeric_limits<float>::infinity();
+    std::vector<float> x = {1.f, -inf, 2.f};
+    float max = std::numeric_limits<float>::lowest(), sum = 0.f;
+    lbann::fast_math::max_and_sum_exp(x.data(), x.size(), max, sum);
+    CHECK(max == 2.f);
+    CHECK(sum == Approx(std::exp(-1.f) + 1.f));
+    x[1] = inf;
+    max = std::numeric_limits<float>::lowest();
+    sum = 0.f;
+    lbann::fast_math::max_and_sum_exp(x.data(), x.size(), max, sum);
+    CHECK_FALSE(std::isfinite(max));
+    CHECK_FALSE(std::isfinite(sum));
+  }
+
+  SECTION("Empty input leaves reduction unchanged") {
+    float max = 2.f, sum = 3.f;
+    lbann::fast_math::max_and_sum_exp(static_cast<const float*>(nullptr), 0, max, sum);
+    CHECK(max == 2.f);
+    CHECK(sum == 3.f);
+  }
+
+}
@@ -0,0 +1,220 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/fused_entrywise.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+using lbann::DataType;
+
+/** y = a*x + b */
+class affine_op : public lbann::entrywise_fusion_interface {
+public:
+  affine_op(DataType a, DataType b) : m_a(a), m_b(b) {}
+  void fp_compute_entrywise(const DataType* x, DataType* y,
+                            El::Int size) const override {
+    for (El::Int i = 0; i < size; ++i) { y[i] = m_a * x[i] + m_b; }
+  }
+  void bp_compute_entrywise(const DataType*, const DataType* dy,
+                            DataType* dx, El::Int size) const override {
+    for (El::Int i = 0; i < size; ++i) { dx[i] = m_a * dy[i]; }
+  }
+private:
+  DataType m_a, m_b;
+};
+
+/** y = x^2 */
+class square_op : public lbann::entrywise_fusion_interface {
+public:
+  void fp_compute_entrywise(const DataType* x, DataType* y,
+                            El::Int size) const override {
+    for (El::Int i = 0; i < size; ++i) { y[i] = x[i] * x[i]; }
+  }
+  void bp_compute_entrywise(const DataType* x, const DataType* dy,
+                            DataType* dx, El::Int size) const override {
+    for (El::Int i = 0; i < size; ++i) { dx[i] = 2 * x[i] * dy[i]; }
+  }
+};
+
+/** y = sin(x) */
+class sin_op : public lbann::entrywise_fusion_interface {
+public:
+  void fp_compute_entrywise(const DataType* x, DataType* y,
+                            El::Int size) const override {
+    for (El::Int i = 0; i < size; ++i) { y[i] = std::sin(x[i]); }
+  }
+  void bp_compute_entrywise(const DataType* x, const DataType* dy,
+                            DataType* dx, El::Int size) const override {
+    for (El::Int i = 0; i < size; ++i) { dx[i] = std::cos(x[i]) * dy[i]; }
+  }
+};
+
+/** Apply operators one at a time, as unfused layers would. */
+void unfused_fp_bp(
+  const std::vector<const lbann::entrywise_fusion_interface*>& ops,
+  El::Int size,
+  const std::vector<DataType>& input,
+  const std::vector<DataType>& gradient_wrt_output,
+  std::vector<DataType>& output,
+  std::vector<DataType>& gradient_wrt_input) {
+  std::vector<std::vector<DataType>> activations(ops.size() + 1);
+  activations[0] = input;
+  for (size_t i = 0; i < ops.size(); ++i) {
+    activations[i+1].resize(size);
+    ops[i]->fp_compute_entrywise(activations[i].data(),
+                                 activations[i+1].data(),
+                                 size);
+  }
+  output = activations.back();
+  std::vector<DataType> grad = gradient_wrt_output;
+  for (size_t i = ops.size(); i-- > 0;) {
+    std::vector<DataType> next_grad(size);
+    ops[i]->bp_compute_entrywise(activations[i].data(), grad.data(),
+                                 next_grad.data(), size);
+    grad = std::move(next_grad);
+  }
+  gradient_wrt_input = grad;
+}
+
+} // namespace
+
+TEST_CASE("Testing fused entry-wise kernels", "[layers][utilities]") {
+
+  // Height spans several tiles and ends with a partial tile. The
+  // leading dimension is larger than the height.
+  const El::Int height = 2500, width = 3, ldim = 2503;
+  const El::Int size = ldim * width;
+  std::vector<DataType> input(size), gradient_wrt_output(size);
+  for (El::Int i = 0; i < size; ++i) {
+    input[i] = DataType(std::sin(0.37 * i));
+    gradient_wrt_output[i] = DataType(std::cos(0.11 * i));
+  }
+
+  const affine_op scale(DataType(0.5), DataType(-0.25));
+  const square_op square;
+  const sin_op sine;
+  const std::vector<const lbann::entrywise_fusion_interface*> ops
+    = {&scale, &square, &sine, &scale};
+  std::vector<DataType> ref_output, ref_gradient_wrt_input;
+  unfused_fp_bp(ops, size, input, gradient_wrt_output,
+                ref_output, ref_gradient_wrt_input);
+
+  SECTION("Fused output matches unfused output") {
+    std::vector<DataType> output(size, DataType(-7));
+    std::vector<DataType> gradient_wrt_input(size, DataType(-7));
+    std::vector<DataType> workspace;
+    lbann::fused_entrywise_fp(ops, height, width,
+                              input.data(), ldim,
+                              output.data(), ldim);
+    lbann::fused_entrywise_bp(ops, height, width,
+                              input.data(), ldim,
+                              gradient_wrt_output.data(), ldim,
+                              gradient_wrt_input.data(), ldim,
+                              workspace);
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < ldim; ++row) {
+        const auto i = row + col * ldim;
+        if (row < height) {
+          REQUIRE(output[i] == Approx(ref_output[i]));
+          REQUIRE(gradient_wrt_input[i]
+                  == Approx(ref_gradient_wrt_input[i]));
+        } else {
+          // Padding past the height is not touched
+          REQUIRE(output[i] == DataType(-7));
+          REQUIRE(gradient_wrt_input[i] == DataType(-7));
+        }
+      }
+    }
+  }
+
+  SECTION("In-place fused kernels") {
+    std::vector<DataType> output = input;
+    std::vector<DataType> gradient = gradient_wrt_output;
+    std::vector<DataType> workspace;
+    lbann::fused_entrywise_fp(ops, height, width,
+                              output.data(), ldim,
+                              output.data(), ldim);
+    lbann::fused_entrywise_bp(ops, height, width,
+                              input.data(), ldim,
+                              gradient.data(), ldim,
+                              gradient.data(), ldim,
+                              workspace);
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        const auto i = row + col * ldim;
+        REQUIRE(output[i] == Approx(ref_output[i]));
+        REQUIRE(gradient[i] == Approx(ref_gradient_wrt_input[i]));
+      }
+    }
+  }
+
+  SECTION("Single operator") {
+    const std::vector<const lbann::entrywise_fusion_interface*> single
+      = {&sine};
+    std::vector<DataType> output(size), gradient_wrt_input(size);
+    std::vector<DataType> workspace;
+    lbann::fused_entrywise_fp(single, height, width,
+                              input.data(), ldim,
+                              output.data(), ldim);
+    lbann::fused_entrywise_bp(single, height, width,
+                              input.data(), ldim,
+                              gradient_wrt_output.data(), ldim,
+                              gradient_wrt_input.data(), ldim,
+                              workspace);
+    for (El::Int i = 0; i < height; ++i) {
+      REQUIRE(output[i] == Approx(std::sin(input[i])));
+      REQUIRE(gradient_wrt_input[i]
+              == Approx(std::cos(input[i]) * gradient_wrt_output[i]));
+    }
+  }
+
+  SECTION("Reduced-precision storage fused into kernels") {
+    const auto format = lbann::storage_format::bfloat16;
+    std::vector<DataType> output(size);
+    std::vector<uint16_t> stored_input(height * width);
+    lbann::fused_entrywise_fp(ops, height, width,
+                              input.data(), ldim,
+                              output.data(), ldim,
+                              format, stored_input.data());
+
+    // Backprop sees the rounded input, which it also restores
+    std::vector<DataType> rounded_input(size), restored_input(size);
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        const auto i = row + col * ldim;
+        const auto& x = stored_input[row + col * height];
+        REQUIRE(x == lbann::float_to_bfloat16(input[i]));
+        REQUIRE(output[i] == Approx(ref_output[i]));
+        rounded_input[i] = lbann::bfloat16_to_float(x);
+      }
+    }
+    std::vector<DataType> rounded_output, rounded_gradient_wrt_input;
+    unfused_fp_bp(ops, size, rounded_input, gradient_wrt_output,
+                  rounded_output, rounded_gradient_wrt_input);
+    std::vector<DataType> gradient_wrt_input(size);
+    std::vector<uint16_t> stored_gradient_wrt_input(height * width);
+    std::vector<DataType> workspace;
+    lbann::fused_entrywise_bp(ops, height, width,
+                              format, stored_input.data(),
+                              restored_input.data(), ldim,
+                              gradient_wrt_output.data(), ldim,
+                              gradient_wrt_input.data(), ldim,
+                              format, stored_gradient_wrt_input.data(),
+                              workspace);
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        const auto i = row + col * ldim;
+        REQUIRE(restored_input[i] == rounded_input[i]);
+        REQUIRE(gradient_wrt_input[i]
+                == Approx(rounded_gradient_wrt_input[i]));
+        REQUIRE(stored_gradient_wrt_input[row + col * height]
+                == lbann::float_to_bfloat16(gradient_wrt_input[i]));
+      }
+    }
+  }
+
+}
@@ -0,0 +1,206 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/grouped_convolution.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+/** Convolution configuration for a single test case. */
+struct conv_config {
+  int num_samples;
+  int num_input_channels;
+  int num_output_channels;
+  int num_groups;
+  std::vector<int> input_dims;
+  std::vector<int> kernel_dims;
+  std::vector<int> pads;
+  std::vector<int> strides;
+};
+
+std::vector<int> get_output_dims(const conv_config& c) {
+  std::vector<int> dims(c.input_dims.size());
+  for (size_t d = 0; d < dims.size(); ++d) {
+    const int effective_dim = (c.input_dims[d] + 2 * c.pads[d]
+                               - c.kernel_dims[d] + 1);
+    dims[d] = (effective_dim + c.strides[d] - 1) / c.strides[d];
+  }
+  return dims;
+}
+
+int product(const std::vector<int>& dims) {
+  int size = 1;
+  for (const auto& d : dims) { size *= d; }
+  return size;
+}
+
+/** Input index for an output position and kernel position within a
+ *  channel, or -1 if the entry is in the padding.
+ */
+int input_index(const conv_config& c, const std::vector<int>& output_dims,
+                int output_pos, int kernel_pos) {
+  const int num_dims = c.input_dims.size();
+  std::vector<int> out(num_dims), ker(num_dims);
+  for (int d = num_dims - 1; d >= 0; --d) {
+    out[d] = output_pos % output_dims[d];
+    output_pos /= output_dims[d];
+    ker[d] = kernel_pos % c.kernel_dims[d];
+    kernel_pos /= c.kernel_dims[d];
+  }
+  int index = 0;
+  for (int d = 0; d < num_dims; ++d) {
+    const int pos = out[d] * c.strides[d] - c.pads[d] + ker[d];
+    if (pos < 0 || pos >= c.input_dims[d]) { return -1; }
+    index = index * c.input_dims[d] + pos;
+  }
+  return index;
+}
+
+/** Check direct kernels against a naive implementation. */
+void check_convolution(const conv_config& c) {
+  const int num_dims = c.input_dims.size();
+  const auto output_dims = get_output_dims(c);
+  const int input_size = product(c.input_dims);
+  const int output_size = product(output_dims);
+  const int kernel_size = product(c.kernel_dims);
+  const int input_height = input_size * c.num_input_channels;
+  const int output_height = output_size * c.num_output_channels;
+  const int in_per_group = c.num_input_channels / c.num_groups;
+  const int out_per_group = c.num_output_channels / c.num_groups;
+  const int kernel_height = c.num_output_channels * in_per_group * kernel_size;
+
+  lbann::CPUMat input(input_height, c.num_samples);
+  lbann::CPUMat gradient_wrt_output(output_height, c.num_samples);
+  lbann::CPUMat kernel(kernel_height, 1);
+  for (int col = 0; col < c.num_samples; ++col) {
+    for (int row = 0; row < input_height; ++row) {
+      input(row, col) = lbann::DataType((row * 7 + col * 13) % 23 - 11) / 8;
+    }
+    for (int row = 0; row < output_height; ++row) {
+      gradient_wrt_output(row, col)
+        = lbann::DataType((row * 5 + col * 3) % 11 - 5) / 4;
+    }
+  }
+  for (int row = 0; row < kernel_height; ++row) {
+    kernel(row, 0) = lbann::DataType(row % 9 - 4) / 4;
+  }
+
+  // Naive reference
+  lbann::CPUMat ref_output(output_height, c.num_samples);
+  lbann::CPUMat ref_gradient_wrt_input(input_height, c.num_samples);
+  lbann::CPUMat ref_gradient_wrt_kernel(kernel_height, 1);
+  El::Zero(ref_output);
+  El::Zero(ref_gradient_wrt_input);
+  El::Zero(ref_gradient_wrt_kernel);
+  for (int col = 0; col < c.num_samples; ++col) {
+    for (int out_channel = 0; out_channel < c.num_output_channels; ++out_channel) {
+      const int group = out_channel / out_per_group;
+      for (int i = 0; i < in_per_group; ++i) {
+        const int in_channel = group * in_per_group + i;
+        const int kernel_offset = (out_channel * in_per_group + i) * kernel_size;
+        for (int j = 0; j < output_size; ++j) {
+          const int out_row = out_channel * output_size + j;
+          for (int k = 0; k < kernel_size; ++k) {
+            const int index = input_index(c, output_dims, j, k);
+            if (index < 0) { continue; }
+            const int in_row = in_channel * input_size + index;
+            const auto w = kernel(kernel_offset + k, 0);
+            const auto dy = gradient_wrt_output(out_row, col);
+            ref_output(out_row, col) += w * input(in_row, col);
+            ref_gradient_wrt_input(in_row, col) += w * dy;
+            ref_gradient_wrt_kernel(kernel_offset + k, 0)
+              += input(in_row, col) * dy;
+          }
+        }
+      }
+    }
+  }
+
+  // Direct kernels
+  const lbann::DataType scale = 0.5;
+  lbann::CPUMat output(output_height, c.num_samples);
+  lbann::CPUMat gradient_wrt_input(input_height, c.num_samples);
+  lbann::CPUMat gradient_wrt_kernel(kernel_height, 1);
+  for (int row = 0; row < kernel_height; ++row) {
+    gradient_wrt_kernel(row, 0) = 1;
+  }
+  lbann::grouped_convolution_forward(input, kernel, output,
+                                     c.num_input_channels,
+                                     c.num_output_channels,
+                                     c.num_groups, num_dims,
+                                     c.input_dims.data(), c.pads.data(),
+                                     c.kernel_dims.data(), c.strides.data());
+  lbann::grouped_convolution_backward_data(gradient_wrt_output, kernel,
+                                           gradient_wrt_input,
+                                           c.num_input_channels,
+                                           c.num_output_channels,
+                                           c.num_groups, num_dims,
+                                           c.input_dims.data(), c.pads.data(),
+                                           c.kernel_dims.data(),
+                                           c.strides.data());
+  lbann::grouped_convolution_backward_filter(input, gradient_wrt_output,
+                                             gradient_wrt_kernel, scale,
+                                             c.num_input_channels,
+                                             c.num_output_channels,
+                                             c.num_groups, num_dims,
+                                             c.input_dims.data(),
+                                             c.pads.data(),
+                                             c.kernel_dims.data(),
+                                             c.strides.data());
+  for (int col = 0; col < c.num_samples; ++col) {
+    for (int row = 0; row < output_height; ++row) {
+      CHECK(std::fabs(output(row, col) - ref_output(row, col)) <= 1e-4f);
+    }
+    for (int row = 0; row < input_height; ++row) {
+      CHECK(std::fabs(gradient_wrt_input(row, col)
+                      - ref_gradient_wrt_input(row, col)) <= 1e-4f);
+    }
+  }
+  for (int row = 0; row < kernel_height; ++row) {
+    const auto expected = 1 + scale * ref_gradient_wrt_kernel(row, 0);
+    CHECK(std::fabs(gradient_wrt_kernel(row, 0) - expected) <= 1e-3f);
+  }
+
+}
+
+} // namespace
+
+TEST_CASE("Testing grouped convolution kernels", "[convolution][utilities]") {
+
+  SECTION("1D depthwise convolution") {
+    check_convolution({3, 4, 4, 4, {17}, {3}, {1}, {1}});
+  }
+
+  SECTION("2D depthwise convolution") {
+    check_convolution({2, 6, 6, 6, {11, 9}, {3, 3}, {1, 1}, {1, 1}});
+  }
+
+  SECTION("2D depthwise convolution with stride") {
+    check_convolution({2, 3, 3, 3, {12, 13}, {3, 3}, {1, 1}, {2, 2}});
+  }
+
+  SECTION("2D depthwise convolution with channel multiplier") {
+    check_convolution({2, 3, 6, 3, {8, 8}, {5, 5}, {2, 2}, {1, 1}});
+  }
+
+  SECTION("2D grouped convolution with anisotropic parameters") {
+    check_convolution({2, 8, 4, 2, {7, 10}, {2, 4}, {1, 2}, {1, 3}});
+  }
+
+  SECTION("3D grouped convolution") {
+    check_convolution({2, 4, 6, 2, {6, 5, 7}, {3, 2, 3}, {1, 0, 1}, {2, 1, 2}});
+  }
+
+  SECTION("Invalid groups") {
+    lbann::CPUMat input(16, 1), kernel(16, 1), output(16, 1);
+    const std::vector<int> dims(2, 4);
+    const std::vector<int> pads(2, 0), kernel_dims(2, 1), strides(2, 1);
+    CHECK_THROWS(lbann::grouped_convolution_forward(
+                   input, kernel, output, 1, 1, 3, 2, dims.data(),
+                   pads.data(), kernel_dims.data(), strides.data()));
+  }
+
+}
@@ -0,0 +1,85 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/memory_planner.hpp>
+
+#include <lbann/utils/exception.hpp>
+
+TEST_CASE("Testing memory_planner", "[memory][utilities]") {
+
+  lbann::memory_planner planner;
+
+  SECTION("Disjoint lifetimes share storage") {
+    auto a = planner.add_buffer(100, 0, 1);
+    auto b = planner.add_buffer(100, 2, 3);
+    auto c = planner.add_buffer(50, 4, 5);
+    planner.plan();
+    CHECK(planner.get_naive_size() == 250);
+    CHECK(planner.get_peak_live_size() == 100);
+    CHECK(planner.get_planned_size() == 100);
+    CHECK(planner.get_offset(a) == 0);
+    CHECK(planner.get_offset(b) == 0);
+    CHECK(planner.get_offset(c) == 0);
+  }
+
+  SECTION("Overlapping lifetimes do not share storage") {
+    auto a = planner.add_buffer(100, 0, 2);
+    auto b = planner.add_buffer(60, 1, 3);
+    auto c = planner.add_buffer(40, 2, 4);
+    planner.plan();
+    CHECK(planner.get_naive_size() == 200);
+    CHECK(planner.get_peak_live_size() == 200);
+    CHECK(planner.get_planned_size() == 200);
+    CHECK(planner.get_offset(a) == 0);
+    CHECK(planner.get_offset(b) == 100);
+    CHECK(planner.get_offset(c) == 160);
+  }
+
+  SECTION("Small buffers are placed in gaps") {
+    planner.add_buffer(100, 0, 1);
+    planner.add_buffer(100, 0, 5);
+    auto c = planner.add_buffer(60, 2, 3);
+    auto d = planner.add_buffer(40, 2, 3);
+    planner.plan();
+    CHECK(planner.get_planned_size() == 200);
+    CHECK(planner.get_offset(c) + 60 <= planner.get_offset(d));
+  }
+
+  SECTION("Aliases extend lifetime of storage") {
+    auto a = planner.add_buffer(100, 0, 1);
+    auto b = planner.add_alias(a, 1, 3);
+    auto c = planner.add_buffer(100, 2, 3);
+    planner.plan();
+    CHECK(planner.get_naive_size() == 200);
+    CHECK(planner.get_planned_size() == 200);
+    CHECK(planner.get_offset(a) == planner.get_offset(b));
+    CHECK(planner.get_offset(a) != planner.get_offset(c));
+  }
+
+  SECTION("In-place chains share a single buffer") {
+    // Error signals of a chain of entry-wise layers, each computed
+    // over its child's error signal during backprop
+    auto a = planner.add_buffer(100, 0, 1);
+    auto b = planner.add_alias(a, 1, 2);
+    auto c = planner.add_alias(b, 2, 3);
+    auto d = planner.add_alias(c, 3, 4);
+    auto e = planner.add_buffer(100, 5, 6);
+    planner.plan();
+    CHECK(planner.get_naive_size() == 200);
+    CHECK(planner.get_aliased_size() == 300);
+    CHECK(planner.get_planned_size() == 100);
+    CHECK(planner.get_offset(b) == planner.get_offset(a));
+    CHECK(planner.get_offset(c) == planner.get_offset(a));
+    CHECK(planner.get_offset(d) == planner.get_offset(a));
+    CHECK(planner.get_offset(e) == planner.get_offset(a));
+  }
+
+  SECTION("Invalid buffers") {
+    REQUIRE_THROWS_AS(planner.add_buffer(-1, 0, 1), lbann::exception);
+    REQUIRE_THROWS_AS(planner.add_buffer(10, 2, 1), lbann::exception);
+    REQUIRE_THROWS_AS(planner.add_alias(0, 0, 1), lbann::exception);
+    REQUIRE_THROWS_AS(planner.get_planned_size(), lbann::exception);
+  }
+
+}
@@ -0,0 +1,86 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/pipeline_schedule.hpp>
+
+#include <lbann/utils/exception.hpp>
+
+TEST_CASE("Testing pipeline schedule utilities", "[pipeline][utilities]") {
+
+  SECTION("Partition balances contiguous stages") {
+    const auto& starts = lbann::pipeline::partition(
+      {1, 2, 3, 4, 5, 6, 7, 8, 9}, 3);
+    REQUIRE(starts.size() == 3);
+    CHECK(starts[0] == 0);
+    CHECK(starts[1] == 5);
+    CHECK(starts[2] == 7);
+  }
+
+  SECTION("Partition does not create empty stages") {
+    const auto& starts = lbann::pipeline::partition({5, 1}, 4);
+    REQUIRE(starts.size() == 2);
+    CHECK(starts[0] == 0);
+    CHECK(starts[1] == 1);
+  }
+
+  SECTION("Invalid number of stages") {
+    CHECK_THROWS_AS(lbann::pipeline::partition({1, 2}, 0),
+                    lbann::exception);
+  }
+
+  SECTION("1F1B schedule") {
+    const auto& steps = lbann::pipeline::one_forward_one_backward(4, 8);
+    REQUIRE(steps.size() == 4);
+    for (const auto& stage_steps : steps) {
+      REQUIRE(stage_steps.size() == 16);
+      int num_forward = 0, num_backward = 0;
+      for (const auto& op : stage_steps) {
+        if (op.forward) {
+          CHECK(op.micro_batch == num_forward++);
+        } else {
+          CHECK(op.micro_batch == num_backward++);
+          CHECK(num_backward <= num_forward);
+        }
+      }
+    }
+    // First stage warms up with one forward step per later stage
+    for (int i = 0; i < 4; ++i) {
+      CHECK(steps[0][i].forward);
+    }
+    CHECK_FALSE(steps[0][4].forward);
+    // Last stage alternates forward and backward steps
+    for (int i = 0; i < 16; ++i) {
+      CHECK(steps[3][i].forward == (i % 2 == 0));
+    }
+  }
+
+  SECTION("Simulated bubble with uniform costs") {
+    const auto& steps = lbann::pipeline::one_forward_one_backward(4, 8);
+    const auto& result = lbann::pipeline::simulate(steps,
+                                                   {1, 1, 1, 1},
+                                                   {2, 2, 2, 2});
+    CHECK(result.total_time == Approx(33));
+    CHECK(result.bubble_fraction == Approx(3.0 / 11.0));
+    REQUIRE(result.idle_times.size() == 4);
+    for (const auto& idle_time : result.idle_times) {
+      CHECK(idle_time == Approx(9));
+    }
+  }
+
+  SECTION("Single stage has no bubble") {
+    const auto& steps = lbann::pipeline::one_forward_one_backward(1, 4);
+    const auto& result = lbann::pipeline::simulate(steps, {1}, {1}, 0.5);
+    CHECK(result.total_time == Approx(8));
+    CHECK(result.bubble_fraction == Approx(0));
+  }
+
+  SECTION("Circular dependencies are detected") {
+    lbann::pipeline::schedule steps(2);
+    steps[0] = {{false, 0}, {true, 0}};
+    steps[1] = {{true, 0}, {false, 0}};
+    CHECK_THROWS_AS(lbann::pipeline::simulate(steps, {1, 1}, {1, 1}),
+                    lbann::exception);
+  }
+
+}
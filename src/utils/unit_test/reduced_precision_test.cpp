@@ -0,0 +1,147 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/reduced_precision.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+using lbann::DataType;
+
+/** Float with given bit pattern. */
+float from_bits(uint32_t bits) {
+  float x;
+  std::memcpy(&x, &bits, sizeof(x));
+  return x;
+}
+
+} // namespace
+
+TEST_CASE("Testing bfloat16 conversions", "[utilities]") {
+
+  SECTION("Representable values are exact") {
+    for (const float x : {0.f, -0.f, 1.f, -2.f, 1.5f, 0.15625f, 3.f * 1024}) {
+      CHECK(lbann::bfloat16_to_float(lbann::float_to_bfloat16(x)) == x);
+    }
+    CHECK(lbann::float_to_bfloat16(1.f) == 0x3f80);
+  }
+
+  SECTION("Ties round to even") {
+    // 1 + 2^-8 is halfway between 1 and 1 + 2^-7
+    CHECK(lbann::float_to_bfloat16(from_bits(0x3f808000u)) == 0x3f80);
+    CHECK(lbann::float_to_bfloat16(from_bits(0x3f818000u)) == 0x3f82);
+    CHECK(lbann::float_to_bfloat16(from_bits(0x3f808001u)) == 0x3f81);
+  }
+
+  SECTION("Special values") {
+    const auto inf = std::numeric_limits<float>::infinity();
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    CHECK(lbann::bfloat16_to_float(lbann::float_to_bfloat16(inf)) == inf);
+    CHECK(lbann::bfloat16_to_float(lbann::float_to_bfloat16(-inf)) == -inf);
+    CHECK(std::isnan(lbann::bfloat16_to_float(lbann::float_to_bfloat16(nan))));
+    // NaN with only low mantissa bits set must not become infinity
+    CHECK(std::isnan(lbann::bfloat16_to_float(
+                       lbann::float_to_bfloat16(from_bits(0x7f800001u)))));
+    // Largest finite float rounds to infinity like any overflow
+    CHECK(lbann::float_to_bfloat16(std::numeric_limits<float>::max())
+          == 0x7f80);
+  }
+
+}
+
+TEST_CASE("Testing float16 conversions", "[utilities]") {
+
+  SECTION("Representable values are exact") {
+    for (const float x : {0.f, -0.f, 1.f, -2.f, 1.5f, 0.15625f, 65504.f}) {
+      CHECK(lbann::float16_to_float(lbann::float_to_float16(x)) == x);
+    }
+    CHECK(lbann::float_to_float16(1.f) == 0x3c00);
+    CHECK(lbann::float_to_float16(65504.f) == 0x7bff);
+  }
+
+  SECTION("Ties round to even") {
+    // 1 + 2^-11 is halfway between 1 and 1 + 2^-10
+    CHECK(lbann::float_to_float16(1.f + std::ldexp(1.f, -11)) == 0x3c00);
+    CHECK(lbann::float_to_float16(1.f + 3 * std::ldexp(1.f, -11)) == 0x3c02);
+  }
+
+  SECTION("Overflow becomes infinity") {
+    CHECK(lbann::float_to_float16(65519.f) == 0x7bff);
+    CHECK(lbann::float_to_float16(65520.f) == 0x7c00);
+    CHECK(lbann::float_to_float16(-1e6f) == 0xfc00);
+    const auto inf = std::numeric_limits<float>::infinity();
+    CHECK(lbann::float16_to_float(lbann::float_to_float16(inf)) == inf);
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    CHECK(std::isnan(lbann::float16_to_float(lbann::float_to_float16(nan))));
+  }
+
+  SECTION("Subnormals") {
+    const auto min_subnormal = std::ldexp(1.f, -24);
+    const auto min_normal = std::ldexp(1.f, -14);
+    CHECK(lbann::float_to_float16(min_subnormal) == 0x0001);
+    CHECK(lbann::float16_to_float(0x0001) == min_subnormal);
+    CHECK(lbann::float_to_float16(min_normal) == 0x0400);
+    CHECK(lbann::float16_to_float(0x03ff) == min_normal - min_subnormal);
+    // Halfway cases round to even
+    CHECK(lbann::float_to_float16(min_subnormal / 2) == 0x0000);
+    CHECK(lbann::float_to_float16(3 * min_subnormal / 2) == 0x0002);
+    CHECK(lbann::float_to_float16(-min_subnormal / 4) == 0x8000);
+  }
+
+}
+
+TEST_CASE("Testing reduced-precision matrices", "[utilities]") {
+
+  SECTION("Storage format names") {
+    CHECK(lbann::storage_format_from_string("")
+          == lbann::storage_format::full);
+    CHECK(lbann::storage_format_from_string("bf16")
+          == lbann::storage_format::bfloat16);
+    CHECK(lbann::storage_format_from_string("float16")
+          == lbann::storage_format::float16);
+    CHECK(lbann::to_string(lbann::storage_format::bfloat16) == "bfloat16");
+    CHECK_THROWS(lbann::storage_format_from_string("int8"));
+  }
+
+  SECTION("Stored matrices round each entry") {
+    const El::Int height = 5, width = 3, ldim = 7;
+    lbann::CPUMat x(height, width, ldim);
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        x(row, col) = DataType(std::sin(0.7 * row + 1.3 * col));
+      }
+    }
+    for (const auto format : {lbann::storage_format::bfloat16,
+                              lbann::storage_format::float16}) {
+      lbann::reduced_precision_matrix stored;
+      stored.store(format, x);
+      CHECK(stored.get_format() == format);
+      CHECK(stored.get_height() == height);
+      CHECK(stored.get_width() == width);
+      lbann::CPUMat y(height, width, ldim + 2);
+      stored.load(y);
+      for (El::Int col = 0; col < width; ++col) {
+        for (El::Int row = 0; row < height; ++row) {
+          const auto& expected
+            = (format == lbann::storage_format::bfloat16 ?
+               lbann::bfloat16_to_float(lbann::float_to_bfloat16(x(row, col))) :
+               lbann::float16_to_float(lbann::float_to_float16(x(row, col))));
+          CHECK(y(row, col) == expected);
+        }
+      }
+      lbann::CPUMat z(height + 1, width);
+      CHECK_THROWS(stored.load(z));
+    }
+  }
+
+  SECTION("Full precision is not a storage format") {
+    lbann::reduced_precision_matrix stored;
+    CHECK_THROWS(stored.resize(lbann::storage_format::full, 2, 2));
+  }
+
+}
@@ -0,0 +1,101 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/step_timing.hpp>
+
+#include <lbann/utils/exception.hpp>
+#include <lbann/utils/timer.hpp>
+
+namespace {
+
+/** Busy-wait for a given number of seconds. */
+void spin(double seconds) {
+  const auto start = lbann::get_time();
+  while (lbann::get_time() - start < seconds) {}
+}
+
+} // namespace
+
+TEST_CASE("Testing step_timing", "[timing][utilities]") {
+
+  using lbann::step_timing;
+  using category = step_timing::category;
+  const auto mode = lbann::execution_mode::training;
+  step_timing timing;
+
+  SECTION("Scopes outside a step are not recorded") {
+    {
+      step_timing::scope s(category::fp_compute);
+      spin(1e-3);
+    }
+    CHECK(timing.get_steps(mode).empty());
+  }
+
+  SECTION("Categories add up to the step time") {
+    const auto start = lbann::get_time();
+    timing.begin_step();
+    {
+      step_timing::scope s(category::fp_compute);
+      spin(2e-3);
+    }
+    spin(1e-3);
+    timing.end_step(mode);
+    const auto step_time = lbann::get_time() - start;
+
+    REQUIRE(timing.get_steps(mode).size() == 1);
+    const auto& step = timing.get_steps(mode).front();
+    lbann::EvalType total = 0;
+    for (const auto& t : step) {
+      CHECK(t >= 0);
+      total += t;
+    }
+    CHECK(total <= step_time);
+    CHECK(step[static_cast<int>(category::fp_compute)] >= 2e-3);
+    CHECK(step[static_cast<int>(category::other)] >= 1e-3);
+    CHECK(step[static_cast<int>(category::bp_compute)] == 0);
+  }
+
+  SECTION("Nested scopes are exclusive") {
+    timing.begin_step();
+    {
+      step_timing::scope s(category::fp_compute);
+      spin(1e-3);
+      {
+        step_timing::scope inner(category::comm_wait);
+        spin(3e-3);
+      }
+      spin(1e-3);
+    }
+    timing.end_step(mode);
+
+    const auto& step = timing.get_steps(mode).front();
+    const auto fp_time = step[static_cast<int>(category::fp_compute)];
+    const auto comm_time = step[static_cast<int>(category::comm_wait)];
+    CHECK(comm_time >= 3e-3);
+    CHECK(fp_time >= 2e-3);
+    CHECK(fp_time < 2e-3 + comm_time);
+  }
+
+  SECTION("Totals and reset") {
+    for (int i = 0; i < 3; ++i) {
+      timing.begin_step();
+      {
+        step_timing::scope s(category::optimizer);
+        spin(1e-3);
+      }
+      timing.end_step(mode);
+    }
+    CHECK(timing.get_steps(mode).size() == 3);
+    CHECK(timing.get_steps(lbann::execution_mode::testing).empty());
+    const auto totals = timing.get_totals(mode);
+    CHECK(totals[static_cast<int>(category::optimizer)] >= 3e-3);
+    timing.reset(mode);
+    CHECK(timing.get_steps(mode).empty());
+  }
+
+  SECTION("Ending a step that was not started") {
+    REQUIRE_THROWS_AS(timing.end_step(mode), lbann::exception);
+  }
+
+}
@@ -508,9 +508,11 @@ bool weights::load_from_save(std::string const& ckpt_dir, std::vector<std::strin
 
 bool weights::save_to_checkpoint_distributed(lbann::persist& p){
   // Functions identically to shared checkpoint except weights and parameters are saved on a per rank basis
+  // Note: The name does not depend on the process layout, so the
+  // checkpoint index can be used to restart on a different layout.
   auto l_name = El::BuildString("weights_", m_name,
-                                "_", m_values->LocalHeight(),
-                                "x", m_values->LocalWidth(), ".bin");
+                                "_", m_values->Height(),
+                                "x", m_values->Width(), ".bin");
   p.write_rank_distmat(persist_type::model, l_name.c_str(), *m_values);
   if (m_optimizer != nullptr) {
     m_optimizer->save_to_checkpoint_distributed(p, m_name);
@@ -521,9 +523,16 @@ bool weights::save_to_checkpoint_distributed(lbann::persist& p){
 bool weights::load_from_checkpoint_distributed(lbann::persist& p){
   // Functions identically to shared checkpoint except weights and parameters are loaded on a per rank basis
   auto l_name = El::BuildString("weights_", m_name,
-                                "_", m_values->LocalHeight(),
-                                "x", m_values->LocalWidth(), ".bin");
-  p.read_rank_distmat(persist_type::model, l_name.c_str(), *m_values);
+                                "_", m_values->Height(),
+                                "x", m_values->Width(), ".bin");
+  if (!p.read_rank_distmat(persist_type::model, l_name.c_str(), *m_values)
+      && !p.is_elastic_restart()) {
+    // Older checkpoints name weights by their local dimensions
+    l_name = El::BuildString("weights_", m_name,
+                             "_", m_values->LocalHeight(),
+                             "x", m_values->LocalWidth(), ".bin");
+    p.read_rank_distmat(persist_type::model, l_name.c_str(), *m_values);
+  }
   if (m_optimizer != nullptr) {
     m_optimizer->load_from_checkpoint_distributed(p, m_name);
   }
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+
+"""
+Pack the images in an image list into large shard files.
+
+The image list has the format used by imagenet_reader: one
+"<image path> <label>" pair per line, with paths relative to an image
+directory. Encoded images are concatenated without re-encoding into
+shard files of roughly a given size. Each shard gets an index file
+(<shard>.idx) that records the position, size, and label of every
+image. A shard list file with one shard per line is written to the
+output directory.
+
+To read the shards, set the imagenet reader's data_filedir to the
+output directory, data_filename to the shard list file, and format to
+"image_shards" (or "image_shards_mmap" to memory-map the shards). See
+include/lbann/data_readers/image_shards.hpp for the file format.
+"""
+
+import argparse
+import os
+import struct
+
+MAGIC = b"LBANNSHD"
+VERSION = 1
+BYTE_ORDER = 0x01020304
+HEADER_FORMAT = "<8sIIQQ"
+RECORD_FORMAT = "<QQq"
+
+def write_index(path, records, data_size):
+    with open(path, "wb") as f:
+        f.write(struct.pack(HEADER_FORMAT, MAGIC, VERSION, BYTE_ORDER,
+                            len(records), data_size))
+        for offset, length, label in records:
+            f.write(struct.pack(RECORD_FORMAT, offset, length, label))
+
+def read_image_list(path):
+    samples = []
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) < 2:
+                continue
+            samples.append((fields[0], int(fields[1])))
+    return samples
+
+def pack_image_shards(samples, image_dir, out_dir, prefix, shard_size):
+    os.makedirs(out_dir, exist_ok=True)
+    shard_names = []
+    shard = None
+    records = []
+    data_size = 0
+
+    def finish_shard():
+        shard.close()
+        write_index(os.path.join(out_dir, shard_names[-1] + ".idx"),
+                    records, data_size)
+
+    for path, label in samples:
+        if shard is None or (records and data_size >= shard_size):
+            if shard is not None:
+                finish_shard()
+            shard_names.append("{}_{:05d}.shard".format(prefix,
+                                                        len(shard_names)))
+            shard = open(os.path.join(out_dir, shard_names[-1]), "wb")
+            records = []
+            data_size = 0
+        with open(os.path.join(image_dir, path), "rb") as f:
+            data = f.read()
+        shard.write(data)
+        records.append((data_size, len(data), label))
+        data_size += len(data)
+    if shard is not None:
+        finish_shard()
+
+    list_path = os.path.join(out_dir, prefix + "_shards.txt")
+    with open(list_path, "w") as f:
+        for name in shard_names:
+            f.write(name + "\n")
+    return list_path, len(shard_names)
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Pack images into shard files for imagenet_reader.")
+    parser.add_argument("image_list", type=str,
+                        help="Image list with \"<path> <label>\" lines")
+    parser.add_argument("image_dir", type=str,
+                        help="Directory that image paths are relative to")
+    parser.add_argument("out_dir", type=str,
+                        help="Output directory for shards")
+    parser.add_argument("--prefix", type=str, default="images",
+                        help="Shard file name prefix (default: images)")
+    parser.add_argument("--shard_size", type=int, default=256,
+                        help="Target shard size in MiB (default: 256)")
+    args = parser.parse_args()
+
+    samples = read_image_list(args.image_list)
+    list_path, num_shards = pack_image_shards(
+        samples, args.image_dir, args.out_dir, args.prefix,
+        args.shard_size * 1024 * 1024)
+    print("Packed {} images into {} shards ({})".format(
+        len(samples), num_shards, list_path))
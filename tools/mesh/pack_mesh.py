@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+
+"""
+Pack dumped mesh images into a single file for mesh_reader.
+
+The input directory has the layout read by mesh_reader: one
+subdirectory per channel (<channel><suffix>/<channel><index>.bin),
+each file holding a height x width image of float32 values in
+row-major order. The output file holds one fixed-size record per
+sample with all channels followed by the target, stored in the
+column-major layout used by mesh_reader, so each sample can be read
+with a single pread.
+
+To read the packed file, set the mesh reader's data_filename to the
+output file and format to "mesh_packed". See
+include/lbann/data_readers/data_reader_mesh.hpp for the file format.
+"""
+
+import argparse
+import glob
+import os
+import struct
+import numpy as np
+
+MAGIC = b"LBANNMSH"
+VERSION = 1
+BYTE_ORDER = 0x01020304
+HEADER_FORMAT = "<8sIIQIIII"
+
+# Must match mesh_reader::m_channels
+CHANNELS = [
+    "Density",
+    "Pressure",
+    "VectorComp_AvgVelocity_R",
+    "VolumeFractions_bubble",
+    "aspectRatio",
+    "conditionNumber",
+    "distortion",
+    "jacobian",
+    "largestAngle",
+    "oddy",
+    "scaledJacobian",
+    "shape",
+    "shear",
+    "skew",
+    "smallestAngle",
+    "stretch",
+    "taper",
+    "volume",
+]
+TARGET = "mask"
+
+def load_image(data_dir, channel, suffix, index, index_length,
+               height, width):
+    path = os.path.join(data_dir, channel + suffix,
+                        "{}{:0{}d}.bin".format(channel, index, index_length))
+    image = np.fromfile(path, dtype="<f4")
+    if image.size != height * width:
+        raise ValueError("{} has {} values, expected {}".format(
+            path, image.size, height * width))
+    # Row-major to column-major
+    return image.reshape(height, width).T
+
+def pack_mesh(data_dir, out_file, suffix, index_length, height, width):
+    num_samples = len(glob.glob(
+        os.path.join(data_dir, TARGET + suffix, "*.bin")))
+    if num_samples == 0:
+        raise ValueError("could not find any targets in " + data_dir)
+    with open(out_file, "wb") as f:
+        f.write(struct.pack(HEADER_FORMAT, MAGIC, VERSION, BYTE_ORDER,
+                            num_samples, len(CHANNELS), height, width, 0))
+        for index in range(num_samples):
+            for channel in CHANNELS + [TARGET]:
+                image = load_image(data_dir, channel, suffix, index,
+                                   index_length, height, width)
+                f.write(image.astype("<f4").tobytes())
+    return num_samples
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Pack mesh images into a single file for mesh_reader.")
+    parser.add_argument("data_dir", type=str,
+                        help="Directory containing the channel directories")
+    parser.add_argument("out_file", type=str, help="Output file")
+    parser.add_argument("--suffix", type=str, default="128",
+                        help="Channel directory suffix (default: 128)")
+    parser.add_argument("--index_length", type=int, default=4,
+                        help="Length of indices in file names (default: 4)")
+    parser.add_argument("--height", type=int, default=128,
+                        help="Image height (default: 128)")
+    parser.add_argument("--width", type=int, default=128,
+                        help="Image width (default: 128)")
+    args = parser.parse_args()
+
+    num_samples = pack_mesh(args.data_dir, args.out_file, args.suffix,
+                            args.index_length, args.height, args.width)
+    print("Packed {} samples into {}".format(num_samples, args.out_file))
@@ -0,0 +1,27 @@
+#define CATCH_CONFIG_RUNNER
+#include <catch2/catch.hpp>
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/comm.hpp>
+
+int main(int argc, char* argv[]) {
+
+  // Initialize MPI and the LBANN communicator once for all tests
+  auto world_comm = lbann::initialize(argc, argv, 20191016);
+  unit_test::utilities::current_world_comm() = world_comm.get();
+
+  // Run tests on every process
+  // Note: A test fails if it fails on any process.
+  Catch::Session session;
+  int result = session.applyCommandLine(argc, argv);
+  if (result == 0) {
+    result = session.run();
+  }
+  result = world_comm->allreduce(result, world_comm->get_world_comm(),
+                                 El::mpi::MAX);
+
+  unit_test::utilities::current_world_comm() = nullptr;
+  return result;
+}
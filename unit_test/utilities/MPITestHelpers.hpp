@@ -0,0 +1,30 @@
+#ifndef LBANN_UNIT_TEST_UTILITIES_MPI_TEST_HELPERS_HPP_INCLUDED
+#define LBANN_UNIT_TEST_UTILITIES_MPI_TEST_HELPERS_HPP_INCLUDED
+
+#include <lbann/comm.hpp>
+#include <lbann/utils/exception.hpp>
+
+namespace unit_test {
+namespace utilities {
+
+/** Communicator set up by the MPI test main() function.
+ *  Null outside of mpi-catch-tests.
+ */
+inline lbann::lbann_comm*& current_world_comm() {
+  static lbann::lbann_comm* comm = nullptr;
+  return comm;
+}
+
+/** Communicator for tests that need MPI. */
+inline lbann::lbann_comm& get_current_comm() {
+  auto* comm = current_world_comm();
+  if (comm == nullptr) {
+    LBANN_ERROR("MPI tests must be run with the MPI test main() function");
+  }
+  return *comm;
+}
+
+} // namespace utilities
+} // namespace unit_test
+
+#endif // LBANN_UNIT_TEST_UTILITIES_MPI_TEST_HELPERS_HPP_INCLUDED